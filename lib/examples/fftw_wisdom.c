@@ -0,0 +1,234 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Pre-generates the FFTW wisdom of this host: creates the eNodeB and UE PHY objects of every bandwidth, so all their
+ * DFT plans are measured once, and saves the wisdom where the eNodeB and the UE load it at startup. It reports the
+ * time to create the objects of each bandwidth without and with the wisdom.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/srslte.h"
+
+static const uint32_t bandwidths[] = {6, 15, 25, 50, 75, 100};
+
+char* output_file_name = NULL;
+int   nof_prb          = -1;
+bool  patient          = false;
+bool  keep_wisdom      = false;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [opPkv]\n", prog);
+  printf("\t-o output_file [Default %s]\n", "$SRSLTE_FFTW_WISDOM or ~/.srslte_fftwisdom_<cpu>");
+  printf("\t-p nof_prb [Default all]\n");
+  printf("\t-P plan with FFTW_PATIENT [Default FFTW_MEASURE]\n");
+  printf("\t-k keep the wisdom loaded at startup [Default start from scratch]\n");
+  printf("\t-v srslte_verbose\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "opPkv")) != -1) {
+    switch (opt) {
+      case 'o':
+        output_file_name = argv[optind];
+        break;
+      case 'p':
+        nof_prb = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'P':
+        patient = true;
+        break;
+      case 'k':
+        keep_wisdom = true;
+        break;
+      case 'v':
+        srslte_verbose++;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// The receive callback is never called, the UE synchronization object is only created
+static int dummy_recv(void* h, cf_t* data[SRSLTE_MAX_CHANNELS], uint32_t nsamples, srslte_timestamp_t* t)
+{
+  return SRSLTE_ERROR;
+}
+
+typedef struct {
+  srslte_enb_dl_t  enb_dl;
+  srslte_enb_ul_t  enb_ul;
+  srslte_prach_t   prach;
+  srslte_ue_sync_t ue_sync;
+  srslte_ue_dl_t   ue_dl;
+  srslte_ue_ul_t   ue_ul;
+  cf_t*            buffer[SRSLTE_MAX_PORTS];
+} phy_objects_t;
+
+static phy_objects_t phy_objects;
+
+static int phy_objects_init(phy_objects_t* q, uint32_t cell_nof_prb)
+{
+  srslte_cell_t cell   = {};
+  cell.nof_prb         = cell_nof_prb;
+  cell.nof_ports       = 1;
+  cell.id              = 1;
+  cell.cp              = SRSLTE_CP_NORM;
+  cell.phich_length    = SRSLTE_PHICH_NORM;
+  cell.phich_resources = SRSLTE_PHICH_R_1;
+  cell.frame_type      = SRSLTE_FDD;
+
+  srslte_refsignal_dmrs_pusch_cfg_t dmrs_cfg  = {};
+  srslte_prach_cfg_t                prach_cfg = {};
+  prach_cfg.zero_corr_zone                    = 11;
+  prach_cfg.num_ra_preambles                  = 52;
+
+  bzero(q, sizeof(phy_objects_t));
+  for (uint32_t i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    q->buffer[i] = srslte_vec_cf_malloc(SRSLTE_SF_LEN_PRB(cell_nof_prb));
+    if (!q->buffer[i]) {
+      perror("malloc");
+      return SRSLTE_ERROR;
+    }
+  }
+
+  if (srslte_enb_dl_init(&q->enb_dl, q->buffer, cell_nof_prb) || srslte_enb_dl_set_cell(&q->enb_dl, cell)) {
+    ERROR("Error initiating eNodeB DL\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_enb_ul_init(&q->enb_ul, q->buffer[0], cell_nof_prb) ||
+      srslte_enb_ul_set_cell(&q->enb_ul, cell, &dmrs_cfg, NULL)) {
+    ERROR("Error initiating eNodeB UL\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_prach_init(&q->prach, srslte_symbol_sz(cell_nof_prb)) ||
+      srslte_prach_set_cfg(&q->prach, &prach_cfg, cell_nof_prb)) {
+    ERROR("Error initiating PRACH\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_ue_sync_init_multi(&q->ue_sync, cell_nof_prb, false, dummy_recv, 1, q) ||
+      srslte_ue_sync_set_cell(&q->ue_sync, cell)) {
+    ERROR("Error initiating UE sync\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_ue_dl_init(&q->ue_dl, q->buffer, cell_nof_prb, 1) || srslte_ue_dl_set_cell(&q->ue_dl, cell)) {
+    ERROR("Error initiating UE DL\n");
+    return SRSLTE_ERROR;
+  }
+  if (srslte_ue_ul_init(&q->ue_ul, q->buffer[0], cell_nof_prb) || srslte_ue_ul_set_cell(&q->ue_ul, cell)) {
+    ERROR("Error initiating UE UL\n");
+    return SRSLTE_ERROR;
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+static void phy_objects_free(phy_objects_t* q)
+{
+  srslte_enb_dl_free(&q->enb_dl);
+  srslte_enb_ul_free(&q->enb_ul);
+  srslte_prach_free(&q->prach);
+  srslte_ue_sync_free(&q->ue_sync);
+  srslte_ue_dl_free(&q->ue_dl);
+  srslte_ue_ul_free(&q->ue_ul);
+  for (uint32_t i = 0; i < SRSLTE_MAX_PORTS; i++) {
+    if (q->buffer[i]) {
+      free(q->buffer[i]);
+    }
+  }
+}
+
+// Creates and destroys the objects of a bandwidth, returns the time it took in ms or a negative value on error
+static float plan_cell(uint32_t cell_nof_prb)
+{
+  struct timeval t[3];
+
+  gettimeofday(&t[1], NULL);
+  int ret = phy_objects_init(&phy_objects, cell_nof_prb);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  phy_objects_free(&phy_objects);
+
+  return ret ? -1.0f : t[0].tv_sec * 1e3f + t[0].tv_usec * 1e-3f;
+}
+
+int main(int argc, char** argv)
+{
+  char     default_file_name[256];
+  uint32_t hits = 0, misses = 0;
+
+  parse_args(argc, argv);
+
+  if (output_file_name == NULL) {
+    if (srslte_dft_wisdom_filename(default_file_name, sizeof(default_file_name))) {
+      ERROR("Error getting the FFTW wisdom file name, is srsLTE built with FFTW?\n");
+      exit(-1);
+    }
+    output_file_name = default_file_name;
+  }
+
+  if (!keep_wisdom) {
+    srslte_dft_wisdom_forget();
+  }
+  srslte_dft_set_fftw_patient(patient);
+
+  for (uint32_t i = 0; i < sizeof(bandwidths) / sizeof(bandwidths[0]); i++) {
+    if (nof_prb > 0 && bandwidths[i] != nof_prb) {
+      continue;
+    }
+
+    // The first pass measures the plans not in the wisdom yet, the second one finds all of them in the wisdom
+    uint32_t prev_misses = misses;
+    float    cold_ms     = plan_cell(bandwidths[i]);
+    srslte_dft_wisdom_get_stats(&hits, &misses);
+    float warm_ms = plan_cell(bandwidths[i]);
+    if (cold_ms < 0 || warm_ms < 0) {
+      exit(-1);
+    }
+
+    printf("nof_prb=%3d; %3d plans measured; init without wisdom %8.1f ms; with wisdom %6.1f ms\n",
+           bandwidths[i],
+           misses - prev_misses,
+           cold_ms,
+           warm_ms);
+  }
+
+  srslte_dft_wisdom_get_stats(&hits, &misses);
+  printf("%d plans from wisdom, %d measured\n", hits, misses);
+
+  if (srslte_dft_wisdom_save(output_file_name)) {
+    ERROR("Error saving FFTW wisdom to %s\n", output_file_name);
+    exit(-1);
+  }
+  printf("Saved FFTW wisdom to %s\n", output_file_name);
+
+  exit(0);
+}
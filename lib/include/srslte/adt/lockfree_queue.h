@@ -0,0 +1,146 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_LOCKFREE_QUEUE_H
+#define SRSLTE_LOCKFREE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ *
+ * @file lockfree_queue.h
+ *
+ * @brief Bounded multi-producer multi-consumer queue that never takes a lock
+ *
+ * Each cell carries a sequence number that tells producers and consumers whether the cell is free to be written or
+ * holds an element ready to be read (D. Vyukov's bounded MPMC queue). Push and pop only contend on a single atomic
+ * index each, so a producer never blocks a consumer and vice-versa.
+ *
+ * The capacity is rounded up to the next power of two. resize() is not thread-safe and must only be called while no
+ * other thread accesses the queue.
+ */
+
+namespace srslte {
+
+template <typename T>
+class lockfree_queue
+{
+public:
+  explicit lockfree_queue(size_t capacity_ = 128) { resize(capacity_); }
+  lockfree_queue(const lockfree_queue&) = delete;
+  lockfree_queue& operator=(const lockfree_queue&) = delete;
+
+  /// Moves the element into the queue on success. On failure (queue full), the element is left untouched
+  bool try_push(T& elem)
+  {
+    cell_t* cell;
+    size_t  pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell         = &buffer[pos & mask];
+      size_t   seq = cell->seq.load(std::memory_order_acquire);
+      intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+      if (dif == 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = std::move(elem);
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+  bool try_push(T&& elem) { return try_push(elem); }
+
+  bool try_pop(T& elem)
+  {
+    cell_t* cell;
+    size_t  pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell         = &buffer[pos & mask];
+      size_t   seq = cell->seq.load(std::memory_order_acquire);
+      intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+      if (dif == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+    elem = std::move(cell->data);
+    cell->seq.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Number of elements in the queue. Only a snapshot when other threads are pushing/popping concurrently
+  size_t size() const
+  {
+    size_t tail = enqueue_pos.load(std::memory_order_acquire);
+    size_t head = dequeue_pos.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+  bool   empty() const { return size() == 0; }
+  bool   full() const { return size() >= capacity(); }
+  size_t capacity() const { return mask + 1; }
+
+  void resize(size_t capacity_)
+  {
+    size_t cap = 1;
+    while (cap < capacity_) {
+      cap <<= 1;
+    }
+    buffer.reset(new cell_t[cap]);
+    mask = cap - 1;
+    for (size_t i = 0; i < cap; ++i) {
+      buffer[i].seq.store(i, std::memory_order_relaxed);
+    }
+    enqueue_pos.store(0, std::memory_order_relaxed);
+    dequeue_pos.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  struct cell_t {
+    std::atomic<size_t> seq;
+    T                   data;
+  };
+
+  std::unique_ptr<cell_t[]> buffer;
+  size_t                    mask = 0;
+  // keep producer and consumer indexes on separate cache lines. Padding is used instead of alignas, as over-aligned
+  // types are not honoured by new before C++17
+  char                pad0[64];
+  std::atomic<size_t> enqueue_pos{0};
+  char                pad1[64];
+  std::atomic<size_t> dequeue_pos{0};
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_LOCKFREE_QUEUE_H
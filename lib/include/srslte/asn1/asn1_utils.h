@@ -24,10 +24,12 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <limits>
 #include <map>
+#include <new>
 #include <sstream>
 #include <stdarg.h> /* va_list, va_start, va_arg, va_end */
 #include <stdint.h>
@@ -135,6 +137,91 @@ public:
   SRSASN_CODE align_bytes_zero();
 };
 
+/*********************
+     decode arena
+*********************/
+
+/**
+ * Monotonic allocator for the containers of decoded PDUs. While an arena_scope is active in a thread, dyn_array and
+ * the heap path of ext_array take their storage from the arena instead of new[], and releasing it is a no-op. All the
+ * memory is released in bulk with reset().
+ * Rules: the containers created inside the scope must be destroyed before the arena is reset. Containers copied or
+ * resized outside of the scope are heap allocated again, so they can outlive the arena.
+ */
+class decode_arena
+{
+public:
+  explicit decode_arena(size_t block_size_ = 16384);
+  decode_arena(const decode_arena&) = delete;
+  decode_arena& operator=(const decode_arena&) = delete;
+  ~decode_arena();
+
+  void* allocate(size_t nof_bytes, size_t align);
+  /// Releases all allocations. If more than one block was needed, they are merged into one for the next PDUs
+  void   reset();
+  size_t bytes_used() const { return used; }
+  size_t capacity() const;
+  size_t nof_blocks() const { return blocks.size(); }
+
+  /// Arena of the innermost active arena_scope of the calling thread, or nullptr
+  static decode_arena* current();
+
+private:
+  struct block_t {
+    uint8_t* data;
+    size_t   size;
+  };
+
+  size_t               block_size;
+  std::vector<block_t> blocks;
+  size_t               offset = 0; ///< next free byte of the last block
+  size_t               used   = 0;
+};
+
+/// Makes the containers allocate from an arena in the calling thread until the end of the scope
+class arena_scope
+{
+public:
+  explicit arena_scope(decode_arena& arena);
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+  ~arena_scope();
+
+private:
+  decode_arena* prev;
+};
+
+namespace detail {
+
+template <class T>
+T* alloc_array(uint32_t n, bool& in_arena)
+{
+  decode_arena* arena = decode_arena::current();
+  in_arena            = arena != nullptr;
+  if (arena == nullptr) {
+    return new T[n];
+  }
+  T* p = static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+  for (uint32_t i = 0; i < n; ++i) {
+    new (&p[i]) T;
+  }
+  return p;
+}
+
+template <class T>
+void free_array(T* p, uint32_t n, bool in_arena)
+{
+  if (not in_arena) {
+    delete[] p;
+    return;
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    p[i].~T();
+  }
+}
+
+} // namespace detail
+
 /*********************
   function helpers
 *********************/
@@ -146,20 +233,22 @@ public:
   using iterator       = T*;
   using const_iterator = const T*;
 
-  dyn_array() = default;
-  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = new T[size_]; }
+  dyn_array() : cap_(0), in_arena(false) {}
+  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size), in_arena(false)
+  {
+    data_ = alloc_data(cap_);
+  }
   dyn_array(const dyn_array<T>& other) : dyn_array(&other[0], other.size_) {}
-  dyn_array(const T* ptr, uint32_t nof_items)
+  dyn_array(const T* ptr, uint32_t nof_items) : cap_(nof_items), in_arena(false)
   {
     size_ = nof_items;
-    cap_  = nof_items;
-    data_ = new T[cap_];
+    data_ = alloc_data(cap_);
     std::copy(ptr, ptr + size_, data_);
   }
   ~dyn_array()
   {
     if (data_ != NULL) {
-      delete[] data_;
+      detail::free_array(data_, cap_, in_arena);
     }
   }
   uint32_t      size() const { return size_; }
@@ -184,10 +273,12 @@ public:
       size_ = new_size;
       return;
     }
-    T* old_data = data_;
-    cap_        = new_size > new_cap ? new_size : new_cap;
+    T*       old_data     = data_;
+    uint32_t old_cap      = cap_;
+    bool     old_in_arena = in_arena;
+    cap_                  = new_size > new_cap ? new_size : new_cap;
     if (cap_ > 0) {
-      data_ = new T[cap_];
+      data_ = alloc_data(cap_);
       if (old_data != NULL) {
         std::copy(&old_data[0], &old_data[size_], data_);
       }
@@ -196,7 +287,7 @@ public:
     }
     size_ = new_size;
     if (old_data != NULL) {
-      delete[] old_data;
+      detail::free_array(old_data, old_cap, old_in_arena);
     }
   }
   iterator erase(iterator it)
@@ -229,11 +320,21 @@ public:
   iterator       end() { return &data_[size()]; }
   const_iterator begin() const { return &data_[0]; }
   const_iterator end() const { return &data_[size()]; }
+  bool           is_in_arena() const { return in_arena; }
 
 private:
+  T* alloc_data(uint32_t n)
+  {
+    bool arena_alloc = false;
+    T*   p           = detail::alloc_array<T>(n, arena_alloc);
+    in_arena         = arena_alloc;
+    return p;
+  }
+
   T*       data_ = nullptr;
   uint32_t size_ = 0;
-  uint32_t cap_  = 0;
+  uint32_t cap_ : 31;
+  uint32_t in_arena : 1; ///< data_ belongs to a decode_arena
 };
 
 template <class T, uint32_t MAX_N>
@@ -287,19 +388,20 @@ class ext_array
 {
 public:
   static const uint32_t small_buffer_size = Nthres;
-  ext_array() : size_(0), head(&small_buffer.data[0]) {}
+  ext_array() : size_(0), in_arena(false), head(&small_buffer.data[0]) {}
   explicit ext_array(uint32_t new_size) : ext_array() { resize(new_size); }
   ext_array(const ext_array<T, Nthres>& other) : ext_array(other.size_)
   {
     std::copy(other.head, other.head + other.size_, head);
   }
-  ext_array(ext_array<T, Nthres>&& other) noexcept
+  ext_array(ext_array<T, Nthres>&& other) noexcept : ext_array()
   {
-    size_ = other.size();
-    if (other.is_in_small_buffer()) {
-      head = &small_buffer.data[0];
+    if (other.is_in_small_buffer() or other.in_arena) {
+      // arena storage is not handed over, as the moved-to array may outlive the arena
+      resize(other.size());
       std::copy(other.data(), other.data() + other.size(), head);
     } else {
+      size_             = other.size();
       head              = other.head;
       small_buffer.cap_ = other.small_buffer.cap_;
       other.head        = &other.small_buffer.data[0];
@@ -309,7 +411,7 @@ public:
   ~ext_array()
   {
     if (not is_in_small_buffer()) {
-      delete[] head;
+      detail::free_array(head, small_buffer.cap_, in_arena);
     }
   }
   ext_array<T, Nthres>& operator=(const ext_array<T, Nthres>& other)
@@ -347,17 +449,19 @@ public:
       size_ = new_size;
       return;
     }
-    T*       old_data = head;
-    uint32_t newcap   = new_size + 5;
-    head              = new T[newcap];
-    std::copy(&small_buffer.data[0], &small_buffer.data[size_], head);
+    T*       old_data     = head;
+    bool     old_in_arena = in_arena;
+    uint32_t newcap       = new_size + 5;
+    head                  = detail::alloc_array<T>(newcap, in_arena);
+    std::copy(&old_data[0], &old_data[size_], head);
     size_ = new_size;
     if (old_data != &small_buffer.data[0]) {
-      delete[] old_data;
+      detail::free_array(old_data, small_buffer.cap_, old_in_arena);
     }
     small_buffer.cap_ = newcap;
   }
   bool is_in_small_buffer() const { return head == &small_buffer.data[0]; }
+  bool is_in_arena() const { return in_arena; }
 
 private:
   union {
@@ -365,6 +469,7 @@ private:
     uint32_t cap_;
   } small_buffer;
   uint32_t size_;
+  bool     in_arena; ///< head belongs to a decode_arena
   T*       head;
 };
 
@@ -654,9 +759,7 @@ SRSASN_CODE fixed_octstring<N, aligned>::pack(bit_ref& bref) const
   if (aligned and N > 2) {
     bref.align_bytes_zero();
   }
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.pack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.pack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -666,9 +769,7 @@ SRSASN_CODE fixed_octstring<N, aligned>::unpack(cbit_ref& bref)
   if (aligned and N > 2) {
     bref.align_bytes();
   }
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.unpack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.unpack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -1298,6 +1399,80 @@ int test_pack_unpack_consistency(const Msg& msg)
   return SRSASN_SUCCESS;
 }
 
+/**
+ * Unpacks the same message nof_iters times, with the containers on the heap or with one arena that is reset between
+ * decodes. Returns the number of decodes per second, or a negative value if a decode fails or if the message decoded
+ * in the arena does not pack to the same bytes as the one decoded on the heap
+ */
+template <class Msg>
+double test_decode_throughput(const uint8_t* msg_buf, uint32_t nof_bytes, uint32_t nof_iters, bool use_arena)
+{
+  uint8_t      buf[2048], buf2[2048];
+  decode_arena arena;
+
+  // reference decode
+  {
+    Msg            msg, msg2;
+    asn1::cbit_ref bref(msg_buf, nof_bytes), bref2(msg_buf, nof_bytes);
+    asn1::bit_ref  bref3(&buf[0], sizeof(buf)), bref4(&buf2[0], sizeof(buf2));
+    if (msg.unpack(bref) != SRSASN_SUCCESS or msg.pack(bref3) != SRSASN_SUCCESS) {
+      return -1;
+    }
+    {
+      arena_scope scope(arena);
+      if (msg2.unpack(bref2) != SRSASN_SUCCESS) {
+        return -1;
+      }
+    }
+    if (msg2.pack(bref4) != SRSASN_SUCCESS or bref3.distance() != bref4.distance() or
+        memcmp(buf, buf2, bref3.distance_bytes()) != 0) {
+      return -1;
+    }
+  }
+
+  auto tic = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_iters; ++i) {
+    // the message of the previous iteration was already destroyed
+    arena.reset();
+    Msg            msg;
+    asn1::cbit_ref bref(msg_buf, nof_bytes);
+    SRSASN_CODE    ret;
+    if (use_arena) {
+      arena_scope scope(arena);
+      ret = msg.unpack(bref);
+    } else {
+      ret = msg.unpack(bref);
+    }
+    if (ret != SRSASN_SUCCESS) {
+      return -1;
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tic;
+  return nof_iters / std::max(elapsed.count(), 1e-9);
+}
+
+/// Packs the given message nof_iters times. Returns the number of encodes per second, or a negative value on failure
+template <class Msg>
+double test_encode_throughput(const uint8_t* msg_buf, uint32_t nof_bytes, uint32_t nof_iters)
+{
+  uint8_t        buf[2048];
+  Msg            msg;
+  asn1::cbit_ref bref(msg_buf, nof_bytes);
+  if (msg.unpack(bref) != SRSASN_SUCCESS) {
+    return -1;
+  }
+
+  auto tic = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_iters; ++i) {
+    asn1::bit_ref bref2(&buf[0], sizeof(buf));
+    if (msg.pack(bref2) != SRSASN_SUCCESS) {
+      return -1;
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tic;
+  return nof_iters / std::max(elapsed.count(), 1e-9);
+}
+
 } // namespace asn1
 
 #endif // SRSASN_COMMON_UTILS_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_AES_128_H
+#define SRSLTE_AES_128_H
+
+#include <stdint.h>
+
+namespace srslte {
+
+/**
+ * AES-128 key with its key schedule expanded once, for the AES based LTE security algorithms (128-EEA2/128-EIA2).
+ *
+ * The round keys and the CMAC subkeys are derived in set_key(), so ciphering a packet only runs the cipher rounds.
+ * When the compiler targets AES-NI (e.g. -march=native) the rounds use the AES instructions, and CTR mode processes
+ * several blocks in parallel (two per instruction with VAES). Otherwise a table based implementation is used.
+ */
+class aes_128_key
+{
+public:
+  aes_128_key() = default;
+  explicit aes_128_key(const uint8_t* key) { set_key(key); }
+
+  void set_key(const uint8_t* key);
+  bool is_set() const { return key_set; }
+
+  /// Encrypt a single 16-byte block. in and out may point to the same buffer
+  void encrypt_block(const uint8_t* in, uint8_t* out) const;
+
+  /// AES-CTR, with nonce_cnt the initial 16-byte counter block, incremented as a 128-bit big-endian integer. In-place
+  /// operation (in == out) is allowed
+  void ctr_crypt(const uint8_t* nonce_cnt, const uint8_t* in, uint32_t len, uint8_t* out) const;
+
+  /// AES-CMAC (RFC 4493) over the concatenation of hdr (up to 16 bytes) and msg. Writes the full 16-byte tag
+  void cmac(const uint8_t* hdr, uint32_t hdr_len, const uint8_t* msg, uint32_t msg_len, uint8_t* tag) const;
+
+  /// Name of the implementation selected at compile time
+  static const char* backend();
+
+private:
+  uint8_t rk[176] = {}; // 11 round keys
+  uint8_t k1[16]  = {}; // CMAC subkeys
+  uint8_t k2[16]  = {};
+  bool    key_set = false;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_AES_128_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_BYTE_BUFFER_SLICE_H
+#define SRSLTE_BYTE_BUFFER_SLICE_H
+
+#include "srslte/adt/span.h"
+#include "srslte/common/buffer_pool.h"
+#include <vector>
+
+namespace srslte {
+
+/**
+ * List of views into byte buffers that together form a message, e.g. the SDU segments of an RLC PDU.
+ *
+ * Buffers whose content is fully referenced by the list are kept alive by the list until it is cleared, so the
+ * payload doesn't need to be copied until it is finally written (e.g. into the MAC PDU). If the whole message is
+ * the remainder of a single buffer, that buffer can be taken over without any copy.
+ */
+class byte_buffer_slice_list
+{
+public:
+  /// Append a view of len bytes starting at data. The memory must stay valid until the list is cleared
+  void append(const uint8_t* data, uint32_t len)
+  {
+    slices.push_back(srslte::span<const uint8_t>(data, len));
+    nof_bytes += len;
+  }
+
+  /// Keep a buffer alive, whose remaining content is referenced by the last appended slice
+  void hold(unique_byte_buffer_t buf) { held.push_back(std::move(buf)); }
+
+  uint32_t size_bytes() const { return nof_bytes; }
+  size_t   nof_slices() const { return slices.size(); }
+  bool     empty() const { return slices.empty(); }
+
+  /// Gather all slices contiguously into dst. Returns the number of bytes written
+  uint32_t copy_to(uint8_t* dst) const
+  {
+    uint8_t* ptr = dst;
+    for (const srslte::span<const uint8_t>& s : slices) {
+      memcpy(ptr, s.data(), s.size());
+      ptr += s.size();
+    }
+    return ptr - dst;
+  }
+
+  /**
+   * Take over the buffer backing the message, if the message is the tail of a single held buffer. The returned buffer
+   * is set to point to the message. Otherwise returns nullptr and the message has to be copied.
+   */
+  unique_byte_buffer_t release_single_buffer()
+  {
+    if (slices.size() != 1 or held.size() != 1) {
+      return nullptr;
+    }
+    unique_byte_buffer_t& buf = held.front();
+    const uint8_t*        end = slices.front().data() + slices.front().size();
+    if (buf == nullptr or buf->msg != end or buf->N_bytes != 0) {
+      return nullptr;
+    }
+    buf->msg -= slices.front().size();
+    buf->N_bytes = slices.front().size();
+    unique_byte_buffer_t ret = std::move(buf);
+    clear();
+    return ret;
+  }
+
+  /// Drop all views and release the held buffers. Capacity is kept, so no allocation happens in steady state
+  void clear()
+  {
+    slices.clear();
+    held.clear();
+    nof_bytes = 0;
+  }
+
+private:
+  std::vector<srslte::span<const uint8_t> > slices;
+  std::vector<unique_byte_buffer_t>         held;
+  uint32_t                                  nof_bytes = 0;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_BYTE_BUFFER_SLICE_H
@@ -72,6 +72,20 @@ void s3g_deinitialize(S3G_STATE* state);
 
 void s3g_generate_keystream(S3G_STATE* state, uint32_t n, uint32_t* ks);
 
+/* Multi-buffer generation of Keystream.
+ * Equivalent to s3g_initialize() and s3g_generate_keystream() for
+ * each of the nof_inst instances, but runs one instance per SIMD lane.
+ * input k, iv: key and initialization variable of each instance.
+ * input n: number of 32-bit words of keystream of each instance.
+ * output ks: keystream of each instance, ks[i] holds n[i] words.
+ */
+
+void s3g_generate_keystream_mb(uint32_t        nof_inst,
+                               const uint32_t (*k)[4],
+                               const uint32_t (*iv)[4],
+                               const uint32_t* n,
+                               uint32_t**      ks);
+
 /* f8.
  * Input key: 128 bit Confidentiality Key.
  * Input count:32-bit Count, Frame dependent input.
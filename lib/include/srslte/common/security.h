@@ -26,6 +26,7 @@
  * Common security header - wraps ciphering/integrity check algorithms.
  *****************************************************************************/
 
+#include "srslte/common/aes_128.h"
 #include "srslte/common/common.h"
 
 namespace srslte {
@@ -78,6 +79,19 @@ struct as_security_config_t {
   CIPHERING_ALGORITHM_ID_ENUM cipher_algo;
 };
 
+/**
+ * AS keys of a bearer with the AES key schedule already expanded, so that 128-EEA2 and 128-EIA2 don't have to run
+ * the key expansion for every packet. Only the keys of the configured algorithms are expanded.
+ */
+struct as_security_ctx_t {
+  aes_128_key k_rrc_int;
+  aes_128_key k_rrc_enc;
+  aes_128_key k_up_int;
+  aes_128_key k_up_enc;
+
+  void set(const as_security_config_t& cfg);
+};
+
 /******************************************************************************
  * Key Generation
  *****************************************************************************/
@@ -132,6 +146,14 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac);
 
+uint8_t security_128_eia2(const aes_128_key& key,
+                          uint32_t           count,
+                          uint32_t           bearer,
+                          uint8_t            direction,
+                          const uint8_t*     msg,
+                          uint32_t           msg_len,
+                          uint8_t*           mac);
+
 uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       count,
                           uint32_t       bearer,
@@ -161,6 +183,14 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+uint8_t security_128_eea2(const aes_128_key& key,
+                          uint32_t           count,
+                          uint8_t            bearer,
+                          uint8_t            direction,
+                          const uint8_t*     msg,
+                          uint32_t           msg_len,
+                          uint8_t*           msg_out);
+
 uint8_t security_128_eea3(uint8_t* key,
                           uint32_t count,
                           uint8_t  bearer,
@@ -169,6 +199,34 @@ uint8_t security_128_eea3(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out);
 
+/******************************************************************************
+ * Batch processing
+ *****************************************************************************/
+
+/// One packet of a batch ciphering or integrity protection call
+struct security_batch_item_t {
+  const uint8_t*     key;       ///< 128-bit key
+  const aes_128_key* aes_key;   ///< Expanded key for EEA2/EIA2. Optional, key is used if nullptr
+  uint32_t           count;     ///< COUNT of the packet
+  uint8_t            bearer;    ///< Bearer identity (5 bits)
+  uint8_t            direction; ///< Direction of the transmission (1 bit)
+  const uint8_t*     msg;       ///< Input message
+  uint32_t           msg_len;   ///< Length of the message in bytes
+  uint8_t*           out;       ///< Ciphered message (may be msg) or 4-byte MAC
+};
+
+/// Number of packets whose keystream is generated in parallel by the batch functions
+uint32_t security_batch_nof_lanes();
+
+/**
+ * Cipher or integrity protect a batch of packets, e.g. the SDUs queued in PDCP. The SNOW 3G and ZUC keystreams of
+ * 128-EEA1, 128-EEA3 and 128-EIA3 are generated for several packets in parallel, one packet per SIMD lane. The other
+ * algorithms process one packet after the other.
+ */
+int security_128_eea_batch(CIPHERING_ALGORITHM_ID_ENUM algo, const security_batch_item_t* items, uint32_t nof_items);
+
+int security_128_eia_batch(INTEGRITY_ALGORITHM_ID_ENUM algo, const security_batch_item_t* items, uint32_t nof_items);
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -183,5 +241,21 @@ security_milenage_f2345(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* res, ui
 
 uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* ak);
 
+/**
+ * Milenage f1, f2, f3, f4 and f5 for one RAND with the key schedule of K already expanded, as needed by the HSS to
+ * build an authentication vector. The E_K(RAND xor OPc) block is shared by all the functions, so the whole vector
+ * costs five AES block encryptions instead of the twelve (plus six key expansions) of the separate functions.
+ */
+void security_milenage_f12345(const aes_128_key& k,
+                              const uint8_t*     opc,
+                              const uint8_t*     rand,
+                              const uint8_t*     sqn,
+                              const uint8_t*     amf,
+                              uint8_t*           mac_a,
+                              uint8_t*           res,
+                              uint8_t*           ck,
+                              uint8_t*           ik,
+                              uint8_t*           ak);
+
 } // namespace srslte
 #endif // SRSLTE_SECURITY_H
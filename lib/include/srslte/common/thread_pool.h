@@ -29,6 +29,7 @@
 #ifndef SRSLTE_THREAD_POOL_H
 #define SRSLTE_THREAD_POOL_H
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <memory>
@@ -108,6 +109,18 @@ public:
   uint32_t nof_pending_tasks();
   size_t   nof_workers() const { return workers.size(); }
 
+  /**
+   * Fork-join: runs task(idx, slot) for every idx in [0, nof_tasks) and returns once all of them have finished.
+   * The calling thread and the idle workers claim the indexes one at a time, so a long task does not hold back the
+   * others. The calling thread runs the tasks that no worker has claimed, so it never waits for a busy pool and the
+   * calls can be nested.
+   *
+   * @param nof_tasks number of tasks
+   * @param task callable, slot is 0 for the calling thread and 1 + worker id for the workers, i.e. it is unique among
+   *             the threads running the tasks of one call and lower than nof_workers() + 1
+   */
+  void parallel_for(uint32_t nof_tasks, const std::function<void(uint32_t idx, uint32_t slot)>& task);
+
 private:
   class worker_t : public thread
   {
@@ -45,4 +45,8 @@ typedef struct {
 void zuc_initialize(zuc_state_t* state, const u8* k, u8* iv);
 void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keystream);
 
+/* generate the keystream of nof_inst independent instances, one per SIMD lane. Equivalent to zuc_initialize() and
+ * zuc_generate_keystream() with key k[i], iv iv[i] and len[i] words for each instance */
+void zuc_generate_keystream_mb(u32 nof_inst, const u8* const* k, const u8* const* iv, const u32* len, u32** ks);
+
 #endif // SRSLTE_ZUC_H
@@ -557,6 +557,12 @@ typedef struct {
   int                           nr_tb_size = -1;
 } mac_args_t;
 
+typedef struct {
+  bool     crypto_batch;      ///< Cipher the DRB PDUs of all UEs in batches, flushed every TTI
+  uint32_t crypto_batch_size; ///< Maximum number of PDUs of a batch
+  bool     crypto_worker;     ///< Run the batches in a dedicated thread instead of the stack thread
+} pdcp_args_t;
+
 class stack_interface_s1ap_lte
 {
 public:
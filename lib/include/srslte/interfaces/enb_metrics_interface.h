@@ -45,6 +45,7 @@ struct stack_metrics_t {
 typedef struct {
   srslte::rf_metrics_t rf;
   phy_metrics_t        phy[ENB_METRICS_MAX_USERS];
+  phy_timing_metrics_t phy_timing;
   stack_metrics_t      stack;
   bool                 running;
 } enb_metrics_t;
@@ -125,6 +125,7 @@ struct rlc_um_nr_config_t {
 };
 
 #define RLC_TX_QUEUE_LEN (256)
+#define RLC_MAX_TX_QUEUE_LEN (1024)
 
 enum class srslte_rat_t { lte, nr, nulltype };
 inline std::string to_string(const srslte_rat_t& type)
@@ -24,6 +24,7 @@
 
 #include "srslte/config.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**********************************************************************************************
  *  File:         dft.h
@@ -40,6 +41,17 @@
  *                norm   - Normalizes output (by sqrt(len) for complex, len for real).
  *                dc     - Handles insertion and removal of null DC carrier internally.
  *
+ *                Complex transforms run either on FFTW or on the built-in FFT (dft_native.h),
+ *                selected for the plans created afterwards with srslte_dft_set_backend(). The
+ *                default is FFTW unless srsLTE was configured with USE_NATIVE_DFT or without
+ *                FFTW, and the SRSLTE_DFT_BACKEND environment variable ("fftw" or "native")
+ *                overrides it at startup. Real transforms always use FFTW.
+ *
+ *                FFTW plans are looked up first in the wisdom, which is loaded at startup
+ *                from a file per set of CPU SIMD extensions in the home directory (or from
+ *                SRSLTE_FFTW_WISDOM) and saved back at exit when new plans were measured.
+ *                lib/examples/fftw_wisdom pre-generates it.
+ *
  *  Reference:
  *********************************************************************************************/
 
@@ -51,22 +63,47 @@ typedef enum { SRSLTE_DFT_COMPLEX, SRSLTE_REAL } srslte_dft_mode_t;
 
 typedef enum { SRSLTE_DFT_FORWARD, SRSLTE_DFT_BACKWARD } srslte_dft_dir_t;
 
+typedef enum { SRSLTE_DFT_BACKEND_FFTW, SRSLTE_DFT_BACKEND_NATIVE } srslte_dft_backend_t;
+
 typedef struct SRSLTE_API {
-  int               init_size; // DFT length used in the first initialization
-  int               size;      // DFT length
-  void*             in;        // Input buffer
-  void*             out;       // Output buffer
-  void*             p;         // DFT plan
-  bool              is_guru;
-  bool              forward; // Forward transform?
-  bool              mirror;  // Shift negative and positive frequencies?
-  bool              db;      // Provide output in dB?
-  bool              norm;    // Normalize output?
-  bool              dc;      // Handle insertion/removal of null DC carrier internally?
-  srslte_dft_dir_t  dir;     // Forward/Backward
-  srslte_dft_mode_t mode;    // Complex/Real
+  int                  init_size; // DFT length used in the first initialization
+  int                  size;      // DFT length
+  void*                in;        // Input buffer
+  void*                out;       // Output buffer
+  void*                p;         // DFT plan
+  bool                 is_guru;
+  bool                 forward; // Forward transform?
+  bool                 mirror;  // Shift negative and positive frequencies?
+  bool                 db;      // Provide output in dB?
+  bool                 norm;    // Normalize output?
+  bool                 dc;      // Handle insertion/removal of null DC carrier internally?
+  srslte_dft_dir_t     dir;     // Forward/Backward
+  srslte_dft_mode_t    mode;    // Complex/Real
+  srslte_dft_backend_t backend; // Implementation running the plan
 } srslte_dft_plan_t;
 
+/* Select the backend of the plans created afterwards */
+
+SRSLTE_API int srslte_dft_set_backend(srslte_dft_backend_t backend);
+
+SRSLTE_API srslte_dft_backend_t srslte_dft_get_backend(void);
+
+SRSLTE_API const char* srslte_dft_backend_string(srslte_dft_backend_t backend);
+
+/* FFTW wisdom, a NULL path is the default file of this host */
+
+SRSLTE_API int srslte_dft_wisdom_filename(char* path, uint32_t len);
+
+SRSLTE_API int srslte_dft_wisdom_load(const char* path);
+
+SRSLTE_API int srslte_dft_wisdom_save(const char* path);
+
+SRSLTE_API void srslte_dft_wisdom_forget(void);
+
+SRSLTE_API void srslte_dft_wisdom_get_stats(uint32_t* nof_hits, uint32_t* nof_misses);
+
+SRSLTE_API void srslte_dft_set_fftw_patient(bool patient);
+
 SRSLTE_API int srslte_dft_plan(srslte_dft_plan_t* plan, int dft_points, srslte_dft_dir_t dir, srslte_dft_mode_t type);
 
 SRSLTE_API int srslte_dft_plan_c(srslte_dft_plan_t* plan, int dft_points, srslte_dft_dir_t dir);
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**********************************************************************************************
+ *  File:         dft_native.h
+ *
+ *  Description:  Built-in complex DFT, used by the DFT module when the native backend is
+ *                selected or FFTW is not available.
+ *                Sizes of the form 2^a*3^b*5^c, which covers the OFDM symbol sizes and the
+ *                DFT-precoding sizes, are computed with a mixed radix (2, 3, 4 and 5) Stockham
+ *                FFT with AVX2 butterflies. Other sizes (e.g. the PRACH sequence lengths) are
+ *                computed with Bluestein's algorithm on top of it.
+ *
+ *  Reference:
+ *********************************************************************************************/
+
+#ifndef SRSLTE_DFT_NATIVE_H
+#define SRSLTE_DFT_NATIVE_H
+
+#include "srslte/config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SRSLTE_DFT_NATIVE_MAX_STAGES 32
+
+typedef struct SRSLTE_API {
+  uint32_t size;
+  bool     forward;
+  uint32_t nof_stages;
+  uint32_t radix[SRSLTE_DFT_NATIVE_MAX_STAGES];
+  cf_t*    twiddle[SRSLTE_DFT_NATIVE_MAX_STAGES];
+  cf_t*    work;
+} srslte_dft_native_kernel_t;
+
+typedef struct SRSLTE_API {
+  uint32_t                   size;
+  bool                       forward;
+  bool                       bluestein; // Size has prime factors other than 2, 3 and 5
+  srslte_dft_native_kernel_t kernel;    // Transform of the DFT size or, for Bluestein, of the convolution size
+  srslte_dft_native_kernel_t kernel_inv;
+  cf_t*                      chirp;
+  cf_t*                      chirp_fft;
+  cf_t*                      conv;
+} srslte_dft_native_t;
+
+SRSLTE_API int srslte_dft_native_init(srslte_dft_native_t* q, uint32_t size, bool forward);
+
+SRSLTE_API void srslte_dft_native_free(srslte_dft_native_t* q);
+
+SRSLTE_API bool srslte_dft_native_is_fast_size(uint32_t size);
+
+/* Unnormalized transform, in and out can be the same buffer */
+SRSLTE_API void srslte_dft_native_run(srslte_dft_native_t* q, const cf_t* in, cf_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSLTE_DFT_NATIVE_H
@@ -119,6 +119,13 @@ SRSLTE_API int srslte_enb_dl_put_pdcch_ul(srslte_enb_dl_t* q, srslte_dci_cfg_t*
 SRSLTE_API int
 srslte_enb_dl_put_pdsch(srslte_enb_dl_t* q, srslte_pdsch_cfg_t* pdsch, uint8_t* data[SRSLTE_MAX_CODEWORDS]);
 
+/* Encodes the PDSCH with an encoder other than the one of q, so that the PDSCH of different UEs can be put into the
+ * subframe concurrently. The encoder must be initialised with the cell and the RNTI of the UE */
+SRSLTE_API int srslte_enb_dl_put_pdsch_lane(srslte_enb_dl_t*    q,
+                                            srslte_pdsch_t*     lane,
+                                            srslte_pdsch_cfg_t* pdsch,
+                                            uint8_t*            data[SRSLTE_MAX_CODEWORDS]);
+
 SRSLTE_API int srslte_enb_dl_put_pmch(srslte_enb_dl_t* q, srslte_pmch_cfg_t* pmch_cfg, uint8_t* data);
 
 SRSLTE_API void srslte_enb_dl_gen_signal(srslte_enb_dl_t* q);
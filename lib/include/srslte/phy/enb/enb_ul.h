@@ -62,6 +62,14 @@ typedef struct SRSLTE_API {
 
 } srslte_enb_ul_t;
 
+/* PUSCH decoder working on the subframe symbols of an srslte_enb_ul_t. The PUSCH of different UEs in the same subframe
+ * can be decoded concurrently, each one with its own srslte_enb_ul_pusch_t */
+typedef struct SRSLTE_API {
+  srslte_chest_ul_res_t chest_res;
+  srslte_chest_ul_t     chest;
+  srslte_pusch_t        pusch;
+} srslte_enb_ul_pusch_t;
+
 /* This function shall be called just after the initial synchronization */
 SRSLTE_API int srslte_enb_ul_init(srslte_enb_ul_t* q, cf_t* in_buffer, uint32_t max_prb);
 
@@ -83,9 +91,46 @@ SRSLTE_API int srslte_enb_ul_get_pucch(srslte_enb_ul_t*    q,
                                        srslte_pucch_cfg_t* cfg,
                                        srslte_pucch_res_t* res);
 
+/**
+ * Decodes the PUCCH of several UEs in the same subframe. Formats 1, 1a, 1b and 2 are decoded with the batched PUCCH
+ * receiver, which despreads every PUCCH PRB once for all the UEs sharing it, the others as srslte_enb_ul_get_pucch()
+ * does. As in srslte_enb_ul_get_pucch(), the UCI configuration of each UE is updated with the UCI actually decoded.
+ *
+ * @param q eNb UL object, srslte_enb_ul_fft() must have been called for the subframe
+ * @param ul_sf Uplink subframe configuration
+ * @param cfg PUCCH configuration of each UE
+ * @param res Result of each UE
+ * @param nof_ue Number of UEs
+ * @return SRSLTE_SUCCESS if all the UEs were decoded, SRSLTE_ERROR code otherwise
+ */
+SRSLTE_API int srslte_enb_ul_get_pucch_batch(srslte_enb_ul_t*    q,
+                                             srslte_ul_sf_cfg_t* ul_sf,
+                                             srslte_pucch_cfg_t* cfg,
+                                             srslte_pucch_res_t* res,
+                                             uint32_t            nof_ue);
+
 SRSLTE_API int srslte_enb_ul_get_pusch(srslte_enb_ul_t*    q,
                                        srslte_ul_sf_cfg_t* ul_sf,
                                        srslte_pusch_cfg_t* cfg,
                                        srslte_pusch_res_t* res);
 
+SRSLTE_API int srslte_enb_ul_pusch_init(srslte_enb_ul_pusch_t* q, uint32_t max_prb);
+
+SRSLTE_API void srslte_enb_ul_pusch_free(srslte_enb_ul_pusch_t* q);
+
+SRSLTE_API int srslte_enb_ul_pusch_set_cell(srslte_enb_ul_pusch_t*             q,
+                                            srslte_cell_t                      cell,
+                                            srslte_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                            srslte_refsignal_srs_cfg_t*        srs_cfg);
+
+SRSLTE_API int srslte_enb_ul_pusch_add_rnti(srslte_enb_ul_pusch_t* q, uint16_t rnti);
+
+SRSLTE_API void srslte_enb_ul_pusch_rem_rnti(srslte_enb_ul_pusch_t* q, uint16_t rnti);
+
+SRSLTE_API int srslte_enb_ul_get_pusch_lane(srslte_enb_ul_t*       q,
+                                            srslte_enb_ul_pusch_t* lane,
+                                            srslte_ul_sf_cfg_t*    ul_sf,
+                                            srslte_pusch_cfg_t*    cfg,
+                                            srslte_pusch_res_t*    res);
+
 #endif // SRSLTE_ENB_UL_H
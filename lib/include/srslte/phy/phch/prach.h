@@ -103,6 +103,11 @@ typedef struct SRSLTE_API {
   uint32_t                    num_ra_preambles;
   bool                        successive_cancellation;
   bool                        freq_domain_offset_calc;
+  bool                        fast_detection;
+  float                       max_delay_us;    // Maximum delay searched by the fast detector, 0 for the whole window
+  uint32_t                    search_len;      // Lags searched at the start of each window by the fast detector
+  uint32_t                    nof_pruned_lags; // Lags evaluated per root with the pruned IDFT, 0 for the full IDFT
+  cf_t*                       pruned_idft;     // Pruned IDFT, one row of N_zc twiddles per evaluated lag
   srslte_tdd_config_t         tdd_config;
   uint32_t                    current_prach_idx;
   cf_t*                       cross;
@@ -133,6 +138,7 @@ typedef struct {
   srslte_tdd_config_t tdd_config;
   bool                enable_successive_cancellation;
   bool                enable_freq_domain_offset_calc;
+  bool                enable_fast_detection;
 } srslte_prach_cfg_t;
 
 typedef struct SRSLTE_API {
@@ -213,6 +219,8 @@ SRSLTE_API int srslte_prach_detect_offset(srslte_prach_t* p,
 
 SRSLTE_API void srslte_prach_set_detect_factor(srslte_prach_t* p, float factor);
 
+SRSLTE_API int srslte_prach_set_max_delay_us(srslte_prach_t* p, float max_delay_us);
+
 SRSLTE_API int srslte_prach_free(srslte_prach_t* p);
 
 SRSLTE_API int srslte_prach_print_seqs(srslte_prach_t* p);
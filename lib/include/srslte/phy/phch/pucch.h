@@ -87,6 +87,15 @@ typedef struct SRSLTE_API {
   cf_t* z_tmp;
   cf_t* ce;
 
+  // Batched receiver, eNb only. The PRBs of a subframe are despread once, for all the cyclic shifts, and kept for all
+  // the resources decoded until srslte_pucch_batch_reset() is called
+  uint32_t batch_nof_prb;
+  cf_t*    batch_x;     // [slot][prb][symbol][subcarrier] Received symbols without the base sequence
+  cf_t*    batch_y;     // [slot][prb][symbol][cyclic shift] 12-point DFT of batch_x
+  float*   batch_noise; // [slot][prb] Noise power per RE, NAN if it can not be estimated
+  uint32_t batch_u[SRSLTE_NOF_SLOTS_PER_SF][SRSLTE_MAX_PRB]; // Base sequence + 1 of each despread PRB, 0 if not done
+  cf_t     batch_dft[SRSLTE_NRE][SRSLTE_NRE];
+
 } srslte_pucch_t;
 
 typedef struct SRSLTE_API {
@@ -129,6 +138,47 @@ SRSLTE_API int srslte_pucch_decode(srslte_pucch_t*        q,
                                    cf_t*                  sf_symbols,
                                    srslte_pucch_res_t*    data);
 
+/**
+ * Drops the PRBs despread by the batched receiver, it must be called every subframe before decoding its resources
+ * with srslte_pucch_decode_batch()
+ *
+ * @param q PUCCH object
+ */
+SRSLTE_API void srslte_pucch_batch_reset(srslte_pucch_t* q);
+
+/**
+ * Tells whether a PUCCH format can be decoded with srslte_pucch_decode_batch()
+ *
+ * @param format PUCCH format
+ * @return true for the formats 1, 1a, 1b and 2
+ */
+SRSLTE_API bool srslte_pucch_batch_supported(srslte_pucch_format_t format);
+
+/**
+ * Batched version of srslte_pucch_decode(). Every PRB is despread only once per subframe for all the cyclic shifts,
+ * with a 12-point DFT per symbol, and shared by all the resources decoded on it. The channel is estimated from the
+ * despread DMRS, one value per slot, so no srslte_chest_ul_estimate_pucch() call is needed and a resource only costs
+ * a few scalar operations.
+ *
+ * The noise is measured in a despread dimension of the PRB that no resource uses. The DMRS detection ratio is the
+ * DMRS power over the DMRS plus noise power, and the format 1 correlation is normalized by the power expected from the
+ * channel and noise estimates, so neither of them drops when other UEs transmit in the same PRB. Both take values
+ * close to the ones of srslte_pucch_decode() for a UE alone in its PRB, so the same thresholds apply. Also measures
+ * the time alignment of detected resources if cfg->meas_ta_en is set.
+ *
+ * @param q PUCCH object
+ * @param sf Uplink subframe configuration
+ * @param cfg PUCCH configuration, the format and n_pucch resource must be already selected
+ * @param sf_symbols Resource grid of the subframe, it shall not change until srslte_pucch_batch_reset() is called
+ * @param data Decoded result
+ * @return SRSLTE_SUCCESS if the resource was decoded, SRSLTE_ERROR code otherwise
+ */
+SRSLTE_API int srslte_pucch_decode_batch(srslte_pucch_t*     q,
+                                         srslte_ul_sf_cfg_t* sf,
+                                         srslte_pucch_cfg_t* cfg,
+                                         cf_t*               sf_symbols,
+                                         srslte_pucch_res_t* data);
+
 /* Other utilities. These functions do not modify the state and run in real-time */
 SRSLTE_API float srslte_pucch_alpha_format1(const uint32_t n_cs_cell[SRSLTE_NSLOTS_X_FRAME][SRSLTE_CP_NORM_NSYMB],
                                             const srslte_pucch_cfg_t* cfg,
@@ -47,6 +47,7 @@
 #define _MM_SQMOD_PS(X) _MM_PERM(_mm_hadd_ps(_mm_mul_ps(X, X), _mm_set_ps(0.0f, 0.0f, 0.0f, 0.0f)))
 #define _MM_PROD_PS(a, b)                                                                                              \
   _mm_addsub_ps(_mm_mul_ps(a, _mm_moveldup_ps(b)), _mm_mul_ps(_mm_shuffle_ps(a, a, 0xB1), _mm_movehdup_ps(b)))
+#define _MM_CONJPROD_PS(a, b) _MM_PROD_PS(a, _MM_CONJ_PS(b))
 
 #endif /* LV_HAVE_SSE */
 
@@ -65,6 +66,8 @@
                     0b11011100)
 #define _MM256_PROD_PS(a, b)                                                                                           \
   _mm256_fmaddsub_ps(a, _mm256_moveldup_ps(b), _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xB1), _mm256_movehdup_ps(b)))
+#define _MM256_CONJPROD_PS(a, b)                                                                                       \
+  _mm256_fmsubadd_ps(a, _mm256_moveldup_ps(b), _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xB1), _mm256_movehdup_ps(b)))
 #else
 #define _MM256_SQMOD_PS(A, B)                                                                                          \
   _mm256_permute_ps(_mm256_hadd_ps(_mm256_add_ps(_mm256_mul_ps(A, A), _mm256_mul_ps(B, B)),                            \
@@ -73,9 +76,22 @@
 #define _MM256_PROD_PS(a, b)                                                                                           \
   _mm256_addsub_ps(_mm256_mul_ps(a, _mm256_moveldup_ps(b)),                                                            \
                    _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xB1), _mm256_movehdup_ps(b)))
+#define _MM256_CONJPROD_PS(a, b) _MM256_PROD_PS(a, _MM256_CONJ_PS(b))
 #endif /* LV_HAVE_FMA */
 #endif /* LV_HAVE_AVX */
 
+/*
+ * AVX512 Macros, FMA is part of AVX512F
+ */
+#ifdef LV_HAVE_AVX512
+#define _MM512_PROD_PS(a, b)                                                                                           \
+  _mm512_fmaddsub_ps(                                                                                                  \
+      a, _mm512_moveldup_ps(b), _mm512_mul_ps(_mm512_permute_ps(a, 0b10110001), _mm512_movehdup_ps(b)))
+#define _MM512_CONJPROD_PS(a, b)                                                                                       \
+  _mm512_fmsubadd_ps(                                                                                                  \
+      a, _mm512_moveldup_ps(b), _mm512_mul_ps(_mm512_permute_ps(a, 0b10110001), _mm512_movehdup_ps(b)))
+#endif /* LV_HAVE_AVX512 */
+
 /*
  * AVX extension with FMA Macros
  */
@@ -486,6 +502,35 @@ static inline simd_f_t srslte_simd_f_hadd(simd_f_t a, simd_f_t b)
 #endif /* LV_HAVE_AVX512 */
 }
 
+#ifdef LV_HAVE_SSE
+/* Complex products of interleaved samples, they save the shuffles of splitting them into real and imaginary parts */
+static inline simd_f_t srslte_simd_cfi_prod(simd_f_t a, simd_f_t b)
+{
+#ifdef LV_HAVE_AVX512
+  return _MM512_PROD_PS(a, b);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _MM256_PROD_PS(a, b);
+#else  /* LV_HAVE_AVX2 */
+  return _MM_PROD_PS(a, b);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline simd_f_t srslte_simd_cfi_conjprod(simd_f_t a, simd_f_t b)
+{
+#ifdef LV_HAVE_AVX512
+  return _MM512_CONJPROD_PS(a, b);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _MM256_CONJPROD_PS(a, b);
+#else  /* LV_HAVE_AVX2 */
+  return _MM_CONJPROD_PS(a, b);
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+#endif /* LV_HAVE_SSE */
+
 static inline simd_f_t srslte_simd_f_sqrt(simd_f_t a)
 {
 #ifdef LV_HAVE_AVX512
@@ -892,8 +937,8 @@ static inline simd_cf_t srslte_simd_cf_prod(simd_cf_t a, simd_cf_t b)
 {
   simd_cf_t ret;
 #ifdef LV_HAVE_AVX512
-  ret.re = _mm512_sub_ps(_mm512_mul_ps(a.re, b.re), _mm512_mul_ps(a.im, b.im));
-  ret.im = _mm512_add_ps(_mm512_mul_ps(a.re, b.im), _mm512_mul_ps(a.im, b.re));
+  ret.re = _mm512_fmsub_ps(a.re, b.re, _mm512_mul_ps(a.im, b.im));
+  ret.im = _mm512_fmadd_ps(a.re, b.im, _mm512_mul_ps(a.im, b.re));
 #else /* LV_HAVE_AVX512 */
 #ifdef LV_HAVE_AVX2
 #ifdef LV_HAVE_FMA
@@ -922,12 +967,17 @@ static inline simd_cf_t srslte_simd_cf_conjprod(simd_cf_t a, simd_cf_t b)
 {
   simd_cf_t ret;
 #ifdef LV_HAVE_AVX512
-  ret.re = _mm512_add_ps(_mm512_mul_ps(a.re, b.re), _mm512_mul_ps(a.im, b.im));
-  ret.im = _mm512_sub_ps(_mm512_mul_ps(a.im, b.re), _mm512_mul_ps(a.re, b.im));
+  ret.re = _mm512_fmadd_ps(a.re, b.re, _mm512_mul_ps(a.im, b.im));
+  ret.im = _mm512_fmsub_ps(a.im, b.re, _mm512_mul_ps(a.re, b.im));
 #else /* LV_HAVE_AVX512 */
 #ifdef LV_HAVE_AVX2
-  ret.re            = _mm256_add_ps(_mm256_mul_ps(a.re, b.re), _mm256_mul_ps(a.im, b.im));
-  ret.im            = _mm256_sub_ps(_mm256_mul_ps(a.im, b.re), _mm256_mul_ps(a.re, b.im));
+#ifdef LV_HAVE_FMA
+  ret.re            = _mm256_fmadd_ps(a.re, b.re, _mm256_mul_ps(a.im, b.im));
+  ret.im            = _mm256_fmsub_ps(a.im, b.re, _mm256_mul_ps(a.re, b.im));
+#else  /* LV_HAVE_FMA */
+  ret.re = _mm256_add_ps(_mm256_mul_ps(a.re, b.re), _mm256_mul_ps(a.im, b.im));
+  ret.im = _mm256_sub_ps(_mm256_mul_ps(a.im, b.re), _mm256_mul_ps(a.re, b.im));
+#endif /* LV_HAVE_FMA */
 #else /* LV_HAVE_AVX2 */
 #ifdef LV_HAVE_SSE
   ret.re            = _mm_add_ps(_mm_mul_ps(a.re, b.re), _mm_mul_ps(a.im, b.im));
@@ -1297,6 +1347,109 @@ static inline simd_i_t srslte_simd_i_and(simd_i_t a, simd_i_t b)
 #endif /* LV_HAVE_AVX512 */
 }
 
+static inline simd_i_t srslte_simd_i_or(simd_i_t a, simd_i_t b)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_or_si512(a, b);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_or_si256(a, b);
+#else
+#ifdef LV_HAVE_SSE
+  return _mm_or_si128(a, b);
+#else
+#ifdef HAVE_NEON
+  return vorrq_s32(a, b);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+static inline simd_i_t srslte_simd_i_xor(simd_i_t a, simd_i_t b)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_xor_si512(a, b);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_xor_si256(a, b);
+#else
+#ifdef LV_HAVE_SSE
+  return _mm_xor_si128(a, b);
+#else
+#ifdef HAVE_NEON
+  return veorq_s32(a, b);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* Logical shift left of each 32-bit element */
+static inline simd_i_t srslte_simd_i_sll(simd_i_t a, int shift)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_slli_epi32(a, shift);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_slli_epi32(a, shift);
+#else
+#ifdef LV_HAVE_SSE
+  return _mm_slli_epi32(a, shift);
+#else
+#ifdef HAVE_NEON
+  return vshlq_s32(a, vdupq_n_s32(shift));
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* Logical shift right of each 32-bit element */
+static inline simd_i_t srslte_simd_i_srl(simd_i_t a, int shift)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_srli_epi32(a, shift);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_srli_epi32(a, shift);
+#else
+#ifdef LV_HAVE_SSE
+  return _mm_srli_epi32(a, shift);
+#else
+#ifdef HAVE_NEON
+  return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(a), vdupq_n_s32(-shift)));
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
+/* Table lookup of each element, ret[i] = table[idx[i]] */
+static inline simd_i_t srslte_simd_i_gather(const int* table, simd_i_t idx)
+{
+#ifdef LV_HAVE_AVX512
+  return _mm512_i32gather_epi32(idx, table, 4);
+#else /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  return _mm256_i32gather_epi32(table, idx, 4);
+#else
+#ifdef LV_HAVE_SSE
+  int i[4];
+  _mm_storeu_si128((__m128i*)i, idx);
+  return _mm_set_epi32(table[i[3]], table[i[2]], table[i[1]], table[i[0]]);
+#else
+#ifdef HAVE_NEON
+  int i[4];
+  vst1q_s32(i, idx);
+  int r[4] = {table[i[0]], table[i[1]], table[i[2]], table[i[3]]};
+  return vld1q_s32(r);
+#endif /* HAVE_NEON */
+#endif /* LV_HAVE_SSE */
+#endif /* LV_HAVE_AVX2 */
+#endif /* LV_HAVE_AVX512 */
+}
+
 static inline simd_sel_t srslte_simd_f_max(simd_f_t a, simd_f_t b)
 {
 #ifdef LV_HAVE_AVX512
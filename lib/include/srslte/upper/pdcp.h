@@ -38,6 +38,9 @@ public:
   void init(srsue::rlc_interface_pdcp* rlc_, srsue::rrc_interface_pdcp* rrc_, srsue::gw_interface_pdcp* gw_);
   void stop();
 
+  // Batch shared with other PDCP instances, used by the LTE DRBs added afterwards
+  void set_crypto_batch(pdcp_crypto_batch* crypto_batch_) { crypto_batch = crypto_batch_; }
+
   // GW interface
   bool is_lcid_enabled(uint32_t lcid);
 
@@ -72,6 +75,7 @@ private:
   srsue::gw_interface_pdcp*  gw  = nullptr;
   srslte::task_sched_handle  task_sched;
   srslte::log_ref            pdcp_log;
+  pdcp_crypto_batch*         crypto_batch = nullptr;
 
   std::map<uint16_t, std::unique_ptr<pdcp_entity_base> > pdcp_array, pdcp_array_mrb;
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_PDCP_CRYPTO_BATCH_H
+#define SRSLTE_PDCP_CRYPTO_BATCH_H
+
+#include "srslte/common/buffer_pool.h"
+#include "srslte/common/logmap.h"
+#include "srslte/common/security.h"
+#include "srslte/common/task_scheduler.h"
+#include "srslte/common/thread_pool.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace srslte {
+
+/****************************************************************************
+ * PDCP ciphering batch
+ * Collects the DRB PDUs of all PDCP entities (of one or more UEs) that need
+ * ciphering or deciphering and processes them together with the batch
+ * security functions, optionally in a dedicated crypto worker thread.
+ ***************************************************************************/
+class pdcp_crypto_batch
+{
+public:
+  /// Receives the processed PDUs of one bearer, in the stack thread and in the order they were pushed
+  using sink_t = std::function<void(unique_byte_buffer_t)>;
+
+  struct job_t {
+    unique_byte_buffer_t        pdu;
+    uint32_t                    offset    = 0; ///< Leading bytes that are not ciphered, i.e. the PDCP header
+    uint32_t                    count     = 0;
+    uint8_t                     bearer    = 0;
+    uint8_t                     direction = 0;
+    CIPHERING_ALGORITHM_ID_ENUM algo      = CIPHERING_ALGORITHM_ID_EEA0;
+    uint8_t                     key[16]   = {};
+    aes_128_key                 aes_key; ///< Only set for 128-EEA2
+    std::weak_ptr<sink_t>       sink;    ///< The PDU is dropped if the bearer was removed in the meantime
+  };
+
+  explicit pdcp_crypto_batch(task_sched_handle task_sched_, uint32_t max_batch_size_ = 64, bool use_worker = false);
+  ~pdcp_crypto_batch();
+  void stop();
+
+  /// Queues a job, the batch is flushed when it reaches the maximum size
+  void push(job_t job);
+
+  /// Processes the pending jobs, or hands them to the worker. Must be called at least once per TTI
+  void flush();
+
+  uint32_t nof_pending() const { return pending.size(); }
+
+private:
+  void process(std::vector<job_t>& jobs);
+  void deliver(std::vector<job_t>& jobs);
+
+  srslte::log_ref           log;
+  srslte::task_sched_handle task_sched;
+  uint32_t                  max_batch_size;
+  std::vector<job_t>        pending;
+
+  // The worker runs the batches in FIFO order and its results are delivered through the stack task queue, so the
+  // PDUs of a bearer reach RLC/GW in the same order as without batching
+  srslte::task_thread_pool worker;
+
+  // Scratch space of process(), which is only ever run by one thread
+  std::vector<security_batch_item_t> items;
+};
+
+} // namespace srslte
+
+#endif // SRSLTE_PDCP_CRYPTO_BATCH_H
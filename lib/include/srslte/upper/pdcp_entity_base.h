@@ -150,6 +150,7 @@ protected:
                        pdcp_discard_timer_t::infinity};
 
   srslte::as_security_config_t sec_cfg = {};
+  srslte::as_security_ctx_t    sec_ctx; // keys of sec_cfg with the AES key schedule expanded
 
   // Security functions
   void integrity_generate(uint8_t* msg, uint32_t msg_len, uint32_t count, uint8_t* mac);
@@ -28,6 +28,7 @@
 #include "srslte/common/security.h"
 #include "srslte/common/threads.h"
 #include "srslte/interfaces/ue_interfaces.h"
+#include "srslte/upper/pdcp_crypto_batch.h"
 #include "srslte/upper/pdcp_entity_base.h"
 
 namespace srslte {
@@ -66,6 +67,9 @@ public:
   // Config helpers
   bool check_valid_config();
 
+  // Cipher/decipher the DRB PDUs together with the PDUs of other bearers
+  void set_crypto_batch(pdcp_crypto_batch* crypto_batch_);
+
   void get_bearer_state(pdcp_lte_state_t* state) override;
   void set_bearer_state(const pdcp_lte_state_t& state) override;
 
@@ -80,9 +84,23 @@ private:
   uint32_t reordering_window = 0;
   uint32_t maximum_pdcp_sn   = 0;
 
+  // Batched ciphering. The sinks are replaced on reset/re-establishment, which drops the PDUs still in the batch
+  pdcp_crypto_batch*                         crypto_batch = nullptr;
+  std::shared_ptr<pdcp_crypto_batch::sink_t> tx_sink, rx_sink;
+
   void handle_srb_pdu(srslte::unique_byte_buffer_t pdu);
   void handle_um_drb_pdu(srslte::unique_byte_buffer_t pdu);
   void handle_am_drb_pdu(srslte::unique_byte_buffer_t pdu);
+
+  void write_tx_pdu(srslte::unique_byte_buffer_t pdu);
+  void decipher_drb_pdu(srslte::unique_byte_buffer_t pdu, uint32_t count, bool do_decryption);
+  void push_crypto_job(srslte::unique_byte_buffer_t                      pdu,
+                       uint32_t                                          offset,
+                       uint32_t                                          count,
+                       bool                                              do_cipher,
+                       uint8_t                                           direction,
+                       const std::shared_ptr<pdcp_crypto_batch::sink_t>& sink);
+  void reset_crypto_sinks();
 };
 
 } // namespace srslte
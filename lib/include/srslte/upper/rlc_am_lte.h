@@ -22,7 +22,10 @@
 #ifndef SRSLTE_RLC_AM_LTE_H
 #define SRSLTE_RLC_AM_LTE_H
 
+#include "srslte/adt/circular_array.h"
+#include "srslte/adt/lockfree_queue.h"
 #include "srslte/common/buffer_pool.h"
+#include "srslte/common/byte_buffer_slice.h"
 #include "srslte/common/common.h"
 #include "srslte/common/log.h"
 #include "srslte/common/timeout.h"
@@ -30,9 +33,12 @@
 #include "srslte/upper/byte_buffer_queue.h"
 #include "srslte/upper/rlc_am_base.h"
 #include "srslte/upper/rlc_common.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <deque>
 #include <list>
-#include <map>
+#include <memory>
 
 namespace srslte {
 
@@ -61,6 +67,91 @@ struct rlc_amd_retx_t {
   uint32_t so_end;
 };
 
+/**
+ * Window of RLC AM PDUs indexed by SN.
+ *
+ * SNs inside an AM window are unique modulo the window size, so each SN gets its own slot in a circular array and no
+ * allocation or tree lookup is needed. An occupancy bitmap allows to skip runs of received/missing SNs a word at a
+ * time, e.g. when building status PDUs.
+ */
+template <class T, std::size_t N = RLC_AM_WINDOW_SIZE>
+class rlc_ringbuffer_t
+{
+  static_assert(N % 64 == 0, "Window size must be a multiple of the bitmap word size");
+
+public:
+  T& add_pdu(uint32_t sn)
+  {
+    if (not test_bit(sn)) {
+      set_bit(sn);
+      count++;
+    }
+    slot_sn[sn]   = sn;
+    (*window)[sn] = T();
+    return (*window)[sn];
+  }
+
+  void remove_pdu(uint32_t sn)
+  {
+    if (has_sn(sn)) {
+      reset_bit(sn);
+      (*window)[sn] = T();
+      count--;
+    }
+  }
+
+  T&       operator[](uint32_t sn) { return (*window)[sn]; }
+  const T& operator[](uint32_t sn) const { return (*window)[sn]; }
+
+  bool     has_sn(uint32_t sn) const { return test_bit(sn) and slot_sn[sn] == sn; }
+  uint32_t size() const { return count; }
+  bool     empty() const { return count == 0; }
+
+  void clear()
+  {
+    for (uint32_t i = 0; i < N; i++) {
+      if (test_bit(i)) {
+        (*window)[i] = T();
+      }
+    }
+    bitmap.fill(0);
+    count = 0;
+  }
+
+  /**
+   * Length of the run of present (or missing) SNs starting at sn, up to max_count. The bitmap is scanned a word at a
+   * time, so the SNs of the run are assumed to lie within the current window.
+   */
+  uint32_t count_run(uint32_t sn, uint32_t max_count, bool present) const
+  {
+    uint32_t n = 0;
+    while (n < max_count) {
+      uint32_t pos   = (sn + n) % N;
+      uint32_t bit   = pos % 64;
+      uint64_t word  = present ? ~bitmap[pos / 64] : bitmap[pos / 64];
+      uint64_t rem   = word >> bit;
+      uint32_t avail = 64 - bit;
+      uint32_t len   = (rem == 0) ? avail : (uint32_t)__builtin_ctzll(rem);
+      n += len;
+      if (len < avail) {
+        break;
+      }
+    }
+    return std::min(n, max_count);
+  }
+
+private:
+  bool test_bit(uint32_t sn) const { return (bitmap[(sn % N) / 64] >> (sn % 64)) & 1u; }
+  void set_bit(uint32_t sn) { bitmap[(sn % N) / 64] |= (uint64_t)1u << (sn % 64); }
+  void reset_bit(uint32_t sn) { bitmap[(sn % N) / 64] &= ~((uint64_t)1u << (sn % 64)); }
+
+  // PDUs are large (e.g. the LI array of the header), keep them off the stack of the owning entity
+  std::unique_ptr<srslte::circular_array<T, N> > window{new srslte::circular_array<T, N>()};
+  srslte::circular_array<uint32_t, N>            slot_sn;
+  std::array<uint64_t, N / 64>                   bitmap = {};
+  uint32_t                                       count  = 0;
+};
+
 class rlc_am_lte : public rlc_common
 {
 public:
@@ -117,6 +208,7 @@ private:
     uint32_t get_buffer_state();
     uint32_t get_num_tx_bytes();
     void     reset_metrics();
+    void     get_lock_metrics(rlc_bearer_metrics_t& m);
 
     // Timeout callback interface
     void timer_expired(uint32_t timeout_id);
@@ -141,6 +233,9 @@ private:
     // Helpers
     bool poll_required();
     bool do_status();
+    void lock();
+    void unlock();
+    bool pop_sdu(unique_byte_buffer_t& sdu);
 
     rlc_am_lte*       parent = nullptr;
     byte_buffer_pool* pool   = nullptr;
@@ -153,9 +248,14 @@ private:
 
     rlc_am_config_t cfg = {};
 
-    // TX SDU buffers
-    byte_buffer_queue    tx_sdu_queue;
-    unique_byte_buffer_t tx_sdu;
+    // TX SDU buffers. SDUs are written without taking the TX lock, so that PDCP never blocks the MAC building PDUs.
+    // The queue is allocated with the maximum length, as it can't be resized safely, and the configured length is
+    // enforced when writing
+    lockfree_queue<unique_byte_buffer_t> tx_sdu_queue;
+    std::atomic<uint32_t>                tx_queue_length    = {RLC_TX_QUEUE_LEN};
+    std::atomic<uint32_t>                tx_sdu_queue_bytes = {0};
+    unique_byte_buffer_t                 tx_sdu;
+    byte_buffer_slice_list               pdu_slices; // SDU segments of the PDU being built
 
     bool tx_enabled = false;
 
@@ -188,14 +288,16 @@ private:
     bsr_callback_t bsr_callback;
 
     // Tx windows
-    std::map<uint32_t, rlc_amd_tx_pdu_t> tx_window;
-    std::deque<rlc_amd_retx_t>           retx_queue;
+    rlc_ringbuffer_t<rlc_amd_tx_pdu_t> tx_window;
+    std::deque<rlc_amd_retx_t>         retx_queue;
 
     // Mutexes
     pthread_mutex_t mutex;
 
     // Metrics
-    uint32_t num_tx_bytes = 0;
+    uint32_t              num_tx_bytes         = 0;
+    std::atomic<uint32_t> num_lock_contentions = {0}; // updated by lock(), so not protected by the mutex
+    std::atomic<uint64_t> lock_wait_us         = {0};
   };
 
   // Receiver sub-class
@@ -227,6 +329,7 @@ private:
     void handle_data_pdu(uint8_t* payload, uint32_t nof_bytes, rlc_amd_pdu_header_t& header);
     void handle_data_pdu_segment(uint8_t* payload, uint32_t nof_bytes, rlc_amd_pdu_header_t& header);
     void reassemble_rx_sdus();
+    void update_vr_ms();
     bool inside_rx_window(const int16_t sn);
     void debug_state();
     void print_rx_segments();
@@ -261,8 +364,8 @@ private:
     pthread_mutex_t mutex;
 
     // Rx windows
-    std::map<uint32_t, rlc_amd_rx_pdu_t>          rx_window;
-    std::map<uint32_t, rlc_amd_rx_pdu_segments_t> rx_segments;
+    rlc_ringbuffer_t<rlc_amd_rx_pdu_t>          rx_window;
+    rlc_ringbuffer_t<rlc_amd_rx_pdu_segments_t> rx_segments;
 
     // Metrics
     uint32_t num_rx_bytes = 0;
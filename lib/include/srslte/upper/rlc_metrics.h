@@ -40,7 +40,13 @@ typedef struct {
   uint32_t num_rx_pdus;
   uint64_t num_tx_pdu_bytes;
   uint64_t num_rx_pdu_bytes;
-  uint32_t num_lost_pdus;    //< Lost PDUs registered at Rx
+  uint32_t num_lost_pdus;       //< Lost PDUs registered at Rx
+  uint64_t num_tx_copied_bytes; //< Payload bytes copied between RLC buffers when assembling PDUs at Tx
+  uint64_t num_rx_copied_bytes; //< Payload bytes copied between RLC buffers when reassembling SDUs at Rx
+
+  // Lock contention metrics
+  uint32_t num_tx_lock_contentions; //< Times the Tx state was found locked by another thread
+  uint64_t tx_lock_wait_us;         //< Total time spent waiting for the Tx state lock
 } rlc_bearer_metrics_t;
 
 typedef struct {
@@ -23,6 +23,7 @@
 #define SRSLTE_RLC_UM_LTE_H
 
 #include "srslte/common/buffer_pool.h"
+#include "srslte/common/byte_buffer_slice.h"
 #include "srslte/common/common.h"
 #include "srslte/common/log.h"
 #include "srslte/interfaces/ue_interfaces.h"
@@ -59,13 +60,15 @@ private:
     rlc_um_lte_tx(rlc_um_base* parent_);
 
     bool     configure(const rlc_config_t& cfg, std::string rb_name);
-    int      build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes);
+    int      build_data_pdu(uint8_t* payload, uint32_t nof_bytes);
     uint32_t get_buffer_state();
     bool     sdu_queue_is_full();
 
   private:
     void reset();
 
+    byte_buffer_slice_list pdu_slices; // SDU segments of the PDU being built
+
     /****************************************************************************
      * State variables and counters
      * Ref: 3GPP TS 36.322 v10.0.0 Section 7
@@ -87,6 +90,7 @@ private:
     void handle_data_pdu(uint8_t* payload, uint32_t nof_bytes);
     void reassemble_rx_sdus();
     bool pdu_belongs_to_rx_sdu();
+    bool append_to_rx_sdu(rlc_umd_pdu_t& pdu);
     bool inside_reordering_window(uint16_t sn);
 
     // Timeout callback interface
@@ -127,7 +131,8 @@ void rlc_um_read_data_pdu_header(uint8_t*              payload,
                                  uint32_t              nof_bytes,
                                  rlc_umd_sn_size_t     sn_size,
                                  rlc_umd_pdu_header_t* header);
-void rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* pdu);
+void     rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* pdu);
+uint32_t rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, uint8_t* payload);
 
 uint32_t rlc_um_packed_length(rlc_umd_pdu_header_t* header);
 bool     rlc_um_start_aligned(uint8_t fi);
@@ -102,6 +102,81 @@ void log_error_code(SRSASN_CODE code, const char* filename, int line)
   }
 }
 
+/*********************
+     decode arena
+*********************/
+
+static thread_local decode_arena* current_arena = nullptr;
+
+decode_arena::decode_arena(size_t block_size_) : block_size(std::max(block_size_, (size_t)64)) {}
+
+decode_arena::~decode_arena()
+{
+  for (block_t& b : blocks) {
+    delete[] b.data;
+  }
+}
+
+void* decode_arena::allocate(size_t nof_bytes, size_t align)
+{
+  if (not blocks.empty()) {
+    block_t&  b     = blocks.back();
+    uintptr_t start = ((uintptr_t)(b.data + offset) + align - 1) & ~(uintptr_t)(align - 1);
+    size_t    pos   = start - (uintptr_t)b.data;
+    if (pos + nof_bytes <= b.size) {
+      offset = pos + nof_bytes;
+      used += nof_bytes;
+      return b.data + pos;
+    }
+  }
+  // new[] of uint8_t is only aligned to the fundamental alignment, leave room to align larger types
+  block_t b;
+  b.size = std::max(block_size, nof_bytes + align);
+  b.data = new uint8_t[b.size];
+  blocks.push_back(b);
+  offset = 0;
+  return allocate(nof_bytes, align);
+}
+
+void decode_arena::reset()
+{
+  if (blocks.size() > 1) {
+    size_t total = capacity();
+    for (block_t& b : blocks) {
+      delete[] b.data;
+    }
+    blocks.resize(1);
+    blocks[0].size = total;
+    blocks[0].data = new uint8_t[total];
+  }
+  offset = 0;
+  used   = 0;
+}
+
+size_t decode_arena::capacity() const
+{
+  size_t total = 0;
+  for (const block_t& b : blocks) {
+    total += b.size;
+  }
+  return total;
+}
+
+decode_arena* decode_arena::current()
+{
+  return current_arena;
+}
+
+arena_scope::arena_scope(decode_arena& arena) : prev(current_arena)
+{
+  current_arena = &arena;
+}
+
+arena_scope::~arena_scope()
+{
+  current_arena = prev;
+}
+
 /*********************
        bit_ref
 *********************/
@@ -132,34 +207,71 @@ int bit_ref_impl<Ptr>::distance_bytes() const
   return ((int)(ptr - start_ptr)) + ((offset) ? 1 : 0);
 }
 
+// Big-endian load/store of 8 bytes, compiled to a single load/store and a byte swap
+static inline uint64_t load_be64(const uint8_t* p)
+{
+  uint64_t w = 0;
+  for (uint32_t i = 0; i < 8; ++i) {
+    w = (w << 8u) | p[i];
+  }
+  return w;
+}
+
+static inline void store_be64(uint8_t* p, uint64_t w)
+{
+  for (uint32_t i = 0; i < 8; ++i) {
+    p[i] = (uint8_t)(w >> (56u - 8u * i));
+  }
+}
+
 SRSASN_CODE bit_ref::pack(uint32_t val, uint32_t n_bits)
 {
   if (n_bits >= 32) {
     log_error("This method only supports packing up to 32 bits\n");
     return SRSASN_ERROR_ENCODE_FAIL;
   }
-  uint32_t mask;
-  while (n_bits > 0) {
-    if (ptr >= max_ptr) {
-      log_error("Buffer size limit was achieved\n");
-      return SRSASN_ERROR_ENCODE_FAIL;
-    }
-    mask             = ((1u << n_bits) - 1u);
-    val              = val & mask;
-    uint8_t keepmask = ((uint8_t)-1) - (uint8_t)((1u << (8u - offset)) - 1u);
-    if ((uint32_t)(8 - offset) > n_bits) {
-      auto bit = static_cast<uint8_t>(val << (8u - offset - n_bits));
-      *ptr     = ((*ptr) & keepmask) + bit;
-      offset += n_bits;
-      n_bits = 0;
-    } else {
-      auto bit = static_cast<uint8_t>(val >> (n_bits - 8u + offset));
-      *ptr     = (*ptr & keepmask) + bit;
-      n_bits -= (8 - offset);
-      offset = 0;
-      ptr++;
+  if (n_bits == 0) {
+    return SRSASN_SUCCESS;
+  }
+  uint32_t total   = offset + n_bits; // at most 38 bits, i.e. 5 bytes
+  uint32_t n_bytes = ceil_frac(total, 8u);
+  if (ptr + n_bytes > max_ptr) {
+    log_error("Buffer size limit was achieved\n");
+    return SRSASN_ERROR_ENCODE_FAIL;
+  }
+  // The bits already written in the current byte followed by the new ones, MSB first. The rest of the last byte is
+  // cleared
+  uint64_t acc = ((uint64_t)*ptr << 56u) & ~(std::numeric_limits<uint64_t>::max() >> offset);
+  acc |= (uint64_t)(val & ((1u << n_bits) - 1u)) << (64u - total);
+  for (uint32_t i = 0; i < n_bytes; ++i) {
+    ptr[i] = (uint8_t)(acc >> (56u - 8u * i));
+  }
+  ptr += total / 8;
+  offset = total % 8;
+  return SRSASN_SUCCESS;
+}
+
+/// Reads up to 57 bits, so that together with the bit offset they fit in one 64-bit word
+template <typename Ptr>
+SRSASN_CODE unpack_word(uint64_t& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_ptr, uint32_t n_bits)
+{
+  uint32_t total   = offset + n_bits;
+  uint32_t n_bytes = ceil_frac(total, 8u);
+  if (ptr + n_bytes > max_ptr) {
+    log_error("Buffer size limit was achieved\n");
+    return SRSASN_ERROR_DECODE_FAIL;
+  }
+  uint64_t w = 0;
+  if (ptr + 8 <= max_ptr) {
+    w = load_be64(ptr);
+  } else {
+    for (uint32_t i = 0; i < n_bytes; ++i) {
+      w |= (uint64_t)ptr[i] << (56u - 8u * i);
     }
   }
+  val = (w << offset) >> (64u - n_bits);
+  ptr += total / 8;
+  offset = total % 8;
   return SRSASN_SUCCESS;
 }
 
@@ -171,25 +283,24 @@ SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
     return SRSASN_ERROR_DECODE_FAIL;
   }
   val = 0;
-  while (n_bits > 0) {
-    if (ptr >= max_ptr) {
-      log_error("Buffer size limit was achieved\n");
-      return SRSASN_ERROR_DECODE_FAIL;
-    }
-    if ((uint32_t)(8 - offset) > n_bits) {
-      uint8_t mask = (uint8_t)(1u << (8u - offset)) - (uint8_t)(1u << (8u - offset - n_bits));
-      val += ((uint32_t)((*ptr) & mask)) >> (8u - offset - n_bits);
-      offset += n_bits;
-      n_bits = 0;
-    } else {
-      auto mask = static_cast<uint8_t>((1u << (8u - offset)) - 1u);
-      val += ((uint32_t)((*ptr) & mask)) << (n_bits - 8 + offset);
-      n_bits -= 8 - offset;
-      offset = 0;
-      ptr++;
+  if (n_bits == 0) {
+    return SRSASN_SUCCESS;
+  }
+  uint64_t    w = 0, lsb = 0;
+  SRSASN_CODE ret;
+  if (n_bits <= 57) {
+    ret = unpack_word(w, ptr, offset, max_ptr, n_bits);
+  } else {
+    ret = unpack_word(w, ptr, offset, max_ptr, n_bits - 32);
+    if (ret == SRSASN_SUCCESS) {
+      ret = unpack_word(lsb, ptr, offset, max_ptr, 32);
+      w   = (w << 32u) | lsb;
     }
   }
-  return SRSASN_SUCCESS;
+  if (ret == SRSASN_SUCCESS) {
+    val = (T)w;
+  }
+  return ret;
 }
 
 template SRSASN_CODE
@@ -234,7 +345,7 @@ SRSASN_CODE bit_ref_impl<Ptr>::unpack_bytes(uint8_t* buf, uint32_t n_bytes)
   if (n_bytes == 0) {
     return SRSASN_SUCCESS;
   }
-  if (ptr + n_bytes >= max_ptr) {
+  if (ptr + n_bytes + (offset > 0 ? 1 : 0) > max_ptr) {
     log_error("Buffer size limit was achieved\n");
     return SRSASN_ERROR_DECODE_FAIL;
   }
@@ -242,11 +353,17 @@ SRSASN_CODE bit_ref_impl<Ptr>::unpack_bytes(uint8_t* buf, uint32_t n_bytes)
     // Aligned case
     memcpy(buf, ptr, n_bytes);
     ptr += n_bytes;
-  } else {
-    for (uint32_t i = 0; i < n_bytes; ++i) {
-      HANDLE_CODE(unpack(buf[i], 8));
-    }
+    return SRSASN_SUCCESS;
   }
+  // Unaligned case, each octet is made of the low bits of one byte and the high bits of the next one
+  uint32_t i = 0;
+  for (; i + 8 <= n_bytes; i += 8) {
+    store_be64(&buf[i], (load_be64(&ptr[i]) << offset) | (ptr[i + 8] >> (8u - offset)));
+  }
+  for (; i < n_bytes; ++i) {
+    buf[i] = (uint8_t)(ptr[i] << offset) | (uint8_t)(ptr[i + 1] >> (8u - offset));
+  }
+  ptr += n_bytes;
   return SRSASN_SUCCESS;
 }
 
@@ -297,7 +414,7 @@ SRSASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
   if (n_bytes == 0) {
     return SRSASN_SUCCESS;
   }
-  if (ptr + n_bytes >= max_ptr) {
+  if (ptr + n_bytes + (offset > 0 ? 1 : 0) > max_ptr) {
     log_error("Buffer size limit was achieved\n");
     return SRSASN_ERROR_ENCODE_FAIL;
   }
@@ -305,11 +422,22 @@ SRSASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
     // Aligned case
     memcpy(ptr, buf, n_bytes);
     ptr += n_bytes;
-  } else {
-    for (uint32_t i = 0; i < n_bytes; ++i) {
-      pack(buf[i], 8);
-    }
+    return SRSASN_SUCCESS;
+  }
+  // Unaligned case, the low bits of each octet are carried over to the next byte
+  auto     carry = static_cast<uint8_t>(*ptr & (0xFFu << (8u - offset)));
+  uint32_t i     = 0;
+  for (; i + 8 <= n_bytes; i += 8) {
+    uint64_t w = load_be64(&buf[i]);
+    store_be64(&ptr[i], ((uint64_t)carry << 56u) | (w >> offset));
+    carry = (uint8_t)(w << (8u - offset));
+  }
+  for (; i < n_bytes; ++i) {
+    ptr[i] = carry | (uint8_t)(buf[i] >> offset);
+    carry  = (uint8_t)(buf[i] << (8u - offset));
   }
+  ptr[n_bytes] = carry;
+  ptr += n_bytes;
   return SRSASN_SUCCESS;
 }
 
@@ -1000,9 +1128,7 @@ template <bool Al>
 SRSASN_CODE unbounded_octstring<Al>::pack(bit_ref& bref) const
 {
   HANDLE_CODE(pack_length(bref, size(), aligned));
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.pack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.pack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -1012,9 +1138,7 @@ SRSASN_CODE unbounded_octstring<Al>::unpack(cbit_ref& bref)
   uint32_t len;
   HANDLE_CODE(unpack_length(len, bref, aligned));
   resize(len);
-  for (uint32_t i = 0; i < size(); ++i) {
-    HANDLE_CODE(bref.unpack(octets_[i], 8));
-  }
+  HANDLE_CODE(bref.unpack_bytes(octets_.data(), size()));
   return SRSASN_SUCCESS;
 }
 
@@ -1097,8 +1221,13 @@ SRSASN_CODE pack_bitfield(bit_ref& bref, const uint8_t* buf, uint32_t nbits, uin
   uint32_t n_octs = ceil_frac(nbits, 8u);
   uint32_t offset = ((nbits - 1) % 8) + 1;
   HANDLE_CODE(bref.pack(buf[n_octs - 1], offset));
-  for (uint32_t i = 1; i < n_octs; ++i) {
-    HANDLE_CODE(bref.pack(buf[n_octs - 1 - i], 8));
+  // the remaining octets are stored in reverse order
+  uint8_t tmp[64];
+  for (uint32_t i = 1; i < n_octs;) {
+    uint32_t n = std::min(n_octs - i, (uint32_t)sizeof(tmp));
+    std::reverse_copy(&buf[n_octs - i - n], &buf[n_octs - i], &tmp[0]);
+    HANDLE_CODE(bref.pack_bytes(&tmp[0], n));
+    i += n;
   }
   return SRSASN_SUCCESS;
 }
@@ -1165,8 +1294,13 @@ SRSASN_CODE unpack_bitfield(uint8_t* buf, cbit_ref& bref, uint32_t n, uint32_t l
   uint32_t n_octs = ceil_frac(n, 8u);
   uint32_t offset = ((n - 1) % 8) + 1;
   HANDLE_CODE(bref.unpack(buf[n_octs - 1], offset));
-  for (uint32_t i = 1; i < n_octs; ++i) {
-    HANDLE_CODE(bref.unpack(buf[n_octs - 1 - i], 8));
+  // the remaining octets are stored in reverse order
+  uint8_t tmp[64];
+  for (uint32_t i = 1; i < n_octs;) {
+    uint32_t nbytes = std::min(n_octs - i, (uint32_t)sizeof(tmp));
+    HANDLE_CODE(bref.unpack_bytes(&tmp[0], nbytes));
+    std::reverse_copy(&tmp[0], &tmp[nbytes], &buf[n_octs - i - nbytes]);
+    i += nbytes;
   }
   return SRSASN_SUCCESS;
 }
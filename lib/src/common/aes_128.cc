@@ -0,0 +1,407 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/aes_128.h"
+#include <algorithm>
+#include <string.h>
+
+#ifdef __AES__
+#include <immintrin.h>
+#endif // __AES__
+
+namespace srslte {
+
+namespace {
+
+const uint8_t sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9,
+    0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f,
+    0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15, 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07,
+    0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3,
+    0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58,
+    0xcf, 0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3,
+    0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec, 0x5f,
+    0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73, 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
+    0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac,
+    0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a,
+    0xae, 0x08, 0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, 0x70,
+    0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+    0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf, 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42,
+    0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+
+inline uint8_t xtime(uint8_t x)
+{
+  return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00));
+}
+
+inline uint64_t load_be64(const uint8_t* p)
+{
+  uint64_t v = 0;
+  for (uint32_t i = 0; i < 8; i++) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+inline void next_counter(uint64_t& hi, uint64_t& lo)
+{
+  if (++lo == 0) {
+    ++hi;
+  }
+}
+
+// Copy len bytes, starting at offset start, of the concatenation hdr || msg
+void gather(const uint8_t* hdr, uint32_t hdr_len, const uint8_t* msg, uint32_t start, uint32_t len, uint8_t* dst)
+{
+  uint32_t n_hdr = 0;
+  if (start < hdr_len) {
+    n_hdr = std::min(hdr_len - start, len);
+    memcpy(dst, hdr + start, n_hdr);
+  }
+  if (len > n_hdr) {
+    memcpy(dst + n_hdr, msg + (start + n_hdr - hdr_len), len - n_hdr);
+  }
+}
+
+void cmac_subkey(const uint8_t* in, uint8_t* out)
+{
+  for (uint32_t i = 0; i < 15; i++) {
+    out[i] = (uint8_t)((in[i] << 1) | (in[i + 1] >> 7));
+  }
+  out[15] = (uint8_t)(in[15] << 1);
+  if (in[0] & 0x80) {
+    out[15] ^= 0x87;
+  }
+}
+
+#ifdef __AES__
+
+struct aesni_round_keys_t {
+  __m128i k[11];
+  explicit aesni_round_keys_t(const uint8_t* rk)
+  {
+    for (uint32_t r = 0; r < 11; r++) {
+      k[r] = _mm_loadu_si128((const __m128i*)&rk[16 * r]);
+    }
+  }
+};
+
+inline __m128i aesni_encrypt(const aesni_round_keys_t& rk, __m128i b)
+{
+  b = _mm_xor_si128(b, rk.k[0]);
+  for (uint32_t r = 1; r < 10; r++) {
+    b = _mm_aesenc_si128(b, rk.k[r]);
+  }
+  return _mm_aesenclast_si128(b, rk.k[10]);
+}
+
+// Counter block from the host-order counter halves
+inline __m128i aesni_counter(uint64_t hi, uint64_t lo)
+{
+  return _mm_set_epi64x((long long)__builtin_bswap64(lo), (long long)__builtin_bswap64(hi));
+}
+
+#else // __AES__
+
+inline uint32_t load_be32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+inline void store_be32(uint8_t* p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+inline uint32_t ror32(uint32_t x, uint32_t n)
+{
+  return (x >> n) | (x << (32 - n));
+}
+
+// SubBytes+MixColumns lookup tables of the table based implementation
+struct aes_tables_t {
+  uint32_t te[4][256];
+  aes_tables_t()
+  {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint8_t  s = sbox[i];
+      uint32_t w = ((uint32_t)xtime(s) << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) | (uint32_t)(xtime(s) ^ s);
+      te[0][i]   = w;
+      te[1][i]   = ror32(w, 8);
+      te[2][i]   = ror32(w, 16);
+      te[3][i]   = ror32(w, 24);
+    }
+  }
+};
+
+const aes_tables_t& aes_tables()
+{
+  static const aes_tables_t tables;
+  return tables;
+}
+
+void sw_encrypt(const uint8_t* rk, const aes_tables_t& t, const uint8_t* in, uint8_t* out)
+{
+  const uint32_t* te0 = t.te[0];
+  const uint32_t* te1 = t.te[1];
+  const uint32_t* te2 = t.te[2];
+  const uint32_t* te3 = t.te[3];
+
+  uint32_t s0 = load_be32(in) ^ load_be32(rk);
+  uint32_t s1 = load_be32(in + 4) ^ load_be32(rk + 4);
+  uint32_t s2 = load_be32(in + 8) ^ load_be32(rk + 8);
+  uint32_t s3 = load_be32(in + 12) ^ load_be32(rk + 12);
+  for (uint32_t r = 1; r < 10; r++) {
+    const uint8_t* k  = &rk[16 * r];
+    uint32_t       t0 = te0[s0 >> 24] ^ te1[(s1 >> 16) & 0xff] ^ te2[(s2 >> 8) & 0xff] ^ te3[s3 & 0xff] ^ load_be32(k);
+    uint32_t t1 = te0[s1 >> 24] ^ te1[(s2 >> 16) & 0xff] ^ te2[(s3 >> 8) & 0xff] ^ te3[s0 & 0xff] ^ load_be32(k + 4);
+    uint32_t t2 = te0[s2 >> 24] ^ te1[(s3 >> 16) & 0xff] ^ te2[(s0 >> 8) & 0xff] ^ te3[s1 & 0xff] ^ load_be32(k + 8);
+    uint32_t t3 = te0[s3 >> 24] ^ te1[(s0 >> 16) & 0xff] ^ te2[(s1 >> 8) & 0xff] ^ te3[s2 & 0xff] ^ load_be32(k + 12);
+    s0          = t0;
+    s1          = t1;
+    s2          = t2;
+    s3          = t3;
+  }
+
+  // last round has no MixColumns
+  const uint8_t* k = &rk[160];
+  store_be32(out,
+             (((uint32_t)sbox[s0 >> 24] << 24) | ((uint32_t)sbox[(s1 >> 16) & 0xff] << 16) |
+              ((uint32_t)sbox[(s2 >> 8) & 0xff] << 8) | (uint32_t)sbox[s3 & 0xff]) ^
+                 load_be32(k));
+  store_be32(out + 4,
+             (((uint32_t)sbox[s1 >> 24] << 24) | ((uint32_t)sbox[(s2 >> 16) & 0xff] << 16) |
+              ((uint32_t)sbox[(s3 >> 8) & 0xff] << 8) | (uint32_t)sbox[s0 & 0xff]) ^
+                 load_be32(k + 4));
+  store_be32(out + 8,
+             (((uint32_t)sbox[s2 >> 24] << 24) | ((uint32_t)sbox[(s3 >> 16) & 0xff] << 16) |
+              ((uint32_t)sbox[(s0 >> 8) & 0xff] << 8) | (uint32_t)sbox[s1 & 0xff]) ^
+                 load_be32(k + 8));
+  store_be32(out + 12,
+             (((uint32_t)sbox[s3 >> 24] << 24) | ((uint32_t)sbox[(s0 >> 16) & 0xff] << 16) |
+              ((uint32_t)sbox[(s1 >> 8) & 0xff] << 8) | (uint32_t)sbox[s2 & 0xff]) ^
+                 load_be32(k + 12));
+}
+
+#endif // __AES__
+
+} // namespace
+
+void aes_128_key::set_key(const uint8_t* key)
+{
+  // FIPS-197 section 5.2
+  memcpy(rk, key, 16);
+  uint8_t rcon = 0x01;
+  for (uint32_t i = 16; i < 176; i += 4) {
+    uint8_t t[4] = {rk[i - 4], rk[i - 3], rk[i - 2], rk[i - 1]};
+    if (i % 16 == 0) {
+      uint8_t t0 = t[0];
+      t[0]       = sbox[t[1]] ^ rcon;
+      t[1]       = sbox[t[2]];
+      t[2]       = sbox[t[3]];
+      t[3]       = sbox[t0];
+      rcon       = xtime(rcon);
+    }
+    for (uint32_t j = 0; j < 4; j++) {
+      rk[i + j] = rk[i + j - 16] ^ t[j];
+    }
+  }
+  key_set = true;
+
+  // CMAC subkeys, RFC 4493 section 2.3
+  uint8_t l[16] = {};
+  encrypt_block(l, l);
+  cmac_subkey(l, k1);
+  cmac_subkey(k1, k2);
+}
+
+void aes_128_key::encrypt_block(const uint8_t* in, uint8_t* out) const
+{
+#ifdef __AES__
+  aesni_round_keys_t k(rk);
+  _mm_storeu_si128((__m128i*)out, aesni_encrypt(k, _mm_loadu_si128((const __m128i*)in)));
+#else  // __AES__
+  sw_encrypt(rk, aes_tables(), in, out);
+#endif // __AES__
+}
+
+void aes_128_key::ctr_crypt(const uint8_t* nonce_cnt, const uint8_t* in, uint32_t len, uint8_t* out) const
+{
+  uint64_t hi = load_be64(nonce_cnt);
+  uint64_t lo = load_be64(nonce_cnt + 8);
+  uint32_t i  = 0;
+
+#ifdef __AES__
+  aesni_round_keys_t k(rk);
+
+#if defined(__VAES__) && defined(__AVX2__)
+  // 8 blocks per iteration, two per VAES instruction
+  __m256i kk[11];
+  for (uint32_t r = 0; r < 11; r++) {
+    kk[r] = _mm256_broadcastsi128_si256(k.k[r]);
+  }
+  for (; len - i >= 128; i += 128) {
+    __m256i b[4];
+    for (uint32_t j = 0; j < 4; j++) {
+      __m128i c0 = aesni_counter(hi, lo);
+      next_counter(hi, lo);
+      __m128i c1 = aesni_counter(hi, lo);
+      next_counter(hi, lo);
+      b[j] = _mm256_xor_si256(_mm256_set_m128i(c1, c0), kk[0]);
+    }
+    for (uint32_t r = 1; r < 10; r++) {
+      for (uint32_t j = 0; j < 4; j++) {
+        b[j] = _mm256_aesenc_epi128(b[j], kk[r]);
+      }
+    }
+    for (uint32_t j = 0; j < 4; j++) {
+      b[j]      = _mm256_aesenclast_epi128(b[j], kk[10]);
+      __m256i m = _mm256_loadu_si256((const __m256i*)&in[i + 32 * j]);
+      _mm256_storeu_si256((__m256i*)&out[i + 32 * j], _mm256_xor_si256(m, b[j]));
+    }
+  }
+#endif // defined(__VAES__) && defined(__AVX2__)
+
+  // 4 interleaved blocks per iteration, to hide the latency of the AES instructions
+  for (; len - i >= 64; i += 64) {
+    __m128i b[4];
+    for (uint32_t j = 0; j < 4; j++) {
+      b[j] = _mm_xor_si128(aesni_counter(hi, lo), k.k[0]);
+      next_counter(hi, lo);
+    }
+    for (uint32_t r = 1; r < 10; r++) {
+      for (uint32_t j = 0; j < 4; j++) {
+        b[j] = _mm_aesenc_si128(b[j], k.k[r]);
+      }
+    }
+    for (uint32_t j = 0; j < 4; j++) {
+      b[j]      = _mm_aesenclast_si128(b[j], k.k[10]);
+      __m128i m = _mm_loadu_si128((const __m128i*)&in[i + 16 * j]);
+      _mm_storeu_si128((__m128i*)&out[i + 16 * j], _mm_xor_si128(m, b[j]));
+    }
+  }
+
+  for (; i < len; i += 16) {
+    __m128i b = aesni_encrypt(k, aesni_counter(hi, lo));
+    next_counter(hi, lo);
+    if (len - i >= 16) {
+      __m128i m = _mm_loadu_si128((const __m128i*)&in[i]);
+      _mm_storeu_si128((__m128i*)&out[i], _mm_xor_si128(m, b));
+    } else {
+      uint8_t ks[16];
+      _mm_storeu_si128((__m128i*)ks, b);
+      for (uint32_t j = 0; j < len - i; j++) {
+        out[i + j] = in[i + j] ^ ks[j];
+      }
+    }
+  }
+#else  // __AES__
+  const aes_tables_t& t       = aes_tables();
+  uint8_t             cnt[16] = {};
+  uint8_t             ks[16];
+  for (; i < len; i += 16) {
+    for (uint32_t j = 0; j < 8; j++) {
+      cnt[j]     = (uint8_t)(hi >> (56 - 8 * j));
+      cnt[8 + j] = (uint8_t)(lo >> (56 - 8 * j));
+    }
+    next_counter(hi, lo);
+    sw_encrypt(rk, t, cnt, ks);
+    uint32_t n = std::min(len - i, 16u);
+    for (uint32_t j = 0; j < n; j++) {
+      out[i + j] = in[i + j] ^ ks[j];
+    }
+  }
+#endif // __AES__
+}
+
+void aes_128_key::cmac(const uint8_t* hdr, uint32_t hdr_len, const uint8_t* msg, uint32_t msg_len, uint8_t* tag) const
+{
+  uint32_t total    = hdr_len + msg_len;
+  uint32_t n        = total == 0 ? 1 : (total + 15) / 16;
+  uint32_t last_len = total - 16 * (n - 1);
+
+  // last block is xored with K1 if complete, otherwise padded and xored with K2
+  uint8_t last[16] = {};
+  gather(hdr, hdr_len, msg, 16 * (n - 1), last_len, last);
+  const uint8_t* subkey = k1;
+  if (last_len < 16) {
+    last[last_len] = 0x80;
+    subkey         = k2;
+  }
+  for (uint32_t j = 0; j < 16; j++) {
+    last[j] ^= subkey[j];
+  }
+
+  uint8_t tmp[16];
+#ifdef __AES__
+  aesni_round_keys_t k(rk);
+  __m128i            x = _mm_setzero_si128();
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    uint32_t start = 16 * i;
+    __m128i  m;
+    if (start >= hdr_len) {
+      m = _mm_loadu_si128((const __m128i*)&msg[start - hdr_len]);
+    } else {
+      gather(hdr, hdr_len, msg, start, 16, tmp);
+      m = _mm_loadu_si128((const __m128i*)tmp);
+    }
+    x = aesni_encrypt(k, _mm_xor_si128(x, m));
+  }
+  x = aesni_encrypt(k, _mm_xor_si128(x, _mm_loadu_si128((const __m128i*)last)));
+  _mm_storeu_si128((__m128i*)tag, x);
+#else  // __AES__
+  const aes_tables_t& t     = aes_tables();
+  uint8_t             x[16] = {};
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    uint32_t       start = 16 * i;
+    const uint8_t* m     = tmp;
+    if (start >= hdr_len) {
+      m = &msg[start - hdr_len];
+    } else {
+      gather(hdr, hdr_len, msg, start, 16, tmp);
+    }
+    for (uint32_t j = 0; j < 16; j++) {
+      x[j] ^= m[j];
+    }
+    sw_encrypt(rk, t, x, x);
+  }
+  for (uint32_t j = 0; j < 16; j++) {
+    x[j] ^= last[j];
+  }
+  sw_encrypt(rk, t, x, tag);
+#endif // __AES__
+}
+
+const char* aes_128_key::backend()
+{
+#if defined(__VAES__) && defined(__AVX2__)
+  return "VAES";
+#elif defined(__AES__)
+  return "AES-NI";
+#else
+  return "generic";
+#endif
+}
+
+} // namespace srslte
@@ -20,6 +20,8 @@
  */
 
 #include "srslte/common/s3g.h"
+#include "srslte/phy/utils/simd.h"
+#include <algorithm>
 
 /* S-box SQ */
 static const uint8_t SQ[256] = {
@@ -565,4 +567,187 @@ uint8_t* s3g_f9(const uint8_t* key, uint32_t count, uint32_t fresh, uint32_t dir
     MAC_I[i] = ((EVAL >> (56 - (i * 8))) ^ (z[4] >> (24 - (i * 8)))) & 0xff;
 
   return MAC_I;
-}
\ No newline at end of file
+}
+/*********************************************************************
+    Multi-buffer keystream generation
+
+    Each SIMD lane runs an independent SNOW 3G instance. The S-boxes
+    S1/S2 (S-box followed by MixColumn) are split into the contribution
+    of each input byte and, together with the multiplication and
+    division by alpha, evaluated with 32-bit table lookups.
+*********************************************************************/
+#if SRSLTE_SIMD_I_SIZE
+
+static void s3g_mb_fill_column(int (*t)[256], uint32_t x, uint8_t s, uint8_t c)
+{
+  uint32_t s1 = s;
+  uint32_t s2 = s3g_mul_x(s, c);
+  uint32_t s3 = s2 ^ s1;
+
+  t[0][x] = (int)((s2 << 24) | (s3 << 16) | (s1 << 8) | s1);
+  t[1][x] = (int)((s1 << 24) | (s2 << 16) | (s3 << 8) | s1);
+  t[2][x] = (int)((s1 << 24) | (s1 << 16) | (s2 << 8) | s3);
+  t[3][x] = (int)((s3 << 24) | (s1 << 16) | (s1 << 8) | s2);
+}
+
+struct s3g_mb_tables_t {
+  int mul_alpha[256];
+  int div_alpha[256];
+  int s1[4][256];
+  int s2[4][256];
+
+  s3g_mb_tables_t()
+  {
+    for (uint32_t x = 0; x < 256; x++) {
+      mul_alpha[x] = (int)s3g_mul_alpha((uint8_t)x);
+      div_alpha[x] = (int)s3g_div_alpha((uint8_t)x);
+      s3g_mb_fill_column(s1, x, S[x], 0x1b);
+      s3g_mb_fill_column(s2, x, SQ[x], 0x69);
+    }
+  }
+};
+
+static const s3g_mb_tables_t& s3g_mb_tables()
+{
+  static const s3g_mb_tables_t tables;
+  return tables;
+}
+
+struct s3g_mb_state_t {
+  simd_i_t lfsr[16]; // circular, lfsr[(base + i) % 16] holds s_i
+  uint32_t base;
+  simd_i_t r1, r2, r3;
+};
+
+static inline simd_i_t s3g_mb_lfsr(const s3g_mb_state_t* st, uint32_t i)
+{
+  return st->lfsr[(st->base + i) & 15];
+}
+
+static inline simd_i_t s3g_mb_sbox(const int (*t)[256], simd_i_t w)
+{
+  simd_i_t mask = srslte_simd_i_set1(0xff);
+  simd_i_t r    = srslte_simd_i_gather(t[0], srslte_simd_i_srl(w, 24));
+  r             = srslte_simd_i_xor(r, srslte_simd_i_gather(t[1], srslte_simd_i_and(srslte_simd_i_srl(w, 16), mask)));
+  r             = srslte_simd_i_xor(r, srslte_simd_i_gather(t[2], srslte_simd_i_and(srslte_simd_i_srl(w, 8), mask)));
+  return srslte_simd_i_xor(r, srslte_simd_i_gather(t[3], srslte_simd_i_and(w, mask)));
+}
+
+static inline simd_i_t s3g_mb_clock_fsm(s3g_mb_state_t* st, const s3g_mb_tables_t& t)
+{
+  simd_i_t f = srslte_simd_i_xor(srslte_simd_i_add(s3g_mb_lfsr(st, 15), st->r1), st->r2);
+  simd_i_t r = srslte_simd_i_add(st->r2, srslte_simd_i_xor(st->r3, s3g_mb_lfsr(st, 5)));
+
+  st->r3 = s3g_mb_sbox(t.s2, st->r2);
+  st->r2 = s3g_mb_sbox(t.s1, st->r1);
+  st->r1 = r;
+  return f;
+}
+
+static inline void s3g_mb_clock_lfsr(s3g_mb_state_t* st, const s3g_mb_tables_t& t, simd_i_t f)
+{
+  simd_i_t s0  = s3g_mb_lfsr(st, 0);
+  simd_i_t s11 = s3g_mb_lfsr(st, 11);
+
+  simd_i_t mul = srslte_simd_i_gather(t.mul_alpha, srslte_simd_i_srl(s0, 24));
+  simd_i_t div = srslte_simd_i_gather(t.div_alpha, srslte_simd_i_and(s11, srslte_simd_i_set1(0xff)));
+
+  simd_i_t v = srslte_simd_i_xor(srslte_simd_i_sll(s0, 8), mul);
+  v          = srslte_simd_i_xor(v, s3g_mb_lfsr(st, 2));
+  v          = srslte_simd_i_xor(v, srslte_simd_i_srl(s11, 8));
+  v          = srslte_simd_i_xor(v, div);
+  v          = srslte_simd_i_xor(v, f);
+
+  // s_0 leaves the register and its slot becomes s_15
+  st->lfsr[st->base] = v;
+  st->base           = (st->base + 1) & 15;
+}
+
+static void s3g_generate_keystream_simd(uint32_t        nof_inst,
+                                        const uint32_t (*k)[4],
+                                        const uint32_t (*iv)[4],
+                                        const uint32_t* n,
+                                        uint32_t**      ks)
+{
+  const s3g_mb_tables_t& t = s3g_mb_tables();
+
+  // initial LFSR of each lane, unused lanes run with an all-zero key
+  alignas(64) int init[16][SRSLTE_SIMD_I_SIZE] = {};
+  uint32_t        max_n                        = 0;
+  for (uint32_t l = 0; l < nof_inst; l++) {
+    init[15][l] = (int)(k[l][3] ^ iv[l][0]);
+    init[14][l] = (int)k[l][2];
+    init[13][l] = (int)k[l][1];
+    init[12][l] = (int)(k[l][0] ^ iv[l][1]);
+    init[11][l] = (int)(k[l][3] ^ 0xffffffff);
+    init[10][l] = (int)(k[l][2] ^ 0xffffffff ^ iv[l][2]);
+    init[9][l]  = (int)(k[l][1] ^ 0xffffffff ^ iv[l][3]);
+    init[8][l]  = (int)(k[l][0] ^ 0xffffffff);
+    init[7][l]  = (int)k[l][3];
+    init[6][l]  = (int)k[l][2];
+    init[5][l]  = (int)k[l][1];
+    init[4][l]  = (int)k[l][0];
+    init[3][l]  = (int)(k[l][3] ^ 0xffffffff);
+    init[2][l]  = (int)(k[l][2] ^ 0xffffffff);
+    init[1][l]  = (int)(k[l][1] ^ 0xffffffff);
+    init[0][l]  = (int)(k[l][0] ^ 0xffffffff);
+    max_n       = std::max(max_n, n[l]);
+  }
+
+  s3g_mb_state_t st;
+  for (uint32_t i = 0; i < 16; i++) {
+    st.lfsr[i] = srslte_simd_i_load(init[i]);
+  }
+  st.base = 0;
+  st.r1   = srslte_simd_i_set1(0);
+  st.r2   = srslte_simd_i_set1(0);
+  st.r3   = srslte_simd_i_set1(0);
+
+  // Initialization mode, see s3g_initialize()
+  for (uint32_t i = 0; i < 32; i++) {
+    s3g_mb_clock_lfsr(&st, t, s3g_mb_clock_fsm(&st, t));
+  }
+
+  // Keystream mode, see s3g_generate_keystream()
+  simd_i_t zero = srslte_simd_i_set1(0);
+  s3g_mb_clock_fsm(&st, t);
+  s3g_mb_clock_lfsr(&st, t, zero);
+
+  alignas(64) int z[SRSLTE_SIMD_I_SIZE];
+  for (uint32_t i = 0; i < max_n; i++) {
+    simd_i_t f = s3g_mb_clock_fsm(&st, t);
+    srslte_simd_i_store(z, srslte_simd_i_xor(f, s3g_mb_lfsr(&st, 0)));
+    s3g_mb_clock_lfsr(&st, t, zero);
+    for (uint32_t l = 0; l < nof_inst; l++) {
+      if (i < n[l]) {
+        ks[l][i] = (uint32_t)z[l];
+      }
+    }
+  }
+}
+
+#endif // SRSLTE_SIMD_I_SIZE
+
+void s3g_generate_keystream_mb(uint32_t        nof_inst,
+                               const uint32_t (*k)[4],
+                               const uint32_t (*iv)[4],
+                               const uint32_t* n,
+                               uint32_t**      ks)
+{
+#if SRSLTE_SIMD_I_SIZE
+  for (uint32_t i = 0; i < nof_inst; i += SRSLTE_SIMD_I_SIZE) {
+    uint32_t nof_lanes = std::min(nof_inst - i, (uint32_t)SRSLTE_SIMD_I_SIZE);
+    s3g_generate_keystream_simd(nof_lanes, &k[i], &iv[i], &n[i], &ks[i]);
+  }
+#else  // SRSLTE_SIMD_I_SIZE
+  for (uint32_t i = 0; i < nof_inst; i++) {
+    S3G_STATE state;
+    uint32_t  k_i[4], iv_i[4];
+    memcpy(k_i, k[i], sizeof(k_i));
+    memcpy(iv_i, iv[i], sizeof(iv_i));
+    s3g_initialize(&state, k_i, iv_i);
+    s3g_generate_keystream(&state, n[i], ks[i]);
+    s3g_deinitialize(&state);
+  }
+#endif // SRSLTE_SIMD_I_SIZE
+}
@@ -22,6 +22,10 @@
 #include "srslte/common/security.h"
 #include "srslte/common/liblte_security.h"
 #include "srslte/common/s3g.h"
+#include "srslte/common/zuc.h"
+#include "srslte/phy/utils/simd.h"
+#include <algorithm>
+#include <vector>
 
 #ifdef HAVE_MBEDTLS
 #include "mbedtls/md5.h"
@@ -32,6 +36,24 @@
 
 namespace srslte {
 
+/******************************************************************************
+ * Security context
+ *****************************************************************************/
+
+void as_security_ctx_t::set(const as_security_config_t& cfg)
+{
+  // the 128-bit algorithms use the 128 least significant bits of the 256-bit keys
+  *this = {};
+  if (cfg.integ_algo == INTEGRITY_ALGORITHM_ID_128_EIA2) {
+    k_rrc_int.set_key(&cfg.k_rrc_int[16]);
+    k_up_int.set_key(&cfg.k_up_int[16]);
+  }
+  if (cfg.cipher_algo == CIPHERING_ALGORITHM_ID_128_EEA2) {
+    k_rrc_enc.set_key(&cfg.k_rrc_enc[16]);
+    k_up_enc.set_key(&cfg.k_up_enc[16]);
+  }
+}
+
 /******************************************************************************
  * Key Generation
  *****************************************************************************/
@@ -124,9 +146,100 @@ uint8_t security_128_eia2(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac)
 {
-  return liblte_security_128_eia2(key, count, bearer, direction, msg, msg_len, mac);
+  return security_128_eia2(aes_128_key(key), count, bearer, direction, msg, msg_len, mac);
+}
+
+uint8_t security_128_eia2(const aes_128_key& key,
+                          uint32_t           count,
+                          uint32_t           bearer,
+                          uint8_t            direction,
+                          const uint8_t*     msg,
+                          uint32_t           msg_len,
+                          uint8_t*           mac)
+{
+  if (not key.is_set() || msg == nullptr || mac == nullptr) {
+    return SRSLTE_ERROR;
+  }
+
+  // M = COUNT || BEARER || DIRECTION || 0^26 || MESSAGE, see TS 33.401 B.2.3
+  uint8_t hdr[8] = {};
+  hdr[0]         = (count >> 24) & 0xFF;
+  hdr[1]         = (count >> 16) & 0xFF;
+  hdr[2]         = (count >> 8) & 0xFF;
+  hdr[3]         = count & 0xFF;
+  hdr[4]         = ((bearer & 0x1F) << 3) | ((direction & 0x01) << 2);
+
+  uint8_t tag[16];
+  key.cmac(hdr, sizeof(hdr), msg, msg_len, tag);
+  memcpy(mac, tag, 4);
+  return SRSLTE_SUCCESS;
+}
+
+namespace {
+
+// IV of 128-EIA3, TS 33.401 B.2.3
+void eia3_iv(uint32_t count, uint32_t bearer, uint8_t direction, uint8_t* iv)
+{
+  uint8_t dir = (direction & 1) << 7;
+  iv[0]       = (count >> 24) & 0xFF;
+  iv[1]       = (count >> 16) & 0xFF;
+  iv[2]       = (count >> 8) & 0xFF;
+  iv[3]       = count & 0xFF;
+  iv[4]       = (bearer << 3) & 0xF8;
+  iv[5] = iv[6] = iv[7] = 0;
+  iv[8]                 = ((count >> 24) & 0xFF) ^ dir;
+  iv[9]                 = (count >> 16) & 0xFF;
+  iv[10]                = (count >> 8) & 0xFF;
+  iv[11]                = count & 0xFF;
+  iv[12]                = iv[4];
+  iv[13]                = iv[5];
+  iv[14]                = iv[6] ^ dir;
+  iv[15]                = iv[7];
+}
+
+// Number of keystream words to protect a msg_len bytes message
+uint32_t eia3_keystream_len(uint32_t msg_len)
+{
+  return (msg_len * 8 + 64 + 31) / 32;
+}
+
+// Keystream word starting at bit i
+uint32_t eia3_get_word(const uint32_t* ks, uint32_t i)
+{
+  uint32_t ti = i % 32;
+  if (ti == 0) {
+    return ks[i / 32];
+  }
+  return (ks[i / 32] << ti) | (ks[i / 32 + 1] >> (32 - ti));
+}
+
+/*
+ * MAC of 128-EIA3 from the keystream, T is the XOR of the keystream words starting at every message bit set. The
+ * message is processed one 32-bit word at a time: the keystream words of all its bits are shifts of the same 64-bit
+ * window, and the message bits are applied as masks instead of branches.
+ */
+uint32_t eia3_mac(const uint32_t* ks, uint32_t ks_len, const uint8_t* msg, uint32_t msg_len)
+{
+  uint32_t T = 0;
+  for (uint32_t w = 0; w < (msg_len + 3) / 4; w++) {
+    uint32_t m = 0;
+    for (uint32_t b = 0; b < 4; b++) {
+      m <<= 8;
+      if (4 * w + b < msg_len) {
+        m |= msg[4 * w + b];
+      }
+    }
+    uint64_t window = ((uint64_t)ks[w] << 32) | ks[w + 1];
+    for (uint32_t j = 0; j < 32; j++) {
+      T ^= (uint32_t)(window >> (32 - j)) & (0U - ((m >> (31 - j)) & 1U));
+    }
+  }
+  T ^= eia3_get_word(ks, msg_len * 8);
+  return T ^ ks[ks_len - 1];
 }
 
+} // namespace
+
 uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       count,
                           uint32_t       bearer,
@@ -135,7 +248,24 @@ uint8_t security_128_eia3(const uint8_t* key,
                           uint32_t       msg_len,
                           uint8_t*       mac)
 {
-  return liblte_security_128_eia3(key, count, bearer, direction, msg, msg_len * 8, mac);
+  if (key == nullptr || msg == nullptr || mac == nullptr) {
+    return SRSLTE_ERROR;
+  }
+
+  uint8_t iv[16];
+  eia3_iv(count, bearer, direction, iv);
+
+  zuc_state_t           zuc_state;
+  std::vector<uint32_t> ks(eia3_keystream_len(msg_len));
+  zuc_initialize(&zuc_state, key, iv);
+  zuc_generate_keystream(&zuc_state, ks.size(), ks.data());
+
+  uint32_t T = eia3_mac(ks.data(), ks.size(), msg, msg_len);
+  mac[0]     = (T >> 24) & 0xFF;
+  mac[1]     = (T >> 16) & 0xFF;
+  mac[2]     = (T >> 8) & 0xFF;
+  mac[3]     = T & 0xFF;
+  return SRSLTE_SUCCESS;
 }
 
 uint8_t security_md5(const uint8_t* input, size_t len, uint8_t* output)
@@ -174,8 +304,31 @@ uint8_t security_128_eea2(uint8_t* key,
                           uint32_t msg_len,
                           uint8_t* msg_out)
 {
+  return security_128_eea2(aes_128_key(key), count, bearer, direction, msg, msg_len, msg_out);
+}
+
+uint8_t security_128_eea2(const aes_128_key& key,
+                          uint32_t           count,
+                          uint8_t            bearer,
+                          uint8_t            direction,
+                          const uint8_t*     msg,
+                          uint32_t           msg_len,
+                          uint8_t*           msg_out)
+{
+  if (not key.is_set() || msg == nullptr || msg_out == nullptr) {
+    return SRSLTE_ERROR;
+  }
+
+  // Initial counter block is COUNT || BEARER || DIRECTION || 0^26 || 0^64, see TS 33.401 B.1.3
+  uint8_t nonce_cnt[16] = {};
+  nonce_cnt[0]          = (count >> 24) & 0xFF;
+  nonce_cnt[1]          = (count >> 16) & 0xFF;
+  nonce_cnt[2]          = (count >> 8) & 0xFF;
+  nonce_cnt[3]          = count & 0xFF;
+  nonce_cnt[4]          = ((bearer & 0x1F) << 3) | ((direction & 0x01) << 2);
 
-  return liblte_security_encryption_eea2(key, count, bearer, direction, msg, msg_len * 8, msg_out);
+  key.ctr_crypt(nonce_cnt, msg, msg_len, msg_out);
+  return SRSLTE_SUCCESS;
 }
 
 uint8_t security_128_eea3(uint8_t* key,
@@ -190,6 +343,232 @@ uint8_t security_128_eea3(uint8_t* key,
   return liblte_security_encryption_eea3(key, count, bearer, direction, msg, msg_len * 8, msg_out);
 }
 
+/******************************************************************************
+ * Batch processing
+ *****************************************************************************/
+
+#define SECURITY_BATCH_MAX_LANES 16
+
+namespace {
+
+void xor_keystream(const uint32_t* ks, const uint8_t* msg, uint32_t len, uint8_t* out)
+{
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = msg[i] ^ (uint8_t)(ks[i / 4] >> (24 - 8 * (i % 4)));
+  }
+}
+
+// Points ks[i] to consecutive regions of ks_buf, of len[i] words each
+void alloc_keystreams(const uint32_t* len, uint32_t n, std::vector<uint32_t>& ks_buf, uint32_t** ks)
+{
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    total += len[i];
+  }
+  ks_buf.resize(total);
+  for (uint32_t i = 0, offset = 0; i < n; offset += len[i], i++) {
+    ks[i] = &ks_buf[offset];
+  }
+}
+
+void eea1_chunk(const security_batch_item_t* items, uint32_t n, std::vector<uint32_t>& ks_buf)
+{
+  uint32_t  k[SECURITY_BATCH_MAX_LANES][4];
+  uint32_t  iv[SECURITY_BATCH_MAX_LANES][4];
+  uint32_t  len[SECURITY_BATCH_MAX_LANES] = {};
+  uint32_t* ks[SECURITY_BATCH_MAX_LANES];
+
+  // key and iv as in liblte_security_encryption_eea1()
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t* key = items[i].key;
+    for (uint32_t j = 0; j < 4; j++) {
+      k[i][3 - j] = ((uint32_t)key[4 * j] << 24) | ((uint32_t)key[4 * j + 1] << 16) |
+                    ((uint32_t)key[4 * j + 2] << 8) | (uint32_t)key[4 * j + 3];
+    }
+    iv[i][3] = items[i].count;
+    iv[i][2] = ((items[i].bearer & 0x1F) << 27) | ((items[i].direction & 0x01) << 26);
+    iv[i][1] = iv[i][3];
+    iv[i][0] = iv[i][2];
+    len[i]   = (items[i].msg_len + 3) / 4;
+  }
+
+  alloc_keystreams(len, n, ks_buf, ks);
+  s3g_generate_keystream_mb(n, k, iv, len, ks);
+
+  for (uint32_t i = 0; i < n; i++) {
+    xor_keystream(ks[i], items[i].msg, items[i].msg_len, items[i].out);
+  }
+}
+
+void eea3_chunk(const security_batch_item_t* items, uint32_t n, std::vector<uint32_t>& ks_buf)
+{
+  uint8_t        iv[SECURITY_BATCH_MAX_LANES][16];
+  const uint8_t* k[SECURITY_BATCH_MAX_LANES];
+  const uint8_t* iv_ptr[SECURITY_BATCH_MAX_LANES];
+  uint32_t       len[SECURITY_BATCH_MAX_LANES] = {};
+  uint32_t*      ks[SECURITY_BATCH_MAX_LANES];
+
+  // iv as in liblte_security_encryption_eea3()
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t* v = iv[i];
+    v[0]       = (items[i].count >> 24) & 0xFF;
+    v[1]       = (items[i].count >> 16) & 0xFF;
+    v[2]       = (items[i].count >> 8) & 0xFF;
+    v[3]       = items[i].count & 0xFF;
+    v[4]       = ((items[i].bearer & 0x1F) << 3) | ((items[i].direction & 0x01) << 2);
+    v[5] = v[6] = v[7] = 0;
+    memcpy(&v[8], &v[0], 8);
+    k[i]      = items[i].key;
+    iv_ptr[i] = v;
+    len[i]    = (items[i].msg_len + 3) / 4;
+  }
+
+  alloc_keystreams(len, n, ks_buf, ks);
+  zuc_generate_keystream_mb(n, k, iv_ptr, len, ks);
+
+  for (uint32_t i = 0; i < n; i++) {
+    xor_keystream(ks[i], items[i].msg, items[i].msg_len, items[i].out);
+  }
+}
+
+void eia3_chunk(const security_batch_item_t* items, uint32_t n, std::vector<uint32_t>& ks_buf)
+{
+  uint8_t        iv[SECURITY_BATCH_MAX_LANES][16];
+  const uint8_t* k[SECURITY_BATCH_MAX_LANES];
+  const uint8_t* iv_ptr[SECURITY_BATCH_MAX_LANES];
+  uint32_t       len[SECURITY_BATCH_MAX_LANES] = {};
+  uint32_t*      ks[SECURITY_BATCH_MAX_LANES];
+
+  for (uint32_t i = 0; i < n; i++) {
+    eia3_iv(items[i].count, items[i].bearer, items[i].direction, iv[i]);
+    k[i]      = items[i].key;
+    iv_ptr[i] = iv[i];
+    len[i]    = eia3_keystream_len(items[i].msg_len);
+  }
+
+  alloc_keystreams(len, n, ks_buf, ks);
+  zuc_generate_keystream_mb(n, k, iv_ptr, len, ks);
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t T = eia3_mac(ks[i], len[i], items[i].msg, items[i].msg_len);
+
+    items[i].out[0] = (T >> 24) & 0xFF;
+    items[i].out[1] = (T >> 16) & 0xFF;
+    items[i].out[2] = (T >> 8) & 0xFF;
+    items[i].out[3] = T & 0xFF;
+  }
+}
+
+bool batch_is_valid(const security_batch_item_t* items, uint32_t nof_items)
+{
+  if (items == nullptr) {
+    return nof_items == 0;
+  }
+  for (uint32_t i = 0; i < nof_items; i++) {
+    if (items[i].key == nullptr || items[i].msg == nullptr || items[i].out == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs the keystream based algorithms in chunks of as many packets as SIMD lanes
+template <typename F>
+void batch_run_chunks(const security_batch_item_t* items, uint32_t nof_items, F&& chunk_func)
+{
+  std::vector<uint32_t> ks_buf;
+  uint32_t              nof_lanes = security_batch_nof_lanes();
+  for (uint32_t i = 0; i < nof_items; i += nof_lanes) {
+    chunk_func(&items[i], std::min(nof_items - i, nof_lanes), ks_buf);
+  }
+}
+
+} // namespace
+
+uint32_t security_batch_nof_lanes()
+{
+#if SRSLTE_SIMD_I_SIZE
+  return SRSLTE_SIMD_I_SIZE;
+#else
+  return 1;
+#endif
+}
+
+int security_128_eea_batch(CIPHERING_ALGORITHM_ID_ENUM algo, const security_batch_item_t* items, uint32_t nof_items)
+{
+  if (not batch_is_valid(items, nof_items)) {
+    return SRSLTE_ERROR;
+  }
+
+  switch (algo) {
+    case CIPHERING_ALGORITHM_ID_EEA0:
+      for (uint32_t i = 0; i < nof_items; i++) {
+        if (items[i].out != items[i].msg) {
+          memcpy(items[i].out, items[i].msg, items[i].msg_len);
+        }
+      }
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+      batch_run_chunks(items, nof_items, eea1_chunk);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2:
+      for (uint32_t i = 0; i < nof_items; i++) {
+        const security_batch_item_t& it = items[i];
+        security_128_eea2(it.aes_key != nullptr ? *it.aes_key : aes_128_key(it.key),
+                          it.count,
+                          it.bearer,
+                          it.direction,
+                          it.msg,
+                          it.msg_len,
+                          it.out);
+      }
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+      batch_run_chunks(items, nof_items, eea3_chunk);
+      break;
+    default:
+      return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int security_128_eia_batch(INTEGRITY_ALGORITHM_ID_ENUM algo, const security_batch_item_t* items, uint32_t nof_items)
+{
+  if (not batch_is_valid(items, nof_items)) {
+    return SRSLTE_ERROR;
+  }
+
+  switch (algo) {
+    case INTEGRITY_ALGORITHM_ID_EIA0:
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA1:
+      // only five keystream words per packet, nothing to gain from generating them in parallel
+      for (uint32_t i = 0; i < nof_items; i++) {
+        const security_batch_item_t& it = items[i];
+        security_128_eia1(it.key, it.count, it.bearer, it.direction, (uint8_t*)it.msg, it.msg_len, it.out);
+      }
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2:
+      for (uint32_t i = 0; i < nof_items; i++) {
+        const security_batch_item_t& it = items[i];
+        security_128_eia2(it.aes_key != nullptr ? *it.aes_key : aes_128_key(it.key),
+                          it.count,
+                          it.bearer,
+                          it.direction,
+                          it.msg,
+                          it.msg_len,
+                          it.out);
+      }
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA3:
+      batch_run_chunks(items, nof_items, eia3_chunk);
+      break;
+    default:
+      return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
 /******************************************************************************
  * Authentication
  *****************************************************************************/
@@ -219,4 +598,76 @@ uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_
   return liblte_security_milenage_f5_star(k, op, rand, ak);
 }
 
+void security_milenage_f12345(const aes_128_key& k,
+                              const uint8_t*     opc,
+                              const uint8_t*     rand,
+                              const uint8_t*     sqn,
+                              const uint8_t*     amf,
+                              uint8_t*           mac_a,
+                              uint8_t*           res,
+                              uint8_t*           ck,
+                              uint8_t*           ik,
+                              uint8_t*           ak)
+{
+  uint8_t temp[16];
+  uint8_t in[16];
+  uint8_t out[16];
+
+  // TEMP = E_K(RAND xor OPc)
+  for (uint32_t i = 0; i < 16; i++) {
+    in[i] = rand[i] ^ opc[i];
+  }
+  k.encrypt_block(in, temp);
+
+  // f1: OUT1 = E_K(TEMP xor rot(IN1 xor OPc, r1) xor c1) xor OPc, with IN1 = SQN || AMF || SQN || AMF and r1 = 64
+  uint8_t in1[16];
+  memcpy(&in1[0], sqn, 6);
+  memcpy(&in1[6], amf, 2);
+  memcpy(&in1[8], sqn, 6);
+  memcpy(&in1[14], amf, 2);
+  for (uint32_t i = 0; i < 16; i++) {
+    in[(i + 8) % 16] = in1[i] ^ opc[i];
+  }
+  for (uint32_t i = 0; i < 16; i++) {
+    in[i] ^= temp[i];
+  }
+  k.encrypt_block(in, out);
+  for (uint32_t i = 0; i < 8; i++) {
+    mac_a[i] = out[i] ^ opc[i];
+  }
+
+  // f2 and f5: OUT2 = E_K(rot(TEMP xor OPc, r2) xor c2) xor OPc, with r2 = 0 and c2 = 1
+  for (uint32_t i = 0; i < 16; i++) {
+    in[i] = temp[i] ^ opc[i];
+  }
+  in[15] ^= 1;
+  k.encrypt_block(in, out);
+  for (uint32_t i = 0; i < 8; i++) {
+    res[i] = out[i + 8] ^ opc[i + 8];
+  }
+  for (uint32_t i = 0; i < 6; i++) {
+    ak[i] = out[i] ^ opc[i];
+  }
+
+  // f3: r3 = 32 and c3 = 2
+  for (uint32_t i = 0; i < 16; i++) {
+    in[(i + 12) % 16] = temp[i] ^ opc[i];
+  }
+  in[15] ^= 2;
+  k.encrypt_block(in, out);
+  for (uint32_t i = 0; i < 16; i++) {
+    ck[i] = out[i] ^ opc[i];
+  }
+
+  // f4: r4 = 64 and c4 = 4
+  for (uint32_t i = 0; i < 16; i++) {
+    in[(i + 8) % 16] = temp[i] ^ opc[i];
+  }
+  in[15] ^= 4;
+  k.encrypt_block(in, out);
+  for (uint32_t i = 0; i < 16; i++) {
+    ik[i] = out[i] ^ opc[i];
+  }
+}
+
 } // namespace srslte
@@ -20,6 +20,7 @@
  */
 
 #include "srslte/common/thread_pool.h"
+#include <algorithm>
 #include <assert.h>
 #include <chrono>
 #include <stdio.h>
@@ -253,6 +254,10 @@ uint32_t thread_pool::get_nof_workers()
  *  once a worker is available
  *************************************************************************/
 
+// Pool and worker id of the calling thread, if it is a task_thread_pool worker
+static thread_local const task_thread_pool* current_pool      = nullptr;
+static thread_local uint32_t                current_worker_id = 0;
+
 task_thread_pool::task_thread_pool(uint32_t nof_workers) : running(false)
 {
   workers.reserve(nof_workers);
@@ -321,6 +326,52 @@ uint32_t task_thread_pool::nof_pending_tasks()
   return pending_tasks.size();
 }
 
+void task_thread_pool::parallel_for(uint32_t nof_tasks, const std::function<void(uint32_t, uint32_t)>& task)
+{
+  struct group_t {
+    std::atomic<uint32_t>   next{0};
+    uint32_t                nof_done = 0;
+    std::mutex              mutex;
+    std::condition_variable cvar;
+  };
+
+  uint32_t slot = current_pool == this ? current_worker_id + 1 : 0;
+  if (nof_tasks < 2 or workers.empty()) {
+    for (uint32_t i = 0; i < nof_tasks; i++) {
+      task(i, slot);
+    }
+    return;
+  }
+
+  // A helper may only start once the group has finished, so it shares the group state. Then it does not claim any
+  // index, hence it never calls the task
+  std::shared_ptr<group_t> group = std::make_shared<group_t>();
+  auto                     run   = [group, nof_tasks, &task](uint32_t run_slot) {
+    uint32_t nof_run = 0;
+    for (uint32_t idx = group->next++; idx < nof_tasks; idx = group->next++) {
+      task(idx, run_slot);
+      nof_run++;
+    }
+    if (nof_run > 0) {
+      std::lock_guard<std::mutex> lock(group->mutex);
+      group->nof_done += nof_run;
+      if (group->nof_done == nof_tasks) {
+        group->cvar.notify_all();
+      }
+    }
+  };
+
+  uint32_t nof_helpers = std::min(nof_tasks - 1, (uint32_t)workers.size());
+  for (uint32_t i = 0; i < nof_helpers; i++) {
+    push_task([run](uint32_t worker_id) { run(worker_id + 1); });
+  }
+  run(slot);
+
+  // Wait for the tasks still running in the workers
+  std::unique_lock<std::mutex> lock(group->mutex);
+  group->cvar.wait(lock, [group, nof_tasks]() { return group->nof_done == nof_tasks; });
+}
+
 task_thread_pool::worker_t::worker_t(srslte::task_thread_pool* parent_, uint32_t my_id) :
   parent(parent_),
   thread(std::string("TASKWORKER") + std::to_string(my_id)),
@@ -361,6 +412,9 @@ bool task_thread_pool::worker_t::wait_task(task_t* task)
 
 void task_thread_pool::worker_t::run_thread()
 {
+  current_pool      = parent;
+  current_worker_id = id();
+
   // main loop
   task_t task;
   while (wait_task(&task)) {
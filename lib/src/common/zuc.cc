@@ -9,6 +9,8 @@
 ---------------------------------------------------------*/
 
 #include "srslte/common/zuc.h"
+#include "srslte/phy/utils/simd.h"
+#include <algorithm>
 
 #define MAKEU32(a, b, c, d) (((u32)(a) << 24) | ((u32)(b) << 16) | ((u32)(c) << 8) | ((u32)(d)))
 #define MulByPow2(x, k) ((((x) << k) | ((x) >> (31 - k))) & 0x7FFFFFFF)
@@ -231,3 +233,197 @@ void zuc_generate_keystream(zuc_state_t* state, int key_stream_len, u32* p_keyst
     LFSRWithWorkMode(state);
   }
 }
+
+/* ——————————————————————- */
+/* multi-buffer keystream generation, one instance per SIMD lane */
+#if SRSLTE_SIMD_I_SIZE
+
+/* S-box tables for 32-bit lookups, already shifted to their byte position */
+struct zuc_mb_tables_t {
+  int s[4][256];
+
+  zuc_mb_tables_t()
+  {
+    for (u32 x = 0; x < 256; x++) {
+      s[0][x] = (int)((u32)S0[x] << 24);
+      s[1][x] = (int)((u32)S1[x] << 16);
+      s[2][x] = (int)((u32)S0[x] << 8);
+      s[3][x] = (int)S1[x];
+    }
+  }
+};
+
+static const zuc_mb_tables_t& zuc_mb_tables()
+{
+  static const zuc_mb_tables_t tables;
+  return tables;
+}
+
+typedef struct {
+  simd_i_t lfsr[16]; /* circular, lfsr[(base + i) % 16] holds LFSR_Si */
+  u32      base;
+  simd_i_t F_R1;
+  simd_i_t F_R2;
+  simd_i_t BRC_X0;
+  simd_i_t BRC_X1;
+  simd_i_t BRC_X2;
+  simd_i_t BRC_X3;
+} zuc_mb_state_t;
+
+static inline simd_i_t zuc_mb_lfsr(const zuc_mb_state_t* st, u32 i)
+{
+  return st->lfsr[(st->base + i) & 15];
+}
+
+static inline simd_i_t zuc_mb_rot(simd_i_t a, int k)
+{
+  return srslte_simd_i_or(srslte_simd_i_sll(a, k), srslte_simd_i_srl(a, 32 - k));
+}
+
+static inline simd_i_t zuc_mb_mul_by_pow2(simd_i_t x, int k)
+{
+  simd_i_t r = srslte_simd_i_or(srslte_simd_i_sll(x, k), srslte_simd_i_srl(x, 31 - k));
+  return srslte_simd_i_and(r, srslte_simd_i_set1(0x7FFFFFFF));
+}
+
+static inline simd_i_t zuc_mb_add_m(simd_i_t a, simd_i_t b)
+{
+  simd_i_t c = srslte_simd_i_add(a, b);
+  return srslte_simd_i_add(srslte_simd_i_and(c, srslte_simd_i_set1(0x7FFFFFFF)), srslte_simd_i_srl(c, 31));
+}
+
+static inline void zuc_mb_lfsr_clock(zuc_mb_state_t* st, const simd_i_t* u)
+{
+  simd_i_t s0 = zuc_mb_lfsr(st, 0);
+  simd_i_t f  = zuc_mb_add_m(s0, zuc_mb_mul_by_pow2(s0, 8));
+  f           = zuc_mb_add_m(f, zuc_mb_mul_by_pow2(zuc_mb_lfsr(st, 4), 20));
+  f           = zuc_mb_add_m(f, zuc_mb_mul_by_pow2(zuc_mb_lfsr(st, 10), 21));
+  f           = zuc_mb_add_m(f, zuc_mb_mul_by_pow2(zuc_mb_lfsr(st, 13), 17));
+  f           = zuc_mb_add_m(f, zuc_mb_mul_by_pow2(zuc_mb_lfsr(st, 15), 15));
+  if (u != NULL) {
+    /* initialisation mode */
+    f = zuc_mb_add_m(f, *u);
+  }
+
+  /* LFSR_S0 leaves the register and its slot becomes LFSR_S15 */
+  st->lfsr[st->base] = f;
+  st->base           = (st->base + 1) & 15;
+}
+
+static inline void zuc_mb_bit_reorganization(zuc_mb_state_t* st)
+{
+  simd_i_t lo16 = srslte_simd_i_set1(0xFFFF);
+  simd_i_t x0_h = srslte_simd_i_sll(srslte_simd_i_and(zuc_mb_lfsr(st, 15), srslte_simd_i_set1(0x7FFF8000)), 1);
+  st->BRC_X0    = srslte_simd_i_or(x0_h, srslte_simd_i_and(zuc_mb_lfsr(st, 14), lo16));
+  st->BRC_X1    = srslte_simd_i_or(srslte_simd_i_sll(srslte_simd_i_and(zuc_mb_lfsr(st, 11), lo16), 16),
+                                srslte_simd_i_srl(zuc_mb_lfsr(st, 9), 15));
+  st->BRC_X2    = srslte_simd_i_or(srslte_simd_i_sll(srslte_simd_i_and(zuc_mb_lfsr(st, 7), lo16), 16),
+                                srslte_simd_i_srl(zuc_mb_lfsr(st, 5), 15));
+  st->BRC_X3    = srslte_simd_i_or(srslte_simd_i_sll(srslte_simd_i_and(zuc_mb_lfsr(st, 2), lo16), 16),
+                                srslte_simd_i_srl(zuc_mb_lfsr(st, 0), 15));
+}
+
+static inline simd_i_t zuc_mb_sbox(const zuc_mb_tables_t& t, simd_i_t w)
+{
+  simd_i_t mask = srslte_simd_i_set1(0xFF);
+  simd_i_t r    = srslte_simd_i_gather(t.s[0], srslte_simd_i_srl(w, 24));
+  r             = srslte_simd_i_or(r, srslte_simd_i_gather(t.s[1], srslte_simd_i_and(srslte_simd_i_srl(w, 16), mask)));
+  r             = srslte_simd_i_or(r, srslte_simd_i_gather(t.s[2], srslte_simd_i_and(srslte_simd_i_srl(w, 8), mask)));
+  return srslte_simd_i_or(r, srslte_simd_i_gather(t.s[3], srslte_simd_i_and(w, mask)));
+}
+
+static inline simd_i_t zuc_mb_l1(simd_i_t x)
+{
+  simd_i_t r = srslte_simd_i_xor(x, zuc_mb_rot(x, 2));
+  r          = srslte_simd_i_xor(r, zuc_mb_rot(x, 10));
+  r          = srslte_simd_i_xor(r, zuc_mb_rot(x, 18));
+  return srslte_simd_i_xor(r, zuc_mb_rot(x, 24));
+}
+
+static inline simd_i_t zuc_mb_l2(simd_i_t x)
+{
+  simd_i_t r = srslte_simd_i_xor(x, zuc_mb_rot(x, 8));
+  r          = srslte_simd_i_xor(r, zuc_mb_rot(x, 14));
+  r          = srslte_simd_i_xor(r, zuc_mb_rot(x, 22));
+  return srslte_simd_i_xor(r, zuc_mb_rot(x, 30));
+}
+
+static inline simd_i_t zuc_mb_f(zuc_mb_state_t* st, const zuc_mb_tables_t& t)
+{
+  simd_i_t W  = srslte_simd_i_add(srslte_simd_i_xor(st->BRC_X0, st->F_R1), st->F_R2);
+  simd_i_t W1 = srslte_simd_i_add(st->F_R1, st->BRC_X1);
+  simd_i_t W2 = srslte_simd_i_xor(st->F_R2, st->BRC_X2);
+  simd_i_t u  = srslte_simd_i_or(srslte_simd_i_sll(W1, 16), srslte_simd_i_srl(W2, 16));
+  simd_i_t v  = srslte_simd_i_or(srslte_simd_i_sll(W2, 16), srslte_simd_i_srl(W1, 16));
+
+  st->F_R1 = zuc_mb_sbox(t, zuc_mb_l1(u));
+  st->F_R2 = zuc_mb_sbox(t, zuc_mb_l2(v));
+  return W;
+}
+
+static void zuc_generate_keystream_simd(u32 nof_inst, const u8* const* k, const u8* const* iv, const u32* len, u32** ks)
+{
+  const zuc_mb_tables_t& t = zuc_mb_tables();
+
+  /* expand key of each lane, unused lanes run with an all-zero key */
+  alignas(64) int init[16][SRSLTE_SIMD_I_SIZE];
+  u32             max_len = 0;
+  for (u32 i = 0; i < 16; i++) {
+    for (u32 l = 0; l < SRSLTE_SIMD_I_SIZE; l++) {
+      init[i][l] = (int)(l < nof_inst ? MAKEU31(k[l][i], EK_d[i], iv[l][i]) : MAKEU31(0, EK_d[i], 0));
+    }
+  }
+  for (u32 l = 0; l < nof_inst; l++) {
+    max_len = std::max(max_len, len[l]);
+  }
+
+  zuc_mb_state_t st;
+  for (u32 i = 0; i < 16; i++) {
+    st.lfsr[i] = srslte_simd_i_load(init[i]);
+  }
+  st.base = 0;
+  st.F_R1 = srslte_simd_i_set1(0);
+  st.F_R2 = srslte_simd_i_set1(0);
+
+  /* initialisation, see zuc_initialize() */
+  for (u32 i = 0; i < 32; i++) {
+    zuc_mb_bit_reorganization(&st);
+    simd_i_t w = srslte_simd_i_srl(zuc_mb_f(&st, t), 1);
+    zuc_mb_lfsr_clock(&st, &w);
+  }
+
+  /* working stage, see zuc_generate_keystream() */
+  zuc_mb_bit_reorganization(&st);
+  zuc_mb_f(&st, t);
+  zuc_mb_lfsr_clock(&st, NULL);
+
+  alignas(64) int z[SRSLTE_SIMD_I_SIZE];
+  for (u32 i = 0; i < max_len; i++) {
+    zuc_mb_bit_reorganization(&st);
+    srslte_simd_i_store(z, srslte_simd_i_xor(zuc_mb_f(&st, t), st.BRC_X3));
+    zuc_mb_lfsr_clock(&st, NULL);
+    for (u32 l = 0; l < nof_inst; l++) {
+      if (i < len[l]) {
+        ks[l][i] = (u32)z[l];
+      }
+    }
+  }
+}
+
+#endif /* SRSLTE_SIMD_I_SIZE */
+
+void zuc_generate_keystream_mb(u32 nof_inst, const u8* const* k, const u8* const* iv, const u32* len, u32** ks)
+{
+#if SRSLTE_SIMD_I_SIZE
+  for (u32 i = 0; i < nof_inst; i += SRSLTE_SIMD_I_SIZE) {
+    u32 nof_lanes = std::min(nof_inst - i, (u32)SRSLTE_SIMD_I_SIZE);
+    zuc_generate_keystream_simd(nof_lanes, &k[i], &iv[i], &len[i], &ks[i]);
+  }
+#else  /* SRSLTE_SIMD_I_SIZE */
+  for (u32 i = 0; i < nof_inst; i++) {
+    zuc_state_t state;
+    zuc_initialize(&state, k[i], (u8*)iv[i]);
+    zuc_generate_keystream(&state, (int)len[i], ks[i]);
+  }
+#endif /* SRSLTE_SIMD_I_SIZE */
+}
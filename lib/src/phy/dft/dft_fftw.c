@@ -21,28 +21,61 @@
 
 #include "srslte/srslte.h"
 #include <complex.h>
+#ifdef HAVE_FFTW
 #include <fftw3.h>
+#endif /* HAVE_FFTW */
 #include <math.h>
 #include <pwd.h>
 #include <string.h>
 #include <unistd.h>
 
 #include "srslte/phy/dft/dft.h"
+#include "srslte/phy/dft/dft_native.h"
 #include "srslte/phy/utils/vector.h"
 
 #define dft_ceil(a, b) ((a - 1) / b + 1)
 #define dft_floor(a, b) (a / b)
 
-#define FFTW_WISDOM_FILE "%s/.srslte_fftwisdom"
+#ifdef HAVE_FFTW
+#define FFTW_WISDOM_FILE "%s/.srslte_fftwisdom_%s"
+
+// The best plans depend on the SIMD extensions, so every set of them has its own wisdom file
+static const char* get_cpu_features()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return "avx512";
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return "avx2";
+  }
+  if (__builtin_cpu_supports("avx")) {
+    return "avx";
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return "sse4";
+  }
+#endif /* defined(__x86_64__) || defined(__i386__) */
+#ifdef __aarch64__
+  return "neon";
+#endif /* __aarch64__ */
+  return "generic";
+}
 
 static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 {
+  const char* path = getenv("SRSLTE_FFTW_WISDOM");
+  if (path != NULL) {
+    return snprintf(full_path, n, "%s", path);
+  }
+
   const char* homedir = NULL;
   if ((homedir = getenv("HOME")) == NULL) {
     homedir = getpwuid(getuid())->pw_dir;
   }
 
-  return snprintf(full_path, n, FFTW_WISDOM_FILE, homedir);
+  return snprintf(full_path, n, FFTW_WISDOM_FILE, homedir, get_cpu_features());
 }
 
 #ifdef FFTW_WISDOM_FILE
@@ -53,15 +86,84 @@ static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 
 static pthread_mutex_t fft_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Planner effort and count of the plans found in the wisdom and the ones measured, protected by fft_mutex
+static unsigned fftw_flags         = FFTW_TYPE;
+static uint32_t fftw_wisdom_hits   = 0;
+static uint32_t fftw_wisdom_misses = 0;
+
+// Every plan is first looked up in the wisdom, a miss plans it with the configured effort
+static bool fftw_wisdom_hit(void* p)
+{
+  if (p) {
+    fftw_wisdom_hits++;
+    return true;
+  }
+  fftw_wisdom_misses++;
+  return false;
+}
+#endif /* HAVE_FFTW */
+
+#if defined(HAVE_FFTW) && !defined(USE_NATIVE_DFT)
+static srslte_dft_backend_t dft_backend = SRSLTE_DFT_BACKEND_FFTW;
+#else
+static srslte_dft_backend_t dft_backend = SRSLTE_DFT_BACKEND_NATIVE;
+#endif
+
+// Native plans keep the guru layout, which FFTW stores in its own plan
+typedef struct {
+  srslte_dft_native_t dft;
+  cf_t*               in;
+  cf_t*               out;
+  cf_t*               tmp; // Gathers the strided guru transforms
+  int                 istride;
+  int                 ostride;
+  int                 how_many;
+  int                 idist;
+  int                 odist;
+} dft_native_plan_t;
+
+int srslte_dft_set_backend(srslte_dft_backend_t backend)
+{
+#ifndef HAVE_FFTW
+  if (backend == SRSLTE_DFT_BACKEND_FFTW) {
+    ERROR("DFT: srsLTE was built without FFTW\n");
+    return SRSLTE_ERROR;
+  }
+#endif /* HAVE_FFTW */
+  dft_backend = backend;
+  return SRSLTE_SUCCESS;
+}
+
+srslte_dft_backend_t srslte_dft_get_backend(void)
+{
+  return dft_backend;
+}
+
+const char* srslte_dft_backend_string(srslte_dft_backend_t backend)
+{
+  return backend == SRSLTE_DFT_BACKEND_FFTW ? "fftw" : "native";
+}
+
 // This function is called in the beggining of any executable where it is linked
 __attribute__((constructor)) static void srslte_dft_load()
 {
+  const char* backend = getenv("SRSLTE_DFT_BACKEND");
+  if (backend != NULL) {
+    if (strcmp(backend, "native") == 0) {
+      srslte_dft_set_backend(SRSLTE_DFT_BACKEND_NATIVE);
+    } else if (strcmp(backend, "fftw") == 0) {
+      srslte_dft_set_backend(SRSLTE_DFT_BACKEND_FFTW);
+    } else {
+      ERROR("DFT: Unknown SRSLTE_DFT_BACKEND %s, using %s\n", backend, srslte_dft_backend_string(dft_backend));
+    }
+  }
+
 #ifdef FFTW_WISDOM_FILE
-  char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  fftwf_import_wisdom_from_filename(full_path);
+  srslte_dft_wisdom_load(NULL);
 #else
+#ifdef HAVE_FFTW
   printf("Warning: FFTW Wisdom file not defined\n");
+#endif /* HAVE_FFTW */
 #endif
 }
 
@@ -69,11 +171,181 @@ __attribute__((constructor)) static void srslte_dft_load()
 __attribute__((destructor)) static void srslte_dft_exit()
 {
 #ifdef FFTW_WISDOM_FILE
-  char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  fftwf_export_wisdom_to_filename(full_path);
+  // The wisdom only changes when a plan was measured
+  if (fftw_wisdom_misses > 0) {
+    srslte_dft_wisdom_save(NULL);
+  }
 #endif
+#ifdef HAVE_FFTW
   fftwf_cleanup();
+#endif /* HAVE_FFTW */
+}
+
+int srslte_dft_wisdom_filename(char* path, uint32_t len)
+{
+#ifdef FFTW_WISDOM_FILE
+  if (get_fftw_wisdom_file(path, len) < len) {
+    return SRSLTE_SUCCESS;
+  }
+#endif /* FFTW_WISDOM_FILE */
+  return SRSLTE_ERROR;
+}
+
+int srslte_dft_wisdom_load(const char* path)
+{
+#ifdef HAVE_FFTW
+  char full_path[256];
+  if (path == NULL) {
+    if (srslte_dft_wisdom_filename(full_path, sizeof(full_path))) {
+      return SRSLTE_ERROR;
+    }
+    path = full_path;
+  }
+
+  pthread_mutex_lock(&fft_mutex);
+  int ret = fftwf_import_wisdom_from_filename(path);
+  pthread_mutex_unlock(&fft_mutex);
+
+  return ret ? SRSLTE_SUCCESS : SRSLTE_ERROR;
+#else  /* HAVE_FFTW */
+  return SRSLTE_ERROR;
+#endif /* HAVE_FFTW */
+}
+
+int srslte_dft_wisdom_save(const char* path)
+{
+#ifdef HAVE_FFTW
+  char full_path[256];
+  char tmp_path[256 + 32];
+  if (path == NULL) {
+    if (srslte_dft_wisdom_filename(full_path, sizeof(full_path))) {
+      return SRSLTE_ERROR;
+    }
+    path = full_path;
+  }
+
+  // Write a temporary file and rename it, so a process loading the wisdom never reads a partial file
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", path, (int)getpid());
+  pthread_mutex_lock(&fft_mutex);
+  int ret = fftwf_export_wisdom_to_filename(tmp_path);
+  pthread_mutex_unlock(&fft_mutex);
+
+  if (!ret || rename(tmp_path, path)) {
+    unlink(tmp_path);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+#else  /* HAVE_FFTW */
+  return SRSLTE_ERROR;
+#endif /* HAVE_FFTW */
+}
+
+void srslte_dft_wisdom_forget()
+{
+#ifdef HAVE_FFTW
+  pthread_mutex_lock(&fft_mutex);
+  fftwf_forget_wisdom();
+  fftw_wisdom_hits   = 0;
+  fftw_wisdom_misses = 0;
+  pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
+}
+
+void srslte_dft_wisdom_get_stats(uint32_t* nof_hits, uint32_t* nof_misses)
+{
+#ifdef HAVE_FFTW
+  pthread_mutex_lock(&fft_mutex);
+  *nof_hits   = fftw_wisdom_hits;
+  *nof_misses = fftw_wisdom_misses;
+  pthread_mutex_unlock(&fft_mutex);
+#else  /* HAVE_FFTW */
+  *nof_hits   = 0;
+  *nof_misses = 0;
+#endif /* HAVE_FFTW */
+}
+
+void srslte_dft_set_fftw_patient(bool patient)
+{
+#ifdef HAVE_FFTW
+  pthread_mutex_lock(&fft_mutex);
+  fftw_flags = patient ? FFTW_PATIENT : FFTW_TYPE;
+  pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
+}
+
+static dft_native_plan_t* dft_native_plan_create(int dft_points, bool forward)
+{
+  dft_native_plan_t* p = calloc(1, sizeof(dft_native_plan_t));
+  if (p == NULL) {
+    return NULL;
+  }
+  if (dft_points <= 0 || srslte_dft_native_init(&p->dft, (uint32_t)dft_points, forward)) {
+    free(p);
+    return NULL;
+  }
+  return p;
+}
+
+static void dft_native_plan_destroy(dft_native_plan_t* p)
+{
+  if (p) {
+    srslte_dft_native_free(&p->dft);
+    if (p->tmp) {
+      free(p->tmp);
+    }
+    free(p);
+  }
+}
+
+static dft_native_plan_t* dft_native_plan_create_guru(int   dft_points,
+                                                      bool  forward,
+                                                      cf_t* in_buffer,
+                                                      cf_t* out_buffer,
+                                                      int   istride,
+                                                      int   ostride,
+                                                      int   how_many,
+                                                      int   idist,
+                                                      int   odist)
+{
+  dft_native_plan_t* p = dft_native_plan_create(dft_points, forward);
+  if (p == NULL) {
+    return NULL;
+  }
+  p->in       = in_buffer;
+  p->out      = out_buffer;
+  p->istride  = istride;
+  p->ostride  = ostride;
+  p->how_many = how_many;
+  p->idist    = idist;
+  p->odist    = odist;
+  if (istride != 1 || ostride != 1) {
+    p->tmp = srslte_vec_cf_malloc(dft_points);
+    if (p->tmp == NULL) {
+      dft_native_plan_destroy(p);
+      return NULL;
+    }
+  }
+  return p;
+}
+
+static void dft_native_run_guru(dft_native_plan_t* p)
+{
+  uint32_t n = p->dft.size;
+  for (int i = 0; i < p->how_many; i++) {
+    cf_t* in  = &p->in[i * p->idist];
+    cf_t* out = &p->out[i * p->odist];
+    if (p->tmp == NULL) {
+      srslte_dft_native_run(&p->dft, in, out);
+    } else {
+      for (uint32_t j = 0; j < n; j++) {
+        p->tmp[j] = in[j * p->istride];
+      }
+      srslte_dft_native_run(&p->dft, p->tmp, p->tmp);
+      for (uint32_t j = 0; j < n; j++) {
+        out[j * p->ostride] = p->tmp[j];
+      }
+    }
+  }
 }
 
 int srslte_dft_plan(srslte_dft_plan_t* plan, const int dft_points, srslte_dft_dir_t dir, srslte_dft_mode_t mode)
@@ -106,8 +378,15 @@ int srslte_dft_replan(srslte_dft_plan_t* plan, const int new_dft_points)
 
 static void allocate(srslte_dft_plan_t* plan, int size_in, int size_out, int len)
 {
-  plan->in  = fftwf_malloc((size_t)size_in * len);
-  plan->out = fftwf_malloc((size_t)size_out * len);
+#ifdef HAVE_FFTW
+  if (plan->backend == SRSLTE_DFT_BACKEND_FFTW) {
+    plan->in  = fftwf_malloc((size_t)size_in * len);
+    plan->out = fftwf_malloc((size_t)size_out * len);
+    return;
+  }
+#endif /* HAVE_FFTW */
+  plan->in  = srslte_vec_malloc((uint32_t)(size_in * len));
+  plan->out = srslte_vec_malloc((uint32_t)(size_out * len));
 }
 
 int srslte_dft_replan_guru_c(srslte_dft_plan_t* plan,
@@ -120,19 +399,31 @@ int srslte_dft_replan_guru_c(srslte_dft_plan_t* plan,
                              int                idist,
                              int                odist)
 {
-  int sign = (plan->forward) ? FFTW_FORWARD : FFTW_BACKWARD;
+  if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+    dft_native_plan_destroy(plan->p);
+    plan->p = dft_native_plan_create_guru(
+        new_dft_points, plan->forward, in_buffer, out_buffer, istride, ostride, how_many, idist, odist);
+  } else {
+#ifdef HAVE_FFTW
+    int sign = (plan->forward) ? FFTW_FORWARD : FFTW_BACKWARD;
 
-  const fftwf_iodim iodim        = {new_dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
+    const fftwf_iodim iodim        = {new_dft_points, istride, ostride};
+    const fftwf_iodim howmany_dims = {how_many, idist, odist};
 
-  pthread_mutex_lock(&fft_mutex);
+    pthread_mutex_lock(&fft_mutex);
 
-  /* Destroy current plan */
-  fftwf_destroy_plan(plan->p);
+    /* Destroy current plan */
+    fftwf_destroy_plan(plan->p);
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+    plan->p =
+        fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, fftw_flags | FFTW_WISDOM_ONLY);
+    if (!fftw_wisdom_hit(plan->p)) {
+      plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, fftw_flags);
+    }
 
-  pthread_mutex_unlock(&fft_mutex);
+    pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
+  }
 
   if (!plan->p) {
     return -1;
@@ -145,15 +436,25 @@ int srslte_dft_replan_guru_c(srslte_dft_plan_t* plan,
 
 int srslte_dft_replan_c(srslte_dft_plan_t* plan, const int new_dft_points)
 {
-  int sign = (plan->dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+    dft_native_plan_destroy(plan->p);
+    plan->p = dft_native_plan_create(new_dft_points, plan->dir == SRSLTE_DFT_FORWARD);
+  } else {
+#ifdef HAVE_FFTW
+    int sign = (plan->dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
 
-  pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
+    pthread_mutex_lock(&fft_mutex);
+    if (plan->p) {
+      fftwf_destroy_plan(plan->p);
+      plan->p = NULL;
+    }
+    plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, fftw_flags | FFTW_WISDOM_ONLY);
+    if (!fftw_wisdom_hit(plan->p)) {
+      plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, fftw_flags);
+    }
+    pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
   }
-  plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
-  pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
     return -1;
@@ -173,18 +474,30 @@ int srslte_dft_plan_guru_c(srslte_dft_plan_t* plan,
                            int                idist,
                            int                odist)
 {
-  int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  plan->backend = dft_backend;
+  if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+    plan->p = dft_native_plan_create_guru(
+        dft_points, dir == SRSLTE_DFT_FORWARD, in_buffer, out_buffer, istride, ostride, how_many, idist, odist);
+  } else {
+#ifdef HAVE_FFTW
+    int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
 
-  const fftwf_iodim iodim        = {dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
+    const fftwf_iodim iodim        = {dft_points, istride, ostride};
+    const fftwf_iodim howmany_dims = {how_many, idist, odist};
 
-  pthread_mutex_lock(&fft_mutex);
+    pthread_mutex_lock(&fft_mutex);
+    plan->p =
+        fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, fftw_flags | FFTW_WISDOM_ONLY);
+    if (!fftw_wisdom_hit(plan->p)) {
+      plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, fftw_flags);
+    }
+    pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
+  }
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
   if (!plan->p) {
     return -1;
   }
-  pthread_mutex_unlock(&fft_mutex);
 
   plan->size      = dft_points;
   plan->init_size = plan->size;
@@ -202,14 +515,24 @@ int srslte_dft_plan_guru_c(srslte_dft_plan_t* plan,
 
 int srslte_dft_plan_c(srslte_dft_plan_t* plan, const int dft_points, srslte_dft_dir_t dir)
 {
-  allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
+  plan->backend = dft_backend;
+  allocate(plan, sizeof(cf_t), sizeof(cf_t), dft_points);
 
-  pthread_mutex_lock(&fft_mutex);
+  if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+    plan->p = dft_native_plan_create(dft_points, dir == SRSLTE_DFT_FORWARD);
+  } else {
+#ifdef HAVE_FFTW
+    pthread_mutex_lock(&fft_mutex);
 
-  int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-  plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+    int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+    plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, fftw_flags | FFTW_WISDOM_ONLY);
+    if (!fftw_wisdom_hit(plan->p)) {
+      plan->p = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, fftw_flags);
+    }
 
-  pthread_mutex_unlock(&fft_mutex);
+    pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
+  }
 
   if (!plan->p) {
     return -1;
@@ -230,6 +553,7 @@ int srslte_dft_plan_c(srslte_dft_plan_t* plan, const int dft_points, srslte_dft_
 
 int srslte_dft_replan_r(srslte_dft_plan_t* plan, const int new_dft_points)
 {
+#ifdef HAVE_FFTW
   int sign = (plan->dir == SRSLTE_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
   pthread_mutex_lock(&fft_mutex);
@@ -237,7 +561,10 @@ int srslte_dft_replan_r(srslte_dft_plan_t* plan, const int new_dft_points)
     fftwf_destroy_plan(plan->p);
     plan->p = NULL;
   }
-  plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, fftw_flags | FFTW_WISDOM_ONLY);
+  if (!fftw_wisdom_hit(plan->p)) {
+    plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, fftw_flags);
+  }
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -245,16 +572,30 @@ int srslte_dft_replan_r(srslte_dft_plan_t* plan, const int new_dft_points)
   }
   plan->size = new_dft_points;
   return 0;
+#else  /* HAVE_FFTW */
+  ERROR("DFT: Real transforms require FFTW\n");
+  return -1;
+#endif /* HAVE_FFTW */
 }
 
 int srslte_dft_plan_r(srslte_dft_plan_t* plan, const int dft_points, srslte_dft_dir_t dir)
 {
+#ifdef HAVE_FFTW
+  // The built-in FFT is complex only
+  plan->backend = SRSLTE_DFT_BACKEND_FFTW;
   allocate(plan, sizeof(float), sizeof(float), dft_points);
   int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
   pthread_mutex_lock(&fft_mutex);
-  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, fftw_flags | FFTW_WISDOM_ONLY);
+  if (!fftw_wisdom_hit(plan->p)) {
+    plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, fftw_flags);
+  }
   pthread_mutex_unlock(&fft_mutex);
+#else  /* HAVE_FFTW */
+  ERROR("DFT: Real transforms require FFTW\n");
+  return -1;
+#endif /* HAVE_FFTW */
 
   if (!plan->p) {
     return -1;
@@ -325,17 +666,23 @@ void srslte_dft_run(srslte_dft_plan_t* plan, const void* in, void* out)
 
 void srslte_dft_run_c_zerocopy(srslte_dft_plan_t* plan, const cf_t* in, cf_t* out)
 {
+  if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+    srslte_dft_native_run(&((dft_native_plan_t*)plan->p)->dft, in, out);
+    return;
+  }
+#ifdef HAVE_FFTW
   fftwf_execute_dft(plan->p, (cf_t*)in, out);
+#endif /* HAVE_FFTW */
 }
 
 void srslte_dft_run_c(srslte_dft_plan_t* plan, const cf_t* in, cf_t* out)
 {
-  float          norm;
-  int            i;
-  fftwf_complex* f_out = plan->out;
+  float norm;
+  int   i;
+  cf_t* f_out = plan->out;
 
   copy_pre((uint8_t*)plan->in, (uint8_t*)in, sizeof(cf_t), plan->size, plan->forward, plan->mirror, plan->dc);
-  fftwf_execute(plan->p);
+  srslte_dft_run_c_zerocopy(plan, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / sqrtf(plan->size);
     srslte_vec_sc_prod_cfc(f_out, norm, f_out, plan->size);
@@ -351,7 +698,13 @@ void srslte_dft_run_c(srslte_dft_plan_t* plan, const cf_t* in, cf_t* out)
 void srslte_dft_run_guru_c(srslte_dft_plan_t* plan)
 {
   if (plan->is_guru == true) {
+    if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+      dft_native_run_guru(plan->p);
+      return;
+    }
+#ifdef HAVE_FFTW
     fftwf_execute(plan->p);
+#endif /* HAVE_FFTW */
   } else {
     ERROR("srslte_dft_run_guru_c: the selected plan is not guru!\n");
   }
@@ -365,7 +718,9 @@ void srslte_dft_run_r(srslte_dft_plan_t* plan, const float* in, float* out)
   float* f_out = plan->out;
 
   memcpy(plan->in, in, sizeof(float) * plan->size);
+#ifdef HAVE_FFTW
   fftwf_execute(plan->p);
+#endif /* HAVE_FFTW */
   if (plan->norm) {
     norm = 1.0 / plan->size;
     srslte_vec_sc_prod_fff(f_out, norm, f_out, plan->size);
@@ -385,6 +740,19 @@ void srslte_dft_plan_free(srslte_dft_plan_t* plan)
   if (!plan->size)
     return;
 
+  if (plan->backend == SRSLTE_DFT_BACKEND_NATIVE) {
+    if (!plan->is_guru) {
+      if (plan->in)
+        free(plan->in);
+      if (plan->out)
+        free(plan->out);
+    }
+    dft_native_plan_destroy(plan->p);
+    bzero(plan, sizeof(srslte_dft_plan_t));
+    return;
+  }
+
+#ifdef HAVE_FFTW
   pthread_mutex_lock(&fft_mutex);
   if (!plan->is_guru) {
     if (plan->in)
@@ -395,5 +763,6 @@ void srslte_dft_plan_free(srslte_dft_plan_t* plan)
   if (plan->p)
     fftwf_destroy_plan(plan->p);
   pthread_mutex_unlock(&fft_mutex);
+#endif /* HAVE_FFTW */
   bzero(plan, sizeof(srslte_dft_plan_t));
 }
@@ -0,0 +1,553 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srslte/phy/dft/dft_native.h"
+#include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd.h"
+#include "srslte/phy/utils/vector.h"
+
+#define DFT_NATIVE_SQRT3_2 0.86602540378443864676f
+#define DFT_NATIVE_COS_2PI_5 0.30901699437494742410f
+#define DFT_NATIVE_COS_4PI_5 -0.80901699437494742410f
+#define DFT_NATIVE_SIN_2PI_5 0.95105651629515357212f
+#define DFT_NATIVE_SIN_4PI_5 0.58778525229247312917f
+
+// Complex products are written out, otherwise the compiler calls the C99 Annex G helpers for every product
+static inline cf_t dft_native_prod(cf_t a, cf_t b)
+{
+  cf_t ret;
+  __real__ ret = __real__ a * __real__ b - __imag__ a * __imag__ b;
+  __imag__ ret = __real__ a * __imag__ b + __imag__ a * __real__ b;
+  return ret;
+}
+
+static inline cf_t dft_native_mulj(cf_t a, float sign)
+{
+  cf_t ret;
+  __real__ ret = -sign * __imag__ a;
+  __imag__ ret = sign * __real__ a;
+  return ret;
+}
+
+#ifdef LV_HAVE_AVX2
+/*
+ * The AVX2 butterflies work on the interleaved samples, four complex per register, so neither the loads nor the
+ * stores need to split the real and imaginary parts
+ */
+// sign * j * a, the mask negates the real parts of the swapped input for +j and the imaginary ones for -j
+static inline __m256 dft_native_avx2_mulj(__m256 a, __m256 mask)
+{
+  return _mm256_xor_ps(_mm256_permute_ps(a, 0b10110001), mask);
+}
+
+static inline __m256 dft_native_avx2_mulj_mask(float sign)
+{
+  return sign > 0 ? _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f)
+                  : _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+}
+
+static inline __m256 dft_native_avx2_set1(cf_t w)
+{
+  return _mm256_castpd_ps(_mm256_broadcast_sd((const double*)&w));
+}
+
+static inline __m256 dft_native_avx2_load(const cf_t* ptr)
+{
+  return _mm256_loadu_ps((const float*)ptr);
+}
+
+static inline void dft_native_avx2_store(cf_t* ptr, __m256 a)
+{
+  _mm256_storeu_ps((float*)ptr, a);
+}
+
+#define DFT_NATIVE_AVX2_CF_SIZE 4
+#endif /* LV_HAVE_AVX2 */
+
+/*
+ * Every stage of the Stockham FFT splits the s interleaved sequences of length n = r * m into r * s interleaved
+ * sequences of length m: a radix r butterfly across the inputs spaced by m*s, then the twiddle of the output. The
+ * s butterflies sharing a twiddle are contiguous in memory, so they are computed with SIMD once s is large enough. The
+ * twiddle of the output u of the butterfly p is tw[(u - 1) * m + p].
+ */
+static void dft_native_stage_r2(const cf_t* tw, uint32_t m, uint32_t s, const cf_t* x, cf_t* y)
+{
+  for (uint32_t p = 0; p < m; p++) {
+    const cf_t* x0 = &x[s * p];
+    const cf_t* x1 = &x[s * (p + m)];
+    cf_t*       y0 = &y[s * 2 * p];
+    cf_t*       y1 = &y0[s];
+    uint32_t    q  = 0;
+
+#ifdef LV_HAVE_AVX2
+    __m256 w1 = dft_native_avx2_set1(tw[p]);
+    for (; q + DFT_NATIVE_AVX2_CF_SIZE <= s; q += DFT_NATIVE_AVX2_CF_SIZE) {
+      __m256 a0 = dft_native_avx2_load(&x0[q]);
+      __m256 a1 = dft_native_avx2_load(&x1[q]);
+      dft_native_avx2_store(&y0[q], _mm256_add_ps(a0, a1));
+      dft_native_avx2_store(&y1[q], _MM256_PROD_PS(_mm256_sub_ps(a0, a1), w1));
+    }
+#endif /* LV_HAVE_AVX2 */
+
+    for (; q < s; q++) {
+      cf_t a0 = x0[q];
+      cf_t a1 = x1[q];
+      y0[q]   = a0 + a1;
+      y1[q]   = dft_native_prod(a0 - a1, tw[p]);
+    }
+  }
+}
+
+static void dft_native_stage_r3(const cf_t* tw, uint32_t m, uint32_t s, float sign, const cf_t* x, cf_t* y)
+{
+  float s3 = sign * DFT_NATIVE_SQRT3_2;
+
+#ifdef LV_HAVE_AVX2
+  __m256 mask = dft_native_avx2_mulj_mask(sign);
+  __m256 half = _mm256_set1_ps(0.5f);
+  __m256 s3v  = _mm256_set1_ps(DFT_NATIVE_SQRT3_2);
+#endif /* LV_HAVE_AVX2 */
+
+  for (uint32_t p = 0; p < m; p++) {
+    const cf_t* x0 = &x[s * p];
+    const cf_t* x1 = &x[s * (p + m)];
+    const cf_t* x2 = &x[s * (p + 2 * m)];
+    cf_t*       y0 = &y[s * 3 * p];
+    cf_t*       y1 = &y0[s];
+    cf_t*       y2 = &y1[s];
+    uint32_t    q  = 0;
+
+#ifdef LV_HAVE_AVX2
+    __m256 w1 = dft_native_avx2_set1(tw[p]);
+    __m256 w2 = dft_native_avx2_set1(tw[m + p]);
+    for (; q + DFT_NATIVE_AVX2_CF_SIZE <= s; q += DFT_NATIVE_AVX2_CF_SIZE) {
+      __m256 a0  = dft_native_avx2_load(&x0[q]);
+      __m256 a1  = dft_native_avx2_load(&x1[q]);
+      __m256 a2  = dft_native_avx2_load(&x2[q]);
+      __m256 s12 = _mm256_add_ps(a1, a2);
+      __m256 re  = _mm256_sub_ps(a0, _mm256_mul_ps(s12, half));
+      __m256 im  = _mm256_mul_ps(dft_native_avx2_mulj(_mm256_sub_ps(a1, a2), mask), s3v);
+      dft_native_avx2_store(&y0[q], _mm256_add_ps(a0, s12));
+      dft_native_avx2_store(&y1[q], _MM256_PROD_PS(_mm256_add_ps(re, im), w1));
+      dft_native_avx2_store(&y2[q], _MM256_PROD_PS(_mm256_sub_ps(re, im), w2));
+    }
+#endif /* LV_HAVE_AVX2 */
+
+    for (; q < s; q++) {
+      cf_t a0  = x0[q];
+      cf_t s12 = x1[q] + x2[q];
+      cf_t re  = a0 - 0.5f * s12;
+      cf_t im  = dft_native_mulj(x1[q] - x2[q], s3);
+      y0[q]    = a0 + s12;
+      y1[q]    = dft_native_prod(re + im, tw[p]);
+      y2[q]    = dft_native_prod(re - im, tw[m + p]);
+    }
+  }
+}
+
+#ifdef LV_HAVE_AVX2
+/*
+ * First radix 4 stage (s = 1), vectorised across four butterflies p instead. Their outputs y[4 * p + u] are the
+ * transpose of the four butterfly output registers
+ */
+static void dft_native_stage_r4_first_avx2(const cf_t* tw, uint32_t m, float sign, const cf_t* x, cf_t* y)
+{
+  __m256 mask = dft_native_avx2_mulj_mask(sign);
+
+  for (uint32_t p = 0; p < m; p += DFT_NATIVE_AVX2_CF_SIZE) {
+    __m256 a0 = dft_native_avx2_load(&x[p]);
+    __m256 a1 = dft_native_avx2_load(&x[p + m]);
+    __m256 a2 = dft_native_avx2_load(&x[p + 2 * m]);
+    __m256 a3 = dft_native_avx2_load(&x[p + 3 * m]);
+    __m256 t0 = _mm256_add_ps(a0, a2);
+    __m256 t1 = _mm256_sub_ps(a0, a2);
+    __m256 t2 = _mm256_add_ps(a1, a3);
+    __m256 t3 = dft_native_avx2_mulj(_mm256_sub_ps(a1, a3), mask);
+
+    __m256d b0 = _mm256_castps_pd(_mm256_add_ps(t0, t2));
+    __m256d b1 = _mm256_castps_pd(_MM256_PROD_PS(_mm256_add_ps(t1, t3), dft_native_avx2_load(&tw[p])));
+    __m256d b2 = _mm256_castps_pd(_MM256_PROD_PS(_mm256_sub_ps(t0, t2), dft_native_avx2_load(&tw[m + p])));
+    __m256d b3 = _mm256_castps_pd(_MM256_PROD_PS(_mm256_sub_ps(t1, t3), dft_native_avx2_load(&tw[2 * m + p])));
+
+    __m256d c0 = _mm256_unpacklo_pd(b0, b1);
+    __m256d c1 = _mm256_unpackhi_pd(b0, b1);
+    __m256d c2 = _mm256_unpacklo_pd(b2, b3);
+    __m256d c3 = _mm256_unpackhi_pd(b2, b3);
+    dft_native_avx2_store(&y[4 * p], _mm256_castpd_ps(_mm256_permute2f128_pd(c0, c2, 0x20)));
+    dft_native_avx2_store(&y[4 * p + 4], _mm256_castpd_ps(_mm256_permute2f128_pd(c1, c3, 0x20)));
+    dft_native_avx2_store(&y[4 * p + 8], _mm256_castpd_ps(_mm256_permute2f128_pd(c0, c2, 0x31)));
+    dft_native_avx2_store(&y[4 * p + 12], _mm256_castpd_ps(_mm256_permute2f128_pd(c1, c3, 0x31)));
+  }
+}
+#endif /* LV_HAVE_AVX2 */
+
+static void dft_native_stage_r4(const cf_t* tw, uint32_t m, uint32_t s, float sign, const cf_t* x, cf_t* y)
+{
+#ifdef LV_HAVE_AVX2
+  if (s == 1 && m % DFT_NATIVE_AVX2_CF_SIZE == 0) {
+    dft_native_stage_r4_first_avx2(tw, m, sign, x, y);
+    return;
+  }
+  __m256 mask = dft_native_avx2_mulj_mask(sign);
+#endif /* LV_HAVE_AVX2 */
+
+  for (uint32_t p = 0; p < m; p++) {
+    const cf_t* x0 = &x[s * p];
+    const cf_t* x1 = &x[s * (p + m)];
+    const cf_t* x2 = &x[s * (p + 2 * m)];
+    const cf_t* x3 = &x[s * (p + 3 * m)];
+    cf_t*       y0 = &y[s * 4 * p];
+    cf_t*       y1 = &y0[s];
+    cf_t*       y2 = &y1[s];
+    cf_t*       y3 = &y2[s];
+    uint32_t    q  = 0;
+
+#ifdef LV_HAVE_AVX2
+    __m256 w1 = dft_native_avx2_set1(tw[p]);
+    __m256 w2 = dft_native_avx2_set1(tw[m + p]);
+    __m256 w3 = dft_native_avx2_set1(tw[2 * m + p]);
+    for (; q + DFT_NATIVE_AVX2_CF_SIZE <= s; q += DFT_NATIVE_AVX2_CF_SIZE) {
+      __m256 a0 = dft_native_avx2_load(&x0[q]);
+      __m256 a1 = dft_native_avx2_load(&x1[q]);
+      __m256 a2 = dft_native_avx2_load(&x2[q]);
+      __m256 a3 = dft_native_avx2_load(&x3[q]);
+      __m256 t0 = _mm256_add_ps(a0, a2);
+      __m256 t1 = _mm256_sub_ps(a0, a2);
+      __m256 t2 = _mm256_add_ps(a1, a3);
+      __m256 t3 = dft_native_avx2_mulj(_mm256_sub_ps(a1, a3), mask);
+      dft_native_avx2_store(&y0[q], _mm256_add_ps(t0, t2));
+      dft_native_avx2_store(&y1[q], _MM256_PROD_PS(_mm256_add_ps(t1, t3), w1));
+      dft_native_avx2_store(&y2[q], _MM256_PROD_PS(_mm256_sub_ps(t0, t2), w2));
+      dft_native_avx2_store(&y3[q], _MM256_PROD_PS(_mm256_sub_ps(t1, t3), w3));
+    }
+#endif /* LV_HAVE_AVX2 */
+
+    for (; q < s; q++) {
+      cf_t t0 = x0[q] + x2[q];
+      cf_t t1 = x0[q] - x2[q];
+      cf_t t2 = x1[q] + x3[q];
+      cf_t t3 = dft_native_mulj(x1[q] - x3[q], sign);
+      y0[q]   = t0 + t2;
+      y1[q]   = dft_native_prod(t1 + t3, tw[p]);
+      y2[q]   = dft_native_prod(t0 - t2, tw[m + p]);
+      y3[q]   = dft_native_prod(t1 - t3, tw[2 * m + p]);
+    }
+  }
+}
+
+static void dft_native_stage_r5(const cf_t* tw, uint32_t m, uint32_t s, float sign, const cf_t* x, cf_t* y)
+{
+  float s1 = sign * DFT_NATIVE_SIN_2PI_5;
+  float s2 = sign * DFT_NATIVE_SIN_4PI_5;
+
+#ifdef LV_HAVE_AVX2
+  __m256 mask = dft_native_avx2_mulj_mask(sign);
+  __m256 c1v  = _mm256_set1_ps(DFT_NATIVE_COS_2PI_5);
+  __m256 c2v  = _mm256_set1_ps(DFT_NATIVE_COS_4PI_5);
+  __m256 s1v  = _mm256_set1_ps(DFT_NATIVE_SIN_2PI_5);
+  __m256 s2v  = _mm256_set1_ps(DFT_NATIVE_SIN_4PI_5);
+#endif /* LV_HAVE_AVX2 */
+
+  for (uint32_t p = 0; p < m; p++) {
+    const cf_t* x0 = &x[s * p];
+    const cf_t* x1 = &x[s * (p + m)];
+    const cf_t* x2 = &x[s * (p + 2 * m)];
+    const cf_t* x3 = &x[s * (p + 3 * m)];
+    const cf_t* x4 = &x[s * (p + 4 * m)];
+    cf_t*       y0 = &y[s * 5 * p];
+    cf_t*       y1 = &y0[s];
+    cf_t*       y2 = &y1[s];
+    cf_t*       y3 = &y2[s];
+    cf_t*       y4 = &y3[s];
+    uint32_t    q  = 0;
+
+#ifdef LV_HAVE_AVX2
+    __m256 w1 = dft_native_avx2_set1(tw[p]);
+    __m256 w2 = dft_native_avx2_set1(tw[m + p]);
+    __m256 w3 = dft_native_avx2_set1(tw[2 * m + p]);
+    __m256 w4 = dft_native_avx2_set1(tw[3 * m + p]);
+    for (; q + DFT_NATIVE_AVX2_CF_SIZE <= s; q += DFT_NATIVE_AVX2_CF_SIZE) {
+      __m256 a0  = dft_native_avx2_load(&x0[q]);
+      __m256 a1  = dft_native_avx2_load(&x1[q]);
+      __m256 a2  = dft_native_avx2_load(&x2[q]);
+      __m256 a3  = dft_native_avx2_load(&x3[q]);
+      __m256 a4  = dft_native_avx2_load(&x4[q]);
+      __m256 s14 = _mm256_add_ps(a1, a4);
+      __m256 d14 = dft_native_avx2_mulj(_mm256_sub_ps(a1, a4), mask);
+      __m256 s23 = _mm256_add_ps(a2, a3);
+      __m256 d23 = dft_native_avx2_mulj(_mm256_sub_ps(a2, a3), mask);
+      __m256 r1  = _mm256_add_ps(a0, _mm256_add_ps(_mm256_mul_ps(s14, c1v), _mm256_mul_ps(s23, c2v)));
+      __m256 r2  = _mm256_add_ps(a0, _mm256_add_ps(_mm256_mul_ps(s14, c2v), _mm256_mul_ps(s23, c1v)));
+      __m256 i1  = _mm256_add_ps(_mm256_mul_ps(d14, s1v), _mm256_mul_ps(d23, s2v));
+      __m256 i2  = _mm256_sub_ps(_mm256_mul_ps(d14, s2v), _mm256_mul_ps(d23, s1v));
+      dft_native_avx2_store(&y0[q], _mm256_add_ps(a0, _mm256_add_ps(s14, s23)));
+      dft_native_avx2_store(&y1[q], _MM256_PROD_PS(_mm256_add_ps(r1, i1), w1));
+      dft_native_avx2_store(&y2[q], _MM256_PROD_PS(_mm256_add_ps(r2, i2), w2));
+      dft_native_avx2_store(&y3[q], _MM256_PROD_PS(_mm256_sub_ps(r2, i2), w3));
+      dft_native_avx2_store(&y4[q], _MM256_PROD_PS(_mm256_sub_ps(r1, i1), w4));
+    }
+#endif /* LV_HAVE_AVX2 */
+
+    for (; q < s; q++) {
+      cf_t a0  = x0[q];
+      cf_t s14 = x1[q] + x4[q];
+      cf_t d14 = x1[q] - x4[q];
+      cf_t s23 = x2[q] + x3[q];
+      cf_t d23 = x2[q] - x3[q];
+      cf_t r1  = a0 + DFT_NATIVE_COS_2PI_5 * s14 + DFT_NATIVE_COS_4PI_5 * s23;
+      cf_t r2  = a0 + DFT_NATIVE_COS_4PI_5 * s14 + DFT_NATIVE_COS_2PI_5 * s23;
+      cf_t i1  = dft_native_mulj(s1 * d14 + s2 * d23, 1.0f);
+      cf_t i2  = dft_native_mulj(s2 * d14 - s1 * d23, 1.0f);
+      y0[q]    = a0 + s14 + s23;
+      y1[q]    = dft_native_prod(r1 + i1, tw[p]);
+      y2[q]    = dft_native_prod(r2 + i2, tw[m + p]);
+      y3[q]    = dft_native_prod(r2 - i2, tw[2 * m + p]);
+      y4[q]    = dft_native_prod(r1 - i1, tw[3 * m + p]);
+    }
+  }
+}
+
+bool srslte_dft_native_is_fast_size(uint32_t size)
+{
+  if (size == 0) {
+    return false;
+  }
+  while (size % 2 == 0) {
+    size /= 2;
+  }
+  while (size % 3 == 0) {
+    size /= 3;
+  }
+  while (size % 5 == 0) {
+    size /= 5;
+  }
+  return size == 1;
+}
+
+static void dft_native_kernel_free(srslte_dft_native_kernel_t* k)
+{
+  for (uint32_t i = 0; i < k->nof_stages; i++) {
+    if (k->twiddle[i]) {
+      free(k->twiddle[i]);
+    }
+  }
+  if (k->work) {
+    free(k->work);
+  }
+  memset(k, 0, sizeof(srslte_dft_native_kernel_t));
+}
+
+static int dft_native_kernel_init(srslte_dft_native_kernel_t* k, uint32_t size, bool forward)
+{
+  static const uint32_t radices[] = {4, 2, 3, 5};
+
+  memset(k, 0, sizeof(srslte_dft_native_kernel_t));
+  k->size    = size;
+  k->forward = forward;
+
+  // Factorize the size, radix 4 first since it has the cheapest butterfly per point
+  uint32_t n = size;
+  for (uint32_t i = 0; i < sizeof(radices) / sizeof(radices[0]); i++) {
+    while (n % radices[i] == 0 && k->nof_stages < SRSLTE_DFT_NATIVE_MAX_STAGES) {
+      k->radix[k->nof_stages++] = radices[i];
+      n /= radices[i];
+    }
+  }
+  if (n != 1) {
+    ERROR("Error native DFT size %d is not a product of 2, 3 and 5\n", size);
+    return SRSLTE_ERROR;
+  }
+
+  k->work = srslte_vec_cf_malloc(size);
+  if (!k->work) {
+    return SRSLTE_ERROR;
+  }
+
+  // The twiddles of the stage of length n are w_n^(p*u) for the m butterflies p and their r - 1 outputs u > 0
+  double sign = forward ? -1.0 : +1.0;
+  n           = size;
+  for (uint32_t i = 0; i < k->nof_stages; i++) {
+    uint32_t r = k->radix[i];
+    uint32_t m = n / r;
+
+    k->twiddle[i] = srslte_vec_cf_malloc(m * (r - 1));
+    if (!k->twiddle[i]) {
+      dft_native_kernel_free(k);
+      return SRSLTE_ERROR;
+    }
+    for (uint32_t p = 0; p < m; p++) {
+      for (uint32_t u = 1; u < r; u++) {
+        double arg                     = sign * 2.0 * M_PI * (double)(p * u) / (double)n;
+        k->twiddle[i][(u - 1) * m + p] = (float)cos(arg) + (float)sin(arg) * I;
+      }
+    }
+    n = m;
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+static void dft_native_kernel_run(srslte_dft_native_kernel_t* k, const cf_t* in, cf_t* out)
+{
+  float sign = k->forward ? -1.0f : +1.0f;
+
+  if (k->nof_stages == 0) {
+    if (in != out) {
+      memcpy(out, in, sizeof(cf_t) * k->size);
+    }
+    return;
+  }
+
+  // Stockham stages are out of place, so they ping-pong between the output and the work buffer, starting on the one
+  // that makes the last stage write the output
+  const cf_t* src = in;
+  cf_t*       dst = (k->nof_stages % 2) ? out : k->work;
+  if (src == dst) {
+    memcpy(k->work, in, sizeof(cf_t) * k->size);
+    src = k->work;
+  }
+
+  uint32_t m = k->size;
+  uint32_t s = 1;
+  for (uint32_t i = 0; i < k->nof_stages; i++) {
+    uint32_t r = k->radix[i];
+    m /= r;
+    switch (r) {
+      case 2:
+        dft_native_stage_r2(k->twiddle[i], m, s, src, dst);
+        break;
+      case 3:
+        dft_native_stage_r3(k->twiddle[i], m, s, sign, src, dst);
+        break;
+      case 4:
+        dft_native_stage_r4(k->twiddle[i], m, s, sign, src, dst);
+        break;
+      default:
+        dft_native_stage_r5(k->twiddle[i], m, s, sign, src, dst);
+        break;
+    }
+    s *= r;
+    src = dst;
+    dst = (dst == out) ? k->work : out;
+  }
+}
+
+/*
+ * Bluestein's algorithm writes the DFT as the convolution of the input times the chirp w_n = exp(-j*pi*n^2/N) with
+ * the conjugated chirp, which is done with fast transforms of the next 2^a*3^b*5^c size of at least 2N - 1
+ */
+static int dft_native_bluestein_init(srslte_dft_native_t* q)
+{
+  uint32_t N = q->size;
+  uint32_t M = 2 * N - 1;
+  while (!srslte_dft_native_is_fast_size(M)) {
+    M++;
+  }
+
+  if (dft_native_kernel_init(&q->kernel, M, true) || dft_native_kernel_init(&q->kernel_inv, M, false)) {
+    return SRSLTE_ERROR;
+  }
+
+  q->chirp     = srslte_vec_cf_malloc(N);
+  q->chirp_fft = srslte_vec_cf_malloc(M);
+  q->conv      = srslte_vec_cf_malloc(M);
+  if (!q->chirp || !q->chirp_fft || !q->conv) {
+    return SRSLTE_ERROR;
+  }
+
+  // n^2 is reduced modulo 2N to keep the chirp accurate for long sequences
+  double sign = q->forward ? -1.0 : +1.0;
+  for (uint32_t n = 0; n < N; n++) {
+    double arg  = sign * M_PI * (double)(((uint64_t)n * n) % (2 * N)) / (double)N;
+    q->chirp[n] = (float)cos(arg) + (float)sin(arg) * I;
+  }
+
+  srslte_vec_cf_zero(q->chirp_fft, M);
+  q->chirp_fft[0] = conjf(q->chirp[0]);
+  for (uint32_t n = 1; n < N; n++) {
+    q->chirp_fft[n]     = conjf(q->chirp[n]);
+    q->chirp_fft[M - n] = conjf(q->chirp[n]);
+  }
+  dft_native_kernel_run(&q->kernel, q->chirp_fft, q->chirp_fft);
+  srslte_vec_sc_prod_cfc(q->chirp_fft, 1.0f / M, q->chirp_fft, M);
+
+  return SRSLTE_SUCCESS;
+}
+
+int srslte_dft_native_init(srslte_dft_native_t* q, uint32_t size, bool forward)
+{
+  if (q == NULL || size == 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  memset(q, 0, sizeof(srslte_dft_native_t));
+  q->size      = size;
+  q->forward   = forward;
+  q->bluestein = !srslte_dft_native_is_fast_size(size);
+
+  int ret = q->bluestein ? dft_native_bluestein_init(q) : dft_native_kernel_init(&q->kernel, size, forward);
+  if (ret != SRSLTE_SUCCESS) {
+    srslte_dft_native_free(q);
+  }
+  return ret;
+}
+
+void srslte_dft_native_free(srslte_dft_native_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+  dft_native_kernel_free(&q->kernel);
+  dft_native_kernel_free(&q->kernel_inv);
+  if (q->chirp) {
+    free(q->chirp);
+  }
+  if (q->chirp_fft) {
+    free(q->chirp_fft);
+  }
+  if (q->conv) {
+    free(q->conv);
+  }
+  memset(q, 0, sizeof(srslte_dft_native_t));
+}
+
+void srslte_dft_native_run(srslte_dft_native_t* q, const cf_t* in, cf_t* out)
+{
+  if (!q->bluestein) {
+    dft_native_kernel_run(&q->kernel, in, out);
+    return;
+  }
+
+  uint32_t N = q->size;
+  uint32_t M = q->kernel.size;
+
+  srslte_vec_prod_ccc(in, q->chirp, q->conv, N);
+  srslte_vec_cf_zero(&q->conv[N], M - N);
+  dft_native_kernel_run(&q->kernel, q->conv, q->conv);
+  srslte_vec_prod_ccc(q->conv, q->chirp_fft, q->conv, M);
+  dft_native_kernel_run(&q->kernel_inv, q->conv, q->conv);
+  srslte_vec_prod_ccc(q->conv, q->chirp, out, N);
+}
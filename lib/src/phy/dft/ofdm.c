@@ -93,11 +93,8 @@ static int ofdm_init_mbsfn_(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg, srslte_dft
       free(q->shift_buffer);
     }
 
-#ifdef AVOID_GURU
-    q->tmp = srslte_vec_cf_malloc(symbol_sz);
-#else
+    // Besides the symbols of a slot, it holds the input and output symbols of the MBSFN region
     q->tmp = srslte_vec_cf_malloc(q->sf_sz);
-#endif /* AVOID_GURU */
     if (!q->tmp) {
       perror("malloc");
       return SRSLTE_ERROR;
@@ -127,15 +124,12 @@ static int ofdm_init_mbsfn_(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg, srslte_dft
   int cp1 = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(0, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
   int cp2 = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(1, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
 
-  // Slides DFT window a fraction of cyclic prefix, it does not apply for the inverse-DFT
-  if (isnormal(cfg->rx_window_offset)) {
-    cfg->rx_window_offset = SRSLTE_MAX(0, cfg->rx_window_offset);   // Needs to be positive
-    cfg->rx_window_offset = SRSLTE_MIN(100, cfg->rx_window_offset); // Needs to be below 100
-    q->window_offset_n = (uint32_t)roundf((float)cp2 * cfg->rx_window_offset);
-
-    for (uint32_t i = 0; i < symbol_sz; i++) {
-      q->window_offset_buffer[i] = cexpf(I * M_PI * 2.0f * (float)q->window_offset_n * (float)i / (float)symbol_sz);
-    }
+  // Slides DFT window a fraction of cyclic prefix, it does not apply for the inverse-DFT. The window is kept when the
+  // number of PRB changes, in proportion to the new cyclic prefix
+  if (isnormal(q->cfg.rx_window_offset)) {
+    q->cfg.rx_window_offset = SRSLTE_MAX(0, q->cfg.rx_window_offset);   // Needs to be positive
+    q->cfg.rx_window_offset = SRSLTE_MIN(100, q->cfg.rx_window_offset); // Needs to be below 100
+    q->window_offset_n      = (uint32_t)roundf((float)cp2 * q->cfg.rx_window_offset);
   }
 
   // Zero temporal and input buffers always
@@ -206,8 +200,8 @@ static int ofdm_init_mbsfn_(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg, srslte_dft
   }
 
   // Set other parameters
-  srslte_ofdm_set_freq_shift(q, q->cfg.freq_shift_f);
   srslte_dft_plan_set_norm(&q->fft_plan, q->cfg.normalize);
+  srslte_ofdm_set_freq_shift(q, q->cfg.freq_shift_f);
 
   return SRSLTE_SUCCESS;
 }
@@ -332,36 +326,58 @@ void srslte_ofdm_rx_free(srslte_ofdm_t* q)
   srslte_ofdm_free_(q);
 }
 
-/* Shifts the signal after the iFFT or before the FFT.
- * Freq_shift is relative to inter-carrier spacing.
- * Caution: This function shall not be called during run-time
+/* Computes the factors applied to the samples while they are copied in and out of the DFT buffers, so the frequency
+ * shift, the DFT window offset and the normalization do not take extra passes over the subframe:
+ *  - shift_buffer: time domain frequency shift of each sample of the subframe, CP included. In Tx it also carries the
+ *    normalization, as it is applied right after the inverse DFT
+ *  - window_offset_buffer: Rx only, phase of the DFT window offset and normalization of each subcarrier, in the
+ *    output order
  */
-int srslte_ofdm_set_freq_shift(srslte_ofdm_t* q, float freq_shift)
+static void ofdm_set_phase(srslte_ofdm_t* q)
 {
-  q->cfg.freq_shift_f = freq_shift;
-
-  // Check if fft shift is required
-  if (!isnormal(q->cfg.freq_shift_f)) {
-    srslte_dft_plan_set_dc(&q->fft_plan, true);
-    return SRSLTE_SUCCESS;
-  }
-
   uint32_t    symbol_sz = q->cfg.symbol_sz;
   srslte_cp_t cp        = q->cfg.cp;
+  float       norm      = q->fft_plan.norm ? 1.0f / sqrtf((float)symbol_sz) : 1.0f;
+  uint32_t    dc        = q->fft_plan.dc ? 1 : 0;
 
-  cf_t* ptr = q->shift_buffer;
-  for (uint32_t n = 0; n < SRSLTE_NOF_SLOTS_PER_SF; n++) {
-    for (uint32_t i = 0; i < q->nof_symbols; i++) {
-      uint32_t cplen = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
-      for (uint32_t t = 0; t < symbol_sz + cplen; t++) {
-        ptr[t] = cexpf(I * 2 * M_PI * ((float)t - (float)cplen) * freq_shift / symbol_sz);
+  // The subcarriers mapped in Tx depend on the DC carrier, zero the ones no longer written
+  srslte_vec_cf_zero(q->tmp, q->sf_sz);
+
+  if (isnormal(q->cfg.freq_shift_f)) {
+    float tx_norm = q->fft_plan.forward ? 1.0f : norm;
+    cf_t* ptr     = q->shift_buffer;
+    for (uint32_t n = 0; n < SRSLTE_NOF_SLOTS_PER_SF; n++) {
+      for (uint32_t i = 0; i < q->nof_symbols; i++) {
+        uint32_t cplen = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
+        for (uint32_t t = 0; t < symbol_sz + cplen; t++) {
+          ptr[t] = tx_norm * cexpf(I * 2 * M_PI * ((float)t - (float)cplen) * q->cfg.freq_shift_f / symbol_sz);
+        }
+        ptr += symbol_sz + cplen;
       }
-      ptr += symbol_sz + cplen;
     }
   }
 
-  /* Disable DC carrier addition */
-  srslte_dft_plan_set_dc(&q->fft_plan, false);
+  if (q->fft_plan.forward) {
+    for (uint32_t k = 0; k < q->nof_re; k++) {
+      uint32_t i = (k < q->nof_re / 2) ? symbol_sz - q->nof_re / 2 + k : dc + k - q->nof_re / 2;
+      q->window_offset_buffer[k] =
+          norm * cexpf(I * M_PI * 2.0f * (float)q->window_offset_n * (float)i / (float)symbol_sz);
+    }
+  }
+}
+
+/* Shifts the signal after the iFFT or before the FFT.
+ * Freq_shift is relative to inter-carrier spacing.
+ * Caution: This function shall not be called during run-time
+ */
+int srslte_ofdm_set_freq_shift(srslte_ofdm_t* q, float freq_shift)
+{
+  q->cfg.freq_shift_f = freq_shift;
+
+  // Disable DC carrier addition if fft shift is required
+  srslte_dft_plan_set_dc(&q->fft_plan, !isnormal(q->cfg.freq_shift_f));
+
+  ofdm_set_phase(q);
 
   return SRSLTE_SUCCESS;
 }
@@ -402,22 +418,21 @@ static void ofdm_rx_slot(srslte_ofdm_t* q, int slot_in_sf)
   float norm = 1.0f / sqrtf(q->fft_plan.size);
   cf_t* tmp = q->tmp;
   uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
+  cf_t* post = q->window_offset_buffer;
 
   srslte_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
 
   for (int i = 0; i < q->nof_symbols; i++) {
-    // Apply frequency domain window offset
+    // Perform FFT shift, applying the frequency domain window offset and normalization in the same pass
     if (q->window_offset_n) {
-      srslte_vec_prod_ccc(tmp, q->window_offset_buffer, tmp, symbol_sz);
-    }
-
-    // Perform FFT shift
-    memcpy(output, tmp + symbol_sz - nof_re / 2, sizeof(cf_t) * nof_re / 2);
-    memcpy(output + nof_re / 2, &tmp[dc], sizeof(cf_t) * nof_re / 2);
-
-    // Normalize output
-    if (q->fft_plan.norm) {
-      srslte_vec_sc_prod_cfc(output, norm, output, nof_re);
+      srslte_vec_prod_ccc(tmp + symbol_sz - nof_re / 2, post, output, nof_re / 2);
+      srslte_vec_prod_ccc(&tmp[dc], &post[nof_re / 2], output + nof_re / 2, nof_re / 2);
+    } else if (q->fft_plan.norm) {
+      srslte_vec_sc_prod_cfc(tmp + symbol_sz - nof_re / 2, norm, output, nof_re / 2);
+      srslte_vec_sc_prod_cfc(&tmp[dc], norm, output + nof_re / 2, nof_re / 2);
+    } else {
+      memcpy(output, tmp + symbol_sz - nof_re / 2, sizeof(cf_t) * nof_re / 2);
+      memcpy(output + nof_re / 2, &tmp[dc], sizeof(cf_t) * nof_re / 2);
     }
 
     tmp += symbol_sz;
@@ -486,6 +501,42 @@ void srslte_ofdm_rx_sf_ng(srslte_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
+/* Maps the subcarriers of an OFDM symbol to the inverse-DFT input, FFT shift included. The guard subcarriers are zeroed
+ * by ofdm_set_phase() and never written
+ */
+static inline void ofdm_tx_map_symbol(srslte_ofdm_t* q, const cf_t* input, cf_t* tmp)
+{
+  uint32_t symbol_sz = q->cfg.symbol_sz;
+  uint32_t nof_re    = q->nof_re;
+  uint32_t dc        = (q->fft_plan.dc) ? 1 : 0;
+
+  memcpy(&tmp[dc], &input[nof_re / 2], nof_re / 2 * sizeof(cf_t));
+  memcpy(&tmp[symbol_sz - nof_re / 2], &input[0], nof_re / 2 * sizeof(cf_t));
+}
+
+/* Writes an inverse-DFT output symbol and its CP, applying the frequency shift and normalization in the same pass. The
+ * symbol may already be in place, right after the CP
+ */
+static inline void ofdm_tx_put_symbol(srslte_ofdm_t* q, const cf_t* symbol, const cf_t* phase, int cp_len, cf_t* output)
+{
+  uint32_t symbol_sz = q->cfg.symbol_sz;
+
+  // The CP is taken from the end of the symbol before it is modified
+  if (isnormal(q->cfg.freq_shift_f)) {
+    srslte_vec_prod_ccc(&symbol[symbol_sz - cp_len], phase, output, cp_len);
+    srslte_vec_prod_ccc(symbol, &phase[cp_len], &output[cp_len], symbol_sz);
+  } else if (q->fft_plan.norm) {
+    float norm = 1.0f / sqrtf(symbol_sz);
+    srslte_vec_sc_prod_cfc(&symbol[symbol_sz - cp_len], norm, output, cp_len);
+    srslte_vec_sc_prod_cfc(symbol, norm, &output[cp_len], symbol_sz);
+  } else {
+    memcpy(output, &symbol[symbol_sz - cp_len], cp_len * sizeof(cf_t));
+    if (symbol != &output[cp_len]) {
+      memcpy(&output[cp_len], symbol, symbol_sz * sizeof(cf_t));
+    }
+  }
+}
+
 /* Transforms input OFDM symbols into output samples.
  * Performs FFT on a each symbol and adds CP.
  */
@@ -509,59 +560,59 @@ static void ofdm_tx_slot(srslte_ofdm_t* q, int slot_in_sf)
   }
 #else
   uint32_t nof_symbols = q->nof_symbols;
-  uint32_t nof_re = q->nof_re;
-  float norm = 1.0f / sqrtf(symbol_sz);
-  cf_t* tmp = q->tmp;
-
-  bzero(tmp, q->slot_sz);
-  uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
+  cf_t*    tmp         = q->tmp;
+  cf_t*    phase       = q->shift_buffer + slot_in_sf * q->slot_sz;
 
   for (int i = 0; i < nof_symbols; i++) {
-    memcpy(&tmp[dc], &input[nof_re / 2], nof_re / 2 * sizeof(cf_t));
-    memcpy(&tmp[symbol_sz - nof_re / 2], &input[0], nof_re / 2 * sizeof(cf_t));
-
-    input += nof_re;
+    ofdm_tx_map_symbol(q, input, tmp);
+    input += q->nof_re;
     tmp += symbol_sz;
   }
 
+  // The inverse DFT writes every symbol after its CP, straight in the output buffer
   srslte_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
 
   for (int i = 0; i < nof_symbols; i++) {
     int cp_len = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
-
-    if (q->fft_plan.norm) {
-      srslte_vec_sc_prod_cfc(&output[cp_len], norm, &output[cp_len], symbol_sz);
-    }
-
-    /* add CP */
-    memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
+    ofdm_tx_put_symbol(q, &output[cp_len], phase, cp_len, output);
     output += symbol_sz + cp_len;
+    phase += symbol_sz + cp_len;
   }
 #endif
 }
 
-void ofdm_tx_slot_mbsfn(srslte_ofdm_t* q, cf_t* input, cf_t* output)
+/* Transforms the MBSFN slot of a subframe, one symbol at a time. The symbols are transformed in the scratch symbols
+ * after the ones of the Guru DFT, so they do not overwrite their guard subcarriers, and the CP, frequency shift and
+ * normalization are applied while they are copied to the output
+ */
+static void ofdm_tx_slot_mbsfn(srslte_ofdm_t* q, cf_t* input, cf_t* output)
 {
   uint32_t symbol_sz = q->cfg.symbol_sz;
+  cf_t*    tmp_in    = q->tmp + q->nof_symbols * symbol_sz;
+  cf_t*    tmp_out   = tmp_in + symbol_sz;
+  cf_t*    phase     = q->shift_buffer;
 
   for (uint32_t i = 0; i < q->nof_symbols_mbsfn; i++) {
     int cp_len = (i > (q->non_mbsfn_region - 1)) ? SRSLTE_CP_LEN_EXT(symbol_sz) : SRSLTE_CP_LEN_NORM(i, symbol_sz);
-    memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
-    srslte_dft_run_c(&q->fft_plan, q->tmp, &output[cp_len]);
+    ofdm_tx_map_symbol(q, input, tmp_in);
+    srslte_dft_run_c_zerocopy(&q->fft_plan, tmp_in, tmp_out);
+    ofdm_tx_put_symbol(q, tmp_out, phase, cp_len, output);
     input += q->nof_re;
-    /* add CP */
-    memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
     output += symbol_sz + cp_len;
+    phase += symbol_sz + cp_len;
 
     /*skip the small section between the non mbms region and the mbms region*/
-    if (i == (q->non_mbsfn_region - 1))
+    if (i == (q->non_mbsfn_region - 1)) {
       output += SRSLTE_NON_MBSFN_REGION_GUARD_LENGTH(q->non_mbsfn_region, symbol_sz);
+      phase += SRSLTE_NON_MBSFN_REGION_GUARD_LENGTH(q->non_mbsfn_region, symbol_sz);
+    }
   }
 }
 
 void srslte_ofdm_set_normalize(srslte_ofdm_t* q, bool normalize_enable)
 {
   srslte_dft_plan_set_norm(&q->fft_plan, normalize_enable);
+  ofdm_set_phase(q);
 }
 
 void srslte_ofdm_tx_sf(srslte_ofdm_t* q)
@@ -575,7 +626,4 @@ void srslte_ofdm_tx_sf(srslte_ofdm_t* q)
     ofdm_tx_slot_mbsfn(q, q->cfg.in_buffer, q->cfg.out_buffer);
     ofdm_tx_slot(q, 1);
   }
-  if (isnormal(q->cfg.freq_shift_f)) {
-    srslte_vec_prod_ccc(q->cfg.out_buffer, q->shift_buffer, q->cfg.out_buffer, q->sf_sz);
-  }
 }
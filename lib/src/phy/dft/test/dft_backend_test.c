@@ -0,0 +1,171 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/common/test_common.h"
+#include "srslte/phy/utils/random.h"
+#include "srslte/srslte.h"
+
+// OFDM symbol sizes, PRACH sequence lengths (Bluestein in the native backend) and the 20 MHz PRACH IFFT size. The
+// DFT-precoding sizes are added from the valid PUSCH allocations
+static const uint32_t fixed_sizes[] = {128, 256, 384, 512, 768, 1024, 1536, 2048, 139, 839, 24576};
+
+static int nof_repetitions = 1000;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s\n", prog);
+  printf("\t-r nof_repetitions [Default %d]\n", nof_repetitions);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "r")) != -1) {
+    switch (opt) {
+      case 'r':
+        nof_repetitions = (int)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static float elapsed_us(struct timeval t[3])
+{
+  get_time_interval(t);
+  return (float)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+}
+
+/*
+ * Plans a forward and a backward transform of the given size with the backend, reports the time it takes to create
+ * them and to run them, and checks that they invert each other. The forward output is left in fwd_out
+ */
+static int test_backend(srslte_dft_backend_t backend, uint32_t size, const cf_t* input, cf_t* fwd_out, cf_t* bwd_out)
+{
+  srslte_dft_plan_t fwd = {}, bwd = {};
+  struct timeval    t[3];
+
+  TESTASSERT(srslte_dft_set_backend(backend) == SRSLTE_SUCCESS);
+
+  gettimeofday(&t[1], NULL);
+  TESTASSERT(srslte_dft_plan_c(&fwd, size, SRSLTE_DFT_FORWARD) == SRSLTE_SUCCESS);
+  TESTASSERT(srslte_dft_plan_c(&bwd, size, SRSLTE_DFT_BACKWARD) == SRSLTE_SUCCESS);
+  gettimeofday(&t[2], NULL);
+  float plan_us = elapsed_us(t);
+  TESTASSERT(fwd.backend == backend && bwd.backend == backend);
+
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < nof_repetitions; i++) {
+    srslte_dft_run_c(&fwd, input, fwd_out);
+  }
+  gettimeofday(&t[2], NULL);
+  float fwd_us = elapsed_us(t) / nof_repetitions;
+
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < nof_repetitions; i++) {
+    srslte_dft_run_c(&bwd, fwd_out, bwd_out);
+  }
+  gettimeofday(&t[2], NULL);
+  float bwd_us = elapsed_us(t) / nof_repetitions;
+
+  srslte_vec_sc_prod_cfc(bwd_out, 1.0f / size, bwd_out, size);
+  srslte_vec_sub_ccc(input, bwd_out, bwd_out, size);
+  float error = sqrtf(srslte_vec_avg_power_cf(bwd_out, size));
+
+  printf("%6s N=%5d; plan %9.1f us; forward %8.2f us; backward %8.2f us; %7.1f Msps; error=%.2e\n",
+         srslte_dft_backend_string(backend),
+         size,
+         plan_us,
+         fwd_us,
+         bwd_us,
+         2 * size / (fwd_us + bwd_us),
+         error);
+  TESTASSERT(error < 1e-4f);
+
+  srslte_dft_plan_free(&fwd);
+  srslte_dft_plan_free(&bwd);
+
+  return SRSLTE_SUCCESS;
+}
+
+static int test_size(srslte_random_t random_gen, uint32_t size, bool have_fftw)
+{
+  cf_t* input      = srslte_vec_cf_malloc(size);
+  cf_t* fftw_out   = srslte_vec_cf_malloc(size);
+  cf_t* native_out = srslte_vec_cf_malloc(size);
+  cf_t* bwd_out    = srslte_vec_cf_malloc(size);
+  TESTASSERT(input != NULL && fftw_out != NULL && native_out != NULL && bwd_out != NULL);
+
+  srslte_random_uniform_complex_dist_vector(random_gen, input, size, -1.0f, +1.0f);
+
+  TESTASSERT(test_backend(SRSLTE_DFT_BACKEND_NATIVE, size, input, native_out, bwd_out) == SRSLTE_SUCCESS);
+
+  // Both backends must give the same transform, the error is relative to the output amplitude sqrt(N)
+  if (have_fftw) {
+    TESTASSERT(test_backend(SRSLTE_DFT_BACKEND_FFTW, size, input, fftw_out, bwd_out) == SRSLTE_SUCCESS);
+    srslte_vec_sub_ccc(fftw_out, native_out, native_out, size);
+    float error = sqrtf(srslte_vec_avg_power_cf(native_out, size) / size);
+    TESTASSERT(error < 1e-5f);
+  }
+
+  free(input);
+  free(fftw_out);
+  free(native_out);
+  free(bwd_out);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslte_random_t      random_gen      = srslte_random_init(0);
+  srslte_dft_backend_t default_backend = srslte_dft_get_backend();
+  bool                 have_fftw       = srslte_dft_set_backend(SRSLTE_DFT_BACKEND_FFTW) == SRSLTE_SUCCESS;
+
+  parse_args(argc, argv);
+
+  printf("Default backend %s\n", srslte_dft_backend_string(default_backend));
+
+  for (uint32_t i = 0; i < sizeof(fixed_sizes) / sizeof(fixed_sizes[0]); i++) {
+    TESTASSERT(test_size(random_gen, fixed_sizes[i], have_fftw) == SRSLTE_SUCCESS);
+  }
+
+  for (uint32_t nof_prb = 1; nof_prb <= SRSLTE_MAX_PRB; nof_prb++) {
+    if (srslte_dft_precoding_valid_prb(nof_prb)) {
+      TESTASSERT(test_size(random_gen, nof_prb * SRSLTE_NRE, have_fftw) == SRSLTE_SUCCESS);
+    }
+  }
+
+  TESTASSERT(srslte_dft_set_backend(default_backend) == SRSLTE_SUCCESS);
+  srslte_random_free(random_gen);
+
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
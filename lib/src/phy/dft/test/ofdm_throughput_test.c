@@ -0,0 +1,262 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/common/test_common.h"
+#include "srslte/phy/utils/random.h"
+#include "srslte/srslte.h"
+
+static const uint32_t bandwidths[] = {6, 15, 25, 50, 75, 100};
+
+static int nof_repetitions = 1000;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s\n", prog);
+  printf("\t-r nof_repetitions [Default %d]\n", nof_repetitions);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "r")) != -1) {
+    switch (opt) {
+      case 'r':
+        nof_repetitions = (int)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static float elapsed_us(struct timeval t[3])
+{
+  get_time_interval(t);
+  return (float)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+}
+
+/*
+ * Modulates and demodulates subframes with the DL configuration (no frequency shift) or the UL one (half subcarrier
+ * shift and normalization, as srslte_ue_ul and srslte_enb_ul use it) and reports the throughput of each direction
+ */
+static int test_throughput(srslte_random_t random_gen, uint32_t nof_prb, bool ul)
+{
+  srslte_ofdm_t  ifft = {}, fft = {};
+  struct timeval t[3];
+  float          tx_us = 0.0f, rx_us = 0.0f;
+
+  uint32_t symbol_sz = (uint32_t)srslte_symbol_sz(nof_prb);
+  uint32_t nof_re    = SRSLTE_SF_LEN_RE(nof_prb, SRSLTE_CP_NORM);
+  uint32_t sf_len    = SRSLTE_SF_LEN(symbol_sz);
+
+  cf_t* input   = srslte_vec_cf_malloc(nof_re);
+  cf_t* samples = srslte_vec_cf_malloc(sf_len);
+  cf_t* output  = srslte_vec_cf_malloc(nof_re);
+  TESTASSERT(input != NULL && samples != NULL && output != NULL);
+
+  srslte_ofdm_cfg_t ofdm_cfg = {};
+  ofdm_cfg.cp                = SRSLTE_CP_NORM;
+  ofdm_cfg.in_buffer         = input;
+  ofdm_cfg.out_buffer        = samples;
+  ofdm_cfg.nof_prb           = nof_prb;
+  ofdm_cfg.freq_shift_f      = ul ? 0.5f : 0.0f;
+  ofdm_cfg.normalize         = ul;
+  TESTASSERT(srslte_ofdm_tx_init_cfg(&ifft, &ofdm_cfg) == SRSLTE_SUCCESS);
+
+  ofdm_cfg.in_buffer    = samples;
+  ofdm_cfg.out_buffer   = output;
+  ofdm_cfg.freq_shift_f = -ofdm_cfg.freq_shift_f;
+  TESTASSERT(srslte_ofdm_rx_init_cfg(&fft, &ofdm_cfg) == SRSLTE_SUCCESS);
+
+  srslte_random_uniform_complex_dist_vector(random_gen, input, nof_re, -1.0f, +1.0f);
+
+  // The Rx removes the frequency shift in its input buffer, so every Rx subframe needs a new Tx one
+  for (int i = 0; i < nof_repetitions; i++) {
+    gettimeofday(&t[1], NULL);
+    srslte_ofdm_tx_sf(&ifft);
+    gettimeofday(&t[2], NULL);
+    tx_us += elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    srslte_ofdm_rx_sf(&fft);
+    gettimeofday(&t[2], NULL);
+    rx_us += elapsed_us(t);
+  }
+
+  // The normalized chain returns the input, the other one scales it by the symbol size
+  if (!ul) {
+    srslte_vec_sc_prod_cfc(output, 1.0f / symbol_sz, output, nof_re);
+  }
+  srslte_vec_sub_ccc(input, output, output, nof_re);
+  float mse = sqrtf(srslte_vec_avg_power_cf(output, nof_re));
+
+  printf("%s nof_prb=%3d; symbol_sz=%4d; Tx %6.1f us/sf %6.1f Msps; Rx %6.1f us/sf %6.1f Msps; MSE=%.6f\n",
+         ul ? "UL" : "DL",
+         nof_prb,
+         symbol_sz,
+         tx_us / nof_repetitions,
+         sf_len * nof_repetitions / tx_us,
+         rx_us / nof_repetitions,
+         sf_len * nof_repetitions / rx_us,
+         mse);
+  TESTASSERT(mse < 0.0001f);
+
+  srslte_ofdm_tx_free(&ifft);
+  srslte_ofdm_rx_free(&fft);
+  free(input);
+  free(samples);
+  free(output);
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Modulates MBSFN subframes, whose first slot is transformed one symbol at a time, and checks that the second slot
+ * still has its guard subcarriers at zero. With the frequency shift and normalization the subframe is demodulated back
+ */
+static int test_mbsfn(srslte_random_t random_gen, uint32_t nof_prb)
+{
+  srslte_ofdm_t     ifft = {}, ifft_shift = {}, fft_shift = {};
+  srslte_dft_plan_t fft  = {};
+  struct timeval    t[3];
+  float             tx_us = 0.0f;
+
+  uint32_t symbol_sz = (uint32_t)srslte_symbol_sz(nof_prb);
+  uint32_t nof_sc    = nof_prb * SRSLTE_NRE;
+  uint32_t nof_re    = SRSLTE_SF_LEN_RE(nof_prb, SRSLTE_CP_NORM);
+  uint32_t sf_len    = SRSLTE_SF_LEN(symbol_sz);
+  uint32_t slot_len  = SRSLTE_SLOT_LEN(symbol_sz);
+
+  cf_t* input         = srslte_vec_cf_malloc(nof_re);
+  cf_t* samples       = srslte_vec_cf_malloc(sf_len);
+  cf_t* samples_shift = srslte_vec_cf_malloc(sf_len);
+  cf_t* output        = srslte_vec_cf_malloc(nof_re);
+  cf_t* symbol        = srslte_vec_cf_malloc(symbol_sz);
+  TESTASSERT(input != NULL && samples != NULL && samples_shift != NULL && output != NULL && symbol != NULL);
+
+  // The gap between the non-MBSFN region and the MBSFN region is never written
+  srslte_vec_cf_zero(samples, sf_len);
+  srslte_vec_cf_zero(samples_shift, sf_len);
+
+  srslte_ofdm_cfg_t ofdm_cfg = {};
+  ofdm_cfg.cp                = SRSLTE_CP_NORM;
+  ofdm_cfg.in_buffer         = input;
+  ofdm_cfg.out_buffer        = samples;
+  ofdm_cfg.nof_prb           = nof_prb;
+  ofdm_cfg.sf_type           = SRSLTE_SF_MBSFN;
+  ofdm_cfg.normalize         = true;
+  TESTASSERT(srslte_ofdm_tx_init_cfg(&ifft, &ofdm_cfg) == SRSLTE_SUCCESS);
+
+  ofdm_cfg.out_buffer   = samples_shift;
+  ofdm_cfg.freq_shift_f = 0.5f;
+  TESTASSERT(srslte_ofdm_tx_init_cfg(&ifft_shift, &ofdm_cfg) == SRSLTE_SUCCESS);
+
+  ofdm_cfg.in_buffer    = samples_shift;
+  ofdm_cfg.out_buffer   = output;
+  ofdm_cfg.freq_shift_f = -0.5f;
+  TESTASSERT(srslte_ofdm_rx_init_cfg(&fft_shift, &ofdm_cfg) == SRSLTE_SUCCESS);
+
+  TESTASSERT(srslte_dft_plan_c(&fft, symbol_sz, SRSLTE_DFT_FORWARD) == SRSLTE_SUCCESS);
+
+  for (int i = 0; i < nof_repetitions; i++) {
+    srslte_random_uniform_complex_dist_vector(random_gen, input, nof_re, -1.0f, +1.0f);
+
+    gettimeofday(&t[1], NULL);
+    srslte_ofdm_tx_sf(&ifft);
+    gettimeofday(&t[2], NULL);
+    tx_us += elapsed_us(t);
+  }
+  srslte_ofdm_tx_sf(&ifft_shift);
+  srslte_ofdm_rx_sf(&fft_shift);
+
+  // The subcarriers of the second slot other than the nof_sc around the DC carry no power
+  float data_power  = 0.0f;
+  float guard_power = 0.0f;
+  cf_t* ptr         = samples + slot_len;
+  for (uint32_t i = 0; i < SRSLTE_CP_NORM_NSYMB; i++) {
+    ptr += SRSLTE_CP_LEN_NORM(i, symbol_sz);
+    srslte_dft_run_c(&fft, ptr, symbol);
+    for (uint32_t k = 0; k < symbol_sz; k++) {
+      float power = crealf(symbol[k] * conjf(symbol[k]));
+      if ((k >= 1 && k <= nof_sc / 2) || k >= symbol_sz - nof_sc / 2) {
+        data_power = SRSLTE_MAX(data_power, power);
+      } else {
+        guard_power = SRSLTE_MAX(guard_power, power);
+      }
+    }
+    ptr += symbol_sz;
+  }
+
+  // The MBSFN region has one symbol less than the first slot of a normal subframe
+  srslte_vec_sub_ccc(input, output, output, nof_re);
+  srslte_vec_cf_zero(&output[SRSLTE_CP_EXT_NSYMB * nof_sc], nof_sc);
+  float mse = sqrtf(srslte_vec_avg_power_cf(output, nof_re));
+
+  printf("MBSFN nof_prb=%3d; symbol_sz=%4d; Tx %6.1f us/sf %6.1f Msps; guard/data power=%.2e; MSE=%.6f\n",
+         nof_prb,
+         symbol_sz,
+         tx_us / nof_repetitions,
+         sf_len * nof_repetitions / tx_us,
+         guard_power / data_power,
+         mse);
+  TESTASSERT(guard_power < 1e-8f * data_power);
+  TESTASSERT(mse < 0.0001f);
+
+  srslte_ofdm_tx_free(&ifft);
+  srslte_ofdm_tx_free(&ifft_shift);
+  srslte_ofdm_rx_free(&fft_shift);
+  srslte_dft_plan_free(&fft);
+  free(input);
+  free(samples);
+  free(samples_shift);
+  free(output);
+  free(symbol);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslte_random_t random_gen = srslte_random_init(0);
+
+  parse_args(argc, argv);
+
+  for (uint32_t i = 0; i < sizeof(bandwidths) / sizeof(bandwidths[0]); i++) {
+    TESTASSERT(test_throughput(random_gen, bandwidths[i], false) == SRSLTE_SUCCESS);
+    TESTASSERT(test_throughput(random_gen, bandwidths[i], true) == SRSLTE_SUCCESS);
+    TESTASSERT(test_mbsfn(random_gen, bandwidths[i]) == SRSLTE_SUCCESS);
+  }
+
+  srslte_random_free(random_gen);
+
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
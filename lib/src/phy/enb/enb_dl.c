@@ -416,6 +416,14 @@ int srslte_enb_dl_put_pdsch(srslte_enb_dl_t* q, srslte_pdsch_cfg_t* pdsch, uint8
   return srslte_pdsch_encode(&q->pdsch, &q->dl_sf, pdsch, data, q->sf_symbols);
 }
 
+int srslte_enb_dl_put_pdsch_lane(srslte_enb_dl_t*    q,
+                                 srslte_pdsch_t*     lane,
+                                 srslte_pdsch_cfg_t* pdsch,
+                                 uint8_t*            data[SRSLTE_MAX_CODEWORDS])
+{
+  return srslte_pdsch_encode(lane, &q->dl_sf, pdsch, data, q->sf_symbols);
+}
+
 int srslte_enb_dl_put_pmch(srslte_enb_dl_t* q, srslte_pmch_cfg_t* pmch_cfg, uint8_t* data)
 {
   return srslte_pmch_encode(&q->pmch, &q->dl_sf, pmch_cfg, data, q->sf_symbols);
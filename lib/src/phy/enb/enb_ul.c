@@ -173,7 +173,11 @@ void srslte_enb_ul_fft(srslte_enb_ul_t* q)
   srslte_ofdm_rx_sf(&q->fft);
 }
 
-static int get_pucch(srslte_enb_ul_t* q, srslte_ul_sf_cfg_t* ul_sf, srslte_pucch_cfg_t* cfg, srslte_pucch_res_t* res)
+static int get_pucch(srslte_enb_ul_t*    q,
+                     srslte_ul_sf_cfg_t* ul_sf,
+                     srslte_pucch_cfg_t* cfg,
+                     srslte_pucch_res_t* res,
+                     bool                batch)
 {
   int      ret                               = SRSLTE_SUCCESS;
   uint32_t n_pucch_i[SRSLTE_PUCCH_MAX_ALLOC] = {};
@@ -208,13 +212,18 @@ static int get_pucch(srslte_enb_ul_t* q, srslte_ul_sf_cfg_t* ul_sf, srslte_pucch
     // Configure resource
     cfg->n_pucch = n_pucch_i[i];
 
-    // Prepare configuration
-    if (srslte_chest_ul_estimate_pucch(&q->chest, ul_sf, cfg, q->sf_symbols, &q->chest_res)) {
-      ERROR("Error estimating PUCCH DMRS\n");
-      return SRSLTE_ERROR;
-    }
+    if (batch) {
+      // The batched receiver estimates the channel itself, from the PRBs shared with the other resources
+      ret = srslte_pucch_decode_batch(&q->pucch, ul_sf, cfg, q->sf_symbols, &pucch_res);
+    } else {
+      // Prepare configuration
+      if (srslte_chest_ul_estimate_pucch(&q->chest, ul_sf, cfg, q->sf_symbols, &q->chest_res)) {
+        ERROR("Error estimating PUCCH DMRS\n");
+        return SRSLTE_ERROR;
+      }
 
-    ret = srslte_pucch_decode(&q->pucch, ul_sf, cfg, &q->chest_res, q->sf_symbols, &pucch_res);
+      ret = srslte_pucch_decode(&q->pucch, ul_sf, cfg, &q->chest_res, q->sf_symbols, &pucch_res);
+    }
     if (ret < SRSLTE_SUCCESS) {
       ERROR("Error decoding PUCCH\n");
     } else {
@@ -235,7 +244,7 @@ static int get_pucch(srslte_enb_ul_t* q, srslte_ul_sf_cfg_t* ul_sf, srslte_pucch
       // Compares correlation value, it stores the PUCCH result with the greatest correlation
       if (i == 0 || pucch_res.correlation > res->correlation) {
         // Copy measurements only if PUCCH was decoded succesfully
-        if (cfg->meas_ta_en) {
+        if (cfg->meas_ta_en && !batch) {
           pucch_res.ta_valid = !(isnan(q->chest_res.ta_us) || isinf(q->chest_res.ta_us));
           pucch_res.ta_us    = q->chest_res.ta_us;
         }
@@ -248,10 +257,11 @@ static int get_pucch(srslte_enb_ul_t* q, srslte_ul_sf_cfg_t* ul_sf, srslte_pucch
   return ret;
 }
 
-int srslte_enb_ul_get_pucch(srslte_enb_ul_t*    q,
-                            srslte_ul_sf_cfg_t* ul_sf,
-                            srslte_pucch_cfg_t* cfg,
-                            srslte_pucch_res_t* res)
+static int get_pucch_ue(srslte_enb_ul_t*    q,
+                        srslte_ul_sf_cfg_t* ul_sf,
+                        srslte_pucch_cfg_t* cfg,
+                        srslte_pucch_res_t* res,
+                        bool                batch)
 {
 
   if (!srslte_pucch_cfg_isvalid(cfg, q->cell.nof_prb)) {
@@ -259,7 +269,7 @@ int srslte_enb_ul_get_pucch(srslte_enb_ul_t*    q,
     return SRSLTE_ERROR_INVALID_INPUTS;
   }
 
-  if (get_pucch(q, ul_sf, cfg, res)) {
+  if (get_pucch(q, ul_sf, cfg, res, batch)) {
     return SRSLTE_ERROR;
   }
 
@@ -267,7 +277,62 @@ int srslte_enb_ul_get_pucch(srslte_enb_ul_t*    q,
   // try again to decode ACK only
   if (cfg->uci_cfg.is_scheduling_request_tti && srslte_uci_cfg_total_ack(&cfg->uci_cfg) && !res->detected) {
     cfg->uci_cfg.is_scheduling_request_tti = false;
-    if (get_pucch(q, ul_sf, cfg, res)) {
+    if (get_pucch(q, ul_sf, cfg, res, batch)) {
+      return SRSLTE_ERROR;
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int srslte_enb_ul_get_pucch(srslte_enb_ul_t*    q,
+                            srslte_ul_sf_cfg_t* ul_sf,
+                            srslte_pucch_cfg_t* cfg,
+                            srslte_pucch_res_t* res)
+{
+  return get_pucch_ue(q, ul_sf, cfg, res, false);
+}
+
+/* Tells whether all the resources a UE may use in this subframe can be decoded by the batched receiver */
+static bool pucch_batch_supported(srslte_enb_ul_t* q, srslte_pucch_cfg_t* cfg)
+{
+  srslte_pucch_cfg_t tmp = *cfg;
+
+  if (!srslte_pucch_cfg_isvalid(&tmp, q->cell.nof_prb)) {
+    return false;
+  }
+  if (!tmp.simul_cqi_ack && srslte_uci_cfg_total_ack(&tmp.uci_cfg) > 0 && tmp.uci_cfg.cqi.data_enable) {
+    tmp.uci_cfg.cqi.data_enable = false;
+  }
+
+  if (!srslte_pucch_batch_supported(srslte_pucch_proc_select_format(&q->cell, &tmp, &tmp.uci_cfg, NULL))) {
+    return false;
+  }
+
+  // If SR and ACK are expected together, the ACK is decoded alone when there is no SR
+  if (tmp.uci_cfg.is_scheduling_request_tti && srslte_uci_cfg_total_ack(&tmp.uci_cfg) > 0) {
+    tmp.uci_cfg.is_scheduling_request_tti = false;
+    return srslte_pucch_batch_supported(srslte_pucch_proc_select_format(&q->cell, &tmp, &tmp.uci_cfg, NULL));
+  }
+  return true;
+}
+
+int srslte_enb_ul_get_pucch_batch(srslte_enb_ul_t*    q,
+                                  srslte_ul_sf_cfg_t* ul_sf,
+                                  srslte_pucch_cfg_t* cfg,
+                                  srslte_pucch_res_t* res,
+                                  uint32_t            nof_ue)
+{
+  if (q == NULL || ul_sf == NULL || (nof_ue > 0 && (cfg == NULL || res == NULL))) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  // The PRBs are despread once for all the UEs of this subframe
+  srslte_pucch_batch_reset(&q->pucch);
+
+  for (uint32_t i = 0; i < nof_ue; i++) {
+    bzero(&res[i], sizeof(srslte_pucch_res_t));
+    if (get_pucch_ue(q, ul_sf, &cfg[i], &res[i], pucch_batch_supported(q, &cfg[i]))) {
       return SRSLTE_ERROR;
     }
   }
@@ -284,3 +349,105 @@ int srslte_enb_ul_get_pusch(srslte_enb_ul_t*    q,
 
   return srslte_pusch_decode(&q->pusch, ul_sf, cfg, &q->chest_res, q->sf_symbols, res);
 }
+
+int srslte_enb_ul_pusch_init(srslte_enb_ul_pusch_t* q, uint32_t max_prb)
+{
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+
+  if (q != NULL) {
+    ret = SRSLTE_ERROR;
+
+    bzero(q, sizeof(srslte_enb_ul_pusch_t));
+
+    q->chest_res.ce = srslte_vec_cf_malloc(SRSLTE_SF_LEN_RE(max_prb, SRSLTE_CP_NORM));
+    if (!q->chest_res.ce) {
+      perror("malloc");
+      goto clean_exit;
+    }
+
+    if (srslte_pusch_init_enb(&q->pusch, max_prb)) {
+      ERROR("Error creating PUSCH object\n");
+      goto clean_exit;
+    }
+
+    if (srslte_chest_ul_init(&q->chest, max_prb)) {
+      ERROR("Error initiating channel estimator\n");
+      goto clean_exit;
+    }
+
+    ret = SRSLTE_SUCCESS;
+
+  } else {
+    ERROR("Invalid parameters\n");
+  }
+
+clean_exit:
+  if (ret == SRSLTE_ERROR) {
+    srslte_enb_ul_pusch_free(q);
+  }
+  return ret;
+}
+
+void srslte_enb_ul_pusch_free(srslte_enb_ul_pusch_t* q)
+{
+  if (q) {
+    srslte_pusch_free(&q->pusch);
+    srslte_chest_ul_free(&q->chest);
+
+    if (q->chest_res.ce) {
+      free(q->chest_res.ce);
+    }
+    bzero(q, sizeof(srslte_enb_ul_pusch_t));
+  }
+}
+
+int srslte_enb_ul_pusch_set_cell(srslte_enb_ul_pusch_t*             q,
+                                 srslte_cell_t                      cell,
+                                 srslte_refsignal_dmrs_pusch_cfg_t* pusch_cfg,
+                                 srslte_refsignal_srs_cfg_t*        srs_cfg)
+{
+  if (q == NULL || !srslte_cell_isvalid(&cell)) {
+    ERROR("Invalid cell properties: Id=%d, Ports=%d, PRBs=%d\n", cell.id, cell.nof_ports, cell.nof_prb);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  if (srslte_pusch_set_cell(&q->pusch, cell)) {
+    ERROR("Error creating PUSCH object\n");
+    return SRSLTE_ERROR;
+  }
+
+  if (srslte_chest_ul_set_cell(&q->chest, cell)) {
+    ERROR("Error initiating channel estimator\n");
+    return SRSLTE_ERROR;
+  }
+
+  srslte_chest_ul_pregen(&q->chest, pusch_cfg, srs_cfg);
+
+  return SRSLTE_SUCCESS;
+}
+
+int srslte_enb_ul_pusch_add_rnti(srslte_enb_ul_pusch_t* q, uint16_t rnti)
+{
+  if (srslte_pusch_set_rnti(&q->pusch, rnti)) {
+    ERROR("Error setting PUSCH rnti\n");
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_enb_ul_pusch_rem_rnti(srslte_enb_ul_pusch_t* q, uint16_t rnti)
+{
+  srslte_pusch_free_rnti(&q->pusch, rnti);
+}
+
+int srslte_enb_ul_get_pusch_lane(srslte_enb_ul_t*       q,
+                                 srslte_enb_ul_pusch_t* lane,
+                                 srslte_ul_sf_cfg_t*    ul_sf,
+                                 srslte_pusch_cfg_t*    cfg,
+                                 srslte_pusch_res_t*    res)
+{
+  // Only reads the subframe symbols, so that other lanes can decode at the same time
+  srslte_chest_ul_estimate_pusch(&lane->chest, ul_sf, cfg, q->sf_symbols, &lane->chest_res);
+
+  return srslte_pusch_decode(&lane->pusch, ul_sf, cfg, &lane->chest_res, q->sf_symbols, res);
+}
@@ -44,6 +44,7 @@ float save_corr[4096];
 #define PHI 7             // PRACH phi parameter
 #define PHI_4 2           // PRACH phi parameter for format 4
 #define MAX_ROOTS 838     // Max number of root sequences
+#define PRACH_PRUNED_IDFT_MAX_LAGS 32 // Above this number of lags per root the full IDFT is cheaper
 //#define PRACH_CANCELLATION_HARD
 #define PRACH_AMP 1.0
 
@@ -338,6 +339,48 @@ int srslte_prach_gen_seqs(srslte_prach_t* p)
   return 0;
 }
 
+/// Selects the lags searched by the fast detector and generates the pruned IDFT if it is cheaper than the full one
+static int prach_fast_detection_plan(srslte_prach_t* p)
+{
+  uint32_t winsize = (p->N_cs != 0) ? p->N_cs : p->N_zc;
+  uint32_t n_wins  = p->N_zc / winsize;
+
+  // A preamble delayed more than the maximum delay is not valid, only the first lags of each window are searched
+  p->search_len = winsize;
+  if (p->max_delay_us > 0) {
+    uint32_t max_lag = (uint32_t)ceilf(p->max_delay_us * 1e-6f * DELTA_F_RA * p->N_zc);
+    p->search_len    = SRSLTE_MAX(1, SRSLTE_MIN(max_lag, winsize));
+  }
+
+  p->nof_pruned_lags = 0;
+  if (n_wins * p->search_len > PRACH_PRUNED_IDFT_MAX_LAGS) {
+    return SRSLTE_SUCCESS;
+  }
+
+  if (p->pruned_idft == NULL) {
+    p->pruned_idft = srslte_vec_cf_malloc(PRACH_PRUNED_IDFT_MAX_LAGS * MAX_N_zc);
+    if (p->pruned_idft == NULL) {
+      ERROR("Error allocating memory\n");
+      return SRSLTE_ERROR;
+    }
+  }
+
+  // Row j * search_len + m evaluates the lag m of the window j, as the unnormalised backward DFT does
+  for (uint32_t j = 0; j < n_wins; j++) {
+    uint32_t start = (p->N_zc - j * winsize) % p->N_zc;
+    for (uint32_t m = 0; m < p->search_len; m++) {
+      uint32_t n   = start + m;
+      cf_t*    row = &p->pruned_idft[(j * p->search_len + m) * p->N_zc];
+      for (uint32_t k = 0; k < p->N_zc; k++) {
+        row[k] = cexpf(_Complex_I * (float)(2.0 * M_PI * ((k * n) % p->N_zc) / p->N_zc));
+      }
+    }
+  }
+  p->nof_pruned_lags = n_wins * p->search_len;
+
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_prach_set_cfg(srslte_prach_t* p, srslte_prach_cfg_t* cfg, uint32_t nof_prb)
 {
   return srslte_prach_set_cell_(p, srslte_symbol_sz(nof_prb), cfg, &cfg->tdd_config);
@@ -431,6 +474,11 @@ int srslte_prach_set_cell_(srslte_prach_t*      p,
       p->successive_cancellation = false;
     }
     p->freq_domain_offset_calc = cfg->enable_freq_domain_offset_calc;
+    p->fast_detection          = cfg->enable_fast_detection;
+    if (p->fast_detection && p->successive_cancellation) {
+      printf("successive cancellation not supported by the fast PRACH detector - disabling fast detection\n");
+      p->fast_detection = false;
+    }
     if (tdd_config) {
       p->tdd_config = *tdd_config;
     }
@@ -520,6 +568,16 @@ int srslte_prach_set_cell_(srslte_prach_t*      p,
         }
       }
     }
+
+    // The fast detector takes the root spectra straight from the table, generate them now
+    if (p->fast_detection) {
+      for (uint32_t i = 0; i < p->N_roots; i++) {
+        get_precoded_dft(p, p->root_seqs_idx[i]);
+      }
+      if (prach_fast_detection_plan(p)) {
+        return SRSLTE_ERROR;
+      }
+    }
     ret = SRSLTE_SUCCESS;
   } else {
     ERROR("Invalid parameters\n");
@@ -578,6 +636,20 @@ void srslte_prach_set_detect_factor(srslte_prach_t* p, float ratio)
   p->detect_factor = ratio;
 }
 
+int srslte_prach_set_max_delay_us(srslte_prach_t* p, float max_delay_us)
+{
+  if (p == NULL || max_delay_us < 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  p->max_delay_us = max_delay_us;
+  if (p->fast_detection) {
+    return prach_fast_detection_plan(p);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_prach_detect(srslte_prach_t* p,
                         uint32_t        freq_offset,
                         cf_t*           signal,
@@ -747,6 +819,64 @@ int srslte_prach_process(srslte_prach_t* p,
   return 0;
 }
 
+/// Same detection as srslte_prach_process() without successive cancellation. The root spectra are precomputed, the
+/// correlation average is taken in the frequency domain and only the searched lags of the correlation are computed,
+/// with the pruned IDFT when it is cheaper than the full one
+static void prach_detect_fast(srslte_prach_t* p,
+                              uint32_t*       indices,
+                              float*          t_offsets,
+                              float*          peak_to_avg,
+                              uint32_t*       n_indices)
+{
+  uint32_t winsize = (p->N_cs != 0) ? p->N_cs : p->N_zc;
+  uint32_t n_wins  = p->N_zc / winsize;
+
+  // The root spectra have unit magnitude, by Parseval the correlation average is the PRACH bins energy for all roots
+  float corr_ave  = srslte_vec_avg_power_cf(p->prach_bins, p->N_zc) * p->N_zc;
+  float threshold = p->detect_factor * corr_ave;
+
+  for (uint32_t i = 0; i < p->num_ra_preambles && i * n_wins < N_SEQS; i++) {
+    // Windows beyond the last preamble are not searched
+    uint32_t nof_wins = SRSLTE_MIN(n_wins, N_SEQS - i * n_wins);
+
+    srslte_vec_prod_conj_ccc(p->prach_bins, p->dft_seqs[p->root_seqs_idx[i]], p->corr_spec, p->N_zc);
+    if (p->freq_domain_offset_calc) {
+      srslte_vec_prod_conj_ccc(p->corr_spec, &p->corr_spec[1], p->cross, p->N_zc - 1);
+    }
+
+    // Both ways leave the searched lags of the window j in corr[j * search_len]
+    if (p->nof_pruned_lags) {
+      for (uint32_t r = 0; r < nof_wins * p->search_len; r++) {
+        cf_t y     = srslte_vec_dot_prod_ccc(p->corr_spec, &p->pruned_idft[r * p->N_zc], p->N_zc);
+        p->corr[r] = __real__ y * __real__ y + __imag__ y * __imag__ y;
+      }
+    } else {
+      srslte_dft_run(&p->zc_ifft, p->corr_spec, p->corr_spec);
+      for (uint32_t j = 0; j < nof_wins; j++) {
+        uint32_t start = (p->N_zc - j * winsize) % p->N_zc;
+        srslte_vec_abs_square_cf(&p->corr_spec[start], &p->corr[j * p->search_len], p->search_len);
+      }
+    }
+
+    for (uint32_t j = 0; j < nof_wins; j++) {
+      float* corr        = &p->corr[j * p->search_len];
+      p->peak_offsets[j] = srslte_vec_max_fi(corr, p->search_len);
+      p->peak_values[j]  = corr[p->peak_offsets[j]];
+      if (p->peak_values[j] > threshold) {
+        indices[*n_indices] = i * n_wins + j;
+        if (peak_to_avg) {
+          peak_to_avg[*n_indices] = p->peak_values[j] / corr_ave;
+        }
+        if (t_offsets) {
+          t_offsets[*n_indices] = (p->freq_domain_offset_calc) ? (srslte_prach_calculate_time_offset_secs(p, p->cross))
+                                                               : (srslte_prach_get_offset_secs(p, j));
+        }
+        (*n_indices)++;
+      }
+    }
+  }
+}
+
 int srslte_prach_detect_offset(srslte_prach_t* p,
                                uint32_t        freq_offset,
                                cf_t*           signal,
@@ -778,6 +908,11 @@ int srslte_prach_detect_offset(srslte_prach_t* p,
     uint32_t begin   = PHI + (K * k_0) + (K / 2);
 
     memcpy(p->prach_bins, &p->signal_fft[begin], p->N_zc * sizeof(cf_t));
+    if (p->fast_detection) {
+      prach_detect_fast(p, indices, t_offsets, peak_to_avg, n_indices);
+      return SRSLTE_SUCCESS;
+    }
+
     int loops = (p->successive_cancellation) ? SUCCESSIVE_CANCELLATION_ITS : 1;
     // if successive cancellation is enabled, we perform the entire search process p->num_ra_preambles times, removing
     // the highest power PRACH preamble each time.
@@ -806,6 +941,7 @@ int srslte_prach_free(srslte_prach_t* p)
   srslte_dft_plan_free(&p->fft);
   srslte_dft_plan_free(&p->zc_fft);
   srslte_dft_plan_free(&p->zc_ifft);
+  free(p->pruned_idft);
 
   if (p->signal_fft) {
     free(p->signal_fft);
@@ -73,6 +73,13 @@ int srslte_pucch_init_(srslte_pucch_t* q, bool is_ue)
 
     if (!q->is_ue) {
       q->ce = srslte_vec_cf_malloc(SRSLTE_PUCCH_MAX_SYMBOLS);
+
+      // The batched receiver despreads all the cyclic shifts of a symbol with a 12-point DFT
+      for (uint32_t k = 0; k < SRSLTE_NRE; k++) {
+        for (uint32_t n = 0; n < SRSLTE_NRE; n++) {
+          q->batch_dft[k][n] = cexpf(-I * 2 * M_PI * ((k * n) % SRSLTE_NRE) / SRSLTE_NRE);
+        }
+      }
     }
 
     ret = SRSLTE_SUCCESS;
@@ -119,6 +126,15 @@ void srslte_pucch_free(srslte_pucch_t* q)
   if (q->ce) {
     free(q->ce);
   }
+  if (q->batch_x) {
+    free(q->batch_x);
+  }
+  if (q->batch_y) {
+    free(q->batch_y);
+  }
+  if (q->batch_noise) {
+    free(q->batch_noise);
+  }
 
   srslte_modem_table_free(&q->mod);
   bzero(q, sizeof(srslte_pucch_t));
@@ -142,6 +158,29 @@ int srslte_pucch_set_cell(srslte_pucch_t* q, srslte_cell_t cell)
       }
     }
 
+    // Allocate the PRBs despread by the batched receiver
+    if (!q->is_ue && cell.nof_prb != q->batch_nof_prb) {
+      uint32_t nof_sym = SRSLTE_NOF_SLOTS_PER_SF * cell.nof_prb * SRSLTE_CP_NORM_NSYMB;
+      if (q->batch_x) {
+        free(q->batch_x);
+      }
+      if (q->batch_y) {
+        free(q->batch_y);
+      }
+      if (q->batch_noise) {
+        free(q->batch_noise);
+      }
+      q->batch_x       = srslte_vec_cf_malloc(nof_sym * SRSLTE_NRE);
+      q->batch_y       = srslte_vec_cf_malloc(nof_sym * SRSLTE_NRE);
+      q->batch_noise   = srslte_vec_f_malloc(SRSLTE_NOF_SLOTS_PER_SF * cell.nof_prb);
+      q->batch_nof_prb = cell.nof_prb;
+      if (!q->batch_x || !q->batch_y || !q->batch_noise) {
+        q->batch_nof_prb = 0;
+        return SRSLTE_ERROR;
+      }
+    }
+    srslte_pucch_batch_reset(q);
+
     ret = SRSLTE_SUCCESS;
   }
   return ret;
@@ -300,6 +339,10 @@ uci_mod_bits(srslte_pucch_t* q, srslte_ul_sf_cfg_t* sf, srslte_pucch_cfg_t* cfg,
 // Declare this here, since we can not include refsignal_ul.h
 void srslte_refsignal_r_uv_arg_1prb(float* arg, uint32_t u);
 
+// DMRS orthogonal sequences of the formats 1, 1a and 1b, Table 5.5.2.2.1-2 in refsignal_ul.c
+extern float w_arg_pucch_format1_cpnorm[3][3];
+extern float w_arg_pucch_format1_cpext[3][2];
+
 /* 3GPP 36211 Table 5.5.2.2.2-1: Demodulation reference signal location for different PUCCH formats. */
 static const uint32_t pucch_symbol_format1_cpnorm[4]   = {0, 1, 5, 6};
 static const uint32_t pucch_symbol_format1_cpext[4]    = {0, 1, 4, 5};
@@ -713,6 +756,37 @@ static int encode_bits(srslte_pucch_cfg_t*   cfg,
   return SRSLTE_SUCCESS;
 }
 
+/* Demodulates and decodes the equalized format 2 symbols in q->z, one per data symbol */
+static int decode_symbols_format2(srslte_pucch_t*     q,
+                                  srslte_ul_sf_cfg_t* sf,
+                                  srslte_pucch_cfg_t* cfg,
+                                  uint8_t             pucch_bits[SRSLTE_CQI_MAX_BITS],
+                                  uint32_t            nof_uci_bits,
+                                  float*              correlation)
+{
+  int16_t llr_pucch2[SRSLTE_CQI_MAX_BITS];
+
+  srslte_sequence_t* seq = get_user_sequence(q, cfg->rnti, sf->tti % SRSLTE_NOF_SF_X_FRAME);
+  if (!seq) {
+    ERROR("Decoding PUCCH2: could not generate sequence\n");
+    return SRSLTE_ERROR;
+  }
+
+  srslte_demod_soft_demodulate_s(SRSLTE_MOD_QPSK, q->z, llr_pucch2, SRSLTE_PUCCH2_NOF_BITS / 2);
+  srslte_scrambling_s_offset(seq, llr_pucch2, 0, SRSLTE_PUCCH2_NOF_BITS);
+
+  // Calculate the LLR RMS for normalising
+  float llr_pow = srslte_vec_avg_power_sf(llr_pucch2, SRSLTE_PUCCH2_NOF_BITS);
+
+  if (isnormal(llr_pow)) {
+    float llr_rms = sqrtf(llr_pow) * SRSLTE_PUCCH2_NOF_BITS;
+    *correlation  = ((float)srslte_uci_decode_cqi_pucch(&q->cqi, llr_pucch2, pucch_bits, nof_uci_bits)) / (llr_rms);
+  } else {
+    *correlation = 0;
+  }
+  return SRSLTE_SUCCESS;
+}
+
 static bool decode_signal(srslte_pucch_t*     q,
                           srslte_ul_sf_cfg_t* sf,
                           srslte_pucch_cfg_t* cfg,
@@ -721,13 +795,11 @@ static bool decode_signal(srslte_pucch_t*     q,
                           uint32_t            nof_uci_bits,
                           float*              correlation)
 {
-  int16_t llr_pucch2[SRSLTE_CQI_MAX_BITS];
   bool    detected = false;
   float   corr = 0, corr_max = -1e9;
   uint8_t b_max = 0, b2_max = 0; // default bit value, eg. HI is NACK
 
-  srslte_sequence_t* seq;
-  cf_t               ref[SRSLTE_PUCCH_MAX_SYMBOLS];
+  cf_t ref[SRSLTE_PUCCH_MAX_SYMBOLS];
 
   switch (cfg->format) {
     case SRSLTE_PUCCH_FORMAT_1:
@@ -782,30 +854,15 @@ static bool decode_signal(srslte_pucch_t*     q,
     case SRSLTE_PUCCH_FORMAT_2:
     case SRSLTE_PUCCH_FORMAT_2A:
     case SRSLTE_PUCCH_FORMAT_2B:
-      seq = get_user_sequence(q, cfg->rnti, sf->tti % SRSLTE_NOF_SF_X_FRAME);
-      if (seq) {
-        encode_signal_format12(q, sf, cfg, NULL, ref, true);
-        srslte_vec_prod_conj_ccc(q->z, ref, q->z_tmp, SRSLTE_PUCCH_MAX_SYMBOLS);
-        for (int i = 0; i < (SRSLTE_PUCCH2_N_SF * SRSLTE_NOF_SLOTS_PER_SF); i++) {
-          q->z[i] = srslte_vec_acc_cc(&q->z_tmp[i * SRSLTE_NRE], SRSLTE_NRE) / SRSLTE_NRE;
-        }
-        srslte_demod_soft_demodulate_s(SRSLTE_MOD_QPSK, q->z, llr_pucch2, SRSLTE_PUCCH2_NOF_BITS / 2);
-        srslte_scrambling_s_offset(seq, llr_pucch2, 0, SRSLTE_PUCCH2_NOF_BITS);
-
-        // Calculate the LLR RMS for normalising
-        float llr_pow = srslte_vec_avg_power_sf(llr_pucch2, SRSLTE_PUCCH2_NOF_BITS);
-
-        if (isnormal(llr_pow)) {
-          float llr_rms = sqrtf(llr_pow) * SRSLTE_PUCCH2_NOF_BITS;
-          corr = ((float)srslte_uci_decode_cqi_pucch(&q->cqi, llr_pucch2, pucch_bits, nof_uci_bits)) / (llr_rms);
-        } else {
-          corr = 0;
-        }
-        detected = true;
-      } else {
-        ERROR("Decoding PUCCH2: could not generate sequence\n");
+      encode_signal_format12(q, sf, cfg, NULL, ref, true);
+      srslte_vec_prod_conj_ccc(q->z, ref, q->z_tmp, SRSLTE_PUCCH_MAX_SYMBOLS);
+      for (int i = 0; i < (SRSLTE_PUCCH2_N_SF * SRSLTE_NOF_SLOTS_PER_SF); i++) {
+        q->z[i] = srslte_vec_acc_cc(&q->z_tmp[i * SRSLTE_NRE], SRSLTE_NRE) / SRSLTE_NRE;
+      }
+      if (decode_symbols_format2(q, sf, cfg, pucch_bits, nof_uci_bits, &corr)) {
         return -1;
       }
+      detected = true;
       break;
     case SRSLTE_PUCCH_FORMAT_3:
       corr     = (float)decode_signal_format3(q, sf, cfg, pucch_bits, q->z) / 4800.0f;
@@ -858,6 +915,34 @@ static void decode_bits(srslte_pucch_cfg_t* cfg,
   }
 }
 
+/* Converts the decoded bits to UCI data, accepting ACK and CQI only if the correlation is above threshold */
+static void decode_result(srslte_pucch_cfg_t* cfg,
+                          bool                pucch_found,
+                          uint8_t             pucch_bits[SRSLTE_CQI_MAX_BITS],
+                          srslte_pucch_res_t* data)
+{
+  decode_bits(cfg, pucch_found, pucch_bits, cfg->pucch2_drs_bits, &data->uci_data);
+
+  data->detected = pucch_found;
+
+  switch (cfg->format) {
+    case SRSLTE_PUCCH_FORMAT_1A:
+    case SRSLTE_PUCCH_FORMAT_1B:
+      data->uci_data.ack.valid = data->correlation > cfg->threshold_data_valid_format1a;
+      break;
+    case SRSLTE_PUCCH_FORMAT_2:
+    case SRSLTE_PUCCH_FORMAT_2A:
+    case SRSLTE_PUCCH_FORMAT_2B:
+      data->detected              = data->correlation > cfg->threshold_data_valid_format2;
+      data->uci_data.ack.valid    = data->detected;
+      data->uci_data.cqi.data_crc = data->detected;
+      break;
+    case SRSLTE_PUCCH_FORMAT_1:
+    case SRSLTE_PUCCH_FORMAT_3:
+    default:; // Not considered, do nothing
+  }
+}
+
 /* Encode, modulate and resource mapping of UCI data over PUCCH */
 int srslte_pucch_encode(srslte_pucch_t*     q,
                         srslte_ul_sf_cfg_t* sf,
@@ -937,28 +1022,7 @@ int srslte_pucch_decode(srslte_pucch_t*        q,
     // Perform ML-decoding
     bool pucch_found = decode_signal(q, sf, cfg, pucch_bits, nof_re, nof_uci_bits, &data->correlation);
 
-    // Convert bits to UCI data
-    decode_bits(cfg, pucch_found, pucch_bits, cfg->pucch2_drs_bits, &data->uci_data);
-
-    data->detected = pucch_found;
-
-    // Accept ACK and CQI only if correlation above threshold
-    switch (cfg->format) {
-      case SRSLTE_PUCCH_FORMAT_1A:
-      case SRSLTE_PUCCH_FORMAT_1B:
-        data->uci_data.ack.valid = data->correlation > cfg->threshold_data_valid_format1a;
-        break;
-      case SRSLTE_PUCCH_FORMAT_2:
-      case SRSLTE_PUCCH_FORMAT_2A:
-      case SRSLTE_PUCCH_FORMAT_2B:
-        data->detected              = data->correlation > cfg->threshold_data_valid_format2;
-        data->uci_data.ack.valid    = data->detected;
-        data->uci_data.cqi.data_crc = data->detected;
-        break;
-      case SRSLTE_PUCCH_FORMAT_1:
-      case SRSLTE_PUCCH_FORMAT_3:
-      default:; // Not considered, do nothing
-    }
+    decode_result(cfg, pucch_found, pucch_bits, data);
 
     ret = SRSLTE_SUCCESS;
   }
@@ -966,6 +1030,340 @@ int srslte_pucch_decode(srslte_pucch_t*        q,
   return ret;
 }
 
+void srslte_pucch_batch_reset(srslte_pucch_t* q)
+{
+  if (q != NULL) {
+    bzero(q->batch_u, sizeof(q->batch_u));
+  }
+}
+
+bool srslte_pucch_batch_supported(srslte_pucch_format_t format)
+{
+  switch (format) {
+    case SRSLTE_PUCCH_FORMAT_1:
+    case SRSLTE_PUCCH_FORMAT_1A:
+    case SRSLTE_PUCCH_FORMAT_1B:
+    case SRSLTE_PUCCH_FORMAT_2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static uint32_t batch_cyclic_shift(float alpha)
+{
+  return (uint32_t)roundf(alpha * SRSLTE_NRE / (2 * M_PI)) % SRSLTE_NRE;
+}
+
+/* Noise power per RE of a despread PRB and slot, measured in a dimension that no resource of the PRB transmits on: the
+ * orthogonal sequence {1, 1, -1, -1} of the format 1 data, which Table 5.4.1-2 never assigns, or the difference of the
+ * two format 2 DMRS of the slot. Returns NAN if the slot has no such dimension */
+static float batch_noise_prb(srslte_pucch_t* q, srslte_pucch_format_t format, bool shortened, uint32_t ns, cf_t* y)
+{
+  const float  w_format1[4] = {1.0f, 1.0f, -1.0f, -1.0f};
+  const float  w_format2[2] = {1.0f, -1.0f};
+  uint32_t     slot         = ns % SRSLTE_NOF_SLOTS_PER_SF;
+  uint32_t     l[4]         = {};
+  const float* w            = NULL;
+  uint32_t     n            = 0;
+
+  if (format < SRSLTE_PUCCH_FORMAT_2 && get_N_sf(format, slot, shortened) == 4) {
+    w = w_format1;
+    n = 4;
+    for (uint32_t m = 0; m < n; m++) {
+      l[m] = get_pucch_symbol(m, format, q->cell.cp);
+    }
+  } else if (format == SRSLTE_PUCCH_FORMAT_2 && srslte_refsignal_dmrs_N_rs(format, q->cell.cp) == 2) {
+    w = w_format2;
+    n = 2;
+    for (uint32_t m = 0; m < n; m++) {
+      l[m] = srslte_refsignal_dmrs_pucch_symbol(m, format, q->cell.cp);
+    }
+  } else {
+    return NAN;
+  }
+
+  // The cyclic shift of every resource hops by the same cell specific value in each symbol
+  float power = 0.0f;
+  for (uint32_t k = 0; k < SRSLTE_NRE; k++) {
+    cf_t p = 0;
+    for (uint32_t m = 0; m < n; m++) {
+      p += w[m] * y[l[m] * SRSLTE_NRE + (k + q->n_cs_cell[ns][l[m]]) % SRSLTE_NRE];
+    }
+    power += __real__(conjf(p) * p);
+  }
+
+  // Every despread value adds up the noise of the SRSLTE_NRE subcarriers
+  return power / (SRSLTE_NRE * SRSLTE_NRE * n);
+}
+
+/* Removes the base sequence from the symbols of a PRB and slot, despreads them for all the cyclic shifts and measures
+ * their noise, unless it was done already for another resource. The format of the first resource decoded in the PRB
+ * selects the noise measurement. Returns the index of the first symbol of the PRB in the batch buffers */
+static int batch_despread_prb(srslte_pucch_t*     q,
+                              srslte_ul_sf_cfg_t* sf,
+                              srslte_pucch_cfg_t* cfg,
+                              uint32_t            ns,
+                              uint32_t            n_prb,
+                              cf_t*               input)
+{
+  uint32_t nsymbols = SRSLTE_CP_NSYMB(q->cell.cp);
+  uint32_t slot     = ns % SRSLTE_NOF_SLOTS_PER_SF;
+
+  if (n_prb >= q->batch_nof_prb || n_prb >= q->cell.nof_prb) {
+    ERROR("Invalid PUCCH n_prb=%d\n", n_prb);
+    return SRSLTE_ERROR;
+  }
+
+  // Get group hopping number u
+  uint32_t f_gh = 0;
+  if (cfg->group_hopping_en) {
+    f_gh = q->f_gh[ns];
+  }
+  uint32_t u = (f_gh + (q->cell.id % 30)) % 30;
+
+  uint32_t idx = (slot * q->batch_nof_prb + n_prb) * SRSLTE_CP_NORM_NSYMB;
+  if (q->batch_u[slot][n_prb] == u + 1) {
+    return idx;
+  }
+
+  cf_t r_uv_conj[SRSLTE_NRE];
+  srslte_refsignal_r_uv_arg_1prb(q->tmp_arg, u);
+  for (uint32_t n = 0; n < SRSLTE_NRE; n++) {
+    r_uv_conj[n] = cexpf(-I * q->tmp_arg[n]);
+  }
+
+  for (uint32_t l = 0; l < nsymbols; l++) {
+    cf_t* x = &q->batch_x[(idx + l) * SRSLTE_NRE];
+    cf_t* y = &q->batch_y[(idx + l) * SRSLTE_NRE];
+
+    srslte_vec_prod_ccc(
+        &input[SRSLTE_RE_IDX(q->cell.nof_prb, l + slot * nsymbols, n_prb * SRSLTE_NRE)], r_uv_conj, x, SRSLTE_NRE);
+    for (uint32_t k = 0; k < SRSLTE_NRE; k++) {
+      y[k] = srslte_vec_dot_prod_ccc(x, q->batch_dft[k], SRSLTE_NRE);
+    }
+  }
+  q->batch_noise[slot * q->batch_nof_prb + n_prb] =
+      batch_noise_prb(q, cfg->format, sf->shortened, ns, &q->batch_y[idx * SRSLTE_NRE]);
+  q->batch_u[slot][n_prb] = u + 1;
+
+  return idx;
+}
+
+/* Correlation of the equalized format 1 data with the sequence of the symbol d, normalized as srslte_vec_corr_ccc() */
+static float batch_corr_format1(cf_t acc, float norm, cf_t d)
+{
+  return isnormal(norm) ? crealf(conjf(d) * acc) / norm : 0.0f;
+}
+
+int srslte_pucch_decode_batch(srslte_pucch_t*     q,
+                              srslte_ul_sf_cfg_t* sf,
+                              srslte_pucch_cfg_t* cfg,
+                              cf_t*               sf_symbols,
+                              srslte_pucch_res_t* data)
+{
+  uint8_t pucch_bits[SRSLTE_CQI_MAX_BITS];
+  bzero(pucch_bits, SRSLTE_CQI_MAX_BITS * sizeof(uint8_t));
+
+  if (q == NULL || sf == NULL || cfg == NULL || sf_symbols == NULL || data == NULL || q->batch_y == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  if (!srslte_pucch_batch_supported(cfg->format)) {
+    ERROR("PUCCH format %s is not supported by the batched receiver\n", srslte_pucch_format_text(cfg->format));
+    return SRSLTE_ERROR;
+  }
+
+  srslte_cp_t cp           = q->cell.cp;
+  uint32_t    nof_cqi_bits = srslte_cqi_size(&cfg->uci_cfg.cqi);
+  uint32_t    nof_uci_bits = cfg->uci_cfg.cqi.ri_len ? cfg->uci_cfg.cqi.ri_len : nof_cqi_bits;
+  uint32_t    sf_idx       = sf->tti % SRSLTE_NOF_SF_X_FRAME;
+  uint32_t    n_rs         = srslte_refsignal_dmrs_N_rs(cfg->format, cp);
+  bool        is_format1   = cfg->format < SRSLTE_PUCCH_FORMAT_2;
+
+  int      idx[SRSLTE_NOF_SLOTS_PER_SF];
+  uint32_t k_rs[SRSLTE_NOF_SLOTS_PER_SF][3];
+  cf_t     w_rs[SRSLTE_NOF_SLOTS_PER_SF][3];
+  cf_t     h[SRSLTE_NOF_SLOTS_PER_SF];
+  float    h_pow     = 0.0f;
+  float    noise     = 0.0f;
+  uint32_t nof_noise = 0;
+
+  // Estimate the channel of each slot from the DMRS with the cyclic shift and orthogonal sequence of the resource, so
+  // other resources sharing the PRB do not leak into it
+  for (uint32_t slot = 0; slot < SRSLTE_NOF_SLOTS_PER_SF; slot++) {
+    uint32_t ns    = SRSLTE_NOF_SLOTS_PER_SF * sf_idx + slot;
+    uint32_t n_prb = srslte_pucch_n_prb(&q->cell, cfg, slot);
+
+    idx[slot] = batch_despread_prb(q, sf, cfg, ns, n_prb, sf_symbols);
+    if (idx[slot] < SRSLTE_SUCCESS) {
+      return SRSLTE_ERROR;
+    }
+    const cf_t* y = &q->batch_y[idx[slot] * SRSLTE_NRE];
+
+    h[slot] = 0;
+    for (uint32_t m = 0; m < n_rs; m++) {
+      uint32_t l     = srslte_refsignal_dmrs_pucch_symbol(m, cfg->format, cp);
+      uint32_t n_oc  = 0;
+      float    alpha = 0;
+      float    w     = 0;
+      if (is_format1) {
+        alpha = srslte_pucch_alpha_format1(q->n_cs_cell, cfg, cp, true, ns, l, &n_oc, NULL);
+        w     = SRSLTE_CP_ISNORM(cp) ? w_arg_pucch_format1_cpnorm[n_oc][m] : w_arg_pucch_format1_cpext[n_oc][m];
+      } else {
+        alpha = srslte_pucch_alpha_format2(q->n_cs_cell, cfg, ns, l);
+      }
+      k_rs[slot][m] = batch_cyclic_shift(alpha);
+      w_rs[slot][m] = cexpf(-I * w);
+      h[slot] += y[l * SRSLTE_NRE + k_rs[slot][m]] * w_rs[slot][m];
+    }
+    h[slot] /= (float)(SRSLTE_NRE * n_rs);
+    h_pow += __real__(conjf(h[slot]) * h[slot]);
+
+    float noise_slot = q->batch_noise[slot * q->batch_nof_prb + n_prb];
+    if (!isnan(noise_slot)) {
+      noise += noise_slot;
+      nof_noise++;
+    }
+  }
+  noise = nof_noise ? noise / nof_noise : NAN;
+
+  // DMRS detection: ratio of the DMRS power over the DMRS plus noise power. It is skipped if the noise can not be
+  // measured, in format 2 with extended CP
+  data->dmrs_correlation = 0.0f;
+  if (isnormal(cfg->threshold_dmrs_detection) && !isnan(noise)) {
+    data->dmrs_correlation = h_pow / (h_pow + SRSLTE_NOF_SLOTS_PER_SF * noise);
+
+    // Return not detected if the ratio is 0, NAN, +/- Infinity or below threshold
+    if (!isnormal(data->dmrs_correlation) || data->dmrs_correlation < cfg->threshold_dmrs_detection) {
+      data->correlation = 0.0f;
+      data->detected    = false;
+      data->ta_valid    = false;
+      return SRSLTE_SUCCESS;
+    }
+  }
+  if (isnan(noise)) {
+    noise = 0.0f;
+  }
+
+  // Despread the data symbols and equalize them with a flat channel in the PRB. The format 1 data power is the one
+  // expected from the channel and noise estimates rather than the one received, which includes all the resources of
+  // the PRB
+  cf_t     acc     = 0;
+  float    acc_pow = 0;
+  uint32_t nof_re  = 0;
+  for (uint32_t slot = 0; slot < SRSLTE_NOF_SLOTS_PER_SF; slot++) {
+    uint32_t    ns   = SRSLTE_NOF_SLOTS_PER_SF * sf_idx + slot;
+    uint32_t    N_sf = get_N_sf(cfg->format, slot, sf->shortened);
+    const cf_t* y    = &q->batch_y[idx[slot] * SRSLTE_NRE];
+    float       pow  = __real__(conjf(h[slot]) * h[slot]);
+    cf_t        c    = conjf(h[slot]) / (pow + noise);
+
+    if (is_format1) {
+      uint32_t N_sf_widx = N_sf == 3 ? 1 : 0;
+      cf_t     d         = 0;
+      for (uint32_t m = 0; m < N_sf; m++) {
+        uint32_t l          = get_pucch_symbol(m, cfg->format, cp);
+        uint32_t n_oc       = 0;
+        uint32_t n_prime_ns = 0;
+        float    alpha      = srslte_pucch_alpha_format1(q->n_cs_cell, cfg, cp, true, ns, l, &n_oc, &n_prime_ns);
+        float    S_ns       = (n_prime_ns % 2) ? M_PI / 2 : 0;
+        d += y[l * SRSLTE_NRE + batch_cyclic_shift(alpha)] * cexpf(-I * (w_n_oc[N_sf_widx][n_oc % 3][m] + S_ns));
+      }
+      acc += c * d;
+      acc_pow += __real__(conjf(c) * c) * N_sf * SRSLTE_NRE * (pow + noise);
+      nof_re += N_sf * SRSLTE_NRE;
+    } else {
+      for (uint32_t m = 0; m < N_sf; m++) {
+        uint32_t l     = get_pucch_symbol(m, cfg->format, cp);
+        float    alpha = srslte_pucch_alpha_format2(q->n_cs_cell, cfg, ns, l);
+        q->z[slot * N_sf + m] = c * y[l * SRSLTE_NRE + batch_cyclic_shift(alpha)] / SRSLTE_NRE;
+      }
+    }
+  }
+
+  // Perform ML-decoding
+  bool    pucch_found = false;
+  float   norm        = sqrtf(acc_pow * nof_re);
+  float   corr = 0, corr_max = -1e9;
+  uint8_t b_max = 0, b2_max = 0;
+  switch (cfg->format) {
+    case SRSLTE_PUCCH_FORMAT_1:
+      corr        = batch_corr_format1(acc, norm, uci_encode_format1());
+      pucch_found = corr >= cfg->threshold_format1;
+      break;
+    case SRSLTE_PUCCH_FORMAT_1A:
+      for (uint8_t b = 0; b < 2; b++) {
+        corr = batch_corr_format1(acc, norm, uci_encode_format1a(b));
+        if (corr > corr_max) {
+          corr_max = corr;
+          b_max    = b;
+        }
+      }
+      corr          = corr_max;
+      pucch_bits[0] = b_max;
+      pucch_found   = corr_max > cfg->threshold_format1;
+      break;
+    case SRSLTE_PUCCH_FORMAT_1B:
+      for (uint8_t b = 0; b < 2; b++) {
+        for (uint8_t b2 = 0; b2 < 2; b2++) {
+          uint8_t bits[2] = {b, b2};
+          corr            = batch_corr_format1(acc, norm, uci_encode_format1b(bits));
+          if (corr > corr_max) {
+            corr_max = corr;
+            b_max    = b;
+            b2_max   = b2;
+          }
+        }
+      }
+      corr          = corr_max;
+      pucch_bits[0] = b_max;
+      pucch_bits[1] = b2_max;
+      pucch_found   = corr_max > cfg->threshold_format1;
+      break;
+    case SRSLTE_PUCCH_FORMAT_2:
+      if (decode_symbols_format2(q, sf, cfg, pucch_bits, nof_uci_bits, &corr)) {
+        return SRSLTE_ERROR;
+      }
+      pucch_found = true;
+      break;
+    default:
+      return SRSLTE_ERROR;
+  }
+  data->correlation = corr;
+
+  decode_result(cfg, pucch_found, pucch_bits, data);
+
+  // Measure the time alignment from the DMRS of the resource, only if it was detected
+  data->ta_valid = false;
+  if (cfg->meas_ta_en && data->detected) {
+    float ta_err = 0.0f;
+    for (uint32_t slot = 0; slot < SRSLTE_NOF_SLOTS_PER_SF; slot++) {
+      cf_t ls[SRSLTE_NRE] = {};
+      cf_t tmp[SRSLTE_NRE];
+      for (uint32_t m = 0; m < n_rs; m++) {
+        uint32_t l = srslte_refsignal_dmrs_pucch_symbol(m, cfg->format, cp);
+        srslte_vec_prod_ccc(&q->batch_x[(idx[slot] + l) * SRSLTE_NRE], q->batch_dft[k_rs[slot][m]], tmp, SRSLTE_NRE);
+        srslte_vec_sc_prod_ccc(tmp, w_rs[slot][m], tmp, SRSLTE_NRE);
+        srslte_vec_sum_ccc(ls, tmp, ls, SRSLTE_NRE);
+      }
+      ta_err += srslte_vec_estimate_frequency(ls, SRSLTE_NRE) / SRSLTE_NOF_SLOTS_PER_SF;
+    }
+
+    // Calculate actual time alignment error in micro-seconds
+    data->ta_valid = true;
+    if (isnormal(ta_err)) {
+      ta_err /= 15e3f;                              // Convert from normalized frequency to seconds
+      ta_err *= 1e6f;                               // Convert to micro-seconds
+      data->ta_us = roundf(ta_err * 10.0f) / 10.0f; // Round to one tenth of micro-second
+    } else {
+      data->ta_us = 0.0f;
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 char* srslte_pucch_format_text(srslte_pucch_format_t format)
 {
   char* ret = NULL;
@@ -37,6 +37,10 @@ uint32_t config_idx       = 3;
 uint32_t root_seq_idx     = 0;
 uint32_t zero_corr_zone   = 15;
 uint32_t num_ra_preambles = 0; // use default
+uint32_t nof_trials       = 0;
+float    snr_db           = -10.0f;
+float    max_delay_us     = 30.0f;
+
 void usage(char* prog)
 {
   printf("Usage: %s\n", prog);
@@ -44,12 +48,15 @@ void usage(char* prog)
   printf("\t-f Preamble format [Default 0]\n");
   printf("\t-r Root sequence index [Default 0]\n");
   printf("\t-z Zero correlation zone config [Default 1]\n");
+  printf("\t-b Number of benchmark trials, 0 skips the benchmark [Default %d]\n", nof_trials);
+  printf("\t-s Benchmark SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-d Maximum preamble delay in us [Default %.1f]\n", max_delay_us);
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "nfrz")) != -1) {
+  while ((opt = getopt(argc, argv, "nfrzbsd")) != -1) {
     switch (opt) {
       case 'n':
         nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -63,6 +70,15 @@ void parse_args(int argc, char** argv)
       case 'z':
         zero_corr_zone = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'b':
+        nof_trials = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'd':
+        max_delay_us = strtof(argv[optind], NULL);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -70,10 +86,82 @@ void parse_args(int argc, char** argv)
   }
 }
 
+/*
+ * Runs the current and the fast detectors on the same preambles, received with a random delay up to the maximum delay
+ * and AWGN. Every other trial carries only noise. The fast detector shall not miss more preambles than the current one.
+ */
+static int benchmark(srslte_prach_t* detectors[2])
+{
+  const char*     names[2]           = {"current", "fast"};
+  uint32_t        nof_miss[2]        = {};
+  uint32_t        nof_false_alarm[2] = {};
+  double          elapsed_us[2]      = {};
+  static cf_t     preamble[MAX_LEN];
+  static cf_t     signal[2 * MAX_LEN];
+  uint32_t        indices[64];
+  uint32_t        n_indices  = 0;
+  srslte_random_t random_gen = srslte_random_init(0);
+  srslte_prach_t* p          = detectors[0];
+  uint32_t        max_delay  = (uint32_t)(max_delay_us * 1e-6f * p->N_ifft_ul * 15000);
+  uint32_t        len        = p->N_cp + p->N_seq;
+
+  srslte_prach_gen(p, 0, 0, preamble);
+  float noise_var = srslte_vec_avg_power_cf(preamble, len) / srslte_convert_dB_to_power(snr_db);
+
+  for (uint32_t trial = 0; trial < nof_trials; trial++) {
+    bool     has_preamble = (trial % 2) == 0;
+    uint32_t seq_index    = (uint32_t)srslte_random_uniform_int_dist(random_gen, 0, 63);
+    uint32_t delay        = (uint32_t)srslte_random_uniform_int_dist(random_gen, 0, max_delay);
+
+    srslte_vec_cf_zero(signal, len + max_delay);
+    if (has_preamble) {
+      srslte_prach_gen(p, seq_index, 0, preamble);
+      srslte_vec_cf_copy(&signal[delay], preamble, len);
+    }
+    srslte_ch_awgn_c(signal, signal, noise_var, len + max_delay);
+
+    for (uint32_t d = 0; d < 2; d++) {
+      struct timeval t[3];
+      gettimeofday(&t[1], NULL);
+      srslte_prach_detect(detectors[d], 0, &signal[p->N_cp], p->N_seq, indices, &n_indices);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      elapsed_us[d] += t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+      bool detected    = false;
+      bool false_alarm = false;
+      for (uint32_t i = 0; i < n_indices; i++) {
+        if (has_preamble && indices[i] == seq_index) {
+          detected = true;
+        } else {
+          false_alarm = true;
+        }
+      }
+      nof_miss[d] += (has_preamble && !detected) ? 1 : 0;
+      nof_false_alarm[d] += false_alarm ? 1 : 0;
+    }
+  }
+
+  for (uint32_t d = 0; d < 2; d++) {
+    printf("%-8s detector: %8.1f detections/s, miss rate %.4f, false alarm rate %.4f (SNR %.1f dB, %d trials)\n",
+           names[d],
+           nof_trials / (elapsed_us[d] * 1e-6),
+           (float)nof_miss[d] / ((nof_trials + 1) / 2),
+           (float)nof_false_alarm[d] / nof_trials,
+           snr_db,
+           nof_trials);
+  }
+
+  srslte_random_free(random_gen);
+
+  return (nof_miss[1] > nof_miss[0] + nof_trials / 100) ? SRSLTE_ERROR : SRSLTE_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   parse_args(argc, argv);
   srslte_prach_t prach;
+  srslte_prach_t prach_fast;
 
   bool high_speed_flag = false;
 
@@ -97,6 +185,20 @@ int main(int argc, char** argv)
     return -1;
   }
 
+  prach_cfg.enable_fast_detection = true;
+  if (srslte_prach_init(&prach_fast, srslte_symbol_sz(nof_prb))) {
+    return -1;
+  }
+  if (srslte_prach_set_cfg(&prach_fast, &prach_cfg, nof_prb)) {
+    ERROR("Error initiating PRACH object\n");
+    return -1;
+  }
+  if (srslte_prach_set_max_delay_us(&prach_fast, max_delay_us)) {
+    ERROR("Error setting PRACH maximum delay\n");
+    return -1;
+  }
+  srslte_prach_t* detectors[2] = {&prach, &prach_fast};
+
   uint32_t seq_index = 0;
   uint32_t indices[64];
   uint32_t n_indices = 0;
@@ -108,17 +210,24 @@ int main(int argc, char** argv)
 
     uint32_t prach_len = prach.N_seq;
 
-    struct timeval t[3];
-    gettimeofday(&t[1], NULL);
-    srslte_prach_detect(&prach, 0, &preamble[prach.N_cp], prach_len, indices, &n_indices);
-    gettimeofday(&t[2], NULL);
-    get_time_interval(t);
-    printf("texec=%ld us\n", t[0].tv_usec);
-    if (n_indices != 1 || indices[0] != seq_index)
-      return -1;
+    for (uint32_t d = 0; d < 2; d++) {
+      struct timeval t[3];
+      gettimeofday(&t[1], NULL);
+      srslte_prach_detect(detectors[d], 0, &preamble[prach.N_cp], prach_len, indices, &n_indices);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      printf("texec=%ld us\n", t[0].tv_usec);
+      if (n_indices != 1 || indices[0] != seq_index)
+        return -1;
+    }
+  }
+
+  if (nof_trials > 0 && benchmark(detectors) != SRSLTE_SUCCESS) {
+    return -1;
   }
 
   srslte_prach_free(&prach);
+  srslte_prach_free(&prach_fast);
 
   printf("Done\n");
   exit(0);
@@ -22,6 +22,8 @@
 #include "srslte/srslte.h"
 #include <srslte/phy/utils/random.h>
 
+#include "srslte/phy/utils/simd.h"
+
 bool zf_solver   = false;
 bool mmse_solver = false;
 bool verbose     = false;
@@ -66,6 +68,16 @@ static srslte_random_t random_h = NULL;
     return passed;                                                                                                     \
   }
 
+// Floating point operations per sample of the complex kernels, for reporting their GFLOP/s
+static const struct {
+  const char* name;
+  uint32_t    flops;
+} kernel_flops[] = {{"srslte_vec_acc_cc", 2},
+                    {"srslte_vec_prod_ccc", 6},
+                    {"srslte_vec_prod_conj_ccc", 6},
+                    {"srslte_vec_sc_prod_cfc", 2},
+                    {"srslte_vec_abs_square_cf", 3}};
+
 #define MALLOC(TYPE, NAME) TYPE* NAME = srslte_vec_malloc(sizeof(TYPE) * block_size)
 
 static double elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
@@ -996,6 +1008,36 @@ int main(int argc, char** argv)
       fprintf(f, "\n");
   }
 
+  printf("\n");
+  printf("%32s |", "Subroutine/GFLOP/s");
+  for (int i = 0; i < size_count; i++) {
+    printf(" %7d", sizes[i]);
+  }
+  if (SRSLTE_SIMD_F_SIZE) {
+    printf("  | SIMD %d bit\n", SRSLTE_SIMD_F_SIZE * 32);
+  } else {
+    printf("  | no SIMD\n");
+  }
+
+  for (int i = 0; i < func_count; i++) {
+    for (uint32_t k = 0; k < sizeof(kernel_flops) / sizeof(kernel_flops[0]); k++) {
+      if (strcmp(func_names[i], kernel_flops[k].name) != 0) {
+        continue;
+      }
+
+      printf("%32s | ", func_names[i]);
+      for (int j = 0; j < size_count; j++) {
+        // Timings below the clock resolution do not give a meaningful rate
+        if (timmings[i][j] > 0.0) {
+          printf(" %7.2f", (double)nof_repetitions * sizes[j] * kernel_flops[k].flops / timmings[i][j] / 1000.0);
+        } else {
+          printf(" %7s", "-");
+        }
+      }
+      printf(" |\n");
+    }
+  }
+
   if (f)
     fclose(f);
   srslte_random_free(random_h);
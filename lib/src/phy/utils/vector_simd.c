@@ -633,6 +633,18 @@ cf_t srslte_vec_acc_cc_simd(const cf_t* x, const int len)
   simd_f_t simd_sum = srslte_simd_f_zero();
 
   if (SRSLTE_IS_ALIGNED(x)) {
+    // Four independent sums, so the additions are not serialised by their latency
+    simd_f_t sum1 = srslte_simd_f_zero();
+    simd_f_t sum2 = srslte_simd_f_zero();
+    simd_f_t sum3 = srslte_simd_f_zero();
+    for (; i < len - 2 * SRSLTE_SIMD_F_SIZE + 1; i += 2 * SRSLTE_SIMD_F_SIZE) {
+      simd_sum = srslte_simd_f_add(simd_sum, srslte_simd_f_load((float*)&x[i]));
+      sum1     = srslte_simd_f_add(sum1, srslte_simd_f_load((float*)&x[i + SRSLTE_SIMD_F_SIZE / 2]));
+      sum2     = srslte_simd_f_add(sum2, srslte_simd_f_load((float*)&x[i + SRSLTE_SIMD_F_SIZE]));
+      sum3     = srslte_simd_f_add(sum3, srslte_simd_f_load((float*)&x[i + 3 * SRSLTE_SIMD_F_SIZE / 2]));
+    }
+    simd_sum = srslte_simd_f_add(srslte_simd_f_add(simd_sum, sum1), srslte_simd_f_add(sum2, sum3));
+
     for (; i < len - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
       simd_f_t a = srslte_simd_f_load((float*)&x[i]);
 
@@ -907,6 +919,27 @@ void srslte_vec_prod_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int l
   int i = 0;
 
 #if SRSLTE_SIMD_CF_SIZE
+#ifdef LV_HAVE_SSE
+  if (SRSLTE_IS_ALIGNED(x) && SRSLTE_IS_ALIGNED(y) && SRSLTE_IS_ALIGNED(z)) {
+    for (; i < len - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
+      simd_f_t a = srslte_simd_f_load((float*)&x[i]);
+      simd_f_t b = srslte_simd_f_load((float*)&y[i]);
+
+      simd_f_t r = srslte_simd_cfi_prod(a, b);
+
+      srslte_simd_f_store((float*)&z[i], r);
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
+      simd_f_t a = srslte_simd_f_loadu((float*)&x[i]);
+      simd_f_t b = srslte_simd_f_loadu((float*)&y[i]);
+
+      simd_f_t r = srslte_simd_cfi_prod(a, b);
+
+      srslte_simd_f_storeu((float*)&z[i], r);
+    }
+  }
+#else  /* LV_HAVE_SSE */
   if (SRSLTE_IS_ALIGNED(x) && SRSLTE_IS_ALIGNED(y) && SRSLTE_IS_ALIGNED(z)) {
     for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
       simd_cf_t a = srslte_simd_cfi_load(&x[i]);
@@ -926,6 +959,7 @@ void srslte_vec_prod_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int l
       srslte_simd_cfi_storeu(&z[i], r);
     }
   }
+#endif /* LV_HAVE_SSE */
 #endif
 
   for (; i < len; i++) {
@@ -1018,6 +1052,27 @@ void srslte_vec_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const
   int i = 0;
 
 #if SRSLTE_SIMD_CF_SIZE
+#ifdef LV_HAVE_SSE
+  if (SRSLTE_IS_ALIGNED(x) && SRSLTE_IS_ALIGNED(y) && SRSLTE_IS_ALIGNED(z)) {
+    for (; i < len - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
+      simd_f_t a = srslte_simd_f_load((float*)&x[i]);
+      simd_f_t b = srslte_simd_f_load((float*)&y[i]);
+
+      simd_f_t r = srslte_simd_cfi_conjprod(a, b);
+
+      srslte_simd_f_store((float*)&z[i], r);
+    }
+  } else {
+    for (; i < len - SRSLTE_SIMD_F_SIZE / 2 + 1; i += SRSLTE_SIMD_F_SIZE / 2) {
+      simd_f_t a = srslte_simd_f_loadu((float*)&x[i]);
+      simd_f_t b = srslte_simd_f_loadu((float*)&y[i]);
+
+      simd_f_t r = srslte_simd_cfi_conjprod(a, b);
+
+      srslte_simd_f_storeu((float*)&z[i], r);
+    }
+  }
+#else  /* LV_HAVE_SSE */
   if (SRSLTE_IS_ALIGNED(x) && SRSLTE_IS_ALIGNED(y) && SRSLTE_IS_ALIGNED(z)) {
     for (; i < len - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
       simd_cf_t a = srslte_simd_cfi_load(&x[i]);
@@ -1037,6 +1092,7 @@ void srslte_vec_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const
       srslte_simd_cfi_storeu(&z[i], r);
     }
   }
+#endif /* LV_HAVE_SSE */
 #endif
 
   for (; i < len; i++) {
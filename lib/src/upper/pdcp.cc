@@ -113,7 +113,11 @@ void pdcp::add_bearer(uint32_t lcid, pdcp_config_t cfg)
       return;
 #endif
     } else {
-      entity.reset(new pdcp_entity_lte{rlc, rrc, gw, task_sched, pdcp_log, lcid, cfg});
+      pdcp_entity_lte* entity_lte = new pdcp_entity_lte{rlc, rrc, gw, task_sched, pdcp_log, lcid, cfg};
+      if (crypto_batch != nullptr) {
+        entity_lte->set_crypto_batch(crypto_batch);
+      }
+      entity.reset(entity_lte);
     }
     if (not pdcp_array.insert(std::make_pair(lcid, std::move(entity))).second) {
       pdcp_log->error("Error inserting PDCP entity in to array.\n");
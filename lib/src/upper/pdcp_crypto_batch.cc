@@ -0,0 +1,119 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/upper/pdcp_crypto_batch.h"
+
+namespace srslte {
+
+pdcp_crypto_batch::pdcp_crypto_batch(task_sched_handle task_sched_, uint32_t max_batch_size_, bool use_worker) :
+  log("PDCP"),
+  task_sched(task_sched_),
+  max_batch_size(std::max(max_batch_size_, 1u)),
+  worker(use_worker ? 1 : 0)
+{
+  pending.reserve(max_batch_size);
+  if (worker.nof_workers() > 0) {
+    worker.start();
+  }
+}
+
+pdcp_crypto_batch::~pdcp_crypto_batch()
+{
+  stop();
+}
+
+void pdcp_crypto_batch::stop()
+{
+  worker.stop();
+  pending.clear();
+}
+
+void pdcp_crypto_batch::push(job_t job)
+{
+  pending.push_back(std::move(job));
+  if (pending.size() >= max_batch_size) {
+    flush();
+  }
+}
+
+void pdcp_crypto_batch::flush()
+{
+  if (pending.empty()) {
+    return;
+  }
+
+  if (worker.nof_workers() == 0) {
+    process(pending);
+    deliver(pending);
+    pending.clear();
+    return;
+  }
+
+  std::shared_ptr<std::vector<job_t> > batch = std::make_shared<std::vector<job_t> >(std::move(pending));
+  pending.clear();
+  pending.reserve(max_batch_size);
+  worker.push_task([this, batch](uint32_t worker_id) {
+    process(*batch);
+    task_sched.notify_background_task_result([this, batch]() { deliver(*batch); });
+  });
+}
+
+void pdcp_crypto_batch::process(std::vector<job_t>& jobs)
+{
+  const CIPHERING_ALGORITHM_ID_ENUM algos[] = {
+      CIPHERING_ALGORITHM_ID_128_EEA1, CIPHERING_ALGORITHM_ID_128_EEA2, CIPHERING_ALGORITHM_ID_128_EEA3};
+
+  // One batch call per algorithm, EEA0 jobs are only passed through
+  for (CIPHERING_ALGORITHM_ID_ENUM algo : algos) {
+    items.clear();
+    for (job_t& job : jobs) {
+      if (job.algo != algo || job.pdu->N_bytes <= job.offset) {
+        continue;
+      }
+      security_batch_item_t item = {};
+      item.key                   = job.key;
+      item.aes_key               = algo == CIPHERING_ALGORITHM_ID_128_EEA2 ? &job.aes_key : nullptr;
+      item.count                 = job.count;
+      item.bearer                = job.bearer;
+      item.direction             = job.direction;
+      item.msg                   = &job.pdu->msg[job.offset];
+      item.msg_len               = job.pdu->N_bytes - job.offset;
+      item.out                   = &job.pdu->msg[job.offset];
+      items.push_back(item);
+    }
+    if (not items.empty()) {
+      security_128_eea_batch(algo, items.data(), items.size());
+    }
+  }
+}
+
+void pdcp_crypto_batch::deliver(std::vector<job_t>& jobs)
+{
+  log->debug("Ciphered batch of %zu PDUs\n", jobs.size());
+  for (job_t& job : jobs) {
+    std::shared_ptr<sink_t> sink = job.sink.lock();
+    if (sink != nullptr) {
+      (*sink)(std::move(job.pdu));
+    }
+  }
+}
+
+} // namespace srslte
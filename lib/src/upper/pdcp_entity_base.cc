@@ -35,6 +35,7 @@ pdcp_entity_base::~pdcp_entity_base() {}
 void pdcp_entity_base::config_security(as_security_config_t sec_cfg_)
 {
   sec_cfg = sec_cfg_;
+  sec_ctx.set(sec_cfg);
 
   log->info("Configuring security with %s and %s\n",
             integrity_algorithm_id_text[sec_cfg.integ_algo],
@@ -67,7 +68,13 @@ void pdcp_entity_base::integrity_generate(uint8_t* msg, uint32_t msg_len, uint32
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
+      security_128_eia2(is_srb() ? sec_ctx.k_rrc_int : sec_ctx.k_up_int,
+                        count,
+                        cfg.bearer_id - 1,
+                        cfg.tx_direction,
+                        msg,
+                        msg_len,
+                        mac);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, mac);
@@ -105,7 +112,13 @@ bool pdcp_entity_base::integrity_verify(uint8_t* msg, uint32_t msg_len, uint32_t
       security_128_eia1(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA2:
-      security_128_eia2(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
+      security_128_eia2(is_srb() ? sec_ctx.k_rrc_int : sec_ctx.k_up_int,
+                        count,
+                        cfg.bearer_id - 1,
+                        cfg.rx_direction,
+                        msg,
+                        msg_len,
+                        mac_exp);
       break;
     case INTEGRITY_ALGORITHM_ID_128_EIA3:
       security_128_eia3(&k_int[16], count, cfg.bearer_id - 1, cfg.rx_direction, msg, msg_len, mac_exp);
@@ -165,8 +178,14 @@ void pdcp_entity_base::cipher_encrypt(uint8_t* msg, uint32_t msg_len, uint32_t c
       memcpy(ct, ct_tmp, msg_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
-      memcpy(ct, ct_tmp, msg_len);
+      // CTR mode can run in place, no need for the temporary buffer
+      security_128_eea2(is_srb() ? sec_ctx.k_rrc_enc : sec_ctx.k_up_enc,
+                        count,
+                        cfg.bearer_id - 1,
+                        cfg.tx_direction,
+                        msg,
+                        msg_len,
+                        ct);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&(k_enc[16]), count, cfg.bearer_id - 1, cfg.tx_direction, msg, msg_len, ct_tmp);
@@ -205,8 +224,8 @@ void pdcp_entity_base::cipher_decrypt(uint8_t* ct, uint32_t ct_len, uint32_t cou
       memcpy(msg, msg_tmp, ct_len);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA2:
-      security_128_eea2(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
-      memcpy(msg, msg_tmp, ct_len);
+      security_128_eea2(
+          is_srb() ? sec_ctx.k_rrc_enc : sec_ctx.k_up_enc, count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg);
       break;
     case CIPHERING_ALGORITHM_ID_128_EEA3:
       security_128_eea3(&k_enc[16], count, cfg.bearer_id - 1, cfg.rx_direction, ct, ct_len, msg_tmp);
@@ -75,6 +75,7 @@ pdcp_entity_lte::~pdcp_entity_lte()
 void pdcp_entity_lte::reestablish()
 {
   log->info("Re-establish %s with bearer ID: %d\n", rrc->get_rb_name(lcid).c_str(), cfg.bearer_id);
+  reset_crypto_sinks();
   // For SRBs
   if (is_srb()) {
     st.next_pdcp_tx_sn = 0;
@@ -99,6 +100,7 @@ void pdcp_entity_lte::reset()
     log->debug("Reset %s\n", rrc->get_rb_name(lcid).c_str());
   }
   active = false;
+  reset_crypto_sinks();
 }
 
 // GW/RRC interface
@@ -132,27 +134,39 @@ void pdcp_entity_lte::write_sdu(unique_byte_buffer_t sdu)
     append_mac(sdu, mac);
   }
 
-  if (encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX) {
+  // Increment NEXT_PDCP_TX_SN and TX_HFN
+  st.next_pdcp_tx_sn++;
+  if (st.next_pdcp_tx_sn > maximum_pdcp_sn) {
+    st.tx_hfn++;
+    st.next_pdcp_tx_sn = 0;
+  }
+
+  bool do_encryption = encryption_direction == DIRECTION_TX || encryption_direction == DIRECTION_TXRX;
+  if (crypto_batch != nullptr && is_drb()) {
+    // All DRB PDUs go through the batch, ciphered or not, to keep their order
+    push_crypto_job(std::move(sdu), cfg.hdr_len_bytes, tx_count, do_encryption, cfg.tx_direction, tx_sink);
+    return;
+  }
+
+  if (do_encryption) {
     cipher_encrypt(
         &sdu->msg[cfg.hdr_len_bytes], sdu->N_bytes - cfg.hdr_len_bytes, tx_count, &sdu->msg[cfg.hdr_len_bytes]);
   }
 
-  log->info_hex(sdu->msg,
-                sdu->N_bytes,
+  write_tx_pdu(std::move(sdu));
+}
+
+void pdcp_entity_lte::write_tx_pdu(unique_byte_buffer_t pdu)
+{
+  log->info_hex(pdu->msg,
+                pdu->N_bytes,
                 "TX %s PDU, SN=%d, integrity=%s, encryption=%s",
                 rrc->get_rb_name(lcid).c_str(),
-                st.next_pdcp_tx_sn,
+                read_data_header(pdu),
                 srslte_direction_text[integrity_direction],
                 srslte_direction_text[encryption_direction]);
 
-  // Increment NEXT_PDCP_TX_SN and TX_HFN
-  st.next_pdcp_tx_sn++;
-  if (st.next_pdcp_tx_sn > maximum_pdcp_sn) {
-    st.tx_hfn++;
-    st.next_pdcp_tx_sn = 0;
-  }
-
-  rlc->write_sdu(lcid, std::move(sdu));
+  rlc->write_sdu(lcid, std::move(pdu));
 }
 
 // RLC interface
@@ -268,11 +282,6 @@ void pdcp_entity_lte::handle_um_drb_pdu(srslte::unique_byte_buffer_t pdu)
   }
 
   uint32_t count = (st.rx_hfn << cfg.sn_len) | sn;
-  if (encryption_direction == DIRECTION_RX || encryption_direction == DIRECTION_TXRX) {
-    cipher_decrypt(pdu->msg, pdu->N_bytes, count, pdu->msg);
-  }
-
-  log->debug_hex(pdu->msg, pdu->N_bytes, "%s Rx PDU SN=%d", rrc->get_rb_name(lcid).c_str(), sn);
 
   st.next_pdcp_rx_sn = sn + 1;
   if (st.next_pdcp_rx_sn > maximum_pdcp_sn) {
@@ -280,8 +289,9 @@ void pdcp_entity_lte::handle_um_drb_pdu(srslte::unique_byte_buffer_t pdu)
     st.rx_hfn++;
   }
 
-  // Pass to upper layers
-  gw->write_pdu(lcid, std::move(pdu));
+  // Decrypt and pass to upper layers
+  decipher_drb_pdu(
+      std::move(pdu), count, encryption_direction == DIRECTION_RX || encryption_direction == DIRECTION_TXRX);
 }
 
 // DRBs mapped on RLC AM, without re-ordering (5.1.2.1.2)
@@ -332,17 +342,73 @@ void pdcp_entity_lte::handle_am_drb_pdu(srslte::unique_byte_buffer_t pdu)
     count = (st.rx_hfn << cfg.sn_len) | sn;
   }
 
-  // Decrypt
-  cipher_decrypt(pdu->msg, pdu->N_bytes, count, pdu->msg);
-  log->debug_hex(pdu->msg, pdu->N_bytes, "%s Rx SDU SN=%d", rrc->get_rb_name(lcid).c_str(), sn);
-
   // Update info on last PDU submitted to upper layers
   st.last_submitted_pdcp_rx_sn = sn;
 
-  // Pass to upper layers
+  // Decrypt and pass to upper layers
+  decipher_drb_pdu(std::move(pdu), count, true);
+}
+
+// Deciphers a DRB PDU, without its header, and passes it to the GW
+void pdcp_entity_lte::decipher_drb_pdu(srslte::unique_byte_buffer_t pdu, uint32_t count, bool do_decryption)
+{
+  if (crypto_batch != nullptr) {
+    push_crypto_job(std::move(pdu), 0, count, do_decryption, cfg.rx_direction, rx_sink);
+    return;
+  }
+
+  if (do_decryption) {
+    cipher_decrypt(pdu->msg, pdu->N_bytes, count, pdu->msg);
+  }
+  log->debug_hex(pdu->msg, pdu->N_bytes, "%s Rx SDU SN=%d", rrc->get_rb_name(lcid).c_str(), SN(count));
+
   gw->write_pdu(lcid, std::move(pdu));
 }
 
+/****************************************************************************
+ * Batched ciphering of DRB PDUs
+ ***************************************************************************/
+void pdcp_entity_lte::set_crypto_batch(pdcp_crypto_batch* crypto_batch_)
+{
+  crypto_batch = crypto_batch_;
+  reset_crypto_sinks();
+}
+
+void pdcp_entity_lte::reset_crypto_sinks()
+{
+  if (crypto_batch == nullptr) {
+    return;
+  }
+  tx_sink = std::make_shared<pdcp_crypto_batch::sink_t>(
+      [this](unique_byte_buffer_t pdu) { write_tx_pdu(std::move(pdu)); });
+  rx_sink = std::make_shared<pdcp_crypto_batch::sink_t>([this](unique_byte_buffer_t pdu) {
+    log->debug_hex(pdu->msg, pdu->N_bytes, "%s Rx SDU", rrc->get_rb_name(lcid).c_str());
+    gw->write_pdu(lcid, std::move(pdu));
+  });
+}
+
+void pdcp_entity_lte::push_crypto_job(srslte::unique_byte_buffer_t                      pdu,
+                                      uint32_t                                          offset,
+                                      uint32_t                                          count,
+                                      bool                                              do_cipher,
+                                      uint8_t                                           direction,
+                                      const std::shared_ptr<pdcp_crypto_batch::sink_t>& sink)
+{
+  pdcp_crypto_batch::job_t job;
+  job.pdu       = std::move(pdu);
+  job.offset    = offset;
+  job.count     = count;
+  job.bearer    = cfg.bearer_id - 1;
+  job.direction = direction;
+  job.algo      = do_cipher ? sec_cfg.cipher_algo : CIPHERING_ALGORITHM_ID_EEA0;
+  job.sink      = sink;
+  memcpy(job.key, &sec_cfg.k_up_enc[16], sizeof(job.key));
+  if (job.algo == CIPHERING_ALGORITHM_ID_128_EEA2) {
+    job.aes_key = sec_ctx.k_up_enc;
+  }
+  crypto_batch->push(std::move(job));
+}
+
 /****************************************************************************
  * Config checking helper
  ***************************************************************************/
@@ -635,6 +635,10 @@ void rlc_bearer_metrics_print(const rlc_bearer_metrics_t& metrics)
   std::cout << "num_rx_pdu_bytes=" << metrics.num_rx_pdu_bytes << "\n";
   std::cout << "num_lost_pdus=" << metrics.num_lost_pdus << "\n";
   std::cout << "num_lost_sdus=" << metrics.num_lost_sdus << "\n";
+  std::cout << "num_tx_copied_bytes=" << metrics.num_tx_copied_bytes << "\n";
+  std::cout << "num_rx_copied_bytes=" << metrics.num_rx_copied_bytes << "\n";
+  std::cout << "num_tx_lock_contentions=" << metrics.num_tx_lock_contentions << "\n";
+  std::cout << "tx_lock_wait_us=" << metrics.tx_lock_wait_us << "\n";
 }
 
 } // namespace srslte
@@ -21,6 +21,7 @@
 
 #include "srslte/upper/rlc_am_lte.h"
 
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
@@ -108,7 +109,9 @@ uint32_t rlc_am_lte::get_bearer()
 
 rlc_bearer_metrics_t rlc_am_lte::get_metrics()
 {
-  return metrics;
+  rlc_bearer_metrics_t m = metrics;
+  tx.get_lock_metrics(m);
+  return m;
 }
 
 void rlc_am_lte::reset_metrics()
@@ -176,6 +179,7 @@ rlc_am_lte::rlc_am_lte_tx::rlc_am_lte_tx(rlc_am_lte* parent_) :
   parent(parent_),
   log(parent_->log),
   pool(byte_buffer_pool::get_instance()),
+  tx_sdu_queue(RLC_MAX_TX_QUEUE_LEN),
   poll_retx_timer(parent_->timers->get_unique_timer()),
   status_prohibit_timer(parent_->timers->get_unique_timer())
 {
@@ -213,7 +217,14 @@ bool rlc_am_lte::rlc_am_lte_tx::configure(const rlc_config_t& cfg_)
     poll_retx_timer.set(static_cast<uint32_t>(cfg.t_poll_retx), [this](uint32_t timerid) { timer_expired(timerid); });
   }
 
-  tx_sdu_queue.resize(cfg_.tx_queue_length);
+  // the queue is not resized, as PDCP may be writing SDUs to it
+  if (cfg_.tx_queue_length > tx_sdu_queue.capacity()) {
+    log->error("Configuring RLC AM TX: tx_queue_length=%d exceeds the maximum of %d\n",
+               cfg_.tx_queue_length,
+               (uint32_t)tx_sdu_queue.capacity());
+    return false;
+  }
+  tx_queue_length = cfg_.tx_queue_length;
 
   tx_enabled = true;
 
@@ -224,7 +235,7 @@ void rlc_am_lte::rlc_am_lte_tx::stop()
 {
   empty_queue();
 
-  pthread_mutex_lock(&mutex);
+  lock();
 
   tx_enabled = false;
 
@@ -249,22 +260,23 @@ void rlc_am_lte::rlc_am_lte_tx::stop()
 
   // Drop all messages in RETX queue
   retx_queue.clear();
-  pthread_mutex_unlock(&mutex);
+  unlock();
 }
 
 void rlc_am_lte::rlc_am_lte_tx::empty_queue()
 {
-  pthread_mutex_lock(&mutex);
+  lock();
 
   // deallocate all SDUs in transmit queue
-  while (tx_sdu_queue.size() > 0) {
-    unique_byte_buffer_t buf = tx_sdu_queue.read();
+  unique_byte_buffer_t buf;
+  while (pop_sdu(buf)) {
+    buf.reset();
   }
 
   // deallocate SDU that is currently processed
   tx_sdu.reset();
 
-  pthread_mutex_unlock(&mutex);
+  unlock();
 }
 
 void rlc_am_lte::rlc_am_lte_tx::reestablish()
@@ -284,12 +296,12 @@ bool rlc_am_lte::rlc_am_lte_tx::has_data()
   return (((do_status() && not status_prohibit_timer.is_running())) || // if we have a status PDU to transmit
           (not retx_queue.empty()) ||                                  // if we have a retransmission
           (tx_sdu != NULL) ||                                          // if we are currently transmitting a SDU
-          (not tx_sdu_queue.is_empty())); // or if there is a SDU queued up for transmission
+          (not tx_sdu_queue.empty())); // or if there is a SDU queued up for transmission
 }
 
 uint32_t rlc_am_lte::rlc_am_lte_tx::get_buffer_state()
 {
-  pthread_mutex_lock(&mutex);
+  lock();
   uint32_t n_bytes = 0;
   uint32_t n_sdus  = 0;
 
@@ -315,7 +327,7 @@ uint32_t rlc_am_lte::rlc_am_lte_tx::get_buffer_state()
                retx.is_segment ? "true" : "false",
                retx.so_start,
                retx.so_end);
-    if (tx_window.end() != tx_window.find(retx.sn)) {
+    if (tx_window.has_sn(retx.sn)) {
       int req_bytes = required_buffer_size(retx);
       if (req_bytes < 0) {
         log->error("In get_buffer_state(): Removing retx.sn=%d from queue\n", retx.sn);
@@ -330,7 +342,7 @@ uint32_t rlc_am_lte::rlc_am_lte_tx::get_buffer_state()
   // Bytes needed for tx SDUs
   if (tx_window.size() < 1024) {
     n_sdus = tx_sdu_queue.size();
-    n_bytes += tx_sdu_queue.size_bytes();
+    n_bytes += tx_sdu_queue_bytes;
     if (tx_sdu != NULL) {
       n_sdus++;
       n_bytes += tx_sdu->N_bytes;
@@ -348,7 +360,7 @@ uint32_t rlc_am_lte::rlc_am_lte_tx::get_buffer_state()
     log->debug("%s Total buffer state - %d SDUs (%d B)\n", RB_NAME, n_sdus, n_bytes);
   }
 
-  pthread_mutex_unlock(&mutex);
+  unlock();
   return n_bytes;
 }
 
@@ -363,20 +375,26 @@ int rlc_am_lte::rlc_am_lte_tx::write_sdu(unique_byte_buffer_t sdu)
     return SRSLTE_ERROR;
   }
 
-  uint8_t*                                 msg_ptr   = sdu->msg;
-  uint32_t                                 nof_bytes = sdu->N_bytes;
-  srslte::error_type<unique_byte_buffer_t> ret       = tx_sdu_queue.try_write(std::move(sdu));
-  if (ret) {
-    log->info_hex(
-        msg_ptr, nof_bytes, "%s Tx SDU (%d B, tx_sdu_queue_len=%d)\n", RB_NAME, nof_bytes, tx_sdu_queue.size());
+  uint8_t* msg_ptr   = sdu->msg;
+  uint32_t nof_bytes = sdu->N_bytes;
+  // account the bytes before the SDU becomes visible to the MAC, which may pop it right away
+  tx_sdu_queue_bytes += nof_bytes;
+  if (tx_sdu_queue.size() < tx_queue_length && tx_sdu_queue.try_push(sdu)) {
+    log->info_hex(msg_ptr,
+                  nof_bytes,
+                  "%s Tx SDU (%d B, tx_sdu_queue_len=%d)\n",
+                  RB_NAME,
+                  nof_bytes,
+                  (uint32_t)tx_sdu_queue.size());
   } else {
-    // in case of fail, the try_write returns back the sdu
-    log->warning_hex(ret.error()->msg,
-                     ret.error()->N_bytes,
+    // in case of fail, the SDU is left untouched
+    tx_sdu_queue_bytes -= nof_bytes;
+    log->warning_hex(sdu->msg,
+                     sdu->N_bytes,
                      "[Dropped SDU] %s Tx SDU (%d B, tx_sdu_queue_len=%d)\n",
                      RB_NAME,
-                     ret.error()->N_bytes,
-                     tx_sdu_queue.size());
+                     sdu->N_bytes,
+                     (uint32_t)tx_sdu_queue.size());
     return SRSLTE_ERROR;
   }
 
@@ -393,17 +411,17 @@ void rlc_am_lte::rlc_am_lte_tx::discard_sdu(uint32_t discard_sn)
 
 bool rlc_am_lte::rlc_am_lte_tx::sdu_queue_is_full()
 {
-  return tx_sdu_queue.is_full();
+  return tx_sdu_queue.size() >= tx_queue_length;
 }
 
 int rlc_am_lte::rlc_am_lte_tx::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
-  pthread_mutex_lock(&mutex);
+  lock();
 
   int pdu_size = 0;
 
   log->debug("MAC opportunity - %d bytes\n", nof_bytes);
-  log->debug("tx_window size - %zu PDUs\n", tx_window.size());
+  log->debug("tx_window size - %d PDUs\n", tx_window.size());
 
   if (not tx_enabled) {
     log->debug("RLC entity not active. Not generating PDU.\n");
@@ -434,23 +452,23 @@ int rlc_am_lte::rlc_am_lte_tx::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 
 unlock_and_exit:
   num_tx_bytes += pdu_size;
-  pthread_mutex_unlock(&mutex);
+  unlock();
   return pdu_size;
 }
 
 void rlc_am_lte::rlc_am_lte_tx::timer_expired(uint32_t timeout_id)
 {
-  pthread_mutex_lock(&mutex);
+  lock();
   if (poll_retx_timer.is_valid() && poll_retx_timer.id() == timeout_id) {
     log->debug("Poll reTx timer expired for LCID=%d after %d ms\n", parent->lcid, poll_retx_timer.duration());
     // Section 5.2.2.3 in TS 36.311, schedule random PDU for retransmission if
     // (a) both tx and retx buffer are empty, or
     // (b) no new data PDU can be transmitted (tx window is full)
-    if ((retx_queue.empty() && tx_sdu_queue.size() == 0) || tx_window.size() >= RLC_AM_WINDOW_SIZE) {
+    if ((retx_queue.empty() && tx_sdu_queue.empty()) || tx_window.size() >= RLC_AM_WINDOW_SIZE) {
       retransmit_random_pdu();
     }
   }
-  pthread_mutex_unlock(&mutex);
+  unlock();
 
   if (bsr_callback) {
     bsr_callback(parent->lcid, get_buffer_state(), 0);
@@ -461,14 +479,17 @@ void rlc_am_lte::rlc_am_lte_tx::retransmit_random_pdu()
 {
   if (not tx_window.empty()) {
     // randomly select PDU in tx window for retransmission
-    std::map<uint32_t, rlc_amd_tx_pdu_t>::iterator it = tx_window.begin();
-    std::advance(it, rand() % tx_window.size());
-    log->info("Schedule SN=%d for reTx.\n", it->first);
+    uint32_t k  = rand() % tx_window.size();
+    uint32_t sn = vt_a;
+    while (not tx_window.has_sn(sn) or k-- > 0) {
+      sn = (sn + 1) % MOD;
+    }
+    log->info("Schedule SN=%d for reTx.\n", sn);
     rlc_amd_retx_t retx = {};
     retx.is_segment     = false;
     retx.so_start       = 0;
-    retx.so_end         = it->second.buf->N_bytes;
-    retx.sn             = it->first;
+    retx.so_end         = tx_window[sn].buf->N_bytes;
+    retx.sn             = sn;
     retx_queue.push_back(retx);
   }
 }
@@ -480,15 +501,55 @@ uint32_t rlc_am_lte::rlc_am_lte_tx::get_num_tx_bytes()
 
 void rlc_am_lte::rlc_am_lte_tx::reset_metrics()
 {
-  pthread_mutex_lock(&mutex);
+  lock();
   num_tx_bytes = 0;
-  pthread_mutex_unlock(&mutex);
+  unlock();
+  num_lock_contentions = 0;
+  lock_wait_us         = 0;
+}
+
+void rlc_am_lte::rlc_am_lte_tx::get_lock_metrics(rlc_bearer_metrics_t& m)
+{
+  m.num_tx_lock_contentions = num_lock_contentions;
+  m.tx_lock_wait_us         = lock_wait_us;
 }
 
 /****************************************************************************
  * Helper functions
  ***************************************************************************/
 
+/**
+ * Acquire the lock protecting the TX state. The lock is first tried without blocking, so
+ * that the number of times and the time the caller had to wait for another thread
+ * (e.g. the stack thread handling a status PDU while the PHY worker builds a PDU) can be
+ * reported in the bearer metrics.
+ */
+void rlc_am_lte::rlc_am_lte_tx::lock()
+{
+  if (pthread_mutex_trylock(&mutex) == 0) {
+    return;
+  }
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  pthread_mutex_lock(&mutex);
+  num_lock_contentions++;
+  lock_wait_us +=
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void rlc_am_lte::rlc_am_lte_tx::unlock()
+{
+  pthread_mutex_unlock(&mutex);
+}
+
+bool rlc_am_lte::rlc_am_lte_tx::pop_sdu(unique_byte_buffer_t& sdu)
+{
+  if (not tx_sdu_queue.try_pop(sdu)) {
+    return false;
+  }
+  tx_sdu_queue_bytes -= std::min(sdu->N_bytes, tx_sdu_queue_bytes.load());
+  return true;
+}
+
 /**
  * Called when building a RLC PDU for checking whether the poll bit needs
  * to be set.
@@ -516,7 +577,7 @@ bool rlc_am_lte::rlc_am_lte_tx::poll_required()
     return true;
   }
 
-  if (tx_sdu_queue.size() == 0 && retx_queue.empty()) {
+  if (tx_sdu_queue.empty() && retx_queue.empty()) {
     return true;
   }
 
@@ -566,7 +627,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_retx_pdu(uint8_t* payload, uint32_t nof_byt
   rlc_amd_retx_t retx = retx_queue.front();
 
   // Sanity check - drop any retx SNs not present in tx_window
-  while (tx_window.end() == tx_window.find(retx.sn)) {
+  while (not tx_window.has_sn(retx.sn)) {
     retx_queue.pop_front();
     if (!retx_queue.empty()) {
       retx = retx_queue.front();
@@ -790,7 +851,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_segment(uint8_t* payload, uint32_t nof_byte
 
 int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
-  if (tx_sdu == NULL && tx_sdu_queue.is_empty()) {
+  if (tx_sdu == NULL && tx_sdu_queue.empty()) {
     log->info("No data available to be sent\n");
     return 0;
   }
@@ -801,16 +862,18 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
     return 0;
   }
 
+  // Allocate the PDU buffer before any SDU is taken from the queue, so no SDU is lost if the pool is exhausted
   unique_byte_buffer_t pdu = srslte::allocate_unique_buffer(*pool, true);
   if (pdu == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
     srslte::console("Fatal Error: Could not allocate PDU in build_data_pdu()\n");
-    srslte::console("tx_window size: %zd PDUs\n", tx_window.size());
+    srslte::console("tx_window size: %d PDUs\n", tx_window.size());
     srslte::console("vt_a = %d, vt_ms = %d, vt_s = %d, poll_sn = %d\n", vt_a, vt_ms, vt_s, poll_sn);
     srslte::console("retx_queue size: %zd PDUs\n", retx_queue.size());
-    std::map<uint32_t, rlc_amd_tx_pdu_t>::iterator txit;
-    for (txit = tx_window.begin(); txit != tx_window.end(); txit++) {
-      srslte::console("tx_window - SN=%d\n", txit->first);
+    for (uint32_t sn = vt_a; sn != vt_s; sn = (sn + 1) % MOD) {
+      if (tx_window.has_sn(sn)) {
+        srslte::console("tx_window - SN=%d\n", sn);
+      }
     }
     exit(-1);
 #else
@@ -818,6 +881,9 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
     return 0;
 #endif
   }
+
+  const uint32_t max_pdu_payload = SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET;
+
   rlc_amd_pdu_header_t header = {};
   header.dc                   = RLC_DC_FIELD_DATA_PDU;
   header.fi                   = RLC_FI_FIELD_START_AND_END_ALIGNED;
@@ -826,8 +892,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   uint32_t head_len  = rlc_am_packed_length(&header);
   uint32_t to_move   = 0;
   uint32_t last_li   = 0;
-  uint32_t pdu_space = SRSLTE_MIN(nof_bytes, pdu->get_tailroom());
-  uint8_t* pdu_ptr   = pdu->msg;
+  uint32_t pdu_space = SRSLTE_MIN(nof_bytes, max_pdu_payload);
 
   if (pdu_space <= head_len + 1) {
     log->info(
@@ -840,18 +905,16 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   // Check for SDU segment
   if (tx_sdu != NULL) {
     to_move = ((pdu_space - head_len) >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : pdu_space - head_len;
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
+    pdu_slices.append(tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
     tx_sdu->N_bytes -= to_move;
     tx_sdu->msg += to_move;
     if (tx_sdu->N_bytes == 0) {
       log->debug("%s Complete SDU scheduled for tx. Stack latency: %ld us\n", RB_NAME, tx_sdu->get_latency_us());
-      tx_sdu.reset();
+      pdu_slices.hold(std::move(tx_sdu));
     }
     if (pdu_space > to_move) {
-      pdu_space -= SRSLTE_MIN(to_move, pdu->get_tailroom());
+      pdu_space -= SRSLTE_MIN(to_move, max_pdu_payload - pdu_slices.size_bytes());
     } else {
       pdu_space = 0;
     }
@@ -865,29 +928,28 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   }
 
   // Pull SDUs from queue
-  while (pdu_space > head_len + 1 && tx_sdu_queue.size() > 0 && header.N_li < RLC_AM_WINDOW_SIZE) {
+  while (pdu_space > head_len + 1 && not tx_sdu_queue.empty() && header.N_li < RLC_AM_WINDOW_SIZE) {
     if (last_li > 0) {
       header.li[header.N_li] = last_li;
       header.N_li++;
     }
     head_len = rlc_am_packed_length(&header);
-    if (head_len >= pdu_space) {
+    // The LI is removed again if no SDU follows it. The pop can fail although the queue isn't empty, while the
+    // producer that reserved the slot is still writing the SDU
+    if (head_len >= pdu_space || not pop_sdu(tx_sdu)) {
       if (header.N_li > 0) {
         header.N_li--;
       }
       break;
     }
-    tx_sdu  = tx_sdu_queue.read();
     to_move = ((pdu_space - head_len) >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : pdu_space - head_len;
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
+    pdu_slices.append(tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
     tx_sdu->N_bytes -= to_move;
     tx_sdu->msg += to_move;
     if (tx_sdu->N_bytes == 0) {
       log->debug("%s Complete SDU scheduled for tx. Stack latency: %ld us\n", RB_NAME, tx_sdu->get_latency_us());
-      tx_sdu.reset();
+      pdu_slices.hold(std::move(tx_sdu));
     }
     if (pdu_space > to_move) {
       pdu_space -= to_move;
@@ -903,11 +965,23 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   }
 
   // Make sure, at least one SDU (segment) has been added until this point
-  if (pdu->N_bytes == 0) {
+  if (pdu_slices.size_bytes() == 0) {
     log->error("Generated empty RLC PDU.\n");
+    pdu_slices.clear();
     return 0;
   }
 
+  // A PDU made of the remainder of a single SDU reuses the SDU buffer. Otherwise the segments are gathered into the
+  // PDU buffer, which is kept in the tx_window for retransmissions
+  unique_byte_buffer_t sdu_buf = pdu_slices.release_single_buffer();
+  if (sdu_buf != nullptr) {
+    pdu = std::move(sdu_buf);
+  } else {
+    pdu->N_bytes = pdu_slices.copy_to(pdu->msg);
+    parent->metrics.num_tx_copied_bytes += pdu->N_bytes;
+    pdu_slices.clear();
+  }
+
   if (tx_sdu != NULL) {
     header.fi |= RLC_FI_FIELD_NOT_END_ALIGNED; // Last byte does not correspond to last byte of SDU
   }
@@ -933,11 +1007,12 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   vt_s      = (vt_s + 1) % MOD;
 
   // Place PDU in tx_window, write header and TX
-  tx_window[header.sn].buf        = std::move(pdu);
-  tx_window[header.sn].header     = header;
-  tx_window[header.sn].is_acked   = false;
-  tx_window[header.sn].retx_count = 0;
-  const byte_buffer_t* buffer_ptr = tx_window[header.sn].buf.get();
+  rlc_amd_tx_pdu_t& tx_pdu        = tx_window.add_pdu(header.sn);
+  tx_pdu.buf                      = std::move(pdu);
+  tx_pdu.header                   = header;
+  tx_pdu.is_acked                 = false;
+  tx_pdu.retx_count               = 0;
+  const byte_buffer_t* buffer_ptr = tx_pdu.buf.get();
 
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&header, &ptr);
@@ -951,15 +1026,16 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
 
 void rlc_am_lte::rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
-  pthread_mutex_lock(&mutex);
-
   log->info_hex(payload, nof_bytes, "%s Rx control PDU", RB_NAME);
 
+  // Unpack the status PDU before taking the lock, it doesn't touch the TX state
   rlc_status_pdu_t status;
   rlc_am_read_status_pdu(payload, nof_bytes, &status);
 
   log->info("%s Rx Status PDU: %s\n", RB_NAME, rlc_am_status_pdu_to_string(&status).c_str());
 
+  lock();
+
   if (poll_retx_timer.is_valid()) {
     poll_retx_timer.stop();
   }
@@ -970,9 +1046,8 @@ void rlc_am_lte::rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t no
   }
 
   // Handle ACKs and NACKs
-  std::map<uint32_t, rlc_amd_tx_pdu_t>::iterator it;
-  bool                                           update_vt_a = true;
-  uint32_t                                       i           = vt_a;
+  bool     update_vt_a = true;
+  uint32_t i           = vt_a;
 
   while (TX_MOD_BASE(i) < TX_MOD_BASE(status.ack_sn) && TX_MOD_BASE(i) < TX_MOD_BASE(vt_s)) {
     bool nack = false;
@@ -980,34 +1055,34 @@ void rlc_am_lte::rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t no
       if (status.nacks[j].nack_sn == i) {
         nack        = true;
         update_vt_a = false;
-        it          = tx_window.find(i);
-        if (tx_window.end() != it) {
+        if (tx_window.has_sn(i)) {
+          rlc_amd_tx_pdu_t& pdu = tx_window[i];
           if (!retx_queue_has_sn(i)) {
             rlc_amd_retx_t retx = {};
             retx.sn             = i;
             retx.is_segment     = false;
             retx.so_start       = 0;
-            retx.so_end         = it->second.buf->N_bytes;
+            retx.so_end         = pdu.buf->N_bytes;
 
             if (status.nacks[j].has_so) {
               // sanity check
-              if (status.nacks[j].so_start >= it->second.buf->N_bytes) {
+              if (status.nacks[j].so_start >= pdu.buf->N_bytes) {
                 // print error but try to send original PDU again
                 log->info("SO_start is larger than original PDU (%d >= %d)\n",
                           status.nacks[j].so_start,
-                          it->second.buf->N_bytes);
+                          pdu.buf->N_bytes);
                 status.nacks[j].so_start = 0;
               }
 
               // check for special SO_end value
               if (status.nacks[j].so_end == 0x7FFF) {
-                status.nacks[j].so_end = it->second.buf->N_bytes;
+                status.nacks[j].so_end = pdu.buf->N_bytes;
               } else {
                 retx.so_end = status.nacks[j].so_end + 1;
               }
 
-              if (status.nacks[j].so_start < it->second.buf->N_bytes &&
-                  status.nacks[j].so_end <= it->second.buf->N_bytes) {
+              if (status.nacks[j].so_start < pdu.buf->N_bytes &&
+                  status.nacks[j].so_end <= pdu.buf->N_bytes) {
                 retx.is_segment = true;
                 retx.so_start   = status.nacks[j].so_start;
               } else {
@@ -1016,7 +1091,7 @@ void rlc_am_lte::rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t no
                              i,
                              status.nacks[j].so_start,
                              status.nacks[j].so_end,
-                             it->second.buf->N_bytes);
+                             pdu.buf->N_bytes);
               }
             }
             retx_queue.push_back(retx);
@@ -1027,14 +1102,11 @@ void rlc_am_lte::rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t no
 
     if (!nack) {
       // ACKed SNs get marked and removed from tx_window if possible
-      if (tx_window.count(i) > 0) {
-        it = tx_window.find(i);
-        if (it != tx_window.end()) {
-          if (update_vt_a) {
-            tx_window.erase(it);
-            vt_a  = (vt_a + 1) % MOD;
-            vt_ms = (vt_ms + 1) % MOD;
-          }
+      if (tx_window.has_sn(i)) {
+        if (update_vt_a) {
+          tx_window.remove_pdu(i);
+          vt_a  = (vt_a + 1) % MOD;
+          vt_ms = (vt_ms + 1) % MOD;
         }
       }
     }
@@ -1043,7 +1115,7 @@ void rlc_am_lte::rlc_am_lte_tx::handle_control_pdu(uint8_t* payload, uint32_t no
 
   debug_state();
 
-  pthread_mutex_unlock(&mutex);
+  unlock();
 }
 
 void rlc_am_lte::rlc_am_lte_tx::debug_state()
@@ -1054,7 +1126,7 @@ void rlc_am_lte::rlc_am_lte_tx::debug_state()
 int rlc_am_lte::rlc_am_lte_tx::required_buffer_size(rlc_amd_retx_t retx)
 {
   if (!retx.is_segment) {
-    if (tx_window.count(retx.sn) == 1) {
+    if (tx_window.has_sn(retx.sn)) {
       if (tx_window[retx.sn].buf) {
         return rlc_am_packed_length(&tx_window[retx.sn].header) + tx_window[retx.sn].buf->N_bytes;
       } else {
@@ -1213,8 +1285,6 @@ void rlc_am_lte::rlc_am_lte_rx::stop()
  */
 void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_bytes, rlc_amd_pdu_header_t& header)
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_t>::iterator it;
-
   log->info_hex(payload, nof_bytes, "%s Rx data PDU SN=%d (%d B)", RB_NAME, header.sn, nof_bytes);
   log->debug("%s\n", rlc_amd_pdu_header_to_string(header).c_str());
 
@@ -1239,8 +1309,7 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_b
     return;
   }
 
-  it = rx_window.find(header.sn);
-  if (rx_window.end() != it) {
+  if (rx_window.has_sn(header.sn)) {
     if (header.p) {
       log->info("%s Status packet requested through polling bit\n", RB_NAME);
       do_status = true;
@@ -1250,9 +1319,8 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_b
   }
 
   // Write to rx window
-  rlc_amd_rx_pdu_t pdu;
-  pdu.buf = srslte::allocate_unique_buffer(*pool, true);
-  if (pdu.buf == NULL) {
+  srslte::unique_byte_buffer_t buf = srslte::allocate_unique_buffer(*pool, true);
+  if (buf == NULL) {
 #ifdef RLC_AM_BUFFER_DEBUG
     srslte::console("Fatal Error: Couldn't allocate PDU in handle_data_pdu().\n");
     exit(-1);
@@ -1263,19 +1331,20 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_b
   }
 
   // check available space for payload
-  if (nof_bytes > pdu.buf->get_tailroom()) {
+  if (nof_bytes > buf->get_tailroom()) {
     log->error("%s Discarding SN=%d of size %d B (available space %d B)\n",
                RB_NAME,
                header.sn,
                nof_bytes,
-               pdu.buf->get_tailroom());
+               buf->get_tailroom());
     return;
   }
-  memcpy(pdu.buf->msg, payload, nof_bytes);
-  pdu.buf->N_bytes = nof_bytes;
-  pdu.header       = header;
+  memcpy(buf->msg, payload, nof_bytes);
+  buf->N_bytes = nof_bytes;
 
-  rx_window[header.sn] = std::move(pdu);
+  rlc_amd_rx_pdu_t& pdu = rx_window.add_pdu(header.sn);
+  pdu.buf               = std::move(buf);
+  pdu.header            = header;
 
   // Update vr_h
   if (RX_MOD_BASE(header.sn) >= RX_MOD_BASE(vr_h)) {
@@ -1283,11 +1352,7 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu(uint8_t* payload, uint32_t nof_b
   }
 
   // Update vr_ms
-  it = rx_window.find(vr_ms);
-  while (rx_window.end() != it) {
-    vr_ms = (vr_ms + 1) % MOD;
-    it    = rx_window.find(vr_ms);
-  }
+  update_vr_ms();
 
   // Check poll bit
   if (header.p) {
@@ -1335,8 +1400,6 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
                                                         uint32_t              nof_bytes,
                                                         rlc_amd_pdu_header_t& header)
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-
   log->info_hex(payload,
                 nof_bytes,
                 "%s Rx data PDU segment of SN=%d (%d B), SO=%d, N_li=%d",
@@ -1379,8 +1442,7 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
   segment.header       = header;
 
   // Check if we already have a segment from the same PDU
-  it = rx_segments.find(header.sn);
-  if (rx_segments.end() != it) {
+  if (rx_segments.has_sn(header.sn)) {
 
     if (header.p) {
       log->info("%s Status packet requested through polling bit\n", RB_NAME);
@@ -1389,16 +1451,15 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
 
     // Add segment to PDU list and check for complete
     // NOTE: MAY MOVE. Preference would be to capture by value, and then move; but header is stack allocated
-    if (add_segment_and_check(&it->second, &segment)) {
-      rx_segments.erase(it);
+    if (add_segment_and_check(&rx_segments[header.sn], &segment)) {
+      rx_segments.remove_pdu(header.sn);
     }
 
   } else {
 
     // Create new PDU segment list and write to rx_segments
-    rlc_amd_rx_pdu_segments_t pdu;
+    rlc_amd_rx_pdu_segments_t& pdu = rx_segments.add_pdu(header.sn);
     pdu.segments.push_back(std::move(segment));
-    rx_segments[header.sn] = std::move(pdu);
 
     // Update vr_h
     if (RX_MOD_BASE(header.sn) >= RX_MOD_BASE(vr_h)) {
@@ -1440,7 +1501,7 @@ void rlc_am_lte::rlc_am_lte_rx::reassemble_rx_sdus()
   }
 
   // Iterate through rx_window, assembling and delivering SDUs
-  while (rx_window.end() != rx_window.find(vr_r)) {
+  while (rx_window.has_sn(vr_r)) {
     // Handle any SDU segments
     for (uint32_t i = 0; i < rx_window[vr_r].header.N_li; i++) {
       len = rx_window[vr_r].header.li[i];
@@ -1468,6 +1529,7 @@ void rlc_am_lte::rlc_am_lte_rx::reassemble_rx_sdus()
 
           memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_r].buf->msg, len);
           rx_sdu->N_bytes += len;
+          parent->metrics.num_rx_copied_bytes += len;
 
           rx_window[vr_r].buf->msg += len;
           rx_window[vr_r].buf->N_bytes -= len;
@@ -1503,9 +1565,14 @@ void rlc_am_lte::rlc_am_lte_rx::reassemble_rx_sdus()
     // Handle last segment
     len = rx_window[vr_r].buf->N_bytes;
     log->debug_hex(rx_window[vr_r].buf->msg, len, "Handling last segment of length %d B of SN=%d\n", len, vr_r);
-    if (rx_sdu->get_tailroom() >= len) {
+    if (rx_sdu->N_bytes == 0 && rlc_am_end_aligned(rx_window[vr_r].header.fi)) {
+      // The last segment is a whole SDU, take over the PDU buffer which already points to it. A segment starting an
+      // SDU is copied instead, the PDU buffer lacks the tailroom for the segments still to come.
+      std::swap(rx_sdu, rx_window[vr_r].buf);
+    } else if (rx_sdu->get_tailroom() >= len) {
       memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_r].buf->msg, len);
       rx_sdu->N_bytes += rx_window[vr_r].buf->N_bytes;
+      parent->metrics.num_rx_copied_bytes += len;
     } else {
       printf("Cannot fit RLC PDU in SDU buffer (tailroom=%d, len=%d), dropping both. Erasing SN=%d.\n",
              rx_sdu->get_tailroom(),
@@ -1537,21 +1604,19 @@ void rlc_am_lte::rlc_am_lte_rx::reassemble_rx_sdus()
     // Move the rx_window
     log->debug("Erasing SN=%d.\n", vr_r);
     // also erase any segments of this SN
-    std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-    it = rx_segments.find(vr_r);
-    if (rx_segments.end() != it) {
+    if (rx_segments.has_sn(vr_r)) {
       log->debug("Erasing segments of SN=%d\n", vr_r);
       std::list<rlc_amd_rx_pdu_t>::iterator segit;
-      for (segit = it->second.segments.begin(); segit != it->second.segments.end(); ++segit) {
+      for (segit = rx_segments[vr_r].segments.begin(); segit != rx_segments[vr_r].segments.end(); ++segit) {
         log->debug(" Erasing segment of SN=%d SO=%d Len=%d N_li=%d\n",
                    segit->header.sn,
                    segit->header.so,
                    segit->buf->N_bytes,
                    segit->header.N_li);
       }
-      it->second.segments.clear();
+      rx_segments.remove_pdu(vr_r);
     }
-    rx_window.erase(vr_r);
+    rx_window.remove_pdu(vr_r);
     vr_r  = (vr_r + 1) % MOD;
     vr_mr = (vr_mr + 1) % MOD;
   }
@@ -1624,12 +1689,8 @@ void rlc_am_lte::rlc_am_lte_rx::timer_expired(uint32_t timeout_id)
     log->debug("%s reordering timeout expiry - updating vr_ms (was %d)\n", RB_NAME, vr_ms);
 
     // 36.322 v10 Section 5.1.3.2.4
-    vr_ms                                             = vr_x;
-    std::map<uint32_t, rlc_amd_rx_pdu_t>::iterator it = rx_window.find(vr_ms);
-    while (rx_window.end() != it) {
-      vr_ms = (vr_ms + 1) % MOD;
-      it    = rx_window.find(vr_ms);
-    }
+    vr_ms = vr_x;
+    update_vr_ms();
 
     if (poll_received) {
       do_status = true;
@@ -1645,6 +1706,13 @@ void rlc_am_lte::rlc_am_lte_rx::timer_expired(uint32_t timeout_id)
   pthread_mutex_unlock(&mutex);
 }
 
+// Advance vr_ms past the SNs that have been received, i.e. up to the first missing SN in the rx window
+void rlc_am_lte::rlc_am_lte_rx::update_vr_ms()
+{
+  uint32_t max_run = RX_MOD_BASE(vr_mr) - RX_MOD_BASE(vr_ms);
+  vr_ms            = (vr_ms + rx_window.count_run(vr_ms, max_run, true)) % MOD;
+}
+
 // Called from Tx object to pack status PDU that doesn't exceed a given size
 int rlc_am_lte::rlc_am_lte_rx::get_status_pdu(rlc_status_pdu_t* status, const uint32_t max_pdu_size)
 {
@@ -1655,11 +1723,13 @@ int rlc_am_lte::rlc_am_lte_rx::get_status_pdu(rlc_status_pdu_t* status, const ui
   // We don't use segment NACKs - just NACK the full PDU
   uint32_t i = vr_r;
   while (RX_MOD_BASE(i) < RX_MOD_BASE(vr_ms) && status->N_nack < RLC_AM_WINDOW_SIZE) {
-    if (rx_window.find(i) == rx_window.end()) {
+    if (not rx_window.has_sn(i)) {
       status->nacks[status->N_nack].nack_sn = i;
       status->N_nack++;
     } else {
-      // only update ACK_SN if this SN has been received
+      // only update ACK_SN if this SN has been received, skipping the whole run of received SNs at once
+      uint32_t run   = rx_window.count_run(i, RX_MOD_BASE(vr_ms) - RX_MOD_BASE(i), true);
+      i              = (i + run - 1) % MOD;
       status->ack_sn = i;
     }
 
@@ -1698,10 +1768,14 @@ int rlc_am_lte::rlc_am_lte_rx::get_status_pdu_length()
   status.ack_sn           = vr_ms;
   uint32_t i              = vr_r;
   while (RX_MOD_BASE(i) < RX_MOD_BASE(vr_ms) && status.N_nack < RLC_AM_WINDOW_SIZE) {
-    if (rx_window.find(i) == rx_window.end()) {
-      status.N_nack++;
+    // count missing SNs run by run using the occupancy bitmap of the window
+    uint32_t remaining = RX_MOD_BASE(vr_ms) - RX_MOD_BASE(i);
+    uint32_t missing   = rx_window.count_run(i, std::min(remaining, RLC_AM_WINDOW_SIZE - status.N_nack), false);
+    status.N_nack += missing;
+    i = (i + missing) % MOD;
+    if (RX_MOD_BASE(i) < RX_MOD_BASE(vr_ms) && status.N_nack < RLC_AM_WINDOW_SIZE) {
+      i = (i + rx_window.count_run(i, RX_MOD_BASE(vr_ms) - RX_MOD_BASE(i), true)) % MOD;
     }
-    i = (i + 1) % MOD;
   }
   pthread_mutex_unlock(&mutex);
   return rlc_am_packed_length(&status);
@@ -1709,12 +1783,14 @@ int rlc_am_lte::rlc_am_lte_rx::get_status_pdu_length()
 
 void rlc_am_lte::rlc_am_lte_rx::print_rx_segments()
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-  std::stringstream                                       ss;
+  std::stringstream ss;
   ss << "rx_segments:" << std::endl;
-  for (it = rx_segments.begin(); it != rx_segments.end(); it++) {
+  for (uint32_t sn = vr_r; sn != vr_h; sn = (sn + 1) % MOD) {
+    if (not rx_segments.has_sn(sn)) {
+      continue;
+    }
     std::list<rlc_amd_rx_pdu_t>::iterator segit;
-    for (segit = it->second.segments.begin(); segit != it->second.segments.end(); segit++) {
+    for (segit = rx_segments[sn].segments.begin(); segit != rx_segments[sn].segments.end(); segit++) {
       ss << "    SN=" << segit->header.sn << " SO:" << segit->header.so << " N:" << segit->buf->N_bytes
          << " N_li: " << segit->header.N_li << std::endl;
     }
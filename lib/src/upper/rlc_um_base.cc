@@ -146,7 +146,7 @@ uint32_t rlc_um_base::get_buffer_state()
 int rlc_um_base::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   if (tx && tx_enabled) {
-    uint32_t len = tx->build_data_pdu(payload, nof_bytes);
+    uint32_t len = tx->read_pdu(payload, nof_bytes);
     if (len > 0) {
       metrics.num_tx_pdu_bytes += len;
       metrics.num_tx_pdus++;
@@ -294,9 +294,8 @@ bool rlc_um_base::rlc_um_base_tx::sdu_queue_is_full()
   return tx_sdu_queue.is_full();
 }
 
-int rlc_um_base::rlc_um_base_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
+int rlc_um_base::rlc_um_base_tx::read_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
-  unique_byte_buffer_t pdu;
   {
     std::lock_guard<std::mutex> lock(mutex);
     log->debug("MAC opportunity - %d bytes\n", nof_bytes);
@@ -305,14 +304,8 @@ int rlc_um_base::rlc_um_base_tx::build_data_pdu(uint8_t* payload, uint32_t nof_b
       log->info("No data available to be sent\n");
       return 0;
     }
-
-    pdu = allocate_unique_buffer(*pool);
-    if (!pdu || pdu->N_bytes != 0) {
-      log->error("Failed to allocate PDU buffer\n");
-      return 0;
-    }
   }
-  return build_data_pdu(std::move(pdu), payload, nof_bytes);
+  return build_data_pdu(payload, nof_bytes);
 }
 
 } // namespace srslte
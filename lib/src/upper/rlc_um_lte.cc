@@ -118,7 +118,7 @@ bool rlc_um_lte::rlc_um_lte_tx::configure(const rlc_config_t& cnfg_, std::string
   return true;
 }
 
-int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes)
+int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
   rlc_umd_pdu_header_t        header;
@@ -129,10 +129,12 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
 
   uint32_t to_move = 0;
   uint32_t last_li = 0;
-  uint8_t* pdu_ptr = pdu->msg;
 
-  int head_len  = rlc_um_packed_length(&header);
-  int pdu_space = SRSLTE_MIN(nof_bytes, pdu->get_tailroom());
+  // The SDU segments are written straight into the MAC payload once the header is known, the PDU size is bounded
+  // to what a PDU buffer would hold
+  uint32_t max_pdu_payload = SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET;
+  int      head_len        = rlc_um_packed_length(&header);
+  int      pdu_space       = SRSLTE_MIN(nof_bytes, max_pdu_payload);
 
   if (pdu_space <= head_len + 1) {
     log->info("%s Cannot build a PDU - %d bytes available, %d bytes required for header\n",
@@ -148,19 +150,17 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
     to_move        = space >= tx_sdu->N_bytes ? tx_sdu->N_bytes : space;
     log->debug(
         "%s adding remainder of SDU segment - %d bytes of %d remaining\n", rb_name.c_str(), to_move, tx_sdu->N_bytes);
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
+    pdu_slices.append(tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
     tx_sdu->N_bytes -= to_move;
     tx_sdu->msg += to_move;
     if (tx_sdu->N_bytes == 0) {
       log->debug(
           "%s Complete SDU scheduled for tx. Stack latency: %ld us\n", rb_name.c_str(), tx_sdu->get_latency_us());
 
-      tx_sdu.reset();
+      pdu_slices.hold(std::move(tx_sdu));
     }
-    pdu_space -= SRSLTE_MIN(to_move, pdu->get_tailroom());
+    pdu_space -= SRSLTE_MIN(to_move, max_pdu_payload - pdu_slices.size_bytes());
     header.fi |= RLC_FI_FIELD_NOT_START_ALIGNED; // First byte does not correspond to first byte of SDU
   }
 
@@ -180,17 +180,15 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
     tx_sdu  = tx_sdu_queue.read();
     to_move = (space >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : space;
     log->debug("%s adding new SDU segment - %d bytes of %d remaining\n", rb_name.c_str(), to_move, tx_sdu->N_bytes);
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
+    pdu_slices.append(tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
     tx_sdu->N_bytes -= to_move;
     tx_sdu->msg += to_move;
     if (tx_sdu->N_bytes == 0) {
       log->debug(
           "%s Complete SDU scheduled for tx. Stack latency: %ld us\n", rb_name.c_str(), tx_sdu->get_latency_us());
 
-      tx_sdu.reset();
+      pdu_slices.hold(std::move(tx_sdu));
     }
     pdu_space -= to_move;
   }
@@ -203,15 +201,16 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
   header.sn = vt_us;
   vt_us     = (vt_us + 1) % cfg.um.tx_mod;
 
-  // Add header and TX
-  rlc_um_write_data_pdu_header(&header, pdu.get());
-  memcpy(payload, pdu->msg, pdu->N_bytes);
+  // Write header and SDU segments into the MAC payload
+  uint32_t pdu_len = rlc_um_write_data_pdu_header(&header, payload);
+  pdu_len += pdu_slices.copy_to(payload + pdu_len);
+  pdu_slices.clear();
 
-  log->info_hex(payload, pdu->N_bytes, "%s Tx PDU SN=%d (%d B)\n", rb_name.c_str(), header.sn, pdu->N_bytes);
+  log->info_hex(payload, pdu_len, "%s Tx PDU SN=%d (%d B)\n", rb_name.c_str(), header.sn, pdu_len);
 
   debug_state();
 
-  return pdu->N_bytes;
+  return pdu_len;
 }
 
 void rlc_um_lte::rlc_um_lte_tx::debug_state()
@@ -388,7 +387,19 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
           break;
         }
 
+        // Check available space in SDU
+        if ((uint32_t)len > rx_sdu->get_tailroom()) {
+          log->error("Dropping PDU %d due to buffer mis-alignment (current segment len %d B, received %d B)\n",
+                     vr_ur,
+                     rx_sdu->N_bytes,
+                     len);
+          rx_sdu->clear();
+          metrics.num_lost_pdus++;
+          break;
+        }
+
         memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_ur].buf->msg, len);
+        metrics.num_rx_copied_bytes += len;
         rx_sdu->N_bytes += len;
         rx_window[vr_ur].buf->msg += len;
         rx_window[vr_ur].buf->N_bytes -= len;
@@ -430,10 +441,9 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
                   rx_sdu->N_bytes,
                   rx_window[vr_ur].buf->N_bytes);
 
-        memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_ur].buf->msg, rx_window[vr_ur].buf->N_bytes);
-        rx_sdu->N_bytes += rx_window[vr_ur].buf->N_bytes;
+        bool appended   = append_to_rx_sdu(rx_window[vr_ur]);
         vr_ur_in_rx_sdu = vr_ur;
-        if (rlc_um_end_aligned(rx_window[vr_ur].header.fi)) {
+        if (appended && rlc_um_end_aligned(rx_window[vr_ur].header.fi)) {
           if (pdu_lost && !rlc_um_start_aligned(rx_window[vr_ur].header.fi)) {
             log->warning("Dropping remainder of lost PDU (lower edge last segments)\n");
             rx_sdu->clear();
@@ -540,6 +550,7 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
       }
 
       memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_ur].buf->msg, len);
+      metrics.num_rx_copied_bytes += len;
       rx_sdu->N_bytes += len;
       rx_window[vr_ur].buf->msg += len;
       rx_window[vr_ur].buf->N_bytes -= len;
@@ -586,24 +597,16 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
       goto clean_up_rx_window;
     }
 
-    if (rx_sdu->N_bytes < SRSLTE_MAX_BUFFER_SIZE_BYTES &&
-        rx_window[vr_ur].buf->N_bytes < SRSLTE_MAX_BUFFER_SIZE_BYTES &&
-        rx_window[vr_ur].buf->N_bytes + rx_sdu->N_bytes < SRSLTE_MAX_BUFFER_SIZE_BYTES) {
-      log->info_hex(rx_window[vr_ur].buf->msg,
-                    rx_window[vr_ur].buf->N_bytes,
-                    "Writing last segment in SDU buffer. Updating vr_ur=%d, vr_ur_in_rx_sdu=%d, Buffer size=%d, "
-                    "segment size=%d\n",
-                    vr_ur,
-                    vr_ur_in_rx_sdu,
-                    rx_sdu->N_bytes,
-                    rx_window[vr_ur].buf->N_bytes);
-      memcpy(&rx_sdu->msg[rx_sdu->N_bytes], rx_window[vr_ur].buf->msg, rx_window[vr_ur].buf->N_bytes);
-      rx_sdu->N_bytes += rx_window[vr_ur].buf->N_bytes;
-    } else {
-      log->error("Out of bounds while reassembling SDU buffer in UM: sdu_len=%d, window_buffer_len=%d, vr_ur=%d\n",
-                 rx_sdu->N_bytes,
-                 rx_window[vr_ur].buf->N_bytes,
-                 vr_ur);
+    log->info_hex(rx_window[vr_ur].buf->msg,
+                  rx_window[vr_ur].buf->N_bytes,
+                  "Writing last segment in SDU buffer. Updating vr_ur=%d, vr_ur_in_rx_sdu=%d, Buffer size=%d, "
+                  "segment size=%d\n",
+                  vr_ur,
+                  vr_ur_in_rx_sdu,
+                  rx_sdu->N_bytes,
+                  rx_window[vr_ur].buf->N_bytes);
+    if (not append_to_rx_sdu(rx_window[vr_ur])) {
+      goto clean_up_rx_window;
     }
     vr_ur_in_rx_sdu = vr_ur;
     if (rlc_um_end_aligned(rx_window[vr_ur].header.fi)) {
@@ -639,6 +642,31 @@ void rlc_um_lte::rlc_um_lte_rx::reassemble_rx_sdus()
   }
 }
 
+// Append the remainder of a PDU to rx_sdu. A remainder that is a complete SDU on its own takes over the PDU buffer
+// instead of being copied, anything else is copied so that later segments find the tailroom of a fresh buffer.
+// Returns false and drops the SDU if it does not fit.
+// Only called when lock is hold
+bool rlc_um_lte::rlc_um_lte_rx::append_to_rx_sdu(rlc_umd_pdu_t& pdu)
+{
+  if (rx_sdu->N_bytes == 0 && rlc_um_end_aligned(pdu.header.fi)) {
+    std::swap(rx_sdu, pdu.buf);
+    return true;
+  }
+  if (pdu.buf->N_bytes > rx_sdu->get_tailroom()) {
+    log->error("Out of bounds while reassembling SDU buffer in UM: sdu_len=%d, window_buffer_len=%d, vr_ur=%d\n",
+               rx_sdu->N_bytes,
+               pdu.buf->N_bytes,
+               vr_ur);
+    rx_sdu->clear();
+    metrics.num_lost_pdus++;
+    return false;
+  }
+  memcpy(&rx_sdu->msg[rx_sdu->N_bytes], pdu.buf->msg, pdu.buf->N_bytes);
+  rx_sdu->N_bytes += pdu.buf->N_bytes;
+  metrics.num_rx_copied_bytes += pdu.buf->N_bytes;
+  return true;
+}
+
 // Only called when lock is hold
 bool rlc_um_lte::rlc_um_lte_rx::pdu_belongs_to_rx_sdu()
 {
@@ -760,13 +788,17 @@ void rlc_um_read_data_pdu_header(uint8_t*              payload,
 }
 
 void rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* pdu)
+{
+  // Make room for the header
+  pdu->msg -= rlc_um_packed_length(header);
+  pdu->N_bytes += rlc_um_write_data_pdu_header(header, pdu->msg);
+}
+
+uint32_t rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, uint8_t* payload)
 {
   uint32_t i;
   uint8_t  ext = (header->N_li > 0) ? 1 : 0;
-  // Make room for the header
-  uint32_t len = rlc_um_packed_length(header);
-  pdu->msg -= len;
-  uint8_t* ptr = pdu->msg;
+  uint8_t* ptr = payload;
 
   // Fixed part
   if (header->sn_size == rlc_umd_sn_size_t::size5bits) {
@@ -806,7 +838,7 @@ void rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* p
   if (header->N_li % 2 == 1)
     ptr++;
 
-  pdu->N_bytes += ptr - pdu->msg;
+  return ptr - payload;
 }
 
 uint32_t rlc_um_packed_length(rlc_umd_pdu_header_t* header)
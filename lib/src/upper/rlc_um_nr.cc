@@ -114,13 +114,19 @@ bool rlc_um_nr::rlc_um_nr_tx::configure(const rlc_config_t& cnfg_, std::string r
   return true;
 }
 
-int rlc_um_nr::rlc_um_nr_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes)
+int rlc_um_nr::rlc_um_nr_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  rlc_um_nr_pdu_header_t      header = {};
-  header.si                          = rlc_nr_si_field_t::full_sdu;
-  header.sn                          = TX_Next;
-  header.sn_size                     = cfg.um_nr.sn_field_length;
+  unique_byte_buffer_t        pdu = allocate_unique_buffer(*pool);
+  if (!pdu || pdu->N_bytes != 0) {
+    log->error("Failed to allocate PDU buffer\n");
+    return 0;
+  }
+
+  rlc_um_nr_pdu_header_t header = {};
+  header.si                     = rlc_nr_si_field_t::full_sdu;
+  header.sn                     = TX_Next;
+  header.sn_size                = cfg.um_nr.sn_field_length;
 
   uint32_t to_move = 0;
   uint8_t* pdu_ptr = pdu->msg;
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/adt/lockfree_queue.h"
+#include "srslte/common/test_common.h"
+#include <thread>
+#include <vector>
+
+int test_lockfree_queue_single_thread()
+{
+  srslte::lockfree_queue<std::unique_ptr<int> > q(5);
+  TESTASSERT(q.capacity() == 8);
+  TESTASSERT(q.empty());
+
+  for (int i = 0; i < 8; ++i) {
+    TESTASSERT(q.try_push(std::unique_ptr<int>(new int(i))));
+  }
+  TESTASSERT(q.full() and q.size() == 8);
+
+  // a failed push leaves the element with the caller
+  std::unique_ptr<int> extra(new int(8));
+  TESTASSERT(not q.try_push(extra));
+  TESTASSERT(extra != nullptr and *extra == 8);
+
+  std::unique_ptr<int> out;
+  for (int i = 0; i < 8; ++i) {
+    TESTASSERT(q.try_pop(out));
+    TESTASSERT(*out == i);
+  }
+  TESTASSERT(not q.try_pop(out));
+  TESTASSERT(q.empty());
+
+  // wrap around the buffer a few times
+  for (int i = 0; i < 100; ++i) {
+    TESTASSERT(q.try_push(std::unique_ptr<int>(new int(i))));
+    TESTASSERT(q.try_pop(out) and *out == i);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_lockfree_queue_multi_producer()
+{
+  const uint32_t nof_producers = 4, nof_elems = 5000;
+
+  srslte::lockfree_queue<uint32_t> q(64);
+  std::vector<std::thread>         producers;
+  for (uint32_t p = 0; p < nof_producers; ++p) {
+    producers.emplace_back([&q, p, nof_elems]() {
+      for (uint32_t i = 0; i < nof_elems; ++i) {
+        uint32_t val = p * nof_elems + i;
+        while (not q.try_push(val)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // every element is received once and the order of each producer is preserved
+  std::vector<uint32_t> last(nof_producers, 0);
+  std::vector<uint32_t> count(nof_producers, 0);
+  uint32_t              total = 0, val;
+  while (total < nof_producers * nof_elems) {
+    if (q.try_pop(val)) {
+      uint32_t p = val / nof_elems, i = val % nof_elems;
+      TESTASSERT(count[p] == 0 or i > last[p]);
+      last[p] = i;
+      count[p]++;
+      total++;
+    }
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  for (uint32_t p = 0; p < nof_producers; ++p) {
+    TESTASSERT(count[p] == nof_elems);
+  }
+  TESTASSERT(q.empty());
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_lockfree_queue_single_thread() == SRSLTE_SUCCESS);
+  TESTASSERT(test_lockfree_queue_multi_producer() == SRSLTE_SUCCESS);
+  return 0;
+}
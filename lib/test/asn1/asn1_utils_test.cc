@@ -192,6 +192,91 @@ int test_bit_ref()
   return 0;
 }
 
+// Random sequences of fields and octet strings, checked against a bit by bit reference encoder
+int test_bit_ref_random()
+{
+  uint8_t                          buf[512], octs[64], octs2[64];
+  std::uniform_int_distribution<>  dist_bits(0, 31), dist_op(0, 3), dist_len(0, 40), dist_byte(0, 255);
+  std::uniform_int_distribution<>  dist_u32(0, std::numeric_limits<int>::max());
+  std::vector<std::pair<uint32_t, uint32_t> > fields; // (value, nof bits), nof bits > 32 for octet strings
+  std::vector<std::vector<uint8_t> >          strings;
+
+  for (uint32_t trial = 0; trial < 200; ++trial) {
+    fields.clear();
+    strings.clear();
+    std::vector<bool> ref_bits;
+    memset(buf, 0xAB, sizeof(buf));
+    bit_ref bref(&buf[0], sizeof(buf));
+    while (ref_bits.size() < 8 * (sizeof(buf) - sizeof(octs) - 8)) {
+      if (dist_op(g) == 0) {
+        std::vector<uint8_t> str(dist_len(g));
+        for (uint8_t& b : str) {
+          b = dist_byte(g);
+        }
+        TESTASSERT(bref.pack_bytes(str.data(), str.size()) == SRSASN_SUCCESS);
+        for (uint8_t b : str) {
+          for (int k = 7; k >= 0; --k) {
+            ref_bits.push_back((b >> k) & 1u);
+          }
+        }
+        fields.emplace_back(strings.size(), 64);
+        strings.push_back(str);
+      } else {
+        uint32_t n   = dist_bits(g);
+        uint32_t val = (uint32_t)dist_u32(g) & ((1u << n) - 1u);
+        TESTASSERT(bref.pack(val, n) == SRSASN_SUCCESS);
+        for (int k = (int)n - 1; k >= 0; --k) {
+          ref_bits.push_back((val >> k) & 1u);
+        }
+        fields.emplace_back(val, n);
+      }
+    }
+    TESTASSERT(bref.distance() == (int)ref_bits.size());
+    for (uint32_t i = 0; i < ref_bits.size(); ++i) {
+      TESTASSERT(((buf[i / 8] >> (7 - i % 8)) & 1u) == ref_bits[i]);
+    }
+    // the unused bits of the last byte are cleared
+    if (ref_bits.size() % 8 != 0) {
+      TESTASSERT((buf[ref_bits.size() / 8] & ((1u << (8 - ref_bits.size() % 8)) - 1u)) == 0);
+    }
+
+    // unpack with the buffer ending right after the last field
+    cbit_ref bref2(&buf[0], bref.distance_bytes());
+    for (const std::pair<uint32_t, uint32_t>& f : fields) {
+      if (f.second > 32) {
+        const std::vector<uint8_t>& str = strings[f.first];
+        TESTASSERT(bref2.unpack_bytes(&octs2[0], str.size()) == SRSASN_SUCCESS);
+        TESTASSERT(std::equal(str.begin(), str.end(), &octs2[0]));
+      } else {
+        uint32_t val;
+        TESTASSERT(bref2.unpack(val, f.second) == SRSASN_SUCCESS);
+        TESTASSERT(val == f.first);
+      }
+    }
+    TESTASSERT(bref2.distance() == bref.distance());
+    uint32_t val;
+    TESTASSERT(bref2.unpack(val, 9) == SRSASN_ERROR_DECODE_FAIL);
+  }
+
+  // 64-bit fields
+  {
+    uint64_t val = 0x0123456789ABCDEFULL, val2;
+    bit_ref  bref(&buf[0], 9);
+    TESTASSERT(bref.pack(1, 3) == SRSASN_SUCCESS);
+    TESTASSERT(bref.pack_bytes(&octs[0], 0) == SRSASN_SUCCESS);
+    for (uint32_t i = 0; i < 8; ++i) {
+      octs[i] = val >> (56 - 8 * i);
+    }
+    TESTASSERT(bref.pack_bytes(&octs[0], 8) == SRSASN_SUCCESS);
+    TESTASSERT(bref.pack(0, 6) == SRSASN_ERROR_ENCODE_FAIL);
+    cbit_ref bref2(&buf[0], 9);
+    TESTASSERT(bref2.unpack(val2, 3) == SRSASN_SUCCESS and val2 == 1);
+    TESTASSERT(bref2.unpack(val2, 64) == SRSASN_SUCCESS and val2 == val);
+  }
+
+  return 0;
+}
+
 int test_oct_string()
 {
   uint8_t  buf[1024];
@@ -524,6 +609,70 @@ int test_copy_ptr()
   return 0;
 }
 
+int test_decode_arena()
+{
+  decode_arena arena(256);
+  TESTASSERT(decode_arena::current() == nullptr);
+
+  dyn_array<uint32_t> copied;
+  {
+    dyn_array<uint32_t> vec;
+    ext_array<uint8_t>  ext;
+    {
+      arena_scope scope(arena);
+      TESTASSERT(decode_arena::current() == &arena);
+      for (uint32_t i = 0; i < 100; ++i) {
+        vec.push_back(i);
+        ext.push_back(i);
+      }
+      TESTASSERT(vec.is_in_arena());
+      TESTASSERT(ext.is_in_arena());
+      TESTASSERT(arena.bytes_used() > 0);
+      TESTASSERT(arena.nof_blocks() > 1);
+      TESTASSERT(((uintptr_t)vec.data() % alignof(uint32_t)) == 0);
+    }
+    TESTASSERT(decode_arena::current() == nullptr);
+    for (uint32_t i = 0; i < 100; ++i) {
+      TESTASSERT(vec[i] == i);
+      TESTASSERT(ext[i] == i);
+    }
+
+    // copies and moves made outside of the scope do not use the arena
+    copied = vec;
+    TESTASSERT(not copied.is_in_arena());
+    ext_array<uint8_t> moved(std::move(ext));
+    TESTASSERT(not moved.is_in_arena());
+    TESTASSERT(moved.size() == 100 and moved[99] == 99);
+
+    // growing outside of the scope moves the elements back to the heap
+    vec.resize(vec.capacity() + 1);
+    TESTASSERT(not vec.is_in_arena());
+    TESTASSERT(vec[50] == 50 and vec[99] == 99);
+  }
+  TESTASSERT(copied.size() == 100 and copied[99] == 99);
+
+  // all blocks are merged into one on reset
+  size_t cap = arena.capacity();
+  arena.reset();
+  TESTASSERT(arena.bytes_used() == 0);
+  TESTASSERT(arena.nof_blocks() == 1);
+  TESTASSERT(arena.capacity() == cap);
+
+  // nested scopes
+  decode_arena arena2;
+  {
+    arena_scope scope(arena);
+    {
+      arena_scope scope2(arena2);
+      TESTASSERT(decode_arena::current() == &arena2);
+    }
+    TESTASSERT(decode_arena::current() == &arena);
+  }
+  TESTASSERT(decode_arena::current() == nullptr);
+
+  return 0;
+}
+
 class EnumTest
 {
 public:
@@ -635,10 +784,12 @@ int main()
   srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_DEBUG);
   TESTASSERT(test_arrays() == 0);
   TESTASSERT(test_bit_ref() == 0);
+  TESTASSERT(test_bit_ref_random() == 0);
   TESTASSERT(test_oct_string() == 0);
   TESTASSERT(test_bitstring() == 0);
   TESTASSERT(test_seq_of() == 0);
   TESTASSERT(test_copy_ptr() == 0);
+  TESTASSERT(test_decode_arena() == 0);
   TESTASSERT(test_enum() == 0);
   //  TESTASSERT(test_json_writer()==0);
   printf("Success\n");
@@ -595,6 +595,46 @@ int test_rrc_conn_reconf_r15_2()
   return SRSASN_SUCCESS;
 }
 
+/*
+ * Decode throughput of a SIB2 and of an RRC Connection Reconfiguration, with the containers allocated on the heap
+ * and in one arena per message, and encode throughput
+ */
+int test_decode_throughput()
+{
+  uint8_t sib2_msg[] = {0x00, 0x01, 0x49, 0x00, 0x12, 0x50, 0x40, 0x08, 0x00, 0x09, 0x40, 0x00, 0xA0,
+                        0x3F, 0x01, 0x00, 0x0A, 0x7F, 0xC9, 0x80, 0x01, 0x04, 0x28, 0x6C, 0x00, 0x0C};
+  uint8_t recfg_msg[] = {0x20, 0x16, 0x15, 0xC8, 0x40, 0x00, 0x03, 0xC2, 0x84, 0x18, 0x10, 0xA8, 0x04, 0xD7, 0x95, 0x14,
+                         0xA2, 0x01, 0x02, 0x18, 0x9A, 0x01, 0x80, 0x14, 0x81, 0x0A, 0xCB, 0x84, 0x08, 0x00, 0xAD, 0x6D,
+                         0xC4, 0x06, 0x08, 0xAF, 0x6D, 0xC7, 0xA0, 0xC0, 0x82, 0x00, 0x00, 0x0C, 0x38, 0x60, 0x20, 0x30,
+                         0xC3, 0x00, 0x00, 0x10, 0x04, 0x40, 0x10, 0xC2, 0x3C, 0x2A, 0x06, 0x20, 0x30, 0x11, 0x10, 0x28,
+                         0x13, 0xDA, 0x4E, 0x96, 0xDA, 0x80, 0x83, 0xA1, 0x00, 0xA4, 0x83, 0x00, 0x32, 0x7B, 0x08, 0x95,
+                         0xAE, 0x00, 0x16, 0xA9, 0x00, 0xE0, 0x80, 0x84, 0x8C, 0x82, 0xBB, 0xB1, 0xB4, 0xBA, 0x18, 0x83,
+                         0x36, 0xB7, 0x31, 0x98, 0x18, 0x98, 0x83, 0x36, 0xB1, 0xB1, 0x9A, 0x1B, 0x1B, 0x02, 0x33, 0xB8,
+                         0x39, 0x39, 0x82, 0x80, 0x85, 0x7F, 0x80, 0x80, 0xAF, 0x03, 0x7F, 0x7F, 0x7D, 0x7D, 0x7F, 0x7F,
+                         0x28, 0x05, 0xFB, 0x32, 0x7B, 0x08, 0xC0, 0x00, 0x01, 0xF8, 0x3E, 0x3C, 0xB1, 0xB2, 0x00, 0xC0,
+                         0x30, 0x38, 0x1F, 0xFA, 0x9C, 0x08, 0x3E, 0xA2, 0x5F, 0x1C, 0xE1, 0xD0, 0x84};
+  const uint32_t nof_iters = 20000;
+
+  double heap1  = test_decode_throughput<bcch_dl_sch_msg_s>(sib2_msg, sizeof(sib2_msg), nof_iters, false);
+  double arena1 = test_decode_throughput<bcch_dl_sch_msg_s>(sib2_msg, sizeof(sib2_msg), nof_iters, true);
+  double heap2  = test_decode_throughput<dl_dcch_msg_s>(recfg_msg, sizeof(recfg_msg), nof_iters, false);
+  double arena2 = test_decode_throughput<dl_dcch_msg_s>(recfg_msg, sizeof(recfg_msg), nof_iters, true);
+  double enc1   = test_encode_throughput<bcch_dl_sch_msg_s>(sib2_msg, sizeof(sib2_msg), nof_iters);
+  double enc2   = test_encode_throughput<dl_dcch_msg_s>(recfg_msg, sizeof(recfg_msg), nof_iters);
+  TESTASSERT(heap1 > 0 and arena1 > 0 and heap2 > 0 and arena2 > 0 and enc1 > 0 and enc2 > 0);
+
+  printf("SIB2:                   %.0f decodes/s (heap), %.0f decodes/s (arena), %.0f encodes/s\n",
+         heap1,
+         arena1,
+         enc1);
+  printf("RRCConnReconfiguration: %.0f decodes/s (heap), %.0f decodes/s (arena), %.0f encodes/s\n",
+         heap2,
+         arena2,
+         enc2);
+
+  return SRSASN_SUCCESS;
+}
+
 int main()
 {
   srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_DEBUG);
@@ -611,6 +651,7 @@ int main()
   TESTASSERT(unrecognized_ext_group_test() == 0);
   TESTASSERT(v2x_test() == 0);
   TESTASSERT(test_rrc_conn_reconf_r15_2() == 0);
+  TESTASSERT(test_decode_throughput() == 0);
 
   printf("Success\n");
   return 0;
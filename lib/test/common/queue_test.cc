@@ -22,6 +22,8 @@
 #include "srslte/adt/move_callback.h"
 #include "srslte/common/multiqueue.h"
 #include "srslte/common/thread_pool.h"
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <thread>
 #include <unistd.h>
@@ -343,6 +345,58 @@ int test_task_thread_pool3()
   return 0;
 }
 
+int test_task_thread_pool_parallel_for()
+{
+  std::cout << "\n====== TEST task thread pool parallel_for: start ======\n";
+  // Description: fork-join of nested groups. Each task must run exactly once, every slot must be used by one thread at
+  //              a time and the call must return only once all the tasks have finished
+
+  uint32_t nof_workers = 3, nof_outer = 4, nof_inner = 50;
+
+  task_thread_pool thread_pool(nof_workers);
+  thread_pool.start();
+
+  std::vector<std::atomic<uint32_t> > count(nof_outer * nof_inner);
+  std::vector<std::atomic<bool> >     slot_busy(nof_workers + 1);
+  std::atomic<bool>                   slot_shared(false);
+  for (uint32_t i = 0; i < count.size(); i++) {
+    count[i] = 0;
+  }
+  for (uint32_t i = 0; i < slot_busy.size(); i++) {
+    slot_busy[i] = false;
+  }
+
+  for (uint32_t run = 0; run < 10; run++) {
+    thread_pool.parallel_for(nof_outer, [&](uint32_t outer, uint32_t outer_slot) {
+      thread_pool.parallel_for(nof_inner, [&](uint32_t inner, uint32_t slot) {
+        if (slot > nof_workers or slot_busy[slot].exchange(true)) {
+          slot_shared = true;
+          return;
+        }
+        count[outer * nof_inner + inner]++;
+        usleep(10);
+        slot_busy[slot] = false;
+      });
+    });
+    for (uint32_t i = 0; i < count.size(); i++) {
+      TESTASSERT(count[i] == run + 1);
+    }
+  }
+  TESTASSERT(not slot_shared);
+
+  // Without workers the tasks run in the calling thread
+  task_thread_pool empty_pool(0);
+  uint32_t         sum = 0;
+  empty_pool.parallel_for(10, [&sum](uint32_t idx, uint32_t slot) { sum += idx + slot; });
+  TESTASSERT(sum == 45);
+
+  thread_pool.stop();
+
+  std::cout << "outcome: Success\n";
+  std::cout << "===================================================\n";
+  return 0;
+}
+
 struct C {
   std::unique_ptr<int> val{new int{5}};
 };
@@ -435,6 +489,7 @@ int main()
   TESTASSERT(test_task_thread_pool() == 0);
   TESTASSERT(test_task_thread_pool2() == 0);
   TESTASSERT(test_task_thread_pool3() == 0);
+  TESTASSERT(test_task_thread_pool_parallel_for() == 0);
 
   TESTASSERT(test_inplace_task() == 0);
 }
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/aes_128.h"
+#include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <vector>
+
+/*
+ * Known answer tests
+ */
+
+// FIPS-197 Appendix C.1
+int test_aes_block()
+{
+  uint8_t key[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+  uint8_t pt[]  = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+  uint8_t ct[]  = {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+
+  srslte::aes_128_key aes(key);
+  uint8_t             out[16];
+  aes.encrypt_block(pt, out);
+  TESTASSERT(memcmp(out, ct, 16) == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+// RFC 4493 section 4, also checks a header split at any position of the message
+int test_aes_cmac()
+{
+  uint8_t key[] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  uint8_t msg[] = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+                   0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+                   0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+                   0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10};
+  struct {
+    uint32_t len;
+    uint8_t  tag[16];
+  } vectors[] = {
+      {0, {0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46}},
+      {16, {0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c}},
+      {40, {0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27}},
+      {64, {0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe}}};
+
+  srslte::aes_128_key aes(key);
+  uint8_t             tag[16];
+  for (const auto& v : vectors) {
+    for (uint32_t hdr_len = 0; hdr_len <= std::min(v.len, 16u); hdr_len++) {
+      aes.cmac(msg, hdr_len, msg + hdr_len, v.len - hdr_len, tag);
+      TESTASSERT(memcmp(tag, v.tag, 16) == 0);
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+// 33.401 Annex C.1 Test Set 1 with a byte-aligned length, every prefix compared against the reference implementation
+int test_eea2()
+{
+  uint8_t  key[]     = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c, 0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+  uint32_t count     = 0x398a59b4;
+  uint8_t  bearer    = 0x15;
+  uint8_t  direction = 1;
+  uint8_t  msg[]     = {0x98, 0x1b, 0xa6, 0x82, 0x4c, 0x1b, 0xfb, 0x1a, 0xb4, 0x85, 0x47, 0x20, 0x29, 0xb7, 0x1d, 0x80,
+                   0x8c, 0xe3, 0x3e, 0x2c, 0xc3, 0xc0, 0xb5, 0xfc, 0x1f, 0x3d, 0xe8, 0xa6, 0xdc, 0x66, 0xb1, 0xf0};
+  uint8_t  ct[]      = {0xe9, 0xfe, 0xd8, 0xa6, 0x3d, 0x15, 0x53, 0x04, 0xd7, 0x1d, 0xf2, 0x0b, 0xf3, 0xe8, 0x22, 0x14,
+                  0xb2, 0x0e, 0xd7, 0xda, 0xd2, 0xf2, 0x33, 0xdc, 0x3c, 0x22, 0xd7, 0xbd, 0xee, 0xed, 0x8e, 0x78};
+
+  srslte::aes_128_key aes(key);
+  uint8_t             out[sizeof(msg)];
+  TESTASSERT(srslte::security_128_eea2(aes, count, bearer, direction, msg, sizeof(msg), out) == SRSLTE_SUCCESS);
+  TESTASSERT(memcmp(out, ct, sizeof(ct)) == 0);
+
+  // in-place decryption
+  TESTASSERT(srslte::security_128_eea2(aes, count, bearer, direction, out, sizeof(out), out) == SRSLTE_SUCCESS);
+  TESTASSERT(memcmp(out, msg, sizeof(msg)) == 0);
+
+  // longer messages exercise the multi-block paths
+  std::vector<uint8_t> big(1500), big_ref(1500), big_out(1500);
+  for (uint32_t i = 0; i < big.size(); i++) {
+    big[i] = (uint8_t)(i * 7);
+  }
+  for (uint32_t len : {1u, 15u, 16u, 17u, 63u, 64u, 65u, 127u, 128u, 129u, 1500u}) {
+    liblte_security_encryption_eea2(key, count, bearer, direction, big.data(), len * 8, big_ref.data());
+    srslte::security_128_eea2(aes, count, bearer, direction, big.data(), len, big_out.data());
+    TESTASSERT(memcmp(big_ref.data(), big_out.data(), len) == 0);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+// 33.401 Annex C.2 Test Set 2
+int test_eia2()
+{
+  uint8_t  key[]     = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c, 0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+  uint32_t count     = 0x398a59b4;
+  uint8_t  bearer    = 0x1a;
+  uint8_t  direction = 1;
+  uint8_t  msg[]     = {0x48, 0x45, 0x83, 0xd5, 0xaf, 0xe0, 0x82, 0xae};
+  uint8_t  mt[]      = {0xb9, 0x37, 0x87, 0xe6};
+
+  srslte::aes_128_key aes(key);
+  uint8_t             mac[4];
+  TESTASSERT(srslte::security_128_eia2(aes, count, bearer, direction, msg, sizeof(msg), mac) == SRSLTE_SUCCESS);
+  TESTASSERT(memcmp(mac, mt, 4) == 0);
+
+  std::vector<uint8_t> big(1500);
+  for (uint32_t i = 0; i < big.size(); i++) {
+    big[i] = (uint8_t)(i * 13);
+  }
+  uint8_t mac_ref[4];
+  for (uint32_t len : {1u, 7u, 8u, 9u, 24u, 25u, 1500u}) {
+    liblte_security_128_eia2(key, count, bearer, direction, big.data(), len, mac_ref);
+    srslte::security_128_eia2(aes, count, bearer, direction, big.data(), len, mac);
+    TESTASSERT(memcmp(mac, mac_ref, 4) == 0);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Throughput of the per-packet key setup against the cached key schedule
+ */
+
+template <typename F>
+double run_mbps(uint32_t nof_packets, uint32_t len, F&& f)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_packets; i++) {
+    f(i);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+  return us > 0 ? 8.0 * len * nof_packets / us : 0.0;
+}
+
+int test_throughput()
+{
+  const uint32_t nof_packets = 20000;
+  uint8_t key[] = {0x2b, 0xd6, 0x45, 0x9f, 0x82, 0xc4, 0x40, 0xe0, 0x95, 0x2c, 0x49, 0x10, 0x48, 0x05, 0xff, 0x48};
+
+  srslte::aes_128_key  aes(key);
+  std::vector<uint8_t> pdu(1500), out(1500);
+  uint8_t              mac[4];
+
+  printf("AES backend: %s\n", srslte::aes_128_key::backend());
+  for (uint32_t len : {40u, 1500u}) {
+    double eea2_ref = run_mbps(nof_packets, len, [&](uint32_t count) {
+      liblte_security_encryption_eea2(key, count, 1, 0, pdu.data(), len * 8, out.data());
+    });
+    double eea2     = run_mbps(nof_packets, len, [&](uint32_t count) {
+      srslte::security_128_eea2(aes, count, 1, 0, pdu.data(), len, out.data());
+    });
+    double eia2_ref = run_mbps(
+        nof_packets, len, [&](uint32_t count) { liblte_security_128_eia2(key, count, 1, 0, pdu.data(), len, mac); });
+    double eia2 = run_mbps(
+        nof_packets, len, [&](uint32_t count) { srslte::security_128_eia2(aes, count, 1, 0, pdu.data(), len, mac); });
+
+    printf("%4d B packets: EEA2 %.1f -> %.1f Mbps, EIA2 %.1f -> %.1f Mbps (per-packet key -> cached key)\n",
+           len,
+           eea2_ref,
+           eea2,
+           eia2_ref,
+           eia2);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_aes_block() == SRSLTE_SUCCESS);
+  TESTASSERT(test_aes_cmac() == SRSLTE_SUCCESS);
+  TESTASSERT(test_eea2() == SRSLTE_SUCCESS);
+  TESTASSERT(test_eia2() == SRSLTE_SUCCESS);
+  TESTASSERT(test_throughput() == SRSLTE_SUCCESS);
+  return SRSLTE_SUCCESS;
+}
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 
 #include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
 
 /*
  * Prototypes
@@ -159,6 +160,15 @@ void test_set_2()
   uint8_t ak_star[] = {0x45, 0x1e, 0x8b, 0xec, 0xa4, 0x3b};
   err_cmp           = arrcmp(ak_star_o, ak_star, sizeof(ak_star));
   assert(err_cmp == 0);
+
+  // f12345 with the expanded key schedule
+  srslte::aes_128_key k_aes(k);
+  srslte::security_milenage_f12345(k_aes, opc_o, rand, sqn, amf, mac_o, res_o, ck_o, ik_o, ak_o);
+  assert(arrcmp(mac_o, mac_a, sizeof(mac_a)) == 0);
+  assert(arrcmp(res_o, res, sizeof(res)) == 0);
+  assert(arrcmp(ck_o, ck, sizeof(ck)) == 0);
+  assert(arrcmp(ik_o, ik, sizeof(ik)) == 0);
+  assert(arrcmp(ak_o, ak, sizeof(ak)) == 0);
   return;
 }
 
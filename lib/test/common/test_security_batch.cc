@@ -0,0 +1,232 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <vector>
+
+using namespace srslte;
+
+// Packet lengths of a batch, including lengths that are not a multiple of the keystream word
+static const uint32_t lengths[] = {1, 3, 4, 5, 40, 41, 100, 333, 1500, 7, 64, 65, 2, 1024, 17, 18, 19, 250, 1499};
+static const uint32_t nof_items = sizeof(lengths) / sizeof(lengths[0]);
+
+struct batch_t {
+  std::vector<std::vector<uint8_t> > keys, msgs, outs, refs;
+  std::vector<security_batch_item_t> items;
+
+  batch_t()
+  {
+    for (uint32_t i = 0; i < nof_items; i++) {
+      std::vector<uint8_t> key(16), msg(lengths[i]);
+      for (uint32_t j = 0; j < key.size(); j++) {
+        key[j] = (uint8_t)(i * 31 + j * 7 + 1);
+      }
+      for (uint32_t j = 0; j < msg.size(); j++) {
+        msg[j] = (uint8_t)(i + j * 13);
+      }
+      keys.push_back(key);
+      msgs.push_back(msg);
+      outs.emplace_back(lengths[i]);
+      refs.emplace_back(lengths[i]);
+    }
+    for (uint32_t i = 0; i < nof_items; i++) {
+      security_batch_item_t item = {};
+      item.key                   = keys[i].data();
+      item.count                 = 0x398a59b4 + i * 1001;
+      item.bearer                = (uint8_t)(i % 32);
+      item.direction             = (uint8_t)(i % 2);
+      item.msg                   = msgs[i].data();
+      item.msg_len               = lengths[i];
+      item.out                   = outs[i].data();
+      items.push_back(item);
+    }
+  }
+};
+
+int test_eea_batch(CIPHERING_ALGORITHM_ID_ENUM algo)
+{
+  batch_t b;
+  TESTASSERT(security_128_eea_batch(algo, b.items.data(), nof_items) == SRSLTE_SUCCESS);
+
+  for (uint32_t i = 0; i < nof_items; i++) {
+    const security_batch_item_t& it = b.items[i];
+    if (algo == CIPHERING_ALGORITHM_ID_128_EEA1) {
+      liblte_security_encryption_eea1(
+          b.keys[i].data(), it.count, it.bearer, it.direction, b.msgs[i].data(), it.msg_len * 8, b.refs[i].data());
+    } else {
+      liblte_security_encryption_eea3(
+          b.keys[i].data(), it.count, it.bearer, it.direction, b.msgs[i].data(), it.msg_len * 8, b.refs[i].data());
+    }
+    TESTASSERT(b.outs[i] == b.refs[i]);
+  }
+
+  // deciphering in place gives back the message
+  for (auto& it : b.items) {
+    it.msg = it.out;
+  }
+  TESTASSERT(security_128_eea_batch(algo, b.items.data(), nof_items) == SRSLTE_SUCCESS);
+  for (uint32_t i = 0; i < nof_items; i++) {
+    TESTASSERT(b.outs[i] == b.msgs[i]);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_eia_batch(INTEGRITY_ALGORITHM_ID_ENUM algo)
+{
+  batch_t b;
+  for (auto& it : b.items) {
+    it.out = (uint8_t*)calloc(4, 1);
+  }
+  TESTASSERT(security_128_eia_batch(algo, b.items.data(), nof_items) == SRSLTE_SUCCESS);
+
+  for (uint32_t i = 0; i < nof_items; i++) {
+    const security_batch_item_t& it = b.items[i];
+    uint8_t                      mac[4];
+    switch (algo) {
+      case INTEGRITY_ALGORITHM_ID_128_EIA1:
+        liblte_security_128_eia1(
+            b.keys[i].data(), it.count, it.bearer, it.direction, b.msgs[i].data(), it.msg_len, mac);
+        break;
+      case INTEGRITY_ALGORITHM_ID_128_EIA2:
+        liblte_security_128_eia2(
+            b.keys[i].data(), it.count, it.bearer, it.direction, b.msgs[i].data(), it.msg_len, mac);
+        break;
+      default:
+        liblte_security_128_eia3(
+            b.keys[i].data(), it.count, it.bearer, it.direction, b.msgs[i].data(), it.msg_len * 8, mac);
+        break;
+    }
+    TESTASSERT(memcmp(mac, it.out, 4) == 0);
+
+    // the word-wise single packet EIA3 matches the bit-wise liblte reference too
+    if (algo == INTEGRITY_ALGORITHM_ID_128_EIA3) {
+      uint8_t mac_single[4];
+      security_128_eia3(b.keys[i].data(), it.count, it.bearer, it.direction, b.msgs[i].data(), it.msg_len, mac_single);
+      TESTASSERT(memcmp(mac, mac_single, 4) == 0);
+    }
+    free(it.out);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_invalid()
+{
+  batch_t b;
+  b.items[3].key = nullptr;
+  TESTASSERT(security_128_eea_batch(CIPHERING_ALGORITHM_ID_128_EEA3, b.items.data(), nof_items) == SRSLTE_ERROR);
+  TESTASSERT(security_128_eea_batch(CIPHERING_ALGORITHM_ID_128_EEA3, nullptr, 0) == SRSLTE_SUCCESS);
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Throughput of one packet after the other against the batch functions
+ */
+
+int test_throughput()
+{
+  const uint32_t nof_batches = 500;
+  const uint32_t batch_size  = 32;
+
+  uint8_t              key[] = {0x2b, 0xd6, 0x45, 0x9f, 0x82, 0xc4, 0x40, 0xe0,
+                   0x95, 0x2c, 0x49, 0x10, 0x48, 0x05, 0xff, 0x48};
+  std::vector<uint8_t> pdus(batch_size * 1500), macs(batch_size * 4);
+
+  printf("Batch lanes: %d\n", security_batch_nof_lanes());
+  for (uint32_t len : {40u, 1500u}) {
+    std::vector<security_batch_item_t> items(batch_size);
+    for (uint32_t i = 0; i < batch_size; i++) {
+      items[i] = {key, nullptr, i, 1, 0, &pdus[i * len], len, &pdus[i * len]};
+    }
+
+    for (uint32_t algo = 0; algo < 2; algo++) {
+      bool        eea1 = algo == 0;
+      const char* name = eea1 ? "EEA1" : "EEA3";
+
+      auto t0 = std::chrono::steady_clock::now();
+      for (uint32_t n = 0; n < nof_batches; n++) {
+        for (auto& it : items) {
+          if (eea1) {
+            security_128_eea1(key, it.count, it.bearer, it.direction, it.out, len, it.out);
+          } else {
+            security_128_eea3(key, it.count, it.bearer, it.direction, it.out, len, it.out);
+          }
+        }
+      }
+      auto t1 = std::chrono::steady_clock::now();
+      for (uint32_t n = 0; n < nof_batches; n++) {
+        security_128_eea_batch(
+            eea1 ? CIPHERING_ALGORITHM_ID_128_EEA1 : CIPHERING_ALGORITHM_ID_128_EEA3, items.data(), batch_size);
+      }
+      auto t2 = std::chrono::steady_clock::now();
+
+      double bits = 8.0 * len * batch_size * nof_batches;
+      auto   us0  = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+      auto   us1  = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+      printf("%4d B packets: %s %.1f -> %.1f Mbps (per packet -> batch)\n",
+             len,
+             name,
+             us0 > 0 ? bits / us0 : 0.0,
+             us1 > 0 ? bits / us1 : 0.0);
+    }
+
+    for (uint32_t i = 0; i < batch_size; i++) {
+      items[i].out = &macs[i * 4];
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < nof_batches; n++) {
+      for (auto& it : items) {
+        security_128_eia3(key, it.count, it.bearer, it.direction, (uint8_t*)it.msg, len, it.out);
+      }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < nof_batches; n++) {
+      security_128_eia_batch(INTEGRITY_ALGORITHM_ID_128_EIA3, items.data(), batch_size);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double bits = 8.0 * len * batch_size * nof_batches;
+    auto   us0  = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    auto   us1  = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+    printf("%4d B packets: EIA3 %.1f -> %.1f Mbps (per packet -> batch)\n",
+           len,
+           us0 > 0 ? bits / us0 : 0.0,
+           us1 > 0 ? bits / us1 : 0.0);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_eea_batch(CIPHERING_ALGORITHM_ID_128_EEA1) == SRSLTE_SUCCESS);
+  TESTASSERT(test_eea_batch(CIPHERING_ALGORITHM_ID_128_EEA3) == SRSLTE_SUCCESS);
+  TESTASSERT(test_eia_batch(INTEGRITY_ALGORITHM_ID_128_EIA1) == SRSLTE_SUCCESS);
+  TESTASSERT(test_eia_batch(INTEGRITY_ALGORITHM_ID_128_EIA2) == SRSLTE_SUCCESS);
+  TESTASSERT(test_eia_batch(INTEGRITY_ALGORITHM_ID_128_EIA3) == SRSLTE_SUCCESS);
+  TESTASSERT(test_invalid() == SRSLTE_SUCCESS);
+  TESTASSERT(test_throughput() == SRSLTE_SUCCESS);
+  return SRSLTE_SUCCESS;
+}
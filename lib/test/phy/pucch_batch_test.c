@@ -0,0 +1,238 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <srslte/common/test_common.h>
+#include <srslte/phy/utils/random.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/srslte.h"
+
+// Every UE has a SR resource in the tested subframes, one in ten is also expecting ACK and some others report CQI. The
+// ACK resources are packed, so several UEs transmit in the same PRB
+#define NOF_SR_UE 200
+#define NOF_CQI_UE 24
+#define NOF_UE (NOF_SR_UE + NOF_CQI_UE)
+#define NOF_SF 20
+#define SR_PROB 0.1f
+#define SNR_DB 20.0f
+
+static srslte_pucch_cfg_t pucch_cfg[NOF_UE];
+static srslte_pucch_cfg_t pucch_cfg_rx[NOF_UE];
+static srslte_pucch_res_t pucch_res[NOF_UE];
+static srslte_uci_value_t uci_tx[NOF_UE];
+
+static void set_ue_cfg(uint32_t ue_idx, srslte_random_t random_gen)
+{
+  srslte_pucch_cfg_t* cfg = &pucch_cfg[ue_idx];
+
+  bzero(cfg, sizeof(srslte_pucch_cfg_t));
+  cfg->delta_pucch_shift             = 2;
+  cfg->n_rb_2                        = 2;
+  cfg->N_cs                          = 0;
+  cfg->N_pucch_1                     = NOF_SR_UE;
+  cfg->rnti                          = 0x46 + ue_idx;
+  cfg->meas_ta_en                    = true;
+  cfg->threshold_format1             = SRSLTE_PUCCH_DEFAULT_THRESHOLD_FORMAT1;
+  cfg->threshold_data_valid_format1a = SRSLTE_PUCCH_DEFAULT_THRESHOLD_FORMAT1A;
+  cfg->threshold_data_valid_format2  = SRSLTE_PUCCH_DEFAULT_THRESHOLD_FORMAT2;
+  cfg->threshold_data_valid_format3  = SRSLTE_PUCCH_DEFAULT_THRESHOLD_FORMAT3;
+  cfg->threshold_dmrs_detection      = SRSLTE_PUCCH_DEFAULT_THRESHOLD_DMRS;
+
+  bzero(&uci_tx[ue_idx], sizeof(srslte_uci_value_t));
+  if (ue_idx < NOF_SR_UE) {
+    cfg->n_pucch_sr                       = ue_idx;
+    cfg->uci_cfg.is_scheduling_request_tti = true;
+    uci_tx[ue_idx].scheduling_request      = srslte_random_bool(random_gen, SR_PROB);
+
+    if (ue_idx % 10 == 0) {
+      cfg->uci_cfg.ack[0].ncce[0]  = (ue_idx / 10) * 2;
+      cfg->uci_cfg.ack[0].nof_acks = 1 + (ue_idx / 10) % 2;
+      for (uint32_t i = 0; i < cfg->uci_cfg.ack[0].nof_acks; i++) {
+        uci_tx[ue_idx].ack.ack_value[i] = srslte_random_uniform_int_dist(random_gen, 0, 1);
+      }
+    }
+  } else {
+    cfg->n_pucch_2                     = ue_idx - NOF_SR_UE;
+    cfg->uci_cfg.cqi.data_enable       = true;
+    cfg->uci_cfg.cqi.type              = SRSLTE_CQI_TYPE_WIDEBAND;
+    uci_tx[ue_idx].cqi.wideband.wideband_cqi = srslte_random_uniform_int_dist(random_gen, 0, 15);
+  }
+}
+
+static bool is_transmitting(uint32_t ue_idx)
+{
+  return uci_tx[ue_idx].scheduling_request || srslte_uci_cfg_total_ack(&pucch_cfg[ue_idx].uci_cfg) > 0 ||
+         pucch_cfg[ue_idx].uci_cfg.cqi.data_enable;
+}
+
+static bool is_correct(uint32_t ue_idx, srslte_pucch_cfg_t* cfg, srslte_pucch_res_t* res)
+{
+  if (ue_idx < NOF_SR_UE) {
+    if (res->uci_data.scheduling_request != uci_tx[ue_idx].scheduling_request) {
+      return false;
+    }
+    if (srslte_uci_cfg_total_ack(&cfg->uci_cfg) > 0) {
+      if (!res->detected || !res->uci_data.ack.valid) {
+        return false;
+      }
+      for (uint32_t i = 0; i < srslte_uci_cfg_total_ack(&cfg->uci_cfg); i++) {
+        if (res->uci_data.ack.ack_value[i] != uci_tx[ue_idx].ack.ack_value[i]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  return res->detected && res->uci_data.cqi.data_crc &&
+         res->uci_data.cqi.wideband.wideband_cqi == uci_tx[ue_idx].cqi.wideband.wideband_cqi;
+}
+
+/*
+ * The batched receiver must decode the UCI of hundreds of UEs in the subframe without errors, also when they share
+ * PRBs. The per UE receiver correlates with the power of the whole PRB, so it is only timed and its errors counted
+ */
+static int test_pucch_batch(uint32_t nof_prb)
+{
+  srslte_cell_t cell = {
+      nof_prb,            // nof_prb
+      1,                  // nof_ports
+      1,                  // cell_id
+      SRSLTE_CP_NORM,     // cyclic prefix
+      SRSLTE_PHICH_NORM,  // PHICH length
+      SRSLTE_PHICH_R_1_6, // PHICH resources
+      SRSLTE_FDD,
+  };
+
+  cf_t*                             buffer         = NULL;
+  srslte_refsignal_dmrs_pusch_cfg_t dmrs_pusch_cfg = {}; // Use default
+  srslte_ue_ul_t                    ue_ul          = {};
+  srslte_ue_ul_cfg_t                ue_ul_cfg      = {};
+  srslte_enb_ul_t                   enb_ul         = {};
+  srslte_ul_sf_cfg_t                ul_sf          = {};
+  srslte_pusch_data_t               pusch_data     = {};
+  srslte_random_t                   random_gen     = srslte_random_init(0x1234);
+  uint64_t                          t_legacy_us    = 0;
+  uint64_t                          t_batch_us     = 0;
+  uint32_t                          nof_tx         = 0;
+  uint32_t                          nof_legacy_err = 0;
+  struct timeval                    t[3];
+
+  // Init buffers
+  buffer = srslte_vec_cf_malloc(SRSLTE_SF_LEN_PRB(cell.nof_prb));
+  TESTASSERT(buffer);
+
+  // Init UE
+  TESTASSERT(!srslte_ue_ul_init(&ue_ul, buffer, cell.nof_prb));
+  TESTASSERT(!srslte_ue_ul_set_cell(&ue_ul, cell));
+
+  // Init eNb
+  TESTASSERT(!srslte_enb_ul_init(&enb_ul, buffer, cell.nof_prb));
+  TESTASSERT(!srslte_enb_ul_set_cell(&enb_ul, cell, &dmrs_pusch_cfg, NULL));
+  for (uint32_t i = 0; i < NOF_UE; i++) {
+    TESTASSERT(!srslte_enb_ul_add_rnti(&enb_ul, 0x46 + i));
+  }
+
+  for (ul_sf.tti = 0; ul_sf.tti < NOF_SF; ul_sf.tti++) {
+    // Generate the signal of every transmitting UE in the resource grid, each one with its own channel
+    srslte_vec_cf_zero(enb_ul.sf_symbols, SRSLTE_NOF_RE(cell));
+    float signal_power = 0;
+    for (uint32_t i = 0; i < NOF_UE; i++) {
+      set_ue_cfg(i, random_gen);
+      if (!is_transmitting(i)) {
+        continue;
+      }
+      ue_ul_cfg.ul_cfg.pucch = pucch_cfg[i];
+      pusch_data.uci         = uci_tx[i];
+      srslte_ue_ul_set_rnti(&ue_ul, pucch_cfg[i].rnti);
+      TESTASSERT(srslte_ue_ul_encode(&ue_ul, &ul_sf, &ue_ul_cfg, &pusch_data) == 1);
+
+      cf_t channel = cexpf(I * srslte_random_uniform_real_dist(random_gen, -M_PI, M_PI));
+      srslte_vec_sc_prod_ccc(ue_ul.sf_symbols, channel, ue_ul.sf_symbols, SRSLTE_NOF_RE(cell));
+      srslte_vec_sum_ccc(enb_ul.sf_symbols, ue_ul.sf_symbols, enb_ul.sf_symbols, SRSLTE_NOF_RE(cell));
+      if (signal_power == 0) {
+        signal_power = srslte_vec_avg_power_cf(ue_ul.sf_symbols, SRSLTE_NOF_RE(cell)) * SRSLTE_NOF_RE(cell) /
+                       (SRSLTE_NRE * SRSLTE_CP_NORM_NSYMB * SRSLTE_NOF_SLOTS_PER_SF);
+      }
+      nof_tx++;
+    }
+    float std_dev = sqrtf(signal_power / 2.0f) * srslte_convert_dB_to_amplitude(-SNR_DB);
+    srslte_ch_awgn_c(enb_ul.sf_symbols, enb_ul.sf_symbols, std_dev, SRSLTE_NOF_RE(cell));
+
+    // Per UE receiver
+    gettimeofday(&t[1], NULL);
+    for (uint32_t i = 0; i < NOF_UE; i++) {
+      pucch_cfg_rx[i] = pucch_cfg[i];
+      TESTASSERT(!srslte_enb_ul_get_pucch(&enb_ul, &ul_sf, &pucch_cfg_rx[i], &pucch_res[i]));
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    t_legacy_us += t[0].tv_sec * 1000000 + t[0].tv_usec;
+
+    for (uint32_t i = 0; i < NOF_UE; i++) {
+      nof_legacy_err += is_correct(i, &pucch_cfg_rx[i], &pucch_res[i]) ? 0 : 1;
+    }
+
+    // Batched receiver
+    gettimeofday(&t[1], NULL);
+    memcpy(pucch_cfg_rx, pucch_cfg, sizeof(pucch_cfg));
+    TESTASSERT(!srslte_enb_ul_get_pucch_batch(&enb_ul, &ul_sf, pucch_cfg_rx, pucch_res, NOF_UE));
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    t_batch_us += t[0].tv_sec * 1000000 + t[0].tv_usec;
+
+    for (uint32_t i = 0; i < NOF_UE; i++) {
+      TESTASSERT(is_correct(i, &pucch_cfg_rx[i], &pucch_res[i]));
+    }
+  }
+
+  printf("nof_prb=%d; %d UEs, %.1f transmitting per subframe; per UE receiver %.1f us/sf, %d errors; batched receiver "
+         "%.1f us/sf\n",
+         nof_prb,
+         NOF_UE,
+         (float)nof_tx / NOF_SF,
+         (float)t_legacy_us / NOF_SF,
+         nof_legacy_err,
+         (float)t_batch_us / NOF_SF);
+
+  // Free all
+  srslte_random_free(random_gen);
+  srslte_ue_ul_free(&ue_ul);
+  srslte_enb_ul_free(&enb_ul);
+  free(buffer);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  TESTASSERT(!test_pucch_batch(25));
+  TESTASSERT(!test_pucch_batch(100));
+
+  printf("Ok\n");
+
+  return SRSLTE_SUCCESS;
+}
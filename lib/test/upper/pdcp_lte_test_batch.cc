@@ -0,0 +1,191 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "pdcp_lte_test.h"
+#include "srslte/upper/pdcp_crypto_batch.h"
+#include <chrono>
+#include <thread>
+
+/*
+ * Dummy classes that keep all the packets they receive
+ */
+class rlc_collector : public srsue::rlc_interface_pdcp
+{
+public:
+  void write_sdu(uint32_t lcid, srslte::unique_byte_buffer_t sdu) { pdus.push_back(std::move(sdu)); }
+  void discard_sdu(uint32_t lcid, uint32_t discard_sn) {}
+  bool rb_is_um(uint32_t lcid) { return false; }
+  bool sdu_queue_is_full(uint32_t lcid) { return false; }
+
+  std::vector<srslte::unique_byte_buffer_t> pdus;
+};
+
+class gw_collector : public srsue::gw_interface_pdcp
+{
+public:
+  void write_pdu(uint32_t lcid, srslte::unique_byte_buffer_t pdu) { sdus.push_back(std::move(pdu)); }
+  void write_pdu_mch(uint32_t lcid, srslte::unique_byte_buffer_t pdu) {}
+
+  std::vector<srslte::unique_byte_buffer_t> sdus;
+};
+
+const uint32_t nof_sdus = 50;
+
+srslte::pdcp_config_t make_drb_cfg(srslte::security_direction_t tx_dir, srslte::security_direction_t rx_dir)
+{
+  return {1,
+          srslte::PDCP_RB_IS_DRB,
+          tx_dir,
+          rx_dir,
+          srslte::PDCP_SN_LEN_12,
+          srslte::pdcp_t_reordering_t::ms500,
+          srslte::pdcp_discard_timer_t::infinity};
+}
+
+srslte::unique_byte_buffer_t make_sdu(uint32_t i, srslte::byte_buffer_pool* pool)
+{
+  srslte::unique_byte_buffer_t sdu = srslte::allocate_unique_buffer(*pool);
+  sdu->N_bytes                     = 1 + (i * 37) % 1500;
+  for (uint32_t j = 0; j < sdu->N_bytes; j++) {
+    sdu->msg[j] = (uint8_t)(i + j * 3);
+  }
+  return sdu;
+}
+
+// Runs the stack tasks until the worker has delivered all the packets
+void wait_for(srsue::stack_test_dummy& stack, const std::vector<srslte::unique_byte_buffer_t>& v, uint32_t n)
+{
+  for (uint32_t i = 0; i < 10000 && v.size() < n; i++) {
+    stack.run_pending_tasks();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+/*
+ * The batched entities must produce the same PDUs as the unbatched one, in the same order
+ */
+int test_batch(srslte::CIPHERING_ALGORITHM_ID_ENUM algo, bool use_worker, srslte::log_ref log)
+{
+  srslte::byte_buffer_pool*    pool = srslte::byte_buffer_pool::get_instance();
+  srslte::as_security_config_t sec  = sec_cfg;
+  sec.cipher_algo                   = algo;
+
+  srsue::stack_test_dummy   stack;
+  srslte::pdcp_crypto_batch batch(&stack.task_sched, 8, use_worker);
+  rrc_dummy                 rrc(log);
+  rlc_collector             rlc_ref, rlc_tx, rlc_rx;
+  gw_collector              gw;
+
+  srslte::pdcp_config_t   cfg_tx = make_drb_cfg(srslte::SECURITY_DIRECTION_DOWNLINK, srslte::SECURITY_DIRECTION_UPLINK);
+  srslte::pdcp_config_t   cfg_rx = make_drb_cfg(srslte::SECURITY_DIRECTION_UPLINK, srslte::SECURITY_DIRECTION_DOWNLINK);
+  srslte::pdcp_entity_lte pdcp_ref(&rlc_ref, &rrc, &gw, &stack.task_sched, log, 3, cfg_tx);
+  srslte::pdcp_entity_lte pdcp_tx(&rlc_tx, &rrc, &gw, &stack.task_sched, log, 3, cfg_tx);
+  srslte::pdcp_entity_lte pdcp_rx(&rlc_rx, &rrc, &gw, &stack.task_sched, log, 3, cfg_rx);
+  for (srslte::pdcp_entity_lte* pdcp : {&pdcp_ref, &pdcp_tx, &pdcp_rx}) {
+    pdcp->config_security(sec);
+    pdcp->enable_encryption(srslte::DIRECTION_TXRX);
+  }
+  pdcp_tx.set_crypto_batch(&batch);
+  pdcp_rx.set_crypto_batch(&batch);
+
+  // TX
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    pdcp_ref.write_sdu(make_sdu(i, pool));
+    pdcp_tx.write_sdu(make_sdu(i, pool));
+  }
+  batch.flush();
+  wait_for(stack, rlc_tx.pdus, nof_sdus);
+  TESTASSERT(rlc_ref.pdus.size() == nof_sdus);
+  TESTASSERT(rlc_tx.pdus.size() == nof_sdus);
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    TESTASSERT(compare_two_packets(rlc_ref.pdus[i], rlc_tx.pdus[i]) == 0);
+  }
+
+  // RX of the ciphered PDUs
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    pdcp_rx.write_pdu(std::move(rlc_tx.pdus[i]));
+  }
+  batch.flush();
+  wait_for(stack, gw.sdus, nof_sdus);
+  TESTASSERT(gw.sdus.size() == nof_sdus);
+  for (uint32_t i = 0; i < nof_sdus; i++) {
+    TESTASSERT(compare_two_packets(make_sdu(i, pool), gw.sdus[i]) == 0);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * PDUs of a bearer that is removed while they wait in the batch are dropped
+ */
+int test_batch_bearer_removed(srslte::log_ref log)
+{
+  srslte::byte_buffer_pool* pool = srslte::byte_buffer_pool::get_instance();
+
+  srsue::stack_test_dummy   stack;
+  srslte::pdcp_crypto_batch batch(&stack.task_sched, 64, false);
+  rrc_dummy                 rrc(log);
+  rlc_collector             rlc;
+  gw_collector              gw;
+
+  srslte::pdcp_config_t cfg = make_drb_cfg(srslte::SECURITY_DIRECTION_DOWNLINK, srslte::SECURITY_DIRECTION_UPLINK);
+  {
+    srslte::pdcp_entity_lte pdcp(&rlc, &rrc, &gw, &stack.task_sched, log, 3, cfg);
+    pdcp.config_security(sec_cfg);
+    pdcp.enable_encryption(srslte::DIRECTION_TXRX);
+    pdcp.set_crypto_batch(&batch);
+    for (uint32_t i = 0; i < 4; i++) {
+      pdcp.write_sdu(make_sdu(i, pool));
+    }
+    TESTASSERT(batch.nof_pending() == 4);
+  }
+  batch.flush();
+  TESTASSERT(rlc.pdus.empty());
+
+  return SRSLTE_SUCCESS;
+}
+
+int run_all_tests(srslte::byte_buffer_pool* pool)
+{
+  // Setup log
+  srslte::log_ref log("PDCP LTE Test Batch");
+  log->set_level(srslte::LOG_LEVEL_DEBUG);
+  log->set_hex_limit(128);
+
+  for (bool use_worker : {false, true}) {
+    TESTASSERT(test_batch(srslte::CIPHERING_ALGORITHM_ID_EEA0, use_worker, log) == SRSLTE_SUCCESS);
+    TESTASSERT(test_batch(srslte::CIPHERING_ALGORITHM_ID_128_EEA1, use_worker, log) == SRSLTE_SUCCESS);
+    TESTASSERT(test_batch(srslte::CIPHERING_ALGORITHM_ID_128_EEA2, use_worker, log) == SRSLTE_SUCCESS);
+    TESTASSERT(test_batch(srslte::CIPHERING_ALGORITHM_ID_128_EEA3, use_worker, log) == SRSLTE_SUCCESS);
+  }
+  TESTASSERT(test_batch_bearer_removed(log) == SRSLTE_SUCCESS);
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  if (run_all_tests(srslte::byte_buffer_pool::get_instance()) != SRSLTE_SUCCESS) {
+    fprintf(stderr, "pdcp_lte_tests() failed\n");
+    return SRSLTE_ERROR;
+  }
+  srslte::byte_buffer_pool::cleanup();
+
+  return SRSLTE_SUCCESS;
+}
@@ -329,6 +329,63 @@ bool segment_test(bool in_seq_rx)
   return SRSLTE_SUCCESS;
 }
 
+// A large SDU starting in the last segment of a large PDU must still fit once its remaining segments arrive
+bool large_sdu_reassembly_test()
+{
+  rlc_am_tester         tester;
+  srslte::timer_handler timers(8);
+
+  rlc_am_lte rlc1(rrc_log1, 1, &tester, &tester, &timers);
+  rlc_am_lte rlc2(rrc_log2, 1, &tester, &tester, &timers);
+
+  if (not rlc1.configure(rlc_config_t::default_rlc_am_config())) {
+    return -1;
+  }
+
+  if (not rlc2.configure(rlc_config_t::default_rlc_am_config())) {
+    return -1;
+  }
+
+  // A small SDU followed by one that only just fits into an empty buffer
+  const uint32_t       sdu_sizes[] = {100, SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET - 32};
+  byte_buffer_pool*    pool        = byte_buffer_pool::get_instance();
+  unique_byte_buffer_t sdu_bufs[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    sdu_bufs[i] = srslte::allocate_unique_buffer(*pool, true);
+    for (uint32_t j = 0; j < sdu_sizes[i]; j++) {
+      sdu_bufs[i]->msg[j] = (i + j) & 0xff;
+    }
+    sdu_bufs[i]->N_bytes = sdu_sizes[i];
+    rlc1.write_sdu(std::move(sdu_bufs[i]));
+  }
+
+  // The first PDU carries the small SDU and the first half of the large one
+  byte_buffer_t pdu_bufs[4];
+  int           n_pdus = 0;
+  while (rlc1.get_buffer_state() > 0 && n_pdus < 4) {
+    int len                    = rlc1.read_pdu(pdu_bufs[n_pdus].msg, 6000);
+    pdu_bufs[n_pdus++].N_bytes = len;
+  }
+  TESTASSERT(n_pdus == 3);
+
+  for (int i = 0; i < n_pdus; i++) {
+    rlc2.write_pdu(pdu_bufs[i].msg, pdu_bufs[i].N_bytes);
+  }
+
+  TESTASSERT(tester.n_sdus == 2);
+  for (int i = 0; i < tester.n_sdus; i++) {
+    TESTASSERT(tester.sdus[i]->N_bytes == sdu_sizes[i]);
+    for (uint32_t j = 0; j < sdu_sizes[i]; j++) {
+      TESTASSERT(tester.sdus[i]->msg[j] == ((i + j) & 0xff));
+    }
+  }
+
+  // Check statistics
+  TESTASSERT(rx_is_tx(rlc1.get_metrics(), rlc2.get_metrics()));
+
+  return SRSLTE_SUCCESS;
+}
+
 bool retx_test()
 {
   rlc_am_tester tester;
@@ -1573,6 +1630,12 @@ int main(int argc, char** argv)
   };
   byte_buffer_pool::get_instance()->cleanup();
 
+  if (large_sdu_reassembly_test()) {
+    printf("large_sdu_reassembly_test failed\n");
+    exit(-1);
+  };
+  byte_buffer_pool::get_instance()->cleanup();
+
   if (retx_test()) {
     printf("retx_test failed\n");
     exit(-1);
@@ -26,9 +26,11 @@
 #include "srslte/upper/rlc.h"
 #include <boost/program_options.hpp>
 #include <boost/program_options/parsers.hpp>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <pthread.h>
 #include <random>
 
@@ -65,6 +67,25 @@ int write_pdu_to_pcap(const bool is_dl, const uint32_t lcid, const uint8_t* payl
   return SRSLTE_ERROR;
 }
 
+// Count heap allocations to report the number of allocations per PDU
+static std::atomic<uint64_t> nof_heap_allocs(0);
+
+// Neither is inlined, so that the compiler doesn't see malloc() paired with operator delete or new with free()
+__attribute__((noinline)) void* operator new(std::size_t size)
+{
+  nof_heap_allocs++;
+  void* ptr = malloc(size > 0 ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
 using namespace std;
 using namespace srsue;
 using namespace srslte;
@@ -485,6 +506,8 @@ void stress_test(stress_test_args_t args)
     rlc2.add_bearer(lcid, cnfg_);
   }
 
+  uint64_t allocs_start = nof_heap_allocs;
+
   tester1.start(7);
   if (!args.single_tx) {
     tester2.start(7);
@@ -520,6 +543,8 @@ void stress_test(stress_test_args_t args)
 
   printf("Writers stopped.\n");
 
+  uint64_t nof_allocs = nof_heap_allocs - allocs_start;
+
   mac.stop();
   if (args.write_pcap) {
     pcap.close();
@@ -535,6 +560,9 @@ void stress_test(stress_test_args_t args)
          metrics.bearer[lcid].num_tx_pdu_bytes,
          metrics.bearer[lcid].num_rx_pdu_bytes);
   rlc_bearer_metrics_print(metrics.bearer[lcid]);
+  uint64_t nof_pdus         = metrics.bearer[lcid].num_tx_pdus;
+  uint64_t nof_rx_sdus      = metrics.bearer[lcid].num_rx_sdus;
+  uint64_t nof_copied_bytes = metrics.bearer[lcid].num_tx_copied_bytes + metrics.bearer[lcid].num_rx_copied_bytes;
 
   rlc2.get_metrics(metrics);
   printf("RLC2 received %d SDUs in %ds (%.2f/s), Tx=%" PRIu64 " B, Rx=%" PRIu64 " B\n",
@@ -544,6 +572,18 @@ void stress_test(stress_test_args_t args)
          metrics.bearer[lcid].num_tx_pdu_bytes,
          metrics.bearer[lcid].num_rx_pdu_bytes);
   rlc_bearer_metrics_print(metrics.bearer[lcid]);
+  nof_pdus += metrics.bearer[lcid].num_tx_pdus;
+  nof_rx_sdus += metrics.bearer[lcid].num_rx_sdus;
+  nof_copied_bytes += metrics.bearer[lcid].num_tx_copied_bytes + metrics.bearer[lcid].num_rx_copied_bytes;
+
+  printf("Transmitted %" PRIu64 " PDUs (%.2f PDUs/s), %" PRIu64 " heap allocations (%.2f per PDU)\n",
+         nof_pdus,
+         static_cast<double>(nof_pdus) / args.test_duration_sec,
+         nof_allocs,
+         nof_pdus > 0 ? static_cast<double>(nof_allocs) / nof_pdus : 0.0);
+  printf("Copied %" PRIu64 " B inside RLC (%.2f B per delivered SDU)\n",
+         nof_copied_bytes,
+         nof_rx_sdus > 0 ? static_cast<double>(nof_copied_bytes) / nof_rx_sdus : 0.0);
 }
 
 int main(int argc, char** argv)
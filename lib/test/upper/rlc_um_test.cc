@@ -389,6 +389,50 @@ int reassmble_test2()
   return 0;
 }
 
+// Several large SDUs carried by two large PDUs, the last SDU of the first PDU continues in the second one
+int large_sdu_reassembly_test()
+{
+  rlc_um_lte_test_context1 ctxt;
+
+  const uint32_t num_sdus = 9;
+  const uint32_t sdu_size = 1400;
+  ctxt.tester.set_expected_sdu_len(sdu_size);
+
+  byte_buffer_pool*    pool = byte_buffer_pool::get_instance();
+  unique_byte_buffer_t sdu_bufs[num_sdus];
+  for (uint32_t i = 0; i < num_sdus; i++) {
+    sdu_bufs[i] = srslte::allocate_unique_buffer(*pool, true);
+    memset(sdu_bufs[i]->msg, i, sdu_size); // Write the index into the buffer
+    sdu_bufs[i]->N_bytes = sdu_size;
+    ctxt.rlc1.write_sdu(std::move(sdu_bufs[i]));
+  }
+
+  // Read 2 PDUs from RLC1
+  const uint32_t       grant_sizes[] = {11250, 12000};
+  unique_byte_buffer_t pdu_bufs[2];
+  for (uint32_t i = 0; i < 2; i++) {
+    pdu_bufs[i]          = srslte::allocate_unique_buffer(*pool, true);
+    int len              = ctxt.rlc1.read_pdu(pdu_bufs[i]->msg, grant_sizes[i]);
+    pdu_bufs[i]->N_bytes = len;
+    TESTASSERT(len > 0);
+  }
+
+  TESTASSERT(0 == ctxt.rlc1.get_buffer_state());
+
+  // Write 2 PDUs into RLC2
+  for (uint32_t i = 0; i < 2; i++) {
+    ctxt.rlc2.write_pdu(pdu_bufs[i]->msg, pdu_bufs[i]->N_bytes);
+  }
+
+  TESTASSERT(num_sdus == ctxt.tester.get_num_sdus());
+  for (uint32_t i = 0; i < ctxt.tester.sdus.size(); i++) {
+    TESTASSERT(ctxt.tester.sdus[i]->N_bytes == sdu_size);
+    TESTASSERT(*(ctxt.tester.sdus[i]->msg) == i);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 /* PDU pack test where 2nd SDU segment is added but no
  * space is left in PDU to add data bytes of the newly added SDU.
  * The test makes sure that a SDU header is removed again and that
@@ -468,4 +512,7 @@ int main(int argc, char** argv)
 
   TESTASSERT(pdu_pack_no_space_test() == 0);
   byte_buffer_pool::get_instance()->cleanup();
+
+  TESTASSERT(large_sdu_reassembly_test() == 0);
+  byte_buffer_pool::get_instance()->cleanup();
 }
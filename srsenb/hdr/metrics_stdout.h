@@ -49,6 +49,7 @@ private:
   std::string float_to_string(float f, int digits, int field_width = 6);
   std::string int_to_hex_string(int value, int field_width);
   std::string float_to_eng_string(float f, int digits);
+  void        print_phy_timing(const phy_timing_metrics_t& timing);
 
   bool                   do_print;
   uint8_t                n_reports;
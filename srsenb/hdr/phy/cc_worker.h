@@ -22,6 +22,7 @@
 #ifndef SRSENB_CC_WORKER_H
 #define SRSENB_CC_WORKER_H
 
+#include <chrono>
 #include <string.h>
 
 #include "phy_common.h"
@@ -40,7 +41,8 @@ public:
 
   cf_t* get_buffer_rx(uint32_t antenna_idx);
   cf_t* get_buffer_tx(uint32_t antenna_idx);
-  void  set_tti(uint32_t tti);
+  void  set_tti(uint32_t tti, const std::chrono::steady_clock::time_point& rx_time);
+  void  set_ue_db(const phy_ue_db::snapshot_t& ue_db_snapshot);
 
   int      add_rnti(uint16_t rnti);
   void     rem_rnti(uint16_t rnti);
@@ -58,7 +60,14 @@ public:
   void work_dl(const srslte_dl_sf_cfg_t&            dl_sf_cfg,
                stack_interface_phy_lte::dl_sched_t& dl_grants,
                stack_interface_phy_lte::ul_sched_t& ul_grants,
-               srslte_mbsfn_cfg_t*                  mbsfn_cfg);
+               srslte_mbsfn_cfg_t*                  mbsfn_cfg,
+               float                                ul_wait_us);
+
+  /// Saves the PHICH resources of the PUSCH received in this TTI, when they are decoded by another worker
+  void set_phich_grants(stack_interface_phy_lte::ul_sched_t& ul_grants);
+
+  /// Indicates as KO the PUSCH grants that were not decoded by the UL deadline, i.e. not set in the reported mask
+  void nack_late_pusch(stack_interface_phy_lte::ul_sched_t& ul_grants, uint64_t pusch_reported);
 
   uint32_t get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS]);
 
@@ -67,11 +76,20 @@ private:
   constexpr static float PUCCH_RL_CORR_TH   = 0.15f;
 
   int  encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
+  int  encode_pdsch_rnti(stack_interface_phy_lte::dl_sched_grant_t& grant, srslte_dl_cfg_t& dl_cfg, uint32_t slot);
   int  encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srslte_mbsfn_cfg_t* mbsfn_cfg);
-  void decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
+  bool decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
+                         srslte_ul_cfg_t&                           ul_cfg,
+                         srslte_pusch_res_t&                        pusch_res,
+                         bool&                                      uci_required,
+                         uint32_t                                   slot);
+  void report_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
                          srslte_ul_cfg_t&                           ul_cfg,
-                         srslte_pusch_res_t&                        pusch_res);
+                         srslte_pusch_res_t&                        pusch_res,
+                         bool                                       uci_required,
+                         uint32_t                                   slot);
   void decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch);
+  void decode_pusch_grant(stack_interface_phy_lte::ul_sched_grant_t& ul_grant, uint32_t grant_idx, uint32_t slot);
   int  encode_phich(stack_interface_phy_lte::ul_sched_ack_t* acks, uint32_t nof_acks);
   int  encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
   int  encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_grants);
@@ -86,9 +104,36 @@ private:
   cf_t*    signal_buffer_tx[SRSLTE_MAX_PORTS] = {};
   uint32_t tti_rx = 0, tti_tx_dl = 0, tti_tx_ul = 0;
 
+  // Reception time of the UL subframe, the PUSCH decoding latency is measured from it
+  std::chrono::steady_clock::time_point rx_time;
+
+  // Snapshot of the PHY common UE database, taken at the start of the TTI being processed
+  phy_ue_db::snapshot_t tti_ue_db;
+
+  // The PUSCH are decoded here and only copied to the MAC buffer if they are reported before the UL deadline
+  uint8_t* pusch_data = nullptr;
+
   srslte_enb_dl_t enb_dl = {};
   srslte_enb_ul_t enb_ul = {};
 
+  // PUSCH decoders and PDSCH encoders of the PHY task pool threads (slot > 0), the calling thread uses enb_ul/enb_dl
+  struct lane_t {
+    srslte_enb_ul_pusch_t ul         = {};
+    srslte_pdsch_t        pdsch      = {};
+    uint8_t*              pusch_data = nullptr;
+  };
+  std::vector<lane_t> lanes;
+
+  // Configuration of the PDSCH being encoded and whether they were encoded, one per DL grant. Not a vector<bool>, the
+  // grants are encoded in parallel
+  std::vector<srslte_dl_cfg_t> pdsch_cfg;
+  std::vector<uint8_t>         pdsch_encoded;
+
+  // UEs expecting PUCCH in the TTI being decoded, with their configuration and result
+  std::vector<uint16_t>           pucch_rnti;
+  std::vector<srslte_pucch_cfg_t> pucch_cfg;
+  std::vector<srslte_pucch_res_t> pucch_res;
+
   srslte_dl_sf_cfg_t dl_sf = {};
   srslte_ul_sf_cfg_t ul_sf = {};
 
@@ -106,8 +151,9 @@ private:
     srslte_phich_grant_t phich_grant = {};
 
     void     metrics_read(phy_metrics_t* metrics);
-    void     metrics_dl(uint32_t mcs);
-    void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters);
+    void     metrics_dl(uint32_t mcs, float ul_wait_us, float encode_us);
+    void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters, float decode_us);
+    void     metrics_ul_late();
     uint32_t get_rnti() const { return rnti; }
 
   private:
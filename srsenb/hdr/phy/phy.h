@@ -67,6 +67,7 @@ public:
   void complete_config(uint16_t rnti) override;
 
   void get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS]) override;
+  void get_timing_metrics(phy_timing_metrics_t* m) override;
 
   void cmd_cell_gain(uint32_t cell_id, float gain_db) override;
 
@@ -74,8 +75,9 @@ public:
   void radio_failure() override{};
 
 private:
-  phy_cfg_mbsfn_t mbsfn_config = {};
-  uint32_t        nof_workers  = 0;
+  phy_cfg_mbsfn_t mbsfn_config   = {};
+  uint32_t        nof_workers    = 0;
+  uint32_t        nof_ul_workers = 0;
 
   const static int MAX_WORKERS = 4;
 
@@ -89,8 +91,13 @@ private:
   std::vector<std::unique_ptr<srslte::log_filter> > log_vec;
   srslte::log*                                      log_h = nullptr;
 
+  // Shares the carriers and the UEs of each TTI among threads, it is used by the workers so it goes first
+  std::unique_ptr<srslte::task_thread_pool> task_pool;
+
   srslte::thread_pool    workers_pool;
   std::vector<sf_worker> workers;
+  srslte::thread_pool    ul_workers_pool;
+  std::vector<sf_worker> ul_workers;
   phy_common             workers_common;
   prach_worker_pool      prach;
   txrx                   tx_rx;
@@ -34,6 +34,9 @@
 #include "srslte/interfaces/radio_interfaces.h"
 #include "srslte/phy/channel/channel.h"
 #include "srslte/radio/radio.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <srslte/common/tti_sempahore.h>
 #include <string.h>
@@ -55,14 +58,83 @@ public:
    */
   srslte::tti_semaphore<void*> semaphore;
 
+  /**
+   * Timestamps of the processing of a TTI by its DL-TX worker: timing[s] is the start of the stage s of
+   * phy_timing_metrics_t and timing[nof_stages] the hand-over of the subframe to the radio
+   */
+  typedef std::array<std::chrono::steady_clock::time_point, phy_timing_metrics_t::nof_stages + 1> tti_timing_t;
+
+  /// The samples received in a subframe are transmitted FDD_HARQ_DELAY_UL_MS after its start, that is, after the
+  /// reception returns. The budget does not account for the buffering of the radio
+  static const uint32_t tx_deadline_us = (FDD_HARQ_DELAY_UL_MS - 1) * 1000;
+
   /**
    * Performs common end worker transmission tasks such as transmission and stack TTI execution
    *
    * @param tx_sem_id Semaphore identifier, the worker thread pointer is used
    * @param buffer baseband IQ sample buffer
    * @param tx_time timestamp to transmit samples
+   * @param timing if not null, its last timestamp is set when the samples are handed to the radio
+   */
+  void worker_end(void*                   tx_sem_id,
+                  srslte::rf_buffer_t&    buffer,
+                  srslte::rf_timestamp_t& tx_time,
+                  tti_timing_t*           timing = nullptr);
+
+  /**
+   * Accumulates the stage durations of a TTI into the timing metrics. The subframe is late if it was handed to the
+   * radio more than tx_deadline_us after its reception
+   *
+   * @param timing timestamps of the TTI, all of them set
+   * @param late_stage set to the stage that took the longest if the subframe was late
+   * @return time left to the deadline in microseconds, negative if the subframe was late
+   */
+  float timing_report(const tti_timing_t& timing, uint32_t* late_stage);
+  void  get_timing_metrics(phy_timing_metrics_t* m);
+
+  /**
+   * Hand-over of the UL-RX stage of a TTI to its DL-TX stage. The stack needs the CRC and UCI received in TTI n before
+   * scheduling TTI n+4, so the DL-TX stage waits for the UL-RX stage, but only until the UL deadline. Then the TTI is
+   * closed: the DL-TX stage indicates as KO the PUSCH that were not reported yet and the UL-RX stage drops the rest.
+   *
+   * The UL-RX stage reports the UCI and each PUSCH to the stack between ul_rx_report_begin() and ul_rx_report_end(),
+   * which is only called if ul_rx_report_begin() returned true. ul_rx_report_end() takes the mask of the PUSCH grant
+   * indexes of the carrier that were reported, 0 for the UCI on PUCCH.
+   *
+   * ul_rx_skip() replaces ul_rx_start() when no UL-RX worker was free for the TTI: the TTI is never open and the
+   * DL-TX stage indicates all its PUSCH as KO without waiting.
    */
-  void worker_end(void* tx_sem_id, srslte::rf_buffer_t& buffer, srslte::rf_timestamp_t& tx_time);
+  void ul_rx_start(uint32_t tti);
+  void ul_rx_skip(uint32_t tti);
+  bool ul_rx_is_open(uint32_t tti);
+  bool ul_rx_report_begin(uint32_t tti);
+  void ul_rx_report_end(uint32_t tti, uint32_t cc_idx, uint64_t pusch_mask);
+  void ul_rx_end(uint32_t tti);
+
+  /**
+   * Waits for the UL-RX stage of a TTI and closes the TTI
+   *
+   * @param tti UL-RX TTI
+   * @param deadline time after which the TTI is closed even if the UL-RX stage has not finished
+   * @param pusch_reported mask of the PUSCH grant indexes reported by the UL-RX stage for each eNb carrier
+   * @return true if the UL-RX stage finished before the deadline
+   */
+  bool ul_rx_wait(uint32_t                                     tti,
+                  const std::chrono::steady_clock::time_point& deadline,
+                  std::vector<uint64_t>&                       pusch_reported);
+
+  /**
+   * Fork-join of the carriers or the UEs of a TTI over the PHY task pool. Without pool the tasks run in the calling
+   * thread.
+   *
+   * @param nof_tasks number of tasks
+   * @param task callable, slot is lower than get_nof_task_slots() and unique among the threads running the tasks
+   */
+  void     parallel_for(uint32_t nof_tasks, const std::function<void(uint32_t idx, uint32_t slot)>& task);
+  uint32_t get_nof_task_slots() const;
+
+  // Pool spreading the carriers and the UEs of a TTI, owned by the PHY. Null when disabled
+  srslte::task_thread_pool* task_pool = nullptr;
 
   // Common objects
   phy_args_t params = {};
@@ -187,6 +259,22 @@ private:
   srslte::circular_array<stack_interface_phy_lte::ul_sched_list_t, TTIMOD_SZ> ul_grants   = {};
   std::mutex                                                                  grant_mutex = {};
 
+  // UL-RX stage state of the TTIs being processed
+  static_assert(stack_interface_phy_lte::MAX_GRANTS <= 64, "The reported PUSCH grants do not fit in the masks");
+  struct ul_rx_state_t {
+    std::mutex              mutex;
+    std::condition_variable cvar;
+    uint32_t                tti      = 0;
+    bool                    open     = false;
+    bool                    finished = false;
+    std::vector<uint64_t>   pusch_reported; ///< One mask per eNb carrier, there may be more than SRSLTE_MAX_CARRIERS
+  };
+  srslte::circular_array<ul_rx_state_t, TTIMOD_SZ> ul_rx_states;
+
+  // Timing metrics accumulated since they were last read
+  std::mutex           timing_mutex   = {};
+  phy_timing_metrics_t timing_metrics = {};
+
   phy_cell_cfg_list_t cell_list;
 
   bool                                     have_mtch_stop   = false;
@@ -47,18 +47,23 @@ struct phy_args_t {
   std::string            type;
   srslte::phy_log_args_t log;
 
-  float       sampling_rate_hz    = 0.0f;
-  float       max_prach_offset_us = 10;
-  int         pusch_max_its       = 10;
-  bool        pusch_8bit_decoder  = false;
-  float       tx_amplitude        = 1.0f;
-  int         nof_phy_threads     = 1;
-  std::string equalizer_mode      = "mmse";
-  float       estimator_fil_w     = 1.0f;
-  bool        pusch_meas_epre     = true;
-  bool        pusch_meas_evm      = false;
-  bool        pusch_meas_ta       = true;
-  bool        pucch_meas_ta       = true;
+  float       sampling_rate_hz     = 0.0f;
+  float       max_prach_offset_us  = 10;
+  bool        prach_fast_detection = true; ///< Search only the valid delays of the PRACH preambles, with a pruned IDFT
+  bool        pucch_batch_rx       = true; ///< Despread each PUCCH PRB once for all the UEs of the TTI
+  int         pusch_max_its        = 10;
+  bool        pusch_8bit_decoder   = false;
+  float       tx_amplitude         = 1.0f;
+  int         nof_phy_threads      = 1;
+  int         nof_ul_phy_threads   = 0;    ///< UL-RX threads, 0 decodes the UL in the same threads as the DL
+  uint32_t    ul_deadline_us       = 2000; ///< Time the DL-TX stage of a TTI waits for its UL-RX stage
+  int         nof_phy_task_threads = 0;    ///< Threads sharing the carriers and UEs of a TTI, 0 disables the pool
+  std::string equalizer_mode       = "mmse";
+  float       estimator_fil_w      = 1.0f;
+  bool        pusch_meas_epre      = true;
+  bool        pusch_meas_evm       = false;
+  bool        pusch_meas_ta        = true;
+  bool        pucch_meas_ta        = true;
 
   srslte::channel::args_t dl_channel_args;
   srslte::channel::args_t ul_channel_args;
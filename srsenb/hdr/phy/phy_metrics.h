@@ -22,6 +22,8 @@
 #ifndef SRSENB_PHY_METRICS_H
 #define SRSENB_PHY_METRICS_H
 
+#include <stdint.h>
+
 namespace srsenb {
 
 // PHY metrics per user
@@ -32,11 +34,15 @@ struct ul_metrics_t {
   float rssi;
   float turbo_iters;
   float mcs;
+  float decode_us; ///< Time from the reception of the subframe to the CRC indication of the PUSCH
+  int   n_late;    ///< PUSCH indicated as KO because they were not decoded by the UL deadline
   int   n_samples;
 };
 
 struct dl_metrics_t {
   float mcs;
+  float ul_wait_us; ///< Time the DL-TX stage waited for the UL-RX stage of the same TTI
+  float encode_us;  ///< Time from the end of the UL wait to the subframe being ready for transmission
   int   n_samples;
 };
 
@@ -45,6 +51,38 @@ struct phy_metrics_t {
   ul_metrics_t ul;
 };
 
+// PHY processing time of the TTIs, from the reception of the subframe to its hand-over to the radio
+
+struct phy_timing_metrics_t {
+  enum stage_t {
+    queue = 0, ///< From the reception of the subframe to the start of its worker
+    ul,        ///< UL processing, or wait for the UL-RX worker
+    sched,     ///< DL and UL scheduling of the MAC
+    encode,    ///< DL encoding
+    tx,        ///< Wait for the previous TTI to be transmitted
+    nof_stages
+  };
+
+  /// Bin i < nof_bins - 1 counts the durations below (bin0_limit_us << i), the last bin counts the rest
+  static const uint32_t nof_bins      = 8;
+  static const uint32_t bin0_limit_us = 50;
+
+  float    mean_us[nof_stages];
+  float    max_us[nof_stages];
+  uint32_t hist[nof_stages][nof_bins];
+  float    slack_mean_us;            ///< Time left to the TX deadline when the subframe is handed to the radio
+  float    slack_min_us;
+  uint32_t n_late;                   ///< Subframes handed to the radio past the TX deadline
+  uint32_t n_late_stage[nof_stages]; ///< Late subframes by the stage that took the longest
+  uint32_t n_samples;
+};
+
+inline const char* phy_timing_stage_to_string(uint32_t stage)
+{
+  static const char* names[phy_timing_metrics_t::nof_stages] = {"queue", "ul", "sched", "encode", "tx"};
+  return stage < phy_timing_metrics_t::nof_stages ? names[stage] : "unknown";
+}
+
 } // namespace srsenb
 
 #endif // SRSENB_PHY_METRICS_H
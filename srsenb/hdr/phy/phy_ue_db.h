@@ -23,7 +23,10 @@
 #define SRSENB_PHY_UE_DB_H_
 
 #include "phy_interfaces.h"
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <srslte/adt/circular_array.h>
 #include <srslte/interfaces/enb_interfaces.h>
@@ -79,36 +82,71 @@ private:
   } cell_state_t;
 
   /**
-   * Cell information for the UE database
+   * Cell configuration for the UE database
    */
   typedef struct {
-    cell_state_t                                     state      = cell_state_none; ///< Configuration state
-    uint32_t                                         enb_cc_idx = 0;  ///< Corresponding eNb cell/carrier index
-    uint8_t                                          last_ri    = 0;  ///< Last reported rank indicator
-    srslte::circular_array<srslte_ra_tb_t, SRSLTE_MAX_HARQ_PROC> last_tb =
-        {};                                                           ///< Stores last PUSCH Resource allocation
-    srslte::phy_cfg_t                                phy_cfg;         ///< Configuration, it has a default constructor
-    srslte::circular_array<bool, TTIMOD_SZ> is_grant_available;       ///< Indicates whether there is an available grant
+    cell_state_t      state      = cell_state_none; ///< Configuration state
+    uint32_t          enb_cc_idx = 0;               ///< Corresponding eNb cell/carrier index
+    srslte::phy_cfg_t phy_cfg;                      ///< Configuration, it has a default constructor
   } cell_info_t;
 
   /**
-   * UE object stored in the PHY common database
+   * Cell state written by the workers, indexed as the cell information
+   */
+  struct cell_tti_state_t {
+    std::atomic<uint8_t>                                         last_ri{0};              ///< Last reported RI
+    srslte::circular_array<srslte_ra_tb_t, SRSLTE_MAX_HARQ_PROC> last_tb            = {}; ///< Last PUSCH allocation
+    srslte::circular_array<bool, TTIMOD_SZ>                      is_grant_available = {}; ///< Available UL grants
+  };
+
+  /**
+   * UE configuration stored in the PHY common database. It is never modified once published, the stack publishes a
+   * modified copy instead
    */
   struct common_ue {
+    std::array<cell_info_t, SRSLTE_MAX_CARRIERS> cell_info       = {}; ///< Cell information, indexed by ue_cell_idx
+    srslte::phy_cfg_t                            pcell_cfg_stash = {}; ///< Stashed Cell information
+  };
+
+  /**
+   * UE state written by the workers. It is shared by all the configuration versions of the UE. Every entry but the RI
+   * belongs to a TTI slot or a HARQ process, which different workers access 8 TTIs apart: the pending ACKs are written
+   * by the DL of a TTI and read by the UL, a HARQ process is used again 8 TTIs later. Each slot and HARQ process has
+   * its own lock, so the workers of different TTIs never contend. The RI is reported by any TTI, it is atomic
+   */
+  struct ue_tti_state_t {
     srslte::circular_array<srslte_pdsch_ack_t, TTIMOD_SZ> pdsch_ack = {}; ///< Pending acknowledgements for this Cell
-    std::array<cell_info_t, SRSLTE_MAX_CARRIERS>          cell_info = {}; ///< Cell information, indexed by ue_cell_idx
-    srslte::phy_cfg_t                                     pcell_cfg_stash = {}; ///< Stashed Cell information
+    std::array<cell_tti_state_t, SRSLTE_MAX_CARRIERS>     cell;           ///< Cell state, indexed by ue_cell_idx
+    mutable srslte::circular_array<std::mutex, TTIMOD_SZ> tti_mutex;      ///< Protects the ACKs and grants of a TTI
+    mutable std::array<std::mutex, SRSLTE_MAX_HARQ_PROC>  harq_mutex;     ///< Protects the TBs of a HARQ process
+  };
+
+  struct ue_entry_t {
+    std::shared_ptr<const common_ue> cfg;
+    std::shared_ptr<ue_tti_state_t>  state;
   };
+  typedef std::map<uint16_t, ue_entry_t> ue_map_t;
+
+  typedef std::shared_ptr<const ue_map_t> ue_map_ptr_t;
 
   /**
-   * UE database indexed by RNTI
+   * UE database indexed by RNTI. A version is never modified once published, the stack swaps the pointer to the
+   * current one and the workers keep reading the version of their snapshot until they take the next one
    */
-  std::map<uint16_t, common_ue> ue_db;
+  std::atomic<const ue_map_ptr_t*> ue_db;
 
   /**
-   * Concurrency protection mutex, allowed modifications from const methods.
+   * RCU grace period of the replaced versions. A worker taking a snapshot counts itself in the readers of the current
+   * epoch while it copies the version pointer, the stack frees a replaced pointer once the readers of both epochs have
+   * gone. The workers never wait, the stack only waits for the copies in progress
    */
-  mutable std::mutex mutex;
+  std::atomic<uint32_t>                        ue_db_epoch = {0};
+  mutable std::array<std::atomic<uint32_t>, 2> ue_db_nof_readers;
+
+  /**
+   * Serialises the modifications from the stack, the workers never take it
+   */
+  std::mutex mutex;
 
   /**
    * Stack interface
@@ -126,19 +164,21 @@ private:
   const phy_cell_cfg_list_t* cell_cfg_list = nullptr;
 
   /**
-   * Internal RNTI addition, it is not thread safe protected
+   * Internal RNTI addition to a working copy of the database
    *
+   * @param ues working copy of the database
    * @param rnti identifier of the UE
    */
-  inline void _add_rnti(uint16_t rnti);
+  inline void _add_rnti(ue_map_t& ues, uint16_t rnti) const;
 
   /**
-   * Internal pending ACK clear for a given RNTI and TTI, it is not thread safe protected
+   * Internal pending ACK clear for a given UE and TTI
    *
    * @param tti is the given TTI (requires assertion prior to call)
-   * @param rnti identifier of the UE (requires assertion prior to call)
+   * @param ue configuration of the UE
+   * @param state state of the UE
    */
-  inline void _clear_tti_pending_rnti(uint32_t tti, uint16_t rnti);
+  static inline void _clear_tti_pending_rnti(uint32_t tti, const common_ue& ue, ue_tti_state_t& state);
 
   /**
    * Helper method to set the constant attributes of a given RNTI after the configuration is set, it does not modify
@@ -150,89 +190,21 @@ private:
   inline void _set_common_config_rnti(uint16_t rnti, srslte::phy_cfg_t& phy_cfg) const;
 
   /**
-   * Gets the SCell index for a given RNTI and a eNb cell/carrier. It returns the SCell index (0 if PCell) if the cc_idx
-   * is found among the configured cells/carriers. Otherwise, it returns SRSLTE_MAX_CARRIERS.
+   * Publishes a modified copy of the database as the current version
    *
-   * @param rnti identifier of the UE (requires assertion prior to call)
-   * @param enb_cc_idx the eNb cell/carrier index to look for in the RNTI.
-   * @return the SCell index as described above.
+   * @param ues modified copy of the database, it is moved
    */
-  inline uint32_t _get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const;
+  void _publish(ue_map_t& ues);
 
   /**
-   * Gets the eNb Cell/Carrier index in which the UCI shall be carried. This corresponds to the serving cell with lowest
-   * index that has an UL grant available.
-   *
-   * If no grant is available in the indicated TTI, it returns the number of the eNb Cells/Carriers.
-   *
-   * @param tti The UL processing TTI
-   * @param rnti Temporal UE ID
-   * @return the eNb Cell/Carrier with lowest serving cell index that has an UL grant
+   * Current version of the database for the stack, only valid under the mutex
    */
-  uint32_t _get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const;
-
-  /**
-   * Checks if a given RNTI exists in the database
-   * @param rnti provides UE identifier
-   * @return SRSLTE_SUCCESS if the indicated RNTI exists, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_rnti(uint16_t rnti) const;
-
-  /**
-   * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx provides eNb cell/carrier
-   * @return SRSLTE_SUCCESS if the indicated RNTI exists, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Checks if an RNTI uses a given eNb cell/carrier as PCell
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx provides eNb cell/carrier index
-   * @return SRSLTE_SUCCESS if the indicated eNb cell/carrier of the RNTI is a PCell, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Checks if an RNTI is configured to use an specified UE cell/carrier as PCell or SCell
-   * @param rnti provides UE identifier
-   * @param ue_cc_idx UE cell/carrier index that is asserted
-   * @return SRSLTE_SUCCESS if the indicated cell/carrier index is valid, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const;
-
-  /**
-   * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell and it is active
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx UE cell/carrier index that is asserted
-   * @return SRSLTE_SUCCESS if the indicated eNb cell/carrier is active, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Internal eNb stack assertion
-   * @return SRSLTE_SUCCESS if available, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_stack() const;
-
-  /**
-   * Internal eNb Cell list assertion
-   * @return SRSLTE_SUCCESS if available, otherwise it returns SRSLTE_ERROR
-   */
-  inline int _assert_cell_list_cfg() const;
-
-  /**
-   * Internal eNb general configuration getter, returns default configuration if the UE does not exist in the given cell
-   *
-   * @param rnti provides UE identifier
-   * @param enb_cc_idx eNb cell index
-   * @param stashed if it is true, it returns the stashed configuration. Otherwise, it return the current configuration.
-   * @return The PHY configuration of the indicated UE for the indicated eNb carrier/call index.
-   */
-  inline srslte::phy_cfg_t _get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, bool stashed) const;
+  const ue_map_t& _get_current() const { return **ue_db.load(); }
 
 public:
+  phy_ue_db();
+  ~phy_ue_db();
+
   /**
    * Initialises the UE database with the stack and cell list
    * @param stack_ptr points to the stack (read/write)
@@ -275,121 +247,234 @@ public:
   void activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, bool activate);
 
   /**
-   * Asserts a given eNb cell is PCell of the given RNTI
-   * @param rnti identifier of the UE
-   * @param enb_cc_idx eNb cell/carrier index
-   * @return It returns true if it is the primmary cell, othwerwise it returns false
-   */
-  bool is_pcell(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Get the current down-link physical layer configuration for an RNTI and an eNb cell/carrier
-   *
-   * @param rnti identifier of the UE
-   * @param cc_idx the eNb cell/carrier identifier
-   */
-  srslte_dl_cfg_t get_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Get the current DCI configuration for PDSCH physical layer configuration for an RNTI and an eNb cell/carrier
-   *
-   * @param rnti identifier of the UE
-   * @param cc_idx the eNb cell/carrier identifier
-   */
-  srslte_dci_cfg_t get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Get the current PUCCH physical layer configuration for an RNTI and an eNb cell/carrier.
-   *
-   * @param rnti identifier of the UE
-   * @param cc_idx the eNb cell/carrier identifier
-   */
-  srslte_ul_cfg_t get_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Get the current DCI configuration for PUSCH physical layer configuration for an RNTI and an eNb cell/carrier
-   *
-   * @param rnti identifier of the UE
-   * @param cc_idx the eNb cell/carrier identifier
-   */
-  srslte_dci_cfg_t get_dci_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const;
-
-  /**
-   * Removes all the pending ACKs of all the RNTIs for a given TTI
-   *
-   * @param tti is the given TTI to clear
-   */
-  void clear_tti_pending_ack(uint32_t tti);
-
-  /**
-   * Sets the pending ACK for a given TTI in a given Component Carrier and user (RNTI is a member of the DCI)
-   *
-   * @param tti is the given TTI to fill
-   * @param cc_idx the carrier where the DCI is scheduled
-   * @param dci carries the Transport Block and required scheduling information
-   *
-   */
-  void set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srslte_dci_dl_t& dci);
-
-  /**
-   * Fills the Uplink Control Information (UCI) configuration and returns true/false idicating if UCI bits are required.
-   * @param tti the current UL reception TTI
-   * @param cc_idx the eNb cell/carrier where the UL receiption is happening
-   * @param rnti is the UE identifier
-   * @param aperiodic_cqi_request indicates if aperiodic CQI was requested
-   * @param uci_cfg brings the UCI configuration
-   * @return true if UCI decoding is required and false otherwise
-   */
-  bool fill_uci_cfg(uint32_t          tti,
-                    uint32_t          enb_cc_idx,
-                    uint16_t          rnti,
-                    bool              aperiodic_cqi_request,
-                    bool              is_pusch_available,
-                    srslte_uci_cfg_t& uci_cfg);
-
-  /**
-   * Sends the decoded Uplink Control Information by PUCCH or PUSCH to MAC
-   * @param tti the current TTI
-   * @param rnti is the UE identifier
-   * @param uci_cfg is the UCI configuration
-   * @param uci_value is the UCI received value
-   */
-  void send_uci_data(uint32_t                  tti,
-                     uint16_t                  rnti,
-                     uint32_t                  enb_cc_idx,
-                     const srslte_uci_cfg_t&   uci_cfg,
-                     const srslte_uci_value_t& uci_value);
-
-  /**
-   * Set the latest UL Transport Block resource allocation for a given RNTI, eNb cell/carrier and UL HARQ process
-   * identifier.
-   *
-   * @param rnti the UE temporal ID
-   * @param enb_cc_idx the cell/carrier origin of the transmission
-   * @param pid HARQ process identifier
-   * @param tb the Resource Allocation for the PUSCH transport block
-   */
-  void set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srslte_ra_tb_t tb);
-
-  /**
-   * Get the latest UL Transport Block resource allocation for a given RNTI, eNb cell/carrier and UL HARQ process
-   * identifier. It returns the resource allocation if the RNTI and cell/eNb are valid, otherwise it will return an
-   * default Resource allocation (all zeros by default).
-   *
-   * @param rnti the UE temporal ID
-   * @param cc_idx the cell/carrier origin of the transmission
-   * @param pid HARQ process identifier
-   * @return the Resource Allocation for the PUSCH transport block
-   */
-  srslte_ra_tb_t get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid) const;
+   * Consistent view of the UE database. The workers take one at the start of each TTI and use it for the whole TTI
+   * without locking, the configuration changes from the stack are seen from the next snapshot on. The pending
+   * acknowledgements, UL grant flags, last UL transport blocks and rank indicators it writes are not part of the
+   * snapshot: they are shared by all the snapshots of the UE.
+   */
+  class snapshot_t
+  {
+  public:
+    snapshot_t() = default;
+
+    /**
+     * Asserts a given eNb cell is PCell of the given RNTI
+     * @param rnti identifier of the UE
+     * @param enb_cc_idx eNb cell/carrier index
+     * @return It returns true if it is the primmary cell, othwerwise it returns false
+     */
+    bool is_pcell(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Get the current down-link physical layer configuration for an RNTI and an eNb cell/carrier
+     *
+     * @param rnti identifier of the UE
+     * @param cc_idx the eNb cell/carrier identifier
+     */
+    srslte_dl_cfg_t get_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Get the current DCI configuration for PDSCH physical layer configuration for an RNTI and an eNb cell/carrier
+     *
+     * @param rnti identifier of the UE
+     * @param cc_idx the eNb cell/carrier identifier
+     */
+    srslte_dci_cfg_t get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Get the current PUCCH physical layer configuration for an RNTI and an eNb cell/carrier.
+     *
+     * @param rnti identifier of the UE
+     * @param cc_idx the eNb cell/carrier identifier
+     */
+    srslte_ul_cfg_t get_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Get the current DCI configuration for PUSCH physical layer configuration for an RNTI and an eNb cell/carrier
+     *
+     * @param rnti identifier of the UE
+     * @param cc_idx the eNb cell/carrier identifier
+     */
+    srslte_dci_cfg_t get_dci_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Removes all the pending ACKs of all the RNTIs for a given TTI
+     *
+     * @param tti is the given TTI to clear
+     */
+    void clear_tti_pending_ack(uint32_t tti);
+
+    /**
+     * Sets the pending ACK for a given TTI in a given Component Carrier and user (RNTI is a member of the DCI)
+     *
+     * @param tti is the given TTI to fill
+     * @param cc_idx the carrier where the DCI is scheduled
+     * @param dci carries the Transport Block and required scheduling information
+     *
+     */
+    void set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srslte_dci_dl_t& dci);
+
+    /**
+     * Fills the Uplink Control Information (UCI) configuration and returns true/false idicating if UCI bits are
+     * required.
+     * @param tti the current UL reception TTI
+     * @param cc_idx the eNb cell/carrier where the UL receiption is happening
+     * @param rnti is the UE identifier
+     * @param aperiodic_cqi_request indicates if aperiodic CQI was requested
+     * @param uci_cfg brings the UCI configuration
+     * @return true if UCI decoding is required and false otherwise
+     */
+    bool fill_uci_cfg(uint32_t          tti,
+                      uint32_t          enb_cc_idx,
+                      uint16_t          rnti,
+                      bool              aperiodic_cqi_request,
+                      bool              is_pusch_available,
+                      srslte_uci_cfg_t& uci_cfg);
+
+    /**
+     * Sends the decoded Uplink Control Information by PUCCH or PUSCH to MAC
+     * @param tti the current TTI
+     * @param rnti is the UE identifier
+     * @param uci_cfg is the UCI configuration
+     * @param uci_value is the UCI received value
+     */
+    void send_uci_data(uint32_t                  tti,
+                       uint16_t                  rnti,
+                       uint32_t                  enb_cc_idx,
+                       const srslte_uci_cfg_t&   uci_cfg,
+                       const srslte_uci_value_t& uci_value);
+
+    /**
+     * Set the latest UL Transport Block resource allocation for a given RNTI, eNb cell/carrier and UL HARQ process
+     * identifier.
+     *
+     * @param rnti the UE temporal ID
+     * @param enb_cc_idx the cell/carrier origin of the transmission
+     * @param pid HARQ process identifier
+     * @param tb the Resource Allocation for the PUSCH transport block
+     */
+    void set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srslte_ra_tb_t tb);
+
+    /**
+     * Get the latest UL Transport Block resource allocation for a given RNTI, eNb cell/carrier and UL HARQ process
+     * identifier. It returns the resource allocation if the RNTI and cell/eNb are valid, otherwise it will return an
+     * default Resource allocation (all zeros by default).
+     *
+     * @param rnti the UE temporal ID
+     * @param cc_idx the cell/carrier origin of the transmission
+     * @param pid HARQ process identifier
+     * @return the Resource Allocation for the PUSCH transport block
+     */
+    srslte_ra_tb_t get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid) const;
+
+    /**
+     * Flags to true the UL grant available for a given TTI, RNTI and eNb cell/carrier index
+     * @param tti the current TTI
+     * @param rnti
+     * @param enb_cc_idx
+     */
+    void set_ul_grant_available(uint32_t tti, const stack_interface_phy_lte::ul_sched_list_t& ul_sched_list);
+
+  private:
+    friend class phy_ue_db;
+
+    ue_map_ptr_t               ue_db         = std::make_shared<ue_map_t>();
+    stack_interface_phy_lte*   stack         = nullptr;
+    const phy_cell_cfg_list_t* cell_cfg_list = nullptr;
+
+    const common_ue& _get_cfg(uint16_t rnti) const { return *ue_db->at(rnti).cfg; }
+    ue_tti_state_t&  _get_state(uint16_t rnti) const { return *ue_db->at(rnti).state; }
+
+    /**
+     * Gets the SCell index for a given RNTI and a eNb cell/carrier. It returns the SCell index (0 if PCell) if the
+     * cc_idx is found among the configured cells/carriers. Otherwise, it returns SRSLTE_MAX_CARRIERS.
+     *
+     * @param rnti identifier of the UE (requires assertion prior to call)
+     * @param enb_cc_idx the eNb cell/carrier index to look for in the RNTI.
+     * @return the SCell index as described above.
+     */
+    inline uint32_t _get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Gets the eNb Cell/Carrier index in which the UCI shall be carried. This corresponds to the serving cell with
+     * lowest index that has an UL grant available.
+     *
+     * If no grant is available in the indicated TTI, it returns the number of the eNb Cells/Carriers.
+     *
+     * @param tti The UL processing TTI
+     * @param rnti Temporal UE ID
+     * @return the eNb Cell/Carrier with lowest serving cell index that has an UL grant
+     */
+    uint32_t _get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const;
+
+    /**
+     * Checks if a given RNTI exists in the database
+     * @param rnti provides UE identifier
+     * @return SRSLTE_SUCCESS if the indicated RNTI exists, otherwise it returns SRSLTE_ERROR
+     */
+    inline int _assert_rnti(uint16_t rnti) const;
+
+    /**
+     * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell
+     * @param rnti provides UE identifier
+     * @param enb_cc_idx provides eNb cell/carrier
+     * @return SRSLTE_SUCCESS if the indicated RNTI exists, otherwise it returns SRSLTE_ERROR
+     */
+    inline int _assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Checks if an RNTI uses a given eNb cell/carrier as PCell
+     * @param rnti provides UE identifier
+     * @param enb_cc_idx provides eNb cell/carrier index
+     * @return SRSLTE_SUCCESS if the indicated eNb cell/carrier of the RNTI is a PCell, otherwise SRSLTE_ERROR
+     */
+    inline int _assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Checks if an RNTI is configured to use an specified UE cell/carrier as PCell or SCell
+     * @param rnti provides UE identifier
+     * @param ue_cc_idx UE cell/carrier index that is asserted
+     * @return SRSLTE_SUCCESS if the indicated cell/carrier index is valid, otherwise it returns SRSLTE_ERROR
+     */
+    inline int _assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const;
+
+    /**
+     * Checks if an RNTI is configured to use an specified eNb cell/carrier as PCell or SCell and it is active
+     * @param rnti provides UE identifier
+     * @param enb_cc_idx UE cell/carrier index that is asserted
+     * @return SRSLTE_SUCCESS if the indicated eNb cell/carrier is active, otherwise it returns SRSLTE_ERROR
+     */
+    inline int _assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const;
+
+    /**
+     * Internal eNb stack assertion
+     * @return SRSLTE_SUCCESS if available, otherwise it returns SRSLTE_ERROR
+     */
+    inline int _assert_stack() const;
+
+    /**
+     * Internal eNb Cell list assertion
+     * @return SRSLTE_SUCCESS if available, otherwise it returns SRSLTE_ERROR
+     */
+    inline int _assert_cell_list_cfg() const;
+
+    /**
+     * Internal eNb general configuration getter, returns default configuration if the UE does not exist in the given
+     * cell
+     *
+     * @param rnti provides UE identifier
+     * @param enb_cc_idx eNb cell index
+     * @param stashed if it is true, it returns the stashed configuration. Otherwise, it return the current
+     * configuration.
+     * @return The PHY configuration of the indicated UE for the indicated eNb carrier/call index.
+     */
+    inline srslte::phy_cfg_t _get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, bool stashed) const;
+  };
 
   /**
-   * Flags to true the UL grant available for a given TTI, RNTI and eNb cell/carrier index
-   * @param tti the current TTI
-   * @param rnti
-   * @param enb_cc_idx
+   * Takes a snapshot of the current version of the UE database
    */
-  void set_ul_grant_available(uint32_t tti, const stack_interface_phy_lte::ul_sched_list_t& ul_sched_list);
+  snapshot_t get_snapshot() const;
 };
 
 } // namespace srsenb
@@ -22,6 +22,7 @@
 #ifndef SRSENB_PHCH_WORKER_H
 #define SRSENB_PHCH_WORKER_H
 
+#include <chrono>
 #include <mutex>
 #include <string.h>
 
@@ -34,12 +35,22 @@ namespace srsenb {
 class sf_worker : public srslte::thread_pool::worker
 {
 public:
+  /**
+   * Subframe processing done by the worker. By default a worker decodes the UL subframe of a TTI and then encodes the
+   * DL subframe of TTI+4. In the split pipeline the UL-RX and DL-TX stages run in separate workers, the DL-TX worker
+   * only waits for the UL-RX worker of the same TTI up to the UL deadline.
+   */
+  enum class stage_t { ul_dl, ul_rx, dl_tx };
+
   sf_worker() = default;
   ~sf_worker();
-  void init(phy_common* phy, srslte::log* log_h);
+  void init(phy_common* phy, srslte::log* log_h, stage_t stage_ = stage_t::ul_dl);
 
   cf_t* get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx);
-  void  set_time(uint32_t tti_, uint32_t tx_worker_cnt_, const srslte::rf_timestamp_t& tx_time_);
+  void  set_time(uint32_t                                     tti_,
+                 uint32_t                                     tx_worker_cnt_,
+                 const srslte::rf_timestamp_t&                tx_time_,
+                 const std::chrono::steady_clock::time_point& rx_time_);
 
   int      add_rnti(uint16_t rnti, uint32_t cc_idx);
   void     rem_rnti(uint16_t rnti);
@@ -59,12 +70,15 @@ public:
 
 private:
   void work_imp() final;
+  void work_ul(stack_interface_phy_lte::ul_sched_list_t& ul_grants);
+  void wait_ul(stack_interface_phy_lte::ul_sched_list_t& ul_grants);
 
   /* Common objects */
   srslte::log* log_h     = nullptr;
   phy_common*  phy       = nullptr;
   bool         initiated = false;
   bool         running   = false;
+  stage_t      stage     = stage_t::ul_dl;
   std::mutex   work_mutex;
 
   uint32_t               tti_rx = 0, tti_tx_dl = 0, tti_tx_ul = 0;
@@ -72,6 +86,12 @@ private:
   uint32_t               tx_worker_cnt = 0;
   srslte::rf_timestamp_t tx_time       = {};
 
+  // Time at which the UL subframe was received, the UL deadline counts from it
+  std::chrono::steady_clock::time_point rx_time;
+
+  // Snapshot of the PHY common UE database, taken at the start of the TTI being processed
+  phy_ue_db::snapshot_t tti_ue_db;
+
   std::vector<std::unique_ptr<cc_worker> > cc_workers;
 
   srslte_softbuffer_tx_t temp_mbsfn_softbuffer = {};
@@ -40,6 +40,7 @@ public:
   bool init(stack_interface_phy_lte*     stack_,
             srslte::radio_interface_phy* radio_handler,
             srslte::thread_pool*         _workers_pool,
+            srslte::thread_pool*         _ul_workers_pool,
             phy_common*                  worker_com,
             prach_worker_pool*           prach_,
             srslte::log*                 log_h,
@@ -49,13 +50,14 @@ public:
 private:
   void run_thread() override;
 
-  stack_interface_phy_lte*     stack        = nullptr;
-  srslte::radio_interface_phy* radio_h      = nullptr;
-  srslte::log*                 log_h        = nullptr;
-  srslte::thread_pool*         workers_pool = nullptr;
-  prach_worker_pool*           prach        = nullptr;
-  phy_common*                  worker_com   = nullptr;
-  srslte::channel_ptr          ul_channel   = nullptr;
+  stack_interface_phy_lte*     stack           = nullptr;
+  srslte::radio_interface_phy* radio_h         = nullptr;
+  srslte::log*                 log_h           = nullptr;
+  srslte::thread_pool*         workers_pool    = nullptr;
+  srslte::thread_pool*         ul_workers_pool = nullptr; ///< UL-RX workers, only in the split pipeline
+  prach_worker_pool*           prach           = nullptr;
+  phy_common*                  worker_com      = nullptr;
+  srslte::channel_ptr          ul_channel      = nullptr;
 
   // Main system TTI counter
   uint32_t tti = 0;
@@ -52,6 +52,8 @@ public:
 
   void get_metrics(srsenb::phy_metrics_t metrics[ENB_METRICS_MAX_USERS]) override;
 
+  void get_timing_metrics(srsenb::phy_timing_metrics_t* m) override { *m = {}; }
+
   // MAC interface
   int dl_config_request(const dl_config_request_t& request) override;
   int tx_request(const tx_request_t& request) override;
@@ -70,6 +70,7 @@ typedef struct {
   std::string      type;
   uint32_t         sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
   mac_args_t       mac;
+  pdcp_args_t      pdcp;
   s1ap_args_t      s1ap;
   pcap_args_t      mac_pcap;
   pcap_args_t      s1ap_pcap;
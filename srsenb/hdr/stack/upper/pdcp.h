@@ -23,6 +23,7 @@
 #include "srslte/interfaces/enb_interfaces.h"
 #include "srslte/interfaces/ue_interfaces.h"
 #include "srslte/upper/pdcp.h"
+#include "srslte/upper/pdcp_crypto_batch.h"
 #include <map>
 
 #ifndef SRSENB_PDCP_H
@@ -35,8 +36,9 @@ class pdcp : public pdcp_interface_rlc, public pdcp_interface_gtpu, public pdcp_
 public:
   pdcp(srslte::task_sched_handle task_sched_, const char* logname);
   virtual ~pdcp() {}
-  void init(rlc_interface_pdcp* rlc_, rrc_interface_pdcp* rrc_, gtpu_interface_pdcp* gtpu_);
+  void init(const pdcp_args_t& args_, rlc_interface_pdcp* rlc_, rrc_interface_pdcp* rrc_, gtpu_interface_pdcp* gtpu_);
   void stop();
+  void tti_clock();
 
   // pdcp_interface_rlc
   void write_pdu(uint16_t rnti, uint32_t lcid, srslte::unique_byte_buffer_t sdu) override;
@@ -106,6 +108,8 @@ private:
 
   std::map<uint32_t, user_interface> users;
 
+  std::unique_ptr<srslte::pdcp_crypto_batch> crypto_batch;
+
   rlc_interface_pdcp*       rlc;
   rrc_interface_pdcp*       rrc;
   gtpu_interface_pdcp*      gtpu;
@@ -128,6 +128,9 @@ private:
 
   asn1::s1ap::s1_setup_resp_s s1setupresponse;
 
+  // Containers of the received PDUs, released in bulk before the next PDU is unpacked
+  asn1::decode_arena rx_arena;
+
   void build_tai_cgi();
   bool connect_mme();
   bool setup_s1();
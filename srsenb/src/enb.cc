@@ -204,6 +204,7 @@ bool enb::get_metrics(enb_metrics_t* m)
 {
   radio->get_metrics(&m->rf);
   phy->get_metrics(m->phy);
+  phy->get_timing_metrics(&m->phy_timing);
   stack->get_metrics(&m->stack);
   m->running = started;
   return true;
@@ -195,11 +195,19 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor")
     ("expert.nof_phy_threads", bpo::value<int>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads")
+    ("expert.nof_ul_phy_threads", bpo::value<int>(&args->phy.nof_ul_phy_threads)->default_value(0), "Number of PHY threads decoding the UL apart from the DL (0 decodes the UL in the PHY threads)")
+    ("expert.ul_deadline_us", bpo::value<uint32_t>(&args->phy.ul_deadline_us)->default_value(2000), "Time after the reception of a subframe by which its PUSCH must be decoded, otherwise they are NACKed")
+    ("expert.nof_phy_task_threads", bpo::value<int>(&args->phy.nof_phy_task_threads)->default_value(0), "Number of threads sharing the carriers and the UEs of each TTI with the PHY threads (0 disables it)")
     ("expert.max_prach_offset_us", bpo::value<float>(&args->phy.max_prach_offset_us)->default_value(30), "Maximum allowed RACH offset (in us)")
+    ("expert.prach_fast_detection", bpo::value<bool>(&args->phy.prach_fast_detection)->default_value(true), "Search the PRACH preambles only up to the maximum RACH offset, with a pruned IDFT")
+    ("expert.pucch_batch_rx", bpo::value<bool>(&args->phy.pucch_batch_rx)->default_value(true), "Decode the PUCCH of all the UEs of a TTI together, despreading each PRB once")
     ("expert.equalizer_mode", bpo::value<string>(&args->phy.equalizer_mode)->default_value("mmse"), "Equalizer mode")
     ("expert.estimator_fil_w", bpo::value<float>(&args->phy.estimator_fil_w)->default_value(0.1), "Chooses the coefficients for the 3-tap channel estimator centered filter.")
     ("expert.rrc_inactivity_timer", bpo::value<uint32_t>(&args->general.rrc_inactivity_timer)->default_value(30000), "Inactivity timer in ms.")
     ("expert.print_buffer_state", bpo::value<bool>(&args->general.print_buffer_state)->default_value(false), "Prints on the console the buffer state every 10 seconds")
+    ("expert.pdcp_crypto_batch", bpo::value<bool>(&args->stack.pdcp.crypto_batch)->default_value(false), "Cipher the DRB PDUs of all UEs in batches, flushed every TTI")
+    ("expert.pdcp_crypto_batch_size", bpo::value<uint32_t>(&args->stack.pdcp.crypto_batch_size)->default_value(64), "Maximum number of PDUs of a PDCP ciphering batch")
+    ("expert.pdcp_crypto_worker", bpo::value<bool>(&args->stack.pdcp.crypto_worker)->default_value(false), "Run the PDCP ciphering batches in a dedicated thread")
     ("expert.eea_pref_list", bpo::value<string>(&args->general.eea_pref_list)->default_value("EEA0, EEA2, EEA1"), "Ordered preference list for the selection of encryption algorithm (EEA) (default: EEA0, EEA2, EEA1).")
     ("expert.eia_pref_list", bpo::value<string>(&args->general.eia_pref_list)->default_value("EIA2, EIA1, EIA0"), "Ordered preference list for the selection of integrity algorithm (EIA) (default: EIA2, EIA1, EIA0).")
 
@@ -63,7 +63,12 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
 {
   if (file.is_open() && enb != NULL) {
     if (n_reports == 0) {
-      file << "time;nof_ue;dl_brate;ul_brate\n";
+      file << "time;nof_ue;dl_brate;ul_brate;phy_late;phy_slack_mean_us;phy_slack_min_us";
+      for (uint32_t s = 0; s < phy_timing_metrics_t::nof_stages; s++) {
+        const char* name = phy_timing_stage_to_string(s);
+        file << ";phy_" << name << "_mean_us;phy_" << name << "_max_us;phy_" << name << "_hist";
+      }
+      file << "\n";
     }
 
     // Time
@@ -88,9 +93,19 @@ void metrics_csv::set_metrics(const enb_metrics_t& metrics, const uint32_t perio
 
     // UL rate
     if (ul_rate_sum > 0) {
-      file << float_to_string(SRSLTE_MAX(0.1, (float)ul_rate_sum), 2, false);
+      file << float_to_string(SRSLTE_MAX(0.1, (float)ul_rate_sum), 2);
     } else {
-      file << float_to_string(0, 2, false);
+      file << float_to_string(0, 2);
+    }
+
+    // PHY processing time, the histogram bins of each stage are separated by '/'
+    const phy_timing_metrics_t& timing = metrics.phy_timing;
+    file << timing.n_late << ";" << lrintf(timing.slack_mean_us) << ";" << lrintf(timing.slack_min_us);
+    for (uint32_t s = 0; s < phy_timing_metrics_t::nof_stages; s++) {
+      file << ";" << lrintf(timing.mean_us[s]) << ";" << lrintf(timing.max_us[s]) << ";";
+      for (uint32_t b = 0; b < phy_timing_metrics_t::nof_bins; b++) {
+        file << (b > 0 ? "/" : "") << timing.hist[s][b];
+      }
     }
 
     file << "\n";
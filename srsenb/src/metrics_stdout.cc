@@ -83,6 +83,10 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
     printf("RF status: O=%d, U=%d, L=%d\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
 
+  if (metrics.phy_timing.n_late > 0) {
+    print_phy_timing(metrics.phy_timing);
+  }
+
   if (metrics.stack.rrc.n_ues == 0) {
     return;
   }
@@ -164,6 +168,23 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
   cout.flags(f); // For avoiding Coverity defect: Not restoring ostream format
 }
 
+void metrics_stdout::print_phy_timing(const phy_timing_metrics_t& timing)
+{
+  printf("PHY late: L=%d/%d, slack mean=%.0f min=%.0f us,",
+         timing.n_late,
+         timing.n_samples,
+         timing.slack_mean_us,
+         timing.slack_min_us);
+  for (uint32_t s = 0; s < phy_timing_metrics_t::nof_stages; s++) {
+    printf(" %s=%.0f/%.0f us (L=%d)",
+           phy_timing_stage_to_string(s),
+           timing.mean_us[s],
+           timing.max_us[s],
+           timing.n_late_stage[s]);
+  }
+  printf("\n");
+}
+
 std::string metrics_stdout::float_to_string(float f, int digits, int field_width)
 {
   std::ostringstream os;
@@ -64,6 +64,13 @@ cc_worker::~cc_worker()
   srslte_softbuffer_tx_free(&temp_mbsfn_softbuffer);
   srslte_enb_dl_free(&enb_dl);
   srslte_enb_ul_free(&enb_ul);
+  for (lane_t& lane : lanes) {
+    srslte_enb_ul_pusch_free(&lane.ul);
+    srslte_pdsch_free(&lane.pdsch);
+    if (lane.pusch_data) {
+      free(lane.pusch_data);
+    }
+  }
 
   for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
     if (signal_buffer_rx[p]) {
@@ -73,6 +80,9 @@ cc_worker::~cc_worker()
       free(signal_buffer_tx[p]);
     }
   }
+  if (pusch_data) {
+    free(pusch_data);
+  }
 
   // Delete all users
   for (auto& it : ue_db) {
@@ -108,6 +118,11 @@ void cc_worker::init(phy_common* phy_, srslte::log* log_h_, uint32_t cc_idx_)
     }
     srslte_vec_cf_zero(signal_buffer_tx[p], 2 * sf_len);
   }
+  pusch_data = srslte_vec_u8_malloc(SRSLTE_MAX_BUFFER_SIZE_BYTES);
+  if (!pusch_data) {
+    ERROR("Error allocating memory\n");
+    return;
+  }
   if (srslte_enb_dl_init(&enb_dl, signal_buffer_tx, nof_prb)) {
     ERROR("Error initiating ENB DL\n");
     return;
@@ -126,6 +141,27 @@ void cc_worker::init(phy_common* phy_, srslte::log* log_h_, uint32_t cc_idx_)
     return;
   }
 
+  // One PUSCH decoder and PDSCH encoder for each thread of the PHY task pool
+  lanes.resize(phy->get_nof_task_slots() - 1);
+  for (lane_t& lane : lanes) {
+    lane.pusch_data = srslte_vec_u8_malloc(SRSLTE_MAX_BUFFER_SIZE_BYTES);
+    if (!lane.pusch_data) {
+      ERROR("Error allocating memory\n");
+      return;
+    }
+    if (srslte_enb_ul_pusch_init(&lane.ul, nof_prb) or
+        srslte_enb_ul_pusch_set_cell(&lane.ul, cell, &phy->dmrs_pusch_cfg, nullptr)) {
+      ERROR("Error initiating ENB UL PUSCH lane\n");
+      return;
+    }
+    if (srslte_pdsch_init_enb(&lane.pdsch, nof_prb) or srslte_pdsch_set_cell(&lane.pdsch, cell)) {
+      ERROR("Error initiating ENB DL PDSCH lane\n");
+      return;
+    }
+  }
+  pdsch_cfg.resize(stack_interface_phy_lte::MAX_GRANTS);
+  pdsch_encoded.resize(stack_interface_phy_lte::MAX_GRANTS);
+
   /* Setup SI-RNTI in PHY */
   add_rnti(SRSLTE_SIRNTI);
 
@@ -149,6 +185,10 @@ void cc_worker::init(phy_common* phy_, srslte::log* log_h_, uint32_t cc_idx_)
   if (phy->params.pusch_8bit_decoder) {
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
+    for (lane_t& lane : lanes) {
+      lane.ul.pusch.llr_is_8bit        = true;
+      lane.ul.pusch.ul_sch.llr_is_8bit = true;
+    }
   }
   initiated = true;
 
@@ -173,11 +213,17 @@ cf_t* cc_worker::get_buffer_tx(uint32_t antenna_idx)
   return signal_buffer_tx[antenna_idx];
 }
 
-void cc_worker::set_tti(uint32_t tti_)
+void cc_worker::set_tti(uint32_t tti_, const std::chrono::steady_clock::time_point& rx_time_)
 {
   tti_rx    = tti_;
   tti_tx_dl = TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS);
   tti_tx_ul = TTI_RX_ACK(tti_rx);
+  rx_time   = rx_time_;
+}
+
+void cc_worker::set_ue_db(const phy_ue_db::snapshot_t& ue_db_snapshot)
+{
+  tti_ue_db = ue_db_snapshot;
 }
 
 int cc_worker::pregen_sequences(uint16_t rnti)
@@ -188,6 +234,11 @@ int cc_worker::pregen_sequences(uint16_t rnti)
   if (srslte_enb_ul_add_rnti(&enb_ul, rnti)) {
     return -1;
   }
+  for (lane_t& lane : lanes) {
+    if (srslte_pdsch_set_rnti(&lane.pdsch, rnti) or srslte_enb_ul_pusch_add_rnti(&lane.ul, rnti)) {
+      return -1;
+    }
+  }
   return SRSLTE_SUCCESS;
 }
 
@@ -213,6 +264,10 @@ void cc_worker::rem_rnti(uint16_t rnti)
   // Always try to remove from PHY-lib
   srslte_enb_dl_rem_rnti(&enb_dl, rnti);
   srslte_enb_ul_rem_rnti(&enb_ul, rnti);
+  for (lane_t& lane : lanes) {
+    srslte_pdsch_free_rnti(&lane.pdsch, rnti);
+    srslte_enb_ul_pusch_rem_rnti(&lane.ul, rnti);
+  }
 }
 
 uint32_t cc_worker::get_nof_rnti()
@@ -230,31 +285,35 @@ void cc_worker::work_ul(const srslte_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy
   // Process UL signal
   srslte_enb_ul_fft(&enb_ul);
 
+  // Decode remaining PUCCH ACKs not associated with PUSCH transmission and SR signals. They go first, they are cheap
+  // and the stack needs them for scheduling the next DL subframe
+  decode_pucch();
+
   // Decode pending UL grants for the tti they were scheduled
   decode_pusch(ul_grants.pusch, ul_grants.nof_grants);
-
-  // Decode remaining PUCCH ACKs not associated with PUSCH transmission and SR signals
-  decode_pucch();
 }
 
 void cc_worker::work_dl(const srslte_dl_sf_cfg_t&            dl_sf_cfg,
                         stack_interface_phy_lte::dl_sched_t& dl_grants,
                         stack_interface_phy_lte::ul_sched_t& ul_grants,
-                        srslte_mbsfn_cfg_t*                  mbsfn_cfg)
+                        srslte_mbsfn_cfg_t*                  mbsfn_cfg,
+                        float                                ul_wait_us)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  dl_sf = dl_sf_cfg;
+  std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+  dl_sf                                         = dl_sf_cfg;
 
   // Put base signals (references, PBCH, PCFICH and PSS/SSS) into the resource grid
   srslte_enb_dl_put_base(&enb_dl, &dl_sf);
 
   // Put DL grants to resource grid. PDSCH data will be encoded as well.
+  bool pmch_encoded = false;
   if (dl_sf_cfg.sf_type == SRSLTE_SF_NORM) {
     encode_pdcch_dl(dl_grants.pdsch, dl_grants.nof_grants);
     encode_pdsch(dl_grants.pdsch, dl_grants.nof_grants);
   } else {
     if (mbsfn_cfg->enable) {
-      encode_pmch(dl_grants.pdsch, mbsfn_cfg);
+      pmch_encoded = encode_pmch(dl_grants.pdsch, mbsfn_cfg) == SRSLTE_SUCCESS;
     }
   }
 
@@ -276,36 +335,93 @@ void cc_worker::work_dl(const srslte_dl_sf_cfg_t&            dl_sf_cfg,
       srslte_vec_sc_prod_cfc(signal_buffer_tx[i], scale, signal_buffer_tx[i], sf_len);
     }
   }
+
+  // Save metrics stats of the grants that were encoded, once the subframe is ready
+  float encode_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_start).count();
+  if (dl_sf_cfg.sf_type == SRSLTE_SF_NORM) {
+    for (uint32_t i = 0; i < dl_grants.nof_grants; i++) {
+      uint16_t rnti = dl_grants.pdsch[i].dci.rnti;
+      if (pdsch_encoded[i] && ue_db.count(rnti)) {
+        ue_db[rnti]->metrics_dl(dl_grants.pdsch[i].dci.tb[0].mcs_idx, ul_wait_us, encode_us);
+      }
+    }
+  } else if (pmch_encoded and ue_db.count(SRSLTE_MRNTI)) {
+    ue_db[SRSLTE_MRNTI]->metrics_dl(mbsfn_cfg->mbsfn_mcs, ul_wait_us, encode_us);
+  }
+}
+
+void cc_worker::set_phich_grants(stack_interface_phy_lte::ul_sched_t& ul_grants)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  srslte_ul_sf_cfg_t          ul_sf_cfg = {};
+  ul_sf_cfg.tti                         = tti_rx;
+
+  for (uint32_t i = 0; i < ul_grants.nof_grants; i++) {
+    stack_interface_phy_lte::ul_sched_grant_t& ul_grant = ul_grants.pusch[i];
+    uint16_t                                   rnti     = ul_grant.dci.rnti;
+    if (rnti == 0 or ue_db.count(rnti) == 0) {
+      continue;
+    }
+
+    srslte_ul_cfg_t      ul_cfg = tti_ue_db.get_ul_config(rnti, cc_idx);
+    srslte_pusch_grant_t grant  = {};
+    if (srslte_ra_ul_dci_to_grant(&enb_ul.cell, &ul_sf_cfg, &ul_cfg.hopping, &ul_grant.dci, &grant)) {
+      Error("Computing PUSCH dci for RNTI %x\n", rnti);
+      continue;
+    }
+    ue_db[rnti]->phich_grant.n_prb_lowest = grant.n_prb_tilde[0];
+    ue_db[rnti]->phich_grant.n_dmrs       = ul_grant.dci.n_dmrs;
+  }
+}
+
+void cc_worker::nack_late_pusch(stack_interface_phy_lte::ul_sched_t& ul_grants, uint64_t pusch_reported)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (uint32_t i = 0; i < ul_grants.nof_grants; i++) {
+    stack_interface_phy_lte::ul_sched_grant_t& ul_grant = ul_grants.pusch[i];
+    uint16_t                                   rnti     = ul_grant.dci.rnti;
+
+    // Same as a PUSCH that was not received, the UE retransmits it
+    if (ul_grant.data != nullptr and (pusch_reported & (1ULL << i)) == 0) {
+      phy->stack->crc_info(tti_rx, rnti, cc_idx, 0, false);
+      if (ue_db.count(rnti)) {
+        ue_db[rnti]->metrics_ul_late();
+      }
+      Warning("PUSCH: cc=%d, rnti=0x%x, tti_rx=%d not decoded by the UL deadline\n", cc_idx, rnti, tti_rx);
+    }
+  }
 }
 
-void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
+bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
                                   srslte_ul_cfg_t&                           ul_cfg,
-                                  srslte_pusch_res_t&                        pusch_res)
+                                  srslte_pusch_res_t&                        pusch_res,
+                                  bool&                                      uci_required,
+                                  uint32_t                                   slot)
 {
   uint16_t rnti = ul_grant.dci.rnti;
 
   // Invalid RNTI
   if (rnti == 0) {
-    return;
+    return false;
   }
 
   // RNTI does not exist
   if (ue_db.count(rnti) == 0) {
-    return;
+    return false;
   }
 
   // Get UE configuration
-  ul_cfg = phy->ue_db.get_ul_config(rnti, cc_idx);
+  ul_cfg = tti_ue_db.get_ul_config(rnti, cc_idx);
 
   // Fill UCI configuration
-  bool uci_required =
-      phy->ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, ul_grant.dci.cqi_request, true, ul_cfg.pusch.uci_cfg);
+  uci_required = tti_ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, ul_grant.dci.cqi_request, true, ul_cfg.pusch.uci_cfg);
 
   // Compute UL grant
   srslte_pusch_grant_t& grant = ul_cfg.pusch.grant;
   if (srslte_ra_ul_dci_to_grant(&enb_ul.cell, &ul_sf, &ul_cfg.hopping, &ul_grant.dci, &grant)) {
     Error("Computing PUSCH dci for RNTI %x\n", rnti);
-    return;
+    return false;
   }
 
   uint32_t ul_pid = TTI_RX(ul_sf.tti) % SRSLTE_FDD_NOF_HARQ;
@@ -313,25 +429,45 @@ void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   // Handle Format0 adaptive retx
   // Use last TBS for this TB in case of mcs>28
   if (ul_grant.dci.tb.mcs_idx > 28) {
-    grant.tb = phy->ue_db.get_last_ul_tb(rnti, cc_idx, ul_pid);
+    grant.tb = tti_ue_db.get_last_ul_tb(rnti, cc_idx, ul_pid);
     Info("RETX: mcs=%d, old_tbs=%d pid=%d\n", ul_grant.dci.tb.mcs_idx, grant.tb.tbs, ul_pid);
   }
-  phy->ue_db.set_last_ul_tb(rnti, cc_idx, ul_pid, grant.tb);
+  tti_ue_db.set_last_ul_tb(rnti, cc_idx, ul_pid, grant.tb);
 
-  // Run PUSCH decoder
+  // Run PUSCH decoder, the task pool threads use their own one
   ul_cfg.pusch.softbuffers.rx = ul_grant.softbuffer_rx;
-  pusch_res.data              = ul_grant.data;
+  pusch_res.data              = ul_grant.data ? (slot > 0 ? lanes[slot - 1].pusch_data : pusch_data) : nullptr;
   if (pusch_res.data) {
-    if (srslte_enb_ul_get_pusch(&enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
+    srslte_ul_sf_cfg_t ul_sf_cfg = ul_sf;
+    int                ret       = SRSLTE_SUCCESS;
+    if (slot > 0) {
+      ret = srslte_enb_ul_get_pusch_lane(&enb_ul, &lanes[slot - 1].ul, &ul_sf_cfg, &ul_cfg.pusch, &pusch_res);
+    } else {
+      ret = srslte_enb_ul_get_pusch(&enb_ul, &ul_sf_cfg, &ul_cfg.pusch, &pusch_res);
+    }
+    if (ret) {
       Error("Decoding PUSCH for RNTI %x\n", rnti);
-      return;
+      return false;
     }
   }
   // Save PHICH scheduling for this user. Each user can have just 1 PUSCH dci per TTI
-  ue_db[rnti]->phich_grant.n_prb_lowest = grant.n_prb_tilde[0];
-  ue_db[rnti]->phich_grant.n_dmrs       = ul_grant.dci.n_dmrs;
+  ue* user                       = ue_db.at(rnti);
+  user->phich_grant.n_prb_lowest = grant.n_prb_tilde[0];
+  user->phich_grant.n_dmrs       = ul_grant.dci.n_dmrs;
 
-  float snr_db = enb_ul.chest_res.snr_db;
+  return true;
+}
+
+void cc_worker::report_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
+                                  srslte_ul_cfg_t&                           ul_cfg,
+                                  srslte_pusch_res_t&                        pusch_res,
+                                  bool                                       uci_required,
+                                  uint32_t                                   slot)
+{
+  const srslte_chest_ul_res_t& chest_res = slot > 0 ? lanes[slot - 1].ul.chest_res : enb_ul.chest_res;
+
+  uint16_t rnti   = ul_grant.dci.rnti;
+  float    snr_db = chest_res.snr_db;
 
   // Notify MAC of RL status
   if (snr_db >= PUSCH_RL_SNR_DB_TH) {
@@ -339,85 +475,134 @@ void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     phy->stack->snr_info(ul_sf.tti, rnti, cc_idx, snr_db);
 
     // Notify MAC of Time Alignment only if it enabled and valid measurement, ignore value otherwise
-    if (ul_cfg.pusch.meas_ta_en and not std::isnan(enb_ul.chest_res.ta_us) and not std::isinf(enb_ul.chest_res.ta_us)) {
-      phy->stack->ta_info(ul_sf.tti, rnti, enb_ul.chest_res.ta_us);
+    if (ul_cfg.pusch.meas_ta_en and not std::isnan(chest_res.ta_us) and not std::isinf(chest_res.ta_us)) {
+      phy->stack->ta_info(ul_sf.tti, rnti, chest_res.ta_us);
     }
   }
 
   // Send UCI data to MAC
   if (uci_required) {
-    phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pusch.uci_cfg, pusch_res.uci);
+    tti_ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pusch.uci_cfg, pusch_res.uci);
   }
 
   // Save statistics only if data was provided
   if (ul_grant.data != nullptr) {
+    float decode_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - rx_time).count();
+
     // Save metrics stats
-    ue_db[rnti]->metrics_ul(ul_grant.dci.tb.mcs_idx, 0, enb_ul.chest_res.snr_db, pusch_res.avg_iterations_block);
+    ue_db.at(rnti)->metrics_ul(ul_grant.dci.tb.mcs_idx, 0, snr_db, pusch_res.avg_iterations_block, decode_us);
   }
 }
 
 void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
 {
-  // Iterate over all the grants, all the grants need to report MAC the CRC status
-  for (uint32_t i = 0; i < nof_pusch; i++) {
-    // Get grant itself and RNTI
-    stack_interface_phy_lte::ul_sched_grant_t& ul_grant = grants[i];
-    uint16_t                                   rnti     = ul_grant.dci.rnti;
+  // All the grants need to report MAC the CRC status. The UEs are spread over the PHY task pool if there is one
+  phy->parallel_for(nof_pusch, [this, grants](uint32_t i, uint32_t slot) { decode_pusch_grant(grants[i], i, slot); });
+}
 
-    srslte_pusch_res_t pusch_res = {};
-    srslte_ul_cfg_t    ul_cfg    = {};
+void cc_worker::decode_pusch_grant(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
+                                   uint32_t                                   grant_idx,
+                                   uint32_t                                   slot)
+{
+  // The DL-TX stage has indicated the grant as KO, there is no point in decoding it
+  if (not phy->ul_rx_is_open(tti_rx)) {
+    return;
+  }
 
-    // Decodes PUSCH for the given grant
-    decode_pusch_rnti(ul_grant, ul_cfg, pusch_res);
+  uint16_t           rnti         = ul_grant.dci.rnti;
+  srslte_pusch_res_t pusch_res    = {};
+  srslte_ul_cfg_t    ul_cfg       = {};
+  bool               uci_required = false;
 
-    // Notify MAC new received data and HARQ Indication value
-    if (ul_grant.data != nullptr) {
-      // Inform MAC about the CRC result
-      phy->stack->crc_info(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
+  // Decodes PUSCH for the given grant
+  bool decoded = decode_pusch_rnti(ul_grant, ul_cfg, pusch_res, uci_required, slot);
 
-      // Logging
-      if (log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
-        char str[512];
-        srslte_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
-        log_h->info("PUSCH: cc=%d, %s\n", cc_idx, str);
-      }
+  // The UL deadline expired while decoding, the grant was already indicated as KO
+  if (not phy->ul_rx_report_begin(tti_rx)) {
+    return;
+  }
+
+  if (decoded) {
+    report_pusch_rnti(ul_grant, ul_cfg, pusch_res, uci_required, slot);
+  }
+
+  // Notify MAC new received data and HARQ Indication value
+  if (ul_grant.data != nullptr) {
+    if (pusch_res.crc) {
+      memcpy(ul_grant.data, pusch_res.data, ul_cfg.pusch.grant.tb.tbs / 8);
+    }
+
+    // Inform MAC about the CRC result
+    phy->stack->crc_info(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
+
+    // Logging
+    if (log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
+      char str[512];
+      srslte_chest_ul_res_t* chest_res = slot > 0 ? &lanes[slot - 1].ul.chest_res : &enb_ul.chest_res;
+      srslte_pusch_rx_info(&ul_cfg.pusch, &pusch_res, chest_res, str, sizeof(str));
+      log_h->info("PUSCH: cc=%d, %s\n", cc_idx, str);
     }
   }
+
+  phy->ul_rx_report_end(tti_rx, cc_idx, 1ULL << grant_idx);
 }
 
 int cc_worker::decode_pucch()
 {
-  srslte_pucch_res_t pucch_res = {};
+  pucch_rnti.clear();
+  pucch_cfg.clear();
 
   for (auto& iter : ue_db) {
     uint16_t rnti = iter.first;
 
     // If it's a User RNTI and doesn't have PUSCH grant in this TTI
-    if (SRSLTE_RNTI_ISUSER(rnti) and phy->ue_db.is_pcell(rnti, cc_idx)) {
-      srslte_ul_cfg_t ul_cfg = phy->ue_db.get_ul_config(rnti, cc_idx);
+    if (SRSLTE_RNTI_ISUSER(rnti) and tti_ue_db.is_pcell(rnti, cc_idx)) {
+      srslte_ul_cfg_t ul_cfg = tti_ue_db.get_ul_config(rnti, cc_idx);
 
       // Check if user needs to receive PUCCH
-      if (phy->ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, false, false, ul_cfg.pucch.uci_cfg)) {
-        // Decode PUCCH
-        if (srslte_enb_ul_get_pucch(&enb_ul, &ul_sf, &ul_cfg.pucch, &pucch_res)) {
-          ERROR("Error getting PUCCH\n");
-          return SRSLTE_ERROR;
-        }
+      if (tti_ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, false, false, ul_cfg.pucch.uci_cfg)) {
+        pucch_rnti.push_back(rnti);
+        pucch_cfg.push_back(ul_cfg.pucch);
+      }
+    }
+  }
+  pucch_res.resize(pucch_cfg.size());
 
-        // Send UCI data to MAC
-        phy->ue_db.send_uci_data(tti_rx, rnti, cc_idx, ul_cfg.pucch.uci_cfg, pucch_res.uci_data);
+  // Decode PUCCH, all the UEs together if the batched receiver is enabled
+  if (phy->params.pucch_batch_rx) {
+    if (srslte_enb_ul_get_pucch_batch(&enb_ul, &ul_sf, pucch_cfg.data(), pucch_res.data(), pucch_cfg.size())) {
+      ERROR("Error getting PUCCH\n");
+      return SRSLTE_ERROR;
+    }
+  } else {
+    for (uint32_t i = 0; i < pucch_cfg.size(); i++) {
+      if (srslte_enb_ul_get_pucch(&enb_ul, &ul_sf, &pucch_cfg[i], &pucch_res[i])) {
+        ERROR("Error getting PUCCH\n");
+        return SRSLTE_ERROR;
+      }
+    }
+  }
 
-        if (pucch_res.detected and pucch_res.ta_valid) {
-          phy->stack->ta_info(tti_rx, rnti, pucch_res.ta_us);
-        }
+  for (uint32_t i = 0; i < pucch_cfg.size(); i++) {
+    uint16_t rnti = pucch_rnti[i];
 
-        // Logging
-        if (log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
-          char str[512];
-          srslte_pucch_rx_info(&ul_cfg.pucch, &pucch_res, str, sizeof(str));
-          log_h->info("PUCCH: cc=%d; %s\n", cc_idx, str);
-        }
-      }
+    // Send UCI data to MAC, unless the UL deadline has expired
+    if (not phy->ul_rx_report_begin(tti_rx)) {
+      return SRSLTE_SUCCESS;
+    }
+    tti_ue_db.send_uci_data(tti_rx, rnti, cc_idx, pucch_cfg[i].uci_cfg, pucch_res[i].uci_data);
+
+    if (pucch_res[i].detected and pucch_res[i].ta_valid) {
+      phy->stack->ta_info(tti_rx, rnti, pucch_res[i].ta_us);
+    }
+    phy->ul_rx_report_end(tti_rx, cc_idx, 0);
+
+    // Logging
+    if (log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
+      char str[512];
+      srslte_pucch_rx_info(&pucch_cfg[i], &pucch_res[i], str, sizeof(str));
+      log_h->info("PUCCH: cc=%d; %s\n", cc_idx, str);
     }
   }
   return 0;
@@ -444,11 +629,11 @@ int cc_worker::encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants
 {
   for (uint32_t i = 0; i < nof_grants; i++) {
     if (grants[i].needs_pdcch) {
-      srslte_dci_cfg_t dci_cfg = phy->ue_db.get_dci_ul_config(grants[i].dci.rnti, cc_idx);
+      srslte_dci_cfg_t dci_cfg = tti_ue_db.get_dci_ul_config(grants[i].dci.rnti, cc_idx);
 
       if (SRSLTE_RNTI_ISUSER(grants[i].dci.rnti)) {
         if (srslte_enb_dl_location_is_common_ncce(&enb_dl, grants[i].dci.location.ncce) &&
-            phy->ue_db.is_pcell(grants[i].dci.rnti, cc_idx)) {
+            tti_ue_db.is_pcell(grants[i].dci.rnti, cc_idx)) {
           // Disable extended CSI request and SRS request in common SS
           srslte_dci_cfg_set_common_ss(&dci_cfg);
         }
@@ -475,11 +660,11 @@ int cc_worker::encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants
   for (uint32_t i = 0; i < nof_grants; i++) {
     uint16_t rnti = grants[i].dci.rnti;
     if (rnti) {
-      srslte_dci_cfg_t dci_cfg = phy->ue_db.get_dci_dl_config(grants[i].dci.rnti, cc_idx);
+      srslte_dci_cfg_t dci_cfg = tti_ue_db.get_dci_dl_config(grants[i].dci.rnti, cc_idx);
 
       if (SRSLTE_RNTI_ISUSER(grants[i].dci.rnti) && grants[i].dci.format == SRSLTE_DCI_FORMAT1A) {
         if (srslte_enb_dl_location_is_common_ncce(&enb_dl, grants[i].dci.location.ncce) &&
-            phy->ue_db.is_pcell(grants[i].dci.rnti, cc_idx)) {
+            tti_ue_db.is_pcell(grants[i].dci.rnti, cc_idx)) {
           srslte_dci_cfg_set_common_ss(&dci_cfg);
         }
       }
@@ -522,11 +707,6 @@ int cc_worker::encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srs
     srslte_pdsch_tx_info(&pmch_cfg.pdsch_cfg, str, 512);
     log_h->info("PMCH: %s\n", str);
   }
-
-  // Save metrics stats
-  if (ue_db.count(SRSLTE_MRNTI)) {
-    ue_db[SRSLTE_MRNTI]->metrics_dl(mbsfn_cfg->mbsfn_mcs);
-  }
   return SRSLTE_SUCCESS;
 }
 
@@ -535,51 +715,88 @@ int cc_worker::encode_pdsch(stack_interface_phy_lte::dl_sched_grant_t* grants, u
 
   /* Scales the Resources Elements affected by the power allocation (p_b) */
   // srslte_enb_dl_prepare_power_allocation(&enb_dl);
+
+  // The PDSCH of different UEs map to different RE, so they can be encoded at the same time. Unless the power
+  // allocation rescales the reference signal symbols of the whole subframe, which is a no-op only when rho_b is 1
+  bool     parallel = true;
+  uint32_t p_b_unit = enb_dl.cell.nof_ports == 1 ? 0 : 1;
   for (uint32_t i = 0; i < nof_grants; i++) {
     uint16_t rnti = grants[i].dci.rnti;
-
     if (rnti && ue_db.count(rnti)) {
-      srslte_dl_cfg_t dl_cfg = phy->ue_db.get_dl_config(rnti, cc_idx);
+      pdsch_cfg[i] = tti_ue_db.get_dl_config(rnti, cc_idx);
+      parallel &= pdsch_cfg[i].pdsch.p_b == p_b_unit;
+    }
+  }
 
-      // Compute DL grant
-      if (srslte_ra_dl_dci_to_grant(
-              &enb_dl.cell, &dl_sf, dl_cfg.tm, dl_cfg.pdsch.use_tbs_index_alt, &grants[i].dci, &dl_cfg.pdsch.grant)) {
-        Error("Computing DL grant\n");
+  std::atomic<int> ret(SRSLTE_SUCCESS);
+  auto             encode = [this, grants, &ret](uint32_t i, uint32_t slot) {
+    uint16_t rnti    = grants[i].dci.rnti;
+    pdsch_encoded[i] = false;
+    if (rnti && ue_db.count(rnti)) {
+      if (encode_pdsch_rnti(grants[i], pdsch_cfg[i], slot) < SRSLTE_SUCCESS) {
+        ret = SRSLTE_ERROR;
+      } else {
+        pdsch_encoded[i] = true;
       }
+    } else {
+      Error("User rnti=0x%x not found in cc_worker=%d\n", rnti, cc_idx);
+    }
+  };
+  if (parallel) {
+    phy->parallel_for(nof_grants, encode);
+  } else {
+    for (uint32_t i = 0; i < nof_grants; i++) {
+      encode(i, 0);
+    }
+  }
 
-      // Set soft buffer
-      for (uint32_t j = 0; j < SRSLTE_MAX_CODEWORDS; j++) {
-        dl_cfg.pdsch.softbuffers.tx[j] = grants[i].softbuffer_tx[j];
-      }
+  // srslte_enb_dl_apply_power_allocation(&enb_dl);
 
-      // Encode PDSCH
-      if (srslte_enb_dl_put_pdsch(&enb_dl, &dl_cfg.pdsch, grants[i].data)) {
-        Error("Error putting PDSCH %d\n", i);
-        return SRSLTE_ERROR;
-      }
+  return ret;
+}
 
-      // Save pending ACK
-      if (SRSLTE_RNTI_ISUSER(rnti)) {
-        // Push whole DCI
-        phy->ue_db.set_ack_pending(tti_tx_ul, cc_idx, grants[i].dci);
-      }
+int cc_worker::encode_pdsch_rnti(stack_interface_phy_lte::dl_sched_grant_t& grant,
+                                 srslte_dl_cfg_t&                            dl_cfg,
+                                 uint32_t                                    slot)
+{
+  uint16_t rnti = grant.dci.rnti;
 
-      if (LOG_THIS(rnti) and log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
-        // Logging
-        char str[512];
-        srslte_pdsch_tx_info(&dl_cfg.pdsch, str, 512);
-        log_h->info("PDSCH: cc=%d, %s, tti_tx_dl=%d\n", cc_idx, str, tti_tx_dl);
-      }
+  // Compute DL grant
+  srslte_dl_sf_cfg_t dl_sf_cfg = dl_sf;
+  if (srslte_ra_dl_dci_to_grant(
+          &enb_dl.cell, &dl_sf_cfg, dl_cfg.tm, dl_cfg.pdsch.use_tbs_index_alt, &grant.dci, &dl_cfg.pdsch.grant)) {
+    Error("Computing DL grant\n");
+  }
 
-      // Save metrics stats
-      ue_db[rnti]->metrics_dl(grants[i].dci.tb[0].mcs_idx);
-    } else {
-      Error("User rnti=0x%x not found in cc_worker=%d\n", rnti, cc_idx);
-    }
+  // Set soft buffer
+  for (uint32_t j = 0; j < SRSLTE_MAX_CODEWORDS; j++) {
+    dl_cfg.pdsch.softbuffers.tx[j] = grant.softbuffer_tx[j];
   }
 
-  // srslte_enb_dl_apply_power_allocation(&enb_dl);
+  // Encode PDSCH, the task pool threads use their own encoder
+  int ret = SRSLTE_SUCCESS;
+  if (slot > 0) {
+    ret = srslte_enb_dl_put_pdsch_lane(&enb_dl, &lanes[slot - 1].pdsch, &dl_cfg.pdsch, grant.data);
+  } else {
+    ret = srslte_enb_dl_put_pdsch(&enb_dl, &dl_cfg.pdsch, grant.data);
+  }
+  if (ret) {
+    Error("Error putting PDSCH for rnti=0x%x\n", rnti);
+    return SRSLTE_ERROR;
+  }
+
+  // Save pending ACK
+  if (SRSLTE_RNTI_ISUSER(rnti)) {
+    // Push whole DCI
+    tti_ue_db.set_ack_pending(tti_tx_ul, cc_idx, grant.dci);
+  }
 
+  if (LOG_THIS(rnti) and log_h->get_level() >= srslte::LOG_LEVEL_INFO) {
+    // Logging
+    char str[512];
+    srslte_pdsch_tx_info(&dl_cfg.pdsch, str, 512);
+    log_h->info("PDSCH: cc=%d, %s, tti_tx_dl=%d\n", cc_idx, str, tti_tx_dl);
+  }
   return SRSLTE_SUCCESS;
 }
 
@@ -605,21 +822,29 @@ void cc_worker::ue::metrics_read(phy_metrics_t* metrics_)
   bzero(&metrics, sizeof(phy_metrics_t));
 }
 
-void cc_worker::ue::metrics_dl(uint32_t mcs)
+void cc_worker::ue::metrics_dl(uint32_t mcs, float ul_wait_us, float encode_us)
 {
-  metrics.dl.mcs = SRSLTE_VEC_CMA(mcs, metrics.dl.mcs, metrics.dl.n_samples);
+  metrics.dl.mcs        = SRSLTE_VEC_CMA(mcs, metrics.dl.mcs, metrics.dl.n_samples);
+  metrics.dl.ul_wait_us = SRSLTE_VEC_CMA(ul_wait_us, metrics.dl.ul_wait_us, metrics.dl.n_samples);
+  metrics.dl.encode_us  = SRSLTE_VEC_CMA(encode_us, metrics.dl.encode_us, metrics.dl.n_samples);
   metrics.dl.n_samples++;
 }
 
-void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters)
+void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters, float decode_us)
 {
   metrics.ul.mcs         = SRSLTE_VEC_CMA((float)mcs, metrics.ul.mcs, metrics.ul.n_samples);
   metrics.ul.sinr        = SRSLTE_VEC_CMA((float)sinr, metrics.ul.sinr, metrics.ul.n_samples);
   metrics.ul.rssi        = SRSLTE_VEC_CMA((float)rssi, metrics.ul.rssi, metrics.ul.n_samples);
   metrics.ul.turbo_iters = SRSLTE_VEC_CMA((float)turbo_iters, metrics.ul.turbo_iters, metrics.ul.n_samples);
+  metrics.ul.decode_us   = SRSLTE_VEC_CMA(decode_us, metrics.ul.decode_us, metrics.ul.n_samples);
   metrics.ul.n_samples++;
 }
 
+void cc_worker::ue::metrics_ul_late()
+{
+  metrics.ul.n_late++;
+}
+
 int cc_worker::read_ce_abs(float* ce_abs)
 {
   int sz = srslte_symbol_sz(phy->get_nof_prb(cc_idx));
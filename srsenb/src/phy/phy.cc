@@ -19,6 +19,7 @@
  *
  */
 
+#include <chrono>
 #include <pthread.h>
 #include <sstream>
 #include <string.h>
@@ -50,7 +51,13 @@ using namespace asn1::rrc;
 namespace srsenb {
 
 phy::phy(srslte::logger* logger_) :
-  logger(logger_), workers_pool(MAX_WORKERS), workers(MAX_WORKERS), workers_common(), nof_workers(0)
+  logger(logger_),
+  workers_pool(MAX_WORKERS),
+  workers(MAX_WORKERS),
+  ul_workers_pool(MAX_WORKERS),
+  ul_workers(MAX_WORKERS),
+  workers_common(),
+  nof_workers(0)
 {
 }
 
@@ -107,6 +114,18 @@ int phy::init(const phy_args_t&            args,
     log_vec.push_back(nullptr);
   }
 
+  // Logs of the UL-RX workers, they go after the PHY lib log
+  nof_ul_workers = (uint32_t)SRSLTE_MIN(SRSLTE_MAX(args.nof_ul_phy_threads, 0), MAX_WORKERS);
+  for (uint32_t i = 0; i < nof_ul_workers; i++) {
+    auto mylog   = std::unique_ptr<srslte::log_filter>(new srslte::log_filter);
+    char tmp[16] = {};
+    sprintf(tmp, "PHY_UL%d", i);
+    mylog->init(tmp, logger, true);
+    mylog->set_level(args.log.phy_level);
+    mylog->set_hex_limit(args.log.phy_hex_limit);
+    log_vec.push_back(std::move(mylog));
+  }
+
   radio       = radio_;
   nof_workers = args.nof_phy_threads;
 
@@ -116,21 +135,55 @@ int phy::init(const phy_args_t&            args,
 
   parse_common_config(cfg);
 
-  // Add workers to workers pool and start threads
+  // The workers allocate a PUSCH decoder and a PDSCH encoder for each thread of the task pool
+  if (args.nof_phy_task_threads > 0) {
+    task_pool = std::unique_ptr<srslte::task_thread_pool>(new srslte::task_thread_pool(args.nof_phy_task_threads));
+    task_pool->start(WORKERS_THREAD_PRIO);
+    workers_common.task_pool = task_pool.get();
+  }
+
+  // Creating the workers and the PRACH plans all the DFTs, which is most of the startup time without FFTW wisdom
+  auto     plan_start       = std::chrono::steady_clock::now();
+  uint32_t prev_wisdom_hits = 0, prev_wisdom_misses = 0;
+  srslte_dft_wisdom_get_stats(&prev_wisdom_hits, &prev_wisdom_misses);
+
+  // Add workers to workers pool and start threads. With UL-RX workers the UL is decoded apart from the DL
+  sf_worker::stage_t stage = nof_ul_workers > 0 ? sf_worker::stage_t::dl_tx : sf_worker::stage_t::ul_dl;
   for (uint32_t i = 0; i < nof_workers; i++) {
-    workers[i].init(&workers_common, log_vec.at(i).get());
+    workers[i].init(&workers_common, log_vec.at(i).get(), stage);
     workers_pool.init_worker(i, &workers[i], WORKERS_THREAD_PRIO);
   }
+  for (uint32_t i = 0; i < nof_ul_workers; i++) {
+    ul_workers[i].init(&workers_common, log_vec.at(nof_workers + 1 + i).get(), sf_worker::stage_t::ul_rx);
+    ul_workers_pool.init_worker(i, &ul_workers[i], WORKERS_THREAD_PRIO);
+  }
 
   // For each carrier, initialise PRACH worker
+  prach_cfg.enable_fast_detection = args.prach_fast_detection;
   for (uint32_t cc = 0; cc < cfg.phy_cell_cfg.size(); cc++) {
     prach_cfg.root_seq_idx = cfg.phy_cell_cfg[cc].root_seq_idx;
     prach.init(cc, cfg.phy_cell_cfg[cc].cell, prach_cfg, stack_, log_vec.at(0).get(), PRACH_WORKER_THREAD_PRIO);
   }
   prach.set_max_prach_offset_us(args.max_prach_offset_us);
 
+  uint32_t wisdom_hits = 0, wisdom_misses = 0;
+  srslte_dft_wisdom_get_stats(&wisdom_hits, &wisdom_misses);
+  auto plan_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - plan_start).count();
+  log_h->info("Initialised workers and PRACH in %ld ms, %d DFT plans from FFTW wisdom and %d measured\n",
+              (long)plan_ms,
+              wisdom_hits - prev_wisdom_hits,
+              wisdom_misses - prev_wisdom_misses);
+
   // Warning this must be initialized after all workers have been added to the pool
-  tx_rx.init(stack_, radio, &workers_pool, &workers_common, &prach, log_vec.at(0).get(), SF_RECV_THREAD_PRIO);
+  tx_rx.init(stack_,
+             radio,
+             &workers_pool,
+             nof_ul_workers > 0 ? &ul_workers_pool : nullptr,
+             &workers_common,
+             &prach,
+             log_vec.at(0).get(),
+             SF_RECV_THREAD_PRIO);
 
   initialized = true;
 
@@ -143,6 +196,10 @@ void phy::stop()
     tx_rx.stop();
     workers_common.stop();
     workers_pool.stop();
+    ul_workers_pool.stop();
+    if (task_pool) {
+      task_pool->stop();
+    }
     prach.stop();
 
     initialized = false;
@@ -161,6 +218,13 @@ void phy::rem_rnti(uint16_t rnti)
       w->release();
     }
   }
+  for (uint32_t i = 0; i < nof_ul_workers; i++) {
+    sf_worker* w = (sf_worker*)ul_workers_pool.wait_worker_id(i);
+    if (w) {
+      w->rem_rnti(rnti);
+      w->release();
+    }
+  }
   if (SRSLTE_RNTI_ISUSER(rnti)) {
     workers_common.ue_db.rem_rnti(rnti);
     workers_common.clear_grants(rnti);
@@ -174,6 +238,11 @@ int phy::pregen_sequences(uint16_t rnti)
       return SRSLTE_ERROR;
     }
   }
+  for (uint32_t i = 0; i < nof_ul_workers; i++) {
+    if (ul_workers[i].pregen_sequences(rnti) != SRSLTE_SUCCESS) {
+      return SRSLTE_ERROR;
+    }
+  }
   return SRSLTE_SUCCESS;
 }
 
@@ -196,30 +265,53 @@ void phy::get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS])
 
   uint32_t nof_users = workers[0].get_nof_rnti();
   bzero(metrics, sizeof(phy_metrics_t) * ENB_METRICS_MAX_USERS);
-  for (uint32_t i = 0; i < nof_workers; i++) {
-    workers[i].get_metrics(metrics_tmp);
+  for (uint32_t i = 0; i < nof_workers + nof_ul_workers; i++) {
+    // Each worker only accumulates its own stats. The UL-RX workers have no DL stats and the DL-TX workers only have
+    // the late PUSCH of the UL stats, skip the empty ones
+    bzero(metrics_tmp, sizeof(metrics_tmp));
+    if (i < nof_workers) {
+      workers[i].get_metrics(metrics_tmp);
+    } else {
+      ul_workers[i - nof_workers].get_metrics(metrics_tmp);
+    }
     for (uint32_t j = 0; j < nof_users; j++) {
-      metrics[j].dl.n_samples += metrics_tmp[j].dl.n_samples;
-      metrics[j].dl.mcs += metrics_tmp[j].dl.n_samples * metrics_tmp[j].dl.mcs;
-
-      metrics[j].ul.n_samples += metrics_tmp[j].ul.n_samples;
-      metrics[j].ul.mcs += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.mcs;
-      metrics[j].ul.n += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.n;
-      metrics[j].ul.rssi += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.rssi;
-      metrics[j].ul.sinr += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.sinr;
-      metrics[j].ul.turbo_iters += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_iters;
+      if (metrics_tmp[j].dl.n_samples > 0) {
+        metrics[j].dl.n_samples += metrics_tmp[j].dl.n_samples;
+        metrics[j].dl.mcs += metrics_tmp[j].dl.n_samples * metrics_tmp[j].dl.mcs;
+        metrics[j].dl.ul_wait_us += metrics_tmp[j].dl.n_samples * metrics_tmp[j].dl.ul_wait_us;
+        metrics[j].dl.encode_us += metrics_tmp[j].dl.n_samples * metrics_tmp[j].dl.encode_us;
+      }
+
+      if (metrics_tmp[j].ul.n_samples > 0) {
+        metrics[j].ul.n_samples += metrics_tmp[j].ul.n_samples;
+        metrics[j].ul.mcs += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.mcs;
+        metrics[j].ul.n += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.n;
+        metrics[j].ul.rssi += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.rssi;
+        metrics[j].ul.sinr += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.sinr;
+        metrics[j].ul.turbo_iters += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_iters;
+        metrics[j].ul.decode_us += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.decode_us;
+      }
+      metrics[j].ul.n_late += metrics_tmp[j].ul.n_late;
     }
   }
   for (uint32_t j = 0; j < nof_users; j++) {
     metrics[j].dl.mcs /= metrics[j].dl.n_samples;
+    metrics[j].dl.ul_wait_us /= metrics[j].dl.n_samples;
+    metrics[j].dl.encode_us /= metrics[j].dl.n_samples;
     metrics[j].ul.mcs /= metrics[j].ul.n_samples;
     metrics[j].ul.n /= metrics[j].ul.n_samples;
     metrics[j].ul.rssi /= metrics[j].ul.n_samples;
     metrics[j].ul.sinr /= metrics[j].ul.n_samples;
     metrics[j].ul.turbo_iters /= metrics[j].ul.n_samples;
+    metrics[j].ul.decode_us /= metrics[j].ul.n_samples;
   }
 }
 
+void phy::get_timing_metrics(phy_timing_metrics_t* m)
+{
+  workers_common.get_timing_metrics(m);
+}
+
 void phy::cmd_cell_gain(uint32_t cell_id, float gain_db)
 {
   workers_common.set_cell_gain(cell_id, gain_db);
@@ -242,6 +334,9 @@ void phy::set_config(uint16_t rnti, const phy_rrc_cfg_list_t& phy_cfg_list)
       for (uint32_t w = 0; w < nof_workers; w++) {
         workers[w].add_rnti(rnti, config.enb_cc_idx);
       }
+      for (uint32_t w = 0; w < nof_ul_workers; w++) {
+        ul_workers[w].add_rnti(rnti, config.enb_cc_idx);
+      }
     }
   }
 }
@@ -284,7 +379,12 @@ void phy::configure_mbsfn(sib_type2_s* sib2, sib_type13_r9_s* sib13, const mcch_
 // Start GUI
 void phy::start_plot()
 {
-  workers[0].start_plot();
+  // The plots show the UL channel
+  if (nof_ul_workers > 0) {
+    ul_workers[0].start_plot();
+  } else {
+    workers[0].start_plot();
+  }
 }
 
 } // namespace srsenb
@@ -77,6 +77,9 @@ bool phy_common::init(const phy_cell_cfg_list_t&   cell_list_,
   for (auto& q : ul_grants) {
     q.resize(cell_list.size());
   }
+  for (auto& state : ul_rx_states) {
+    state.pusch_reported.resize(cell_list.size());
+  }
 
   // Set UE PHY data-base stack and configuration
   ue_db.init(stack, params, cell_list);
@@ -118,6 +121,93 @@ void phy_common::set_ul_grants(uint32_t tti, const stack_interface_phy_lte::ul_s
   ul_grants[tti] = ul_grant_list;
 }
 
+void phy_common::ul_rx_start(uint32_t tti)
+{
+  ul_rx_state_t&              state = ul_rx_states[tti];
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.tti      = tti;
+  state.open     = true;
+  state.finished = false;
+  std::fill(state.pusch_reported.begin(), state.pusch_reported.end(), 0);
+}
+
+void phy_common::ul_rx_skip(uint32_t tti)
+{
+  ul_rx_state_t&              state = ul_rx_states[tti];
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.tti      = tti;
+  state.open     = false;
+  state.finished = true;
+  std::fill(state.pusch_reported.begin(), state.pusch_reported.end(), 0);
+}
+
+bool phy_common::ul_rx_is_open(uint32_t tti)
+{
+  ul_rx_state_t&              state = ul_rx_states[tti];
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.tti == tti and state.open;
+}
+
+bool phy_common::ul_rx_report_begin(uint32_t tti)
+{
+  ul_rx_state_t& state = ul_rx_states[tti];
+  state.mutex.lock();
+  if (state.tti == tti and state.open) {
+    // Keep the lock, the TTI can not be closed until ul_rx_report_end()
+    return true;
+  }
+  state.mutex.unlock();
+  return false;
+}
+
+void phy_common::ul_rx_report_end(uint32_t tti, uint32_t cc_idx, uint64_t pusch_mask)
+{
+  ul_rx_state_t& state = ul_rx_states[tti];
+  state.pusch_reported[cc_idx] |= pusch_mask;
+  state.mutex.unlock();
+}
+
+void phy_common::ul_rx_end(uint32_t tti)
+{
+  ul_rx_state_t&              state = ul_rx_states[tti];
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (state.tti == tti) {
+    state.finished = true;
+    state.cvar.notify_all();
+  }
+}
+
+bool phy_common::ul_rx_wait(uint32_t                                     tti,
+                            const std::chrono::steady_clock::time_point& deadline,
+                            std::vector<uint64_t>&                       pusch_reported)
+{
+  ul_rx_state_t&               state = ul_rx_states[tti];
+  std::unique_lock<std::mutex> lock(state.mutex);
+  bool                         in_time = state.cvar.wait_until(lock, deadline, [&state]() { return state.finished; });
+
+  // A skipped TTI was never open, none of its PUSCH was decoded
+  in_time        = in_time and state.open;
+  state.open     = false;
+  pusch_reported = state.pusch_reported;
+  return in_time;
+}
+
+void phy_common::parallel_for(uint32_t nof_tasks, const std::function<void(uint32_t, uint32_t)>& task)
+{
+  if (task_pool == nullptr) {
+    for (uint32_t i = 0; i < nof_tasks; i++) {
+      task(i, 0);
+    }
+    return;
+  }
+  task_pool->parallel_for(nof_tasks, task);
+}
+
+uint32_t phy_common::get_nof_task_slots() const
+{
+  return task_pool == nullptr ? 1 : task_pool->nof_workers() + 1;
+}
+
 /* The transmission of UL subframes must be in sequence. The correct sequence is guaranteed by a chain of N semaphores,
  * one per TTI%nof_workers. Each threads waits for the semaphore for the current thread and after transmission allows
  * next TTI to be transmitted
@@ -125,7 +215,10 @@ void phy_common::set_ul_grants(uint32_t tti, const stack_interface_phy_lte::ul_s
  * Each worker uses this function to indicate that all processing is done and data is ready for transmission or
  * there is no transmission at all (tx_enable). In that case, the end of burst message will be sent to the radio
  */
-void phy_common::worker_end(void* tx_sem_id, srslte::rf_buffer_t& buffer, srslte::rf_timestamp_t& tx_time)
+void phy_common::worker_end(void*                   tx_sem_id,
+                            srslte::rf_buffer_t&    buffer,
+                            srslte::rf_timestamp_t& tx_time,
+                            tti_timing_t*           timing)
 {
   // Wait for the green light to transmit in the current TTI
   semaphore.wait(tx_sem_id);
@@ -135,6 +228,10 @@ void phy_common::worker_end(void* tx_sem_id, srslte::rf_buffer_t& buffer, srslte
     dl_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), buffer.get_nof_samples(), tx_time.get(0));
   }
 
+  if (timing != nullptr) {
+    (*timing)[phy_timing_metrics_t::nof_stages] = std::chrono::steady_clock::now();
+  }
+
   // Always transmit on single radio
   radio->tx(buffer, tx_time);
 
@@ -142,6 +239,49 @@ void phy_common::worker_end(void* tx_sem_id, srslte::rf_buffer_t& buffer, srslte
   semaphore.release();
 }
 
+float phy_common::timing_report(const tti_timing_t& timing, uint32_t* late_stage)
+{
+  float    stage_us[phy_timing_metrics_t::nof_stages];
+  uint32_t longest = 0;
+  for (uint32_t s = 0; s < phy_timing_metrics_t::nof_stages; s++) {
+    stage_us[s] = std::chrono::duration_cast<std::chrono::microseconds>(timing[s + 1] - timing[s]).count();
+    if (stage_us[s] > stage_us[longest]) {
+      longest = s;
+    }
+  }
+  float slack_us = (float)tx_deadline_us -
+                   std::chrono::duration_cast<std::chrono::microseconds>(timing.back() - timing.front()).count();
+
+  std::lock_guard<std::mutex> lock(timing_mutex);
+  phy_timing_metrics_t&       m = timing_metrics;
+  for (uint32_t s = 0; s < phy_timing_metrics_t::nof_stages; s++) {
+    uint32_t bin = 0;
+    while (bin < phy_timing_metrics_t::nof_bins - 1 && stage_us[s] >= (phy_timing_metrics_t::bin0_limit_us << bin)) {
+      bin++;
+    }
+    m.hist[s][bin]++;
+    m.mean_us[s] = SRSLTE_VEC_CMA(stage_us[s], m.mean_us[s], m.n_samples);
+    m.max_us[s]  = SRSLTE_MAX(m.max_us[s], stage_us[s]);
+  }
+  m.slack_mean_us = SRSLTE_VEC_CMA(slack_us, m.slack_mean_us, m.n_samples);
+  m.slack_min_us  = m.n_samples == 0 ? slack_us : SRSLTE_MIN(m.slack_min_us, slack_us);
+  if (slack_us < 0) {
+    m.n_late++;
+    m.n_late_stage[longest]++;
+    *late_stage = longest;
+  }
+  m.n_samples++;
+
+  return slack_us;
+}
+
+void phy_common::get_timing_metrics(phy_timing_metrics_t* m)
+{
+  std::lock_guard<std::mutex> lock(timing_mutex);
+  *m             = timing_metrics;
+  timing_metrics = {};
+}
+
 void phy_common::set_mch_period_stop(uint32_t stop)
 {
   pthread_mutex_lock(&mtch_mutex);
@@ -20,9 +20,22 @@
  */
 
 #include "srsenb/hdr/phy/phy_ue_db.h"
+#include <thread>
 
 using namespace srsenb;
 
+phy_ue_db::phy_ue_db() : ue_db(new ue_map_ptr_t(std::make_shared<ue_map_t>()))
+{
+  for (std::atomic<uint32_t>& nof_readers : ue_db_nof_readers) {
+    nof_readers = 0;
+  }
+}
+
+phy_ue_db::~phy_ue_db()
+{
+  delete ue_db.load();
+}
+
 void phy_ue_db::init(stack_interface_phy_lte*   stack_ptr,
                      const phy_args_t&          phy_args_,
                      const phy_cell_cfg_list_t& cell_cfg_list_)
@@ -32,20 +45,15 @@ void phy_ue_db::init(stack_interface_phy_lte*   stack_ptr,
   cell_cfg_list = &cell_cfg_list_;
 }
 
-inline void phy_ue_db::_add_rnti(uint16_t rnti)
+inline void phy_ue_db::_add_rnti(ue_map_t& ues, uint16_t rnti) const
 {
-  // Private function not mutexed
-
   // Assert RNTI does NOT exist
-  if (ue_db.count(rnti)) {
+  if (ues.count(rnti)) {
     return;
   }
 
-  // Create new UE by accesing it
-  ue_db[rnti].cell_info[0] = {};
-
-  // Get UE
-  common_ue& ue = ue_db[rnti];
+  // Create new UE
+  common_ue ue = {};
 
   // Load default values to PCell
   ue.cell_info[0].phy_cfg.set_defaults();
@@ -56,20 +64,22 @@ inline void phy_ue_db::_add_rnti(uint16_t rnti)
   // Configure as PCell
   ue.cell_info[0].state = cell_state_primary;
 
+  // The state starts from scratch, even if the RNTI was removed while a worker was still using it
+  ue_entry_t& entry = ues[rnti];
+  entry.cfg         = std::make_shared<common_ue>(ue);
+  entry.state       = std::make_shared<ue_tti_state_t>();
+
   // Iterate all pending ACK
   for (uint32_t tti = 0; tti < TTIMOD_SZ; tti++) {
-    _clear_tti_pending_rnti(tti, rnti);
+    _clear_tti_pending_rnti(tti, *entry.cfg, *entry.state);
   }
 }
 
-inline void phy_ue_db::_clear_tti_pending_rnti(uint32_t tti, uint16_t rnti)
+inline void phy_ue_db::_clear_tti_pending_rnti(uint32_t tti, const common_ue& ue, ue_tti_state_t& state)
 {
-  // Private function not mutexed, no need to assert RNTI or TTI
-
-  // Get UE
-  common_ue& ue = ue_db[rnti];
-
-  srslte_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
+  // No need to assert TTI
+  std::lock_guard<std::mutex> lock(state.tti_mutex[tti]);
+  srslte_pdsch_ack_t&         pdsch_ack = state.pdsch_ack[tti];
 
   // Reset ACK information
   pdsch_ack = {};
@@ -107,10 +117,41 @@ inline void phy_ue_db::_set_common_config_rnti(uint16_t rnti, srslte::phy_cfg_t&
   phy_cfg.ul_cfg.pucch.meas_ta_en                    = phy_args->pucch_meas_ta;
 }
 
-inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const
+void phy_ue_db::_publish(ue_map_t& ues)
+{
+  const ue_map_ptr_t* old_ue_db = ue_db.exchange(new ue_map_ptr_t(std::make_shared<ue_map_t>(std::move(ues))));
+
+  // Wait for the workers copying the old pointer. A worker which read the epoch before the first flip but counted
+  // itself after it is in the readers of the second flip
+  for (uint32_t i = 0; i < 2; i++) {
+    uint32_t epoch = ue_db_epoch.fetch_add(1);
+    while (ue_db_nof_readers[epoch % 2] != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  // The snapshots hold their own reference to the version
+  delete old_ue_db;
+}
+
+phy_ue_db::snapshot_t phy_ue_db::get_snapshot() const
+{
+  snapshot_t snapshot;
+
+  uint32_t epoch = ue_db_epoch % 2;
+  ue_db_nof_readers[epoch]++;
+  snapshot.ue_db = *ue_db.load();
+  ue_db_nof_readers[epoch]--;
+
+  snapshot.stack         = stack;
+  snapshot.cell_cfg_list = cell_cfg_list;
+  return snapshot;
+}
+
+inline uint32_t phy_ue_db::snapshot_t::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) const
 {
   uint32_t         ue_cc_idx = 0;
-  const common_ue& ue        = ue_db.at(rnti);
+  const common_ue& ue        = _get_cfg(rnti);
 
   for (; ue_cc_idx < SRSLTE_MAX_CARRIERS; ue_cc_idx++) {
     const cell_info_t& scell_info = ue.cell_info[ue_cc_idx];
@@ -123,21 +164,25 @@ inline uint32_t phy_ue_db::_get_ue_cc_idx(uint16_t rnti, uint32_t enb_cc_idx) co
   return ue_cc_idx;
 }
 
-uint32_t phy_ue_db::_get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const
+uint32_t phy_ue_db::snapshot_t::_get_uci_enb_cc_idx(uint32_t tti, uint16_t rnti) const
 {
+  const common_ue&      ue    = _get_cfg(rnti);
+  const ue_tti_state_t& state = _get_state(rnti);
+
   // Find the lowest index available PUSCH grant
-  for (const cell_info_t& cell_info : ue_db.at(rnti).cell_info) {
-    if (cell_info.is_grant_available[tti]) {
-      return cell_info.enb_cc_idx;
+  std::lock_guard<std::mutex> lock(state.tti_mutex[tti]);
+  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSLTE_MAX_CARRIERS; ue_cc_idx++) {
+    if (state.cell[ue_cc_idx].is_grant_available[tti]) {
+      return ue.cell_info[ue_cc_idx].enb_cc_idx;
     }
   }
 
   return (uint32_t)cell_cfg_list->size();
 }
 
-inline int phy_ue_db::_assert_rnti(uint16_t rnti) const
+inline int phy_ue_db::snapshot_t::_assert_rnti(uint16_t rnti) const
 {
-  if (not ue_db.count(rnti)) {
+  if (not ue_db->count(rnti)) {
     ERROR("Trying to access RNTI 0x%X, it does not exist.\n", rnti);
     return SRSLTE_ERROR;
   }
@@ -145,7 +190,7 @@ inline int phy_ue_db::_assert_rnti(uint16_t rnti) const
   return SRSLTE_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
+inline int phy_ue_db::snapshot_t::_assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
 {
   // Assert RNTI exist
   if (_assert_rnti(rnti) != SRSLTE_SUCCESS) {
@@ -160,14 +205,14 @@ inline int phy_ue_db::_assert_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
   return SRSLTE_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
+inline int phy_ue_db::snapshot_t::_assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
 {
   if (_assert_enb_cc(rnti, enb_cc_idx) != SRSLTE_SUCCESS) {
     return SRSLTE_ERROR;
   }
 
   // Check cell is PCell
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
+  const cell_info_t& cell_info = _get_cfg(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
   if (cell_info.state != cell_state_primary) {
     return SRSLTE_ERROR;
   }
@@ -175,7 +220,7 @@ inline int phy_ue_db::_assert_enb_pcell(uint16_t rnti, uint32_t enb_cc_idx) cons
   return SRSLTE_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
+inline int phy_ue_db::snapshot_t::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
 {
   if (_assert_rnti(rnti) != SRSLTE_SUCCESS) {
     return SRSLTE_ERROR;
@@ -186,7 +231,7 @@ inline int phy_ue_db::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
     return SRSLTE_ERROR;
   }
 
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info.at(ue_cc_idx);
+  const cell_info_t& cell_info = _get_cfg(rnti).cell_info.at(ue_cc_idx);
   if (cell_info.state == cell_state_none) {
     return SRSLTE_ERROR;
   }
@@ -194,14 +239,14 @@ inline int phy_ue_db::_assert_ue_cc(uint16_t rnti, uint32_t ue_cc_idx) const
   return SRSLTE_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
+inline int phy_ue_db::snapshot_t::_assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx) const
 {
   if (_assert_enb_cc(rnti, enb_cc_idx) != SRSLTE_SUCCESS) {
     return SRSLTE_ERROR;
   }
 
   // Check SCell is active, ignore PCell state
-  const cell_info_t& cell_info = ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
+  const cell_info_t& cell_info = _get_cfg(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)];
   if (cell_info.state != cell_state_primary and cell_info.state != cell_state_secondary_active) {
     return SRSLTE_ERROR;
   }
@@ -209,7 +254,7 @@ inline int phy_ue_db::_assert_active_enb_cc(uint16_t rnti, uint32_t enb_cc_idx)
   return SRSLTE_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_stack() const
+inline int phy_ue_db::snapshot_t::_assert_stack() const
 {
   if (stack == nullptr) {
     return SRSLTE_ERROR;
@@ -218,7 +263,7 @@ inline int phy_ue_db::_assert_stack() const
   return SRSLTE_SUCCESS;
 }
 
-inline int phy_ue_db::_assert_cell_list_cfg() const
+inline int phy_ue_db::snapshot_t::_assert_cell_list_cfg() const
 {
   if (cell_cfg_list == nullptr) {
     return SRSLTE_ERROR;
@@ -227,7 +272,8 @@ inline int phy_ue_db::_assert_cell_list_cfg() const
   return SRSLTE_SUCCESS;
 }
 
-inline srslte::phy_cfg_t phy_ue_db::_get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, bool stashed) const
+inline srslte::phy_cfg_t
+phy_ue_db::snapshot_t::_get_rnti_config(uint16_t rnti, uint32_t enb_cc_idx, bool stashed) const
 {
   srslte::phy_cfg_t default_cfg = {};
   default_cfg.set_defaults();
@@ -250,20 +296,18 @@ inline srslte::phy_cfg_t phy_ue_db::_get_rnti_config(uint16_t rnti, uint32_t enb
 
   // Return Stashed configuration if PCell and stashed is true
   if (ue_cc_idx == 0 and stashed) {
-    return ue_db.at(rnti).pcell_cfg_stash;
+    return _get_cfg(rnti).pcell_cfg_stash;
   }
 
   // Otherwise return current configuration
-  return ue_db.at(rnti).cell_info.at(ue_cc_idx).phy_cfg;
+  return _get_cfg(rnti).cell_info.at(ue_cc_idx).phy_cfg;
 }
 
-void phy_ue_db::clear_tti_pending_ack(uint32_t tti)
+void phy_ue_db::snapshot_t::clear_tti_pending_ack(uint32_t tti)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Iterate all UEs
-  for (auto& iter : ue_db) {
-    _clear_tti_pending_rnti(TTIMOD(tti), iter.first);
+  for (auto& iter : *ue_db) {
+    _clear_tti_pending_rnti(TTIMOD(tti), *iter.second.cfg, *iter.second.state);
   }
 }
 
@@ -271,13 +315,16 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
 {
   std::lock_guard<std::mutex> lock(mutex);
 
+  // Modify a copy of the database, the workers keep reading the current one
+  ue_map_t ues = _get_current();
+
   // Create new user if did not exist
-  if (ue_db.count(rnti) == 0) {
-    _add_rnti(rnti);
+  if (ues.count(rnti) == 0) {
+    _add_rnti(ues, rnti);
   }
 
-  // Get UE by reference
-  common_ue& ue = ue_db[rnti];
+  // Get a copy of the UE configuration
+  common_ue ue = *ues.at(rnti).cfg;
 
   // Number of configured secondary serving cells
   uint32_t nof_configured_scell = 0;
@@ -339,14 +386,20 @@ void phy_ue_db::addmod_rnti(uint16_t rnti, const phy_interface_rrc_lte::phy_rrc_
 
   // Load new UL configuration
   ue.cell_info[0].phy_cfg.ul_cfg = ue.pcell_cfg_stash.ul_cfg;
+
+  ues.at(rnti).cfg = std::make_shared<common_ue>(ue);
+  _publish(ues);
 }
 
 void phy_ue_db::rem_rnti(uint16_t rnti)
 {
   std::lock_guard<std::mutex> lock(mutex);
 
-  if (ue_db.count(rnti) != 0) {
-    ue_db.erase(rnti);
+  // The workers holding a snapshot with the UE keep using it until their next TTI
+  if (_get_current().count(rnti) != 0) {
+    ue_map_t ues = _get_current();
+    ues.erase(rnti);
+    _publish(ues);
   }
 }
 
@@ -355,12 +408,17 @@ void phy_ue_db::complete_config(uint16_t rnti)
   std::lock_guard<std::mutex> lock(mutex);
 
   // Makes sure the RNTI exists
-  if (_assert_rnti(rnti) != SRSLTE_SUCCESS) {
+  if (get_snapshot()._assert_rnti(rnti) != SRSLTE_SUCCESS) {
     return;
   }
 
   // Apply stashed configuration
-  ue_db[rnti].cell_info[0].phy_cfg = ue_db[rnti].pcell_cfg_stash;
+  ue_map_t  ues           = _get_current();
+  common_ue ue            = *ues.at(rnti).cfg;
+  ue.cell_info[0].phy_cfg = ue.pcell_cfg_stash;
+
+  ues.at(rnti).cfg = std::make_shared<common_ue>(ue);
+  _publish(ues);
 }
 
 void phy_ue_db::activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, bool activate)
@@ -368,11 +426,13 @@ void phy_ue_db::activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, boo
   std::lock_guard<std::mutex> lock(mutex);
 
   // Assert RNTI and SCell are valid
-  if (_assert_ue_cc(rnti, ue_cc_idx) != SRSLTE_SUCCESS) {
+  if (get_snapshot()._assert_ue_cc(rnti, ue_cc_idx) != SRSLTE_SUCCESS) {
     return;
   }
 
-  cell_info_t& cell_info = ue_db[rnti].cell_info[ue_cc_idx];
+  ue_map_t     ues       = _get_current();
+  common_ue    ue        = *ues.at(rnti).cfg;
+  cell_info_t& cell_info = ue.cell_info[ue_cc_idx];
 
   // If scell is default only complain
   if (activate and cell_info.state == cell_state_none) {
@@ -381,51 +441,47 @@ void phy_ue_db::activate_deactivate_scell(uint16_t rnti, uint32_t ue_cc_idx, boo
   }
   // Set scell state
   cell_info.state = (activate) ? cell_state_secondary_active : cell_state_secondary_inactive;
+
+  ues.at(rnti).cfg = std::make_shared<common_ue>(ue);
+  _publish(ues);
 }
 
-bool phy_ue_db::is_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
+bool phy_ue_db::snapshot_t::is_pcell(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return _assert_enb_pcell(rnti, enb_cc_idx) == SRSLTE_SUCCESS;
 }
 
-srslte_dl_cfg_t phy_ue_db::get_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const
+srslte_dl_cfg_t phy_ue_db::snapshot_t::get_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return _get_rnti_config(rnti, enb_cc_idx, false).dl_cfg;
 }
 
-srslte_dci_cfg_t phy_ue_db::get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const
+srslte_dci_cfg_t phy_ue_db::snapshot_t::get_dci_dl_config(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return _get_rnti_config(rnti, enb_cc_idx, false).dl_cfg.dci;
 }
 
-srslte_ul_cfg_t phy_ue_db::get_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const
+srslte_ul_cfg_t phy_ue_db::snapshot_t::get_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return _get_rnti_config(rnti, enb_cc_idx, false).ul_cfg;
 }
 
-srslte_dci_cfg_t phy_ue_db::get_dci_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const
+srslte_dci_cfg_t phy_ue_db::snapshot_t::get_dci_ul_config(uint16_t rnti, uint32_t enb_cc_idx) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
   return _get_rnti_config(rnti, enb_cc_idx, true).dl_cfg.dci;
 }
 
-void phy_ue_db::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srslte_dci_dl_t& dci)
+void phy_ue_db::snapshot_t::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srslte_dci_dl_t& dci)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert rnti and cell exits and it is active
   if (_assert_active_enb_cc(dci.rnti, enb_cc_idx) != SRSLTE_SUCCESS) {
     return;
   }
 
-  common_ue& ue        = ue_db[dci.rnti];
-  uint32_t   ue_cc_idx = _get_ue_cc_idx(dci.rnti, enb_cc_idx);
-
-  srslte_pdsch_ack_cc_t& pdsch_ack_cc = ue.pdsch_ack[tti].cc[ue_cc_idx];
+  ue_tti_state_t&             state        = _get_state(dci.rnti);
+  uint32_t                    ue_cc_idx    = _get_ue_cc_idx(dci.rnti, enb_cc_idx);
+  std::lock_guard<std::mutex> lock(state.tti_mutex[tti]);
+  srslte_pdsch_ack_cc_t&      pdsch_ack_cc = state.pdsch_ack[tti].cc[ue_cc_idx];
   pdsch_ack_cc.M                      = 1; ///< Hardcoded for FDD
 
   // Fill PDSCH ACK information
@@ -448,15 +504,13 @@ void phy_ue_db::set_ack_pending(uint32_t tti, uint32_t enb_cc_idx, const srslte_
   }
 }
 
-bool phy_ue_db::fill_uci_cfg(uint32_t          tti,
-                             uint32_t          enb_cc_idx,
-                             uint16_t          rnti,
-                             bool              aperiodic_cqi_request,
-                             bool              is_pusch_available,
-                             srslte_uci_cfg_t& uci_cfg)
+bool phy_ue_db::snapshot_t::fill_uci_cfg(uint32_t          tti,
+                                         uint32_t          enb_cc_idx,
+                                         uint16_t          rnti,
+                                         bool              aperiodic_cqi_request,
+                                         bool              is_pusch_available,
+                                         srslte_uci_cfg_t& uci_cfg)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Reset UCI CFG, avoid returning carrying cached information
   uci_cfg = {};
 
@@ -489,7 +543,8 @@ bool phy_ue_db::fill_uci_cfg(uint32_t          tti,
     return false;
   }
 
-  common_ue&               ue           = ue_db.at(rnti);
+  const common_ue&         ue           = _get_cfg(rnti);
+  ue_tti_state_t&          state        = _get_state(rnti);
   const srslte::phy_cfg_t& pcell_cfg    = ue.cell_info[0].phy_cfg;
   bool                     uci_required = false;
 
@@ -511,7 +566,8 @@ bool phy_ue_db::fill_uci_cfg(uint32_t          tti,
       const srslte_cell_t& cell = cell_cfg_list->at(cell_info.enb_cc_idx).cell;
 
       // Check if CQI report is required
-      periodic_cqi_required = srslte_enb_dl_gen_cqi_periodic(&cell, &dl_cfg, tti, cell_info.last_ri, &uci_cfg.cqi);
+      periodic_cqi_required =
+          srslte_enb_dl_gen_cqi_periodic(&cell, &dl_cfg, tti, state.cell[cell_idx].last_ri, &uci_cfg.cqi);
 
       // Save SCell index for using it after
       uci_cfg.cqi.scell_index = cell_idx;
@@ -524,29 +580,30 @@ bool phy_ue_db::fill_uci_cfg(uint32_t          tti,
     // Aperiodic only supported for PCell
     const srslte_dl_cfg_t& dl_cfg = pcell_info.phy_cfg.dl_cfg;
 
-    uci_required = srslte_enb_dl_gen_cqi_aperiodic(&pcell, &dl_cfg, pcell_info.last_ri, &uci_cfg.cqi);
+    uci_required = srslte_enb_dl_gen_cqi_aperiodic(&pcell, &dl_cfg, state.cell[0].last_ri, &uci_cfg.cqi);
   }
 
   // Get pending ACKs from PDSCH
-  srslte_dl_sf_cfg_t dl_sf_cfg  = {};
-  dl_sf_cfg.tti                 = tti;
-  srslte_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
-  pdsch_ack.is_pusch_available  = is_pusch_available;
-  srslte_enb_dl_gen_ack(&pcell, &dl_sf_cfg, &pdsch_ack, &uci_cfg);
+  srslte_dl_sf_cfg_t dl_sf_cfg = {};
+  dl_sf_cfg.tti                = tti;
+  {
+    std::lock_guard<std::mutex> lock(state.tti_mutex[tti]);
+    srslte_pdsch_ack_t&         pdsch_ack = state.pdsch_ack[tti];
+    pdsch_ack.is_pusch_available          = is_pusch_available;
+    srslte_enb_dl_gen_ack(&pcell, &dl_sf_cfg, &pdsch_ack, &uci_cfg);
+  }
   uci_required |= (srslte_uci_cfg_total_ack(&uci_cfg) > 0);
 
   // Return whether UCI needs to be decoded
   return uci_required;
 }
 
-void phy_ue_db::send_uci_data(uint32_t                  tti,
-                              uint16_t                  rnti,
-                              uint32_t                  enb_cc_idx,
-                              const srslte_uci_cfg_t&   uci_cfg,
-                              const srslte_uci_value_t& uci_value)
+void phy_ue_db::snapshot_t::send_uci_data(uint32_t                  tti,
+                                          uint16_t                  rnti,
+                                          uint32_t                  enb_cc_idx,
+                                          const srslte_uci_cfg_t&   uci_cfg,
+                                          const srslte_uci_value_t& uci_value)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert UE RNTI database entry and eNb cell/carrier must be active
   if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSLTE_SUCCESS) {
     return;
@@ -563,20 +620,24 @@ void phy_ue_db::send_uci_data(uint32_t                  tti,
   }
 
   // Get UE
-  common_ue& ue = ue_db.at(rnti);
-
-  // Get ACK info
-  srslte_pdsch_ack_t& pdsch_ack = ue.pdsch_ack[tti];
-  srslte_enb_dl_get_ack(&cell_cfg_list->at(ue.cell_info[0].enb_cc_idx).cell, &uci_cfg, &uci_value, &pdsch_ack);
-
-  // Iterate over the ACK information
-  for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSLTE_MAX_CARRIERS; ue_cc_idx++) {
-    const srslte_pdsch_ack_cc_t& pdsch_ack_cc = pdsch_ack.cc[ue_cc_idx];
-    for (uint32_t m = 0; m < pdsch_ack_cc.M; m++) {
-      if (pdsch_ack_cc.m[m].present) {
-        for (uint32_t tb = 0; tb < SRSLTE_MAX_CODEWORDS; tb++) {
-          if (pdsch_ack_cc.m[m].value[tb] != 2) {
-            stack->ack_info(tti, rnti, ue.cell_info[ue_cc_idx].enb_cc_idx, tb, pdsch_ack_cc.m[m].value[tb] == 1);
+  const common_ue& ue    = _get_cfg(rnti);
+  ue_tti_state_t&  state = _get_state(rnti);
+
+  {
+    // Get ACK info
+    std::lock_guard<std::mutex> lock(state.tti_mutex[tti]);
+    srslte_pdsch_ack_t&         pdsch_ack = state.pdsch_ack[tti];
+    srslte_enb_dl_get_ack(&cell_cfg_list->at(ue.cell_info[0].enb_cc_idx).cell, &uci_cfg, &uci_value, &pdsch_ack);
+
+    // Iterate over the ACK information
+    for (uint32_t ue_cc_idx = 0; ue_cc_idx < SRSLTE_MAX_CARRIERS; ue_cc_idx++) {
+      const srslte_pdsch_ack_cc_t& pdsch_ack_cc = pdsch_ack.cc[ue_cc_idx];
+      for (uint32_t m = 0; m < pdsch_ack_cc.M; m++) {
+        if (pdsch_ack_cc.m[m].present) {
+          for (uint32_t tb = 0; tb < SRSLTE_MAX_CODEWORDS; tb++) {
+            if (pdsch_ack_cc.m[m].value[tb] != 2) {
+              stack->ack_info(tti, rnti, ue.cell_info[ue_cc_idx].enb_cc_idx, tb, pdsch_ack_cc.m[m].value[tb] == 1);
+            }
           }
         }
       }
@@ -589,8 +650,7 @@ void phy_ue_db::send_uci_data(uint32_t                  tti,
   }
 
   // Get CQI carrier index
-  cell_info_t& cqi_scell_info = ue_db.at(rnti).cell_info[uci_cfg.cqi.scell_index];
-  uint32_t     cqi_cc_idx     = cqi_scell_info.enb_cc_idx;
+  uint32_t cqi_cc_idx = ue.cell_info[uci_cfg.cqi.scell_index].enb_cc_idx;
 
   // Notify CQI only if CRC is valid
   if (uci_value.cqi.data_crc) {
@@ -635,44 +695,44 @@ void phy_ue_db::send_uci_data(uint32_t                  tti,
   // Rank indicator (TM3 and TM4)
   if (uci_cfg.cqi.ri_len) {
     stack->ri_info(tti, rnti, cqi_cc_idx, uci_value.ri);
-    cqi_scell_info.last_ri = uci_value.ri;
+    state.cell[uci_cfg.cqi.scell_index].last_ri = uci_value.ri;
   }
 }
 
-void phy_ue_db::set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srslte_ra_tb_t tb)
+void phy_ue_db::snapshot_t::set_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid, srslte_ra_tb_t tb)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert UE DB entry
   if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSLTE_SUCCESS) {
     return;
   }
 
   // Save resource allocation
-  ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid] = tb;
+  ue_tti_state_t&             state = _get_state(rnti);
+  std::lock_guard<std::mutex> lock(state.harq_mutex[pid]);
+  state.cell[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid] = tb;
 }
 
-srslte_ra_tb_t phy_ue_db::get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid) const
+srslte_ra_tb_t phy_ue_db::snapshot_t::get_last_ul_tb(uint16_t rnti, uint32_t enb_cc_idx, uint32_t pid) const
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Assert UE DB entry
   if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSLTE_SUCCESS) {
     return {};
   }
 
   // Returns the latest stored UL transmission grant
-  return ue_db.at(rnti).cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid];
+  const ue_tti_state_t&       state = _get_state(rnti);
+  std::lock_guard<std::mutex> lock(state.harq_mutex[pid]);
+  return state.cell[_get_ue_cc_idx(rnti, enb_cc_idx)].last_tb[pid];
 }
 
-void phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_lte::ul_sched_list_t& ul_sched_list)
+void phy_ue_db::snapshot_t::set_ul_grant_available(uint32_t                                        tti,
+                                                   const stack_interface_phy_lte::ul_sched_list_t& ul_sched_list)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
   // Reset all available grants flags for the given TTI
-  for (auto& ue : ue_db) {
-    for (cell_info_t& cell_info : ue.second.cell_info) {
-      cell_info.is_grant_available[tti] = false;
+  for (auto& ue : *ue_db) {
+    std::lock_guard<std::mutex> lock(ue.second.state->tti_mutex[tti]);
+    for (cell_tti_state_t& cell : ue.second.state->cell) {
+      cell.is_grant_available[tti] = false;
     }
   }
 
@@ -685,7 +745,9 @@ void phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_l
       // Check that eNb Cell/Carrier is active for the given RNTI
       if (_assert_active_enb_cc(rnti, enb_cc_idx) == SRSLTE_SUCCESS) {
         // Rise Grant available flag
-        ue_db[rnti].cell_info[_get_ue_cc_idx(rnti, enb_cc_idx)].is_grant_available[tti] = true;
+        ue_tti_state_t&             state = _get_state(rnti);
+        std::lock_guard<std::mutex> lock(state.tti_mutex[tti]);
+        state.cell[_get_ue_cc_idx(rnti, enb_cc_idx)].is_grant_available[tti] = true;
       }
     }
   }
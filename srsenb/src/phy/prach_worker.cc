@@ -124,6 +124,12 @@ int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
 int prach_worker::run_tti(sf_buffer* b)
 {
   if (srslte_prach_tti_opportunity(&prach, b->tti, -1)) {
+    // The fast detector only searches up to the maximum offset, which is set from other threads
+    if (prach.max_delay_us != max_prach_offset_us && srslte_prach_set_max_delay_us(&prach, max_prach_offset_us)) {
+      log_h->error("Error setting PRACH maximum delay\n");
+      return SRSLTE_ERROR;
+    }
+
     // Detect possible PRACHs
     if (srslte_prach_detect_offset(&prach,
                                    prach_cfg.freq_offset,
@@ -72,10 +72,11 @@ namespace srsenb {
 FILE* f;
 #endif
 
-void sf_worker::init(phy_common* phy_, srslte::log* log_h_)
+void sf_worker::init(phy_common* phy_, srslte::log* log_h_, stage_t stage_)
 {
   phy   = phy_;
   log_h = log_h_;
+  stage = stage_;
 
   // Initialise each component carrier workers
   for (uint32_t i = 0; i < phy->get_nof_carriers(); i++) {
@@ -111,7 +112,10 @@ cf_t* sf_worker::get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx)
   return cc_workers[cc_idx]->get_buffer_rx(antenna_idx);
 }
 
-void sf_worker::set_time(uint32_t tti_, uint32_t tx_worker_cnt_, const srslte::rf_timestamp_t& tx_time_)
+void sf_worker::set_time(uint32_t                                     tti_,
+                         uint32_t                                     tx_worker_cnt_,
+                         const srslte::rf_timestamp_t&                tx_time_,
+                         const std::chrono::steady_clock::time_point& rx_time_)
 {
   tti_rx    = tti_;
   tti_tx_dl = TTI_ADD(tti_rx, FDD_HARQ_DELAY_UL_MS);
@@ -123,9 +127,10 @@ void sf_worker::set_time(uint32_t tti_, uint32_t tx_worker_cnt_, const srslte::r
 
   tx_worker_cnt = tx_worker_cnt_;
   tx_time.copy(tx_time_);
+  rx_time = rx_time_;
 
   for (auto& w : cc_workers) {
-    w->set_tti(tti_);
+    w->set_tti(tti_, rx_time);
   }
 }
 
@@ -163,11 +168,65 @@ uint32_t sf_worker::get_nof_rnti()
   return cc_workers[0]->get_nof_rnti();
 }
 
+void sf_worker::work_ul(stack_interface_phy_lte::ul_sched_list_t& ul_grants)
+{
+  // Configure UL subframe
+  srslte_ul_sf_cfg_t ul_sf = {};
+  ul_sf.tti                = tti_rx;
+
+  // Set UL grant availability prior to any UL processing
+  tti_ue_db.set_ul_grant_available(tti_rx, ul_grants);
+
+  // Process UL, the carriers are spread over the PHY task pool if there is one
+  phy->parallel_for(cc_workers.size(), [this, &ul_sf, &ul_grants](uint32_t cc, uint32_t slot) {
+    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
+  });
+}
+
+void sf_worker::wait_ul(stack_interface_phy_lte::ul_sched_list_t& ul_grants)
+{
+  std::vector<uint64_t>                 pusch_reported;
+  std::chrono::steady_clock::time_point deadline = rx_time + std::chrono::microseconds(phy->params.ul_deadline_us);
+
+  // Past the deadline the stack is told that the PUSCH not decoded yet were lost, so that the UE retransmits them
+  if (not phy->ul_rx_wait(tti_rx, deadline, pusch_reported)) {
+    for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
+      cc_workers[cc]->nack_late_pusch(ul_grants[cc], pusch_reported[cc]);
+    }
+  }
+
+  // The PUSCH were decoded by the UL-RX worker, derive their PHICH resources from the grants
+  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
+    cc_workers[cc]->set_phich_grants(ul_grants[cc]);
+  }
+}
+
 void sf_worker::work_imp()
 {
   std::lock_guard<std::mutex> lock(work_mutex);
 
-  srslte_ul_sf_cfg_t ul_sf = {};
+  // All the carriers of the TTI read the same version of the UE database, without locking it
+  tti_ue_db = phy->ue_db.get_snapshot();
+  for (auto& w : cc_workers) {
+    w->set_ue_db(tti_ue_db);
+  }
+
+  // UL-RX stage of the split pipeline, the DL-TX worker of the same TTI takes care of the transmission
+  if (stage == stage_t::ul_rx) {
+    log_h->step(tti_rx);
+    if (running) {
+      stack_interface_phy_lte::ul_sched_list_t ul_grants = phy->get_ul_grants(t_rx);
+      work_ul(ul_grants);
+    }
+    phy->ul_rx_end(tti_rx);
+    return;
+  }
+
+  // Stage timestamps of the TTI, the subframe was received by the TX/RX thread
+  phy_common::tti_timing_t timing     = {};
+  timing[phy_timing_metrics_t::queue] = rx_time;
+  timing[phy_timing_metrics_t::ul]    = std::chrono::steady_clock::now();
+
   srslte_dl_sf_cfg_t dl_sf = {};
 
   // Get Transmission buffers
@@ -200,16 +259,16 @@ void sf_worker::work_imp()
 
   Debug("Worker %d running\n", get_id());
 
-  // Configure UL subframe
-  ul_sf.tti = tti_rx;
-
-  // Set UL grant availability prior to any UL processing
-  phy->ue_db.set_ul_grant_available(tti_rx, ul_grants);
-
-  // Process UL
-  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
-    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
+  // The stack needs the CRC and UCI received in this TTI for scheduling, process the UL or wait for the UL-RX worker
+  std::chrono::steady_clock::time_point t_ul = std::chrono::steady_clock::now();
+  if (stage == stage_t::ul_dl) {
+    work_ul(ul_grants);
+  } else {
+    wait_ul(ul_grants);
   }
+  timing[phy_timing_metrics_t::sched] = std::chrono::steady_clock::now();
+  float ul_wait_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(timing[phy_timing_metrics_t::sched] - t_ul).count();
 
   // Get DL scheduling for the TX TTI from MAC
   if (sf_type == SRSLTE_SF_NORM) {
@@ -238,19 +297,22 @@ void sf_worker::work_imp()
     return;
   }
 
+  timing[phy_timing_metrics_t::encode] = std::chrono::steady_clock::now();
+
   // Configure DL subframe
   dl_sf.tti              = tti_tx_dl;
   dl_sf.sf_type          = sf_type;
   dl_sf.non_mbsfn_region = mbsfn_cfg.non_mbsfn_region_length;
 
   // Prepare for receive ACK for DL grants in t_tx_dl+4
-  phy->ue_db.clear_tti_pending_ack(tti_tx_ul);
+  tti_ue_db.clear_tti_pending_ack(tti_tx_ul);
 
-  // Process DL
-  for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
-    dl_sf.cfi = dl_grants[cc].cfi;
-    cc_workers[cc]->work_dl(dl_sf, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg);
-  }
+  // Process DL, the carriers are spread over the PHY task pool if there is one
+  phy->parallel_for(cc_workers.size(), [&](uint32_t cc, uint32_t slot) {
+    srslte_dl_sf_cfg_t cc_dl_sf = dl_sf;
+    cc_dl_sf.cfi                = dl_grants[cc].cfi;
+    cc_workers[cc]->work_dl(cc_dl_sf, dl_grants[cc], ul_grants_tx[cc], &mbsfn_cfg, ul_wait_us);
+  });
 
   // Save grants
   phy->set_ul_grants(t_tx_ul, ul_grants_tx);
@@ -258,7 +320,19 @@ void sf_worker::work_imp()
 
   Debug("Sending to radio\n");
   tx_buffer.set_nof_samples(SRSLTE_SF_LEN_PRB(phy->get_nof_prb(0)));
-  phy->worker_end(this, tx_buffer, tx_time);
+  timing[phy_timing_metrics_t::tx] = std::chrono::steady_clock::now();
+  phy->worker_end(this, tx_buffer, tx_time, &timing);
+
+  // Attribute a late subframe to the stage that took the longest
+  uint32_t late_stage = 0;
+  float    slack_us   = phy->timing_report(timing, &late_stage);
+  if (slack_us < 0) {
+    Warning("Late subframe tti_tx_dl=%d: handed to the radio %.0f us past the deadline, %s stage took %.0f us\n",
+            tti_tx_dl,
+            -slack_us,
+            phy_timing_stage_to_string(late_stage),
+            std::chrono::duration<float, std::micro>(timing[late_stage + 1] - timing[late_stage]).count());
+  }
 
 #ifdef DEBUG_WRITE_FILE
   fwrite(signal_buffer_tx, SRSLTE_SF_LEN_PRB(phy->cell.nof_prb) * sizeof(cf_t), 1, f);
@@ -290,12 +364,16 @@ uint32_t sf_worker::get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS])
       phy_metrics_t* m  = &metrics[r];
       phy_metrics_t* _m = &_metrics[r];
       m->dl.mcs         = SRSLTE_VEC_PMA(m->dl.mcs, m->dl.n_samples, _m->dl.mcs, _m->dl.n_samples);
+      m->dl.ul_wait_us  = SRSLTE_VEC_PMA(m->dl.ul_wait_us, m->dl.n_samples, _m->dl.ul_wait_us, _m->dl.n_samples);
+      m->dl.encode_us   = SRSLTE_VEC_PMA(m->dl.encode_us, m->dl.n_samples, _m->dl.encode_us, _m->dl.n_samples);
       m->dl.n_samples += _m->dl.n_samples;
       m->ul.n           = SRSLTE_VEC_PMA(m->ul.n, m->ul.n_samples, _m->ul.n, _m->ul.n_samples);
       m->ul.sinr        = SRSLTE_VEC_PMA(m->ul.sinr, m->ul.n_samples, _m->ul.sinr, _m->ul.n_samples);
       m->ul.mcs         = SRSLTE_VEC_PMA(m->ul.mcs, m->ul.n_samples, _m->ul.mcs, _m->ul.n_samples);
       m->ul.rssi        = SRSLTE_VEC_PMA(m->ul.rssi, m->ul.n_samples, _m->ul.rssi, _m->ul.n_samples);
       m->ul.turbo_iters = SRSLTE_VEC_PMA(m->ul.turbo_iters, m->ul.n_samples, _m->ul.turbo_iters, _m->ul.n_samples);
+      m->ul.decode_us   = SRSLTE_VEC_PMA(m->ul.decode_us, m->ul.n_samples, _m->ul.decode_us, _m->ul.n_samples);
+      m->ul.n_late += _m->ul.n_late;
       m->ul.n_samples += _m->ul.n_samples;
     }
   }
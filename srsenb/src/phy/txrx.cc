@@ -53,19 +53,21 @@ txrx::txrx() : thread("TXRX")
 bool txrx::init(stack_interface_phy_lte*     stack_,
                 srslte::radio_interface_phy* radio_h_,
                 srslte::thread_pool*         workers_pool_,
+                srslte::thread_pool*         ul_workers_pool_,
                 phy_common*                  worker_com_,
                 prach_worker_pool*           prach_,
                 srslte::log*                 log_h_,
                 uint32_t                     prio_)
 {
-  stack         = stack_;
-  radio_h       = radio_h_;
-  log_h         = log_h_;
-  workers_pool  = workers_pool_;
-  worker_com    = worker_com_;
-  prach         = prach_;
-  tx_worker_cnt = 0;
-  running       = true;
+  stack           = stack_;
+  radio_h         = radio_h_;
+  log_h           = log_h_;
+  workers_pool    = workers_pool_;
+  ul_workers_pool = ul_workers_pool_;
+  worker_com      = worker_com_;
+  prach           = prach_;
+  tx_worker_cnt   = 0;
+  running         = true;
 
   nof_workers = workers_pool->get_nof_workers();
 
@@ -90,6 +92,7 @@ void txrx::stop()
 void txrx::run_thread()
 {
   sf_worker*             worker    = nullptr;
+  sf_worker*             rx_worker = nullptr;
   srslte::rf_buffer_t    buffer    = {};
   srslte::rf_timestamp_t timestamp = {};
   uint32_t               sf_len    = SRSLTE_SF_LEN_PRB(worker_com->get_nof_prb(0));
@@ -125,18 +128,33 @@ void txrx::run_thread()
   while (running) {
     tti    = TTI_ADD(tti, 1);
     worker = (sf_worker*)workers_pool->wait_worker(tti);
+
+    // In the split pipeline the subframe is received by a UL-RX worker, otherwise the same worker does both. The
+    // TX/RX thread never waits for a UL-RX worker: if they are all busy, the subframe is received by the DL-TX worker
+    // and not decoded, its PUSCH are indicated as KO so that the UEs retransmit them
+    rx_worker = worker;
+    if (worker and ul_workers_pool) {
+      sf_worker* ul_worker = (sf_worker*)ul_workers_pool->wait_worker_nb(tti);
+      if (ul_worker) {
+        rx_worker = ul_worker;
+      } else {
+        log_h->warning("No UL-RX worker available for tti=%d, dropping its PUSCH\n", tti);
+      }
+    }
+
     if (worker) {
       // Multiple cell buffer mapping
       for (uint32_t cc = 0; cc < worker_com->get_nof_carriers(); cc++) {
         uint32_t rf_port = worker_com->get_rf_port(cc);
         for (uint32_t p = 0; p < worker_com->get_nof_ports(cc); p++) {
           // WARNING: The number of ports for all cells must be the same
-          buffer.set(rf_port, p, worker_com->get_nof_ports(0), worker->get_buffer_rx(cc, p));
+          buffer.set(rf_port, p, worker_com->get_nof_ports(0), rx_worker->get_buffer_rx(cc, p));
         }
       }
 
       buffer.set_nof_samples(sf_len);
       radio_h->rx_now(buffer, timestamp);
+      std::chrono::steady_clock::time_point rx_time = std::chrono::steady_clock::now();
 
       if (ul_channel) {
         ul_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), sf_len, timestamp.get(0));
@@ -152,11 +170,20 @@ void txrx::run_thread()
             timestamp.get(0).frac_secs,
             worker->get_id());
 
-      worker->set_time(tti, tx_worker_cnt, timestamp);
+      worker->set_time(tti, tx_worker_cnt, timestamp, rx_time);
       tx_worker_cnt = (tx_worker_cnt + 1) % nof_workers;
 
       // Trigger phy worker execution
+      if (ul_workers_pool and rx_worker == worker) {
+        worker_com->ul_rx_skip(tti);
+      } else {
+        worker_com->ul_rx_start(tti);
+      }
       worker_com->semaphore.push(worker);
+      if (rx_worker != worker) {
+        rx_worker->set_time(tti, tx_worker_cnt, timestamp, rx_time);
+        ul_workers_pool->start_worker(rx_worker);
+      }
       workers_pool->start_worker(worker);
 
       // Trigger prach worker execution
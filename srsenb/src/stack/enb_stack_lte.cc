@@ -110,7 +110,7 @@ int enb_stack_lte::init(const stack_args_t& args_, const rrc_cfg_t& rrc_cfg_)
   // Init all layers
   mac.init(args.mac, rrc_cfg.cell_list, phy, &rlc, &rrc, mac_log);
   rlc.init(&pdcp, &rrc, &mac, task_sched.get_timer_handler(), rlc_log);
-  pdcp.init(&rlc, &rrc, &gtpu);
+  pdcp.init(args.pdcp, &rlc, &rrc, &gtpu);
   rrc.init(rrc_cfg, phy, &mac, &rlc, &pdcp, &s1ap, &gtpu);
   if (s1ap.init(args.s1ap, &rrc, this) != SRSLTE_SUCCESS) {
     stack_log->error("Couldn't initialize S1AP\n");
@@ -141,6 +141,7 @@ void enb_stack_lte::tti_clock()
 void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
+  pdcp.tti_clock();
   rrc.tti_clock();
 }
 
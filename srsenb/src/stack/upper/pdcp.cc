@@ -30,26 +30,47 @@ pdcp::pdcp(srslte::task_sched_handle task_sched_, const char* logname) :
   pool(srslte::byte_buffer_pool::get_instance())
 {}
 
-void pdcp::init(rlc_interface_pdcp* rlc_, rrc_interface_pdcp* rrc_, gtpu_interface_pdcp* gtpu_)
+void pdcp::init(const pdcp_args_t&   args_,
+                rlc_interface_pdcp*  rlc_,
+                rrc_interface_pdcp*  rrc_,
+                gtpu_interface_pdcp* gtpu_)
 {
   rlc  = rlc_;
   rrc  = rrc_;
   gtpu = gtpu_;
+
+  if (args_.crypto_batch) {
+    crypto_batch.reset(new srslte::pdcp_crypto_batch(task_sched, args_.crypto_batch_size, args_.crypto_worker));
+    log_h->info("Ciphering DRB PDUs in batches of up to %d PDUs%s\n",
+                args_.crypto_batch_size,
+                args_.crypto_worker ? " in a worker thread" : "");
+  }
 }
 
 void pdcp::stop()
 {
+  if (crypto_batch != nullptr) {
+    crypto_batch->stop();
+  }
   for (std::map<uint32_t, user_interface>::iterator iter = users.begin(); iter != users.end(); ++iter) {
     clear_user(&iter->second);
   }
   users.clear();
 }
 
+void pdcp::tti_clock()
+{
+  if (crypto_batch != nullptr) {
+    crypto_batch->flush();
+  }
+}
+
 void pdcp::add_user(uint16_t rnti)
 {
   if (users.count(rnti) == 0) {
     srslte::pdcp* obj = new srslte::pdcp(task_sched, log_h->get_service_name().c_str());
     obj->init(&users[rnti].rlc_itf, &users[rnti].rrc_itf, &users[rnti].gtpu_itf);
+    obj->set_crypto_batch(crypto_batch.get());
     users[rnti].rlc_itf.rnti  = rnti;
     users[rnti].gtpu_itf.rnti = rnti;
     users[rnti].rrc_itf.rnti  = rnti;
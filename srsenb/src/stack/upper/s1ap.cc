@@ -533,10 +533,17 @@ bool s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu)
     pcap->write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
-  s1ap_pdu_c     rx_pdu;
-  asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
+  // The PDU unpacked in the previous call was already destroyed
+  rx_arena.reset();
 
-  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+  s1ap_pdu_c        rx_pdu;
+  asn1::cbit_ref    bref(pdu->msg, pdu->N_bytes);
+  asn1::SRSASN_CODE ret;
+  {
+    asn1::arena_scope scope(rx_arena);
+    ret = rx_pdu.unpack(bref);
+  }
+  if (ret != asn1::SRSASN_SUCCESS) {
     s1ap_log->error("Failed to unpack received PDU\n");
     return false;
   }
@@ -84,6 +84,20 @@ public:
     metrics[1].phy->ul.mcs            = 28.0;
     metrics[1].phy->ul.sinr           = 22.2;
 
+    metrics[1].phy_timing.n_samples       = 1000;
+    metrics[1].phy_timing.n_late          = 2;
+    metrics[1].phy_timing.slack_mean_us   = 1800;
+    metrics[1].phy_timing.slack_min_us    = -250;
+    metrics[1].phy_timing.mean_us[0]      = 20;
+    metrics[1].phy_timing.max_us[0]       = 120;
+    metrics[1].phy_timing.hist[0][0]      = 990;
+    metrics[1].phy_timing.hist[0][2]      = 10;
+    metrics[1].phy_timing.mean_us[3]      = 900;
+    metrics[1].phy_timing.max_us[3]       = 3100;
+    metrics[1].phy_timing.hist[3][4]      = 998;
+    metrics[1].phy_timing.hist[3][6]      = 2;
+    metrics[1].phy_timing.n_late_stage[3] = 2;
+
     // third entry
     metrics[2].rf.rf_o                = 10;
     metrics[2].stack.rrc.n_ues        = 1;
@@ -21,6 +21,7 @@
 #include <boost/program_options.hpp>
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/parsers.hpp>
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <srsenb/hdr/phy/phy.h>
@@ -288,6 +289,12 @@ private:
   uint8_t*                                          data                                                    = nullptr;
   uint16_t                                          ue_rnti                                                 = 0;
   srslte_random_t                                   random_gen                                              = nullptr;
+  bool                                              late_pusch                                              = false;
+  std::atomic<uint32_t>                             nof_late_pusch                                          = {0};
+
+  // PUSCH data buffers of each eNb cell/carrier and UL HARQ process, the eNb PHY only writes the PUSCH received in time
+  static const uint8_t  ul_data_fill = 0xff; ///< Never generated by the dummy UE
+  std::vector<uint8_t*> ul_data;
 
   CALLBACK(sr_detected);
   CALLBACK(rach_detected);
@@ -315,6 +322,7 @@ private:
     uint32_t tti;
     uint32_t cc_idx;
     bool     crc;
+    bool     data_ok;
   } tti_ul_info_t;
 
   typedef struct {
@@ -343,10 +351,12 @@ public:
   explicit dummy_stack(const srsenb::phy_cfg_t&                                 phy_cfg_,
                        const srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t& phy_rrc_,
                        const std::string&                                       log_level,
-                       uint16_t                                                 rnti_) :
+                       uint16_t                                                 rnti_,
+                       bool                                                     late_pusch_) :
     log_h("STACK"),
     ue_rnti(rnti_),
     random_gen(srslte_random_init(rnti_)),
+    late_pusch(late_pusch_),
     phy_cell_cfg(phy_cfg_.phy_cell_cfg),
     phy_rrc(phy_rrc_)
   {
@@ -397,6 +407,11 @@ public:
 
     data = srslte_vec_u8_malloc(150000);
     memset(data, 0, 150000);
+
+    ul_data.resize(phy_cell_cfg.size() * SRSLTE_FDD_NOF_HARQ);
+    for (auto& d : ul_data) {
+      d = srslte_vec_u8_malloc(SRSENB_MAX_BUFFER_SIZE_BYTES);
+    }
   }
 
   ~dummy_stack()
@@ -410,11 +425,17 @@ public:
     if (data) {
       free(data);
     }
+    for (auto& d : ul_data) {
+      if (d) {
+        free(d);
+      }
+    }
 
     srslte_random_free(random_gen);
   }
 
-  void set_active_cell_list(std::vector<uint32_t>& active_cell_list_) { active_cell_list = active_cell_list_; }
+  void     set_active_cell_list(std::vector<uint32_t>& active_cell_list_) { active_cell_list = active_cell_list_; }
+  uint32_t get_nof_late_pusch() const { return nof_late_pusch; }
 
   int sr_detected(uint32_t tti, uint16_t rnti) override
   {
@@ -489,11 +510,26 @@ public:
   }
   int crc_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, uint32_t nof_bytes, bool crc_res) override
   {
+    // The PUSCH data is only copied if it was decoded in time, a KO leaves the buffer untouched
+    uint8_t* pusch_data = ul_data[cc_idx * SRSLTE_FDD_NOF_HARQ + tti % SRSLTE_FDD_NOF_HARQ];
+    bool     data_ok    = true;
+    if (crc_res) {
+      for (uint32_t i = 0; i < nof_bytes; i++) {
+        data_ok &= pusch_data[i] == static_cast<uint8_t>(((i + 257) * (i + 373)) % 255);
+      }
+    } else {
+      for (uint32_t i = 0; i < SRSENB_MAX_BUFFER_SIZE_BYTES; i++) {
+        data_ok &= pusch_data[i] == ul_data_fill;
+      }
+      nof_late_pusch++;
+    }
+
     // Push grant info in queue
     tti_ul_info_t tti_ul_info = {};
     tti_ul_info.tti           = tti;
     tti_ul_info.cc_idx        = cc_idx;
     tti_ul_info.crc           = crc_res;
+    tti_ul_info.data_ok       = data_ok;
     tti_ul_info_ack_queue.push(tti_ul_info);
 
     log_h.info("Received UL ACK tti=%d; rnti=0x%x; cc=%d; ack=%d;\n", tti, rnti, cc_idx, crc_res);
@@ -664,13 +700,14 @@ public:
         ul_sched.pusch[0].dci.tb.cw_idx           = 0;
         ul_sched.pusch[0].dci.n_dmrs              = 0;
         ul_sched.pusch[0].dci.cqi_request         = false;
-        ul_sched.pusch[0].data                    = data;
+        ul_sched.pusch[0].data                    = ul_data[cc_idx * SRSLTE_FDD_NOF_HARQ + tti % SRSLTE_FDD_NOF_HARQ];
 
         ul_sched.pusch[0].needs_pdcch   = true;
         ul_sched.pusch[0].softbuffer_rx = &softbuffer_rx[scell_idx][tti % SRSLTE_FDD_NOF_HARQ];
 
-        // Reset Rx softbuffer
+        // Reset Rx softbuffer and data
         srslte_softbuffer_rx_reset(ul_sched.pusch[0].softbuffer_rx);
+        memset(ul_sched.pusch[0].data, ul_data_fill, SRSENB_MAX_BUFFER_SIZE_BYTES);
 
         // Push grant info in queue
         tti_ul_info_t tti_ul_info = {};
@@ -691,6 +728,9 @@ public:
   void tti_clock() override { notify_tti_clock(); }
   int  run_tti(bool enable_assert)
   {
+    // The UCI of the TTIs closed by the UL deadline is lost, only the PUSCH are indicated
+    bool enable_assert_uci = enable_assert and not late_pusch;
+
     // Check DL ACKs match with grants
     while (not tti_dl_info_ack_queue.empty()) {
       // Get both Info
@@ -701,7 +741,7 @@ public:
       tti_dl_sched.tti = TTI_ADD(tti_dl_sched.tti, FDD_HARQ_DELAY_DL_MS);
 
       // Assert that ACKs have been received
-      if (enable_assert) {
+      if (enable_assert_uci) {
         TESTASSERT(tti_dl_sched.tti == tti_dl_ack.tti);
         TESTASSERT(tti_dl_sched.cc_idx == tti_dl_ack.cc_idx);
         TESTASSERT(tti_dl_sched.tb_idx == tti_dl_ack.tb_idx);
@@ -721,22 +761,23 @@ public:
       if (enable_assert) {
         TESTASSERT(tti_ul_sched.tti == tti_ul_ack.tti);
         TESTASSERT(tti_ul_sched.cc_idx == tti_ul_ack.cc_idx);
-        TESTASSERT(tti_ul_sched.crc == tti_ul_ack.crc);
+        TESTASSERT(tti_ul_sched.crc == tti_ul_ack.crc or late_pusch);
       }
+      TESTASSERT(tti_ul_ack.data_ok);
 
       tti_ul_info_sched_queue.pop();
       tti_ul_info_ack_queue.pop();
     }
 
     //  Check SR match with TTI
-    size_t req_queue_size = (enable_assert) ? 1 : 0;
+    size_t req_queue_size = (enable_assert_uci) ? 1 : 0;
     while (tti_sr_info_queue.size() > req_queue_size) {
       tti_sr_info_t tti_sr_info1 = tti_sr_info_queue.front();
 
       // POP first from queue
       tti_sr_info_queue.pop();
 
-      if (enable_assert) {
+      if (enable_assert_uci) {
         // Get second, do not pop
         tti_sr_info_t& tti_sr_info2 = tti_sr_info_queue.front();
 
@@ -1147,6 +1188,9 @@ public:
     std::string           log_level           = "none";
     uint32_t              tm_u32              = 1;
     uint32_t              period_pcell_rotate = 0;
+    uint32_t              nof_task_threads    = 0;
+    uint32_t              nof_ul_threads      = 0;
+    uint32_t              ul_deadline_us      = 2000; ///< Zero closes the UL of every TTI as soon as the DL starts
     srslte_tm_t           tm                  = SRSLTE_TM1;
     args_t()
     {
@@ -1213,8 +1257,11 @@ public:
     log_h.set_level(args.log_level);
 
     // PHY arguments
-    phy_args.log.phy_level   = args.log_level;
-    phy_args.nof_phy_threads = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.log.phy_level        = args.log_level;
+    phy_args.nof_phy_threads      = 1; ///< Set number of phy threads to 1 for avoiding concurrency issues
+    phy_args.nof_phy_task_threads = args.nof_task_threads;
+    phy_args.nof_ul_phy_threads   = args.nof_ul_threads;
+    phy_args.ul_deadline_us       = args.ul_deadline_us;
 
     // Create cell configuration
     phy_cfg.phy_cell_cfg.resize(args.nof_enb_cells);
@@ -1298,7 +1345,9 @@ public:
         new dummy_radio(args.nof_enb_cells * args.cell.nof_ports, args.cell.nof_prb, args.log_level));
 
     /// Create Dummy Stack isntance
-    stack = unique_dummy_stack_t(new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti));
+    bool late_pusch = args.nof_ul_threads > 0 and args.ul_deadline_us == 0;
+    stack           = unique_dummy_stack_t(
+        new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti, late_pusch));
     stack->set_active_cell_list(args.ue_cell_list);
 
     /// eNb PHY initialisation instance
@@ -1325,6 +1374,19 @@ public:
 
   ~phy_test_bench() = default;
 
+  /// The PUSCH indicated as KO by the stack are the ones that missed the UL deadline in the eNb PHY metrics. How many
+  /// depends on the scheduling of the UL-RX and DL-TX threads, so any number is fine
+  int check_late_pusch()
+  {
+    srsenb::phy_metrics_t metrics[ENB_METRICS_MAX_USERS] = {};
+    enb_phy->get_metrics(metrics);
+
+    log_h.info("Late PUSCH: stack=%d; metrics=%d;\n", stack->get_nof_late_pusch(), metrics[0].ul.n_late);
+    TESTASSERT(stack->get_nof_late_pusch() == (uint32_t)metrics[0].ul.n_late);
+
+    return SRSLTE_SUCCESS;
+  }
+
   int run_tti()
   {
     int ret = SRSLTE_SUCCESS;
@@ -1420,6 +1482,9 @@ int parse_args(int argc, char** argv, phy_test_bench::args_t& args)
       ("cell.nof_ports", bpo::value<uint32_t>(&args.cell.nof_ports)->default_value(args.cell.nof_ports), "eNb Cell/Carrier number of ports")
       ("tm", bpo::value<uint32_t>(&args.tm_u32)->default_value(args.tm_u32),                             "Transmission mode")
       ("rotation", bpo::value<uint32_t>(&args.period_pcell_rotate),                      "Serving cells rotation period in ms, set to zero to disable")
+      ("nof_task_threads", bpo::value<uint32_t>(&args.nof_task_threads),                 "Threads sharing the carriers and UEs of each TTI with the PHY thread")
+      ("nof_ul_threads", bpo::value<uint32_t>(&args.nof_ul_threads),                     "UL-RX threads, zero decodes the UL in the PHY thread")
+      ("ul_deadline_us", bpo::value<uint32_t>(&args.ul_deadline_us),                     "Time the DL of a TTI waits for its UL-RX thread, zero NACKs every PUSCH not decoded yet")
       ;
   options.add(common).add_options()("help", "Show this message");
   // clang-format on
@@ -1484,6 +1549,11 @@ int main(int argc, char** argv)
 
   test_bench->stop();
 
+  // Past the UL deadline the PUSCH are NACKed and not copied to the stack buffers
+  if (test_args.nof_ul_threads > 0 and test_args.ul_deadline_us == 0) {
+    TESTASSERT(test_bench->check_late_pusch() == SRSLTE_SUCCESS);
+  }
+
   std::cout << "Passed" << std::endl;
 
   return SRSLTE_SUCCESS;
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/phy_common.h"
+#include "srslte/common/test_common.h"
+#include <cmath>
+#include <thread>
+
+using namespace srsenb;
+
+typedef phy_timing_metrics_t tm_t;
+
+// Timestamps of a TTI whose stages took the given durations
+static phy_common::tti_timing_t make_timing(const uint32_t stage_us[tm_t::nof_stages])
+{
+  phy_common::tti_timing_t timing;
+  timing[0] = std::chrono::steady_clock::now();
+  for (uint32_t s = 0; s < tm_t::nof_stages; s++) {
+    timing[s + 1] = timing[s] + std::chrono::microseconds(stage_us[s]);
+  }
+  return timing;
+}
+
+static uint32_t total_us(const uint32_t stage_us[tm_t::nof_stages])
+{
+  uint32_t t = 0;
+  for (uint32_t s = 0; s < tm_t::nof_stages; s++) {
+    t += stage_us[s];
+  }
+  return t;
+}
+
+/*
+ * Stage durations at the bin limits, bin i < nof_bins - 1 counts the durations below (bin0_limit_us << i)
+ */
+int test_histogram_bins()
+{
+  phy_common   common;
+  tm_t         m          = {};
+  uint32_t     late_stage = tm_t::nof_stages;
+  const size_t nof_bins   = tm_t::nof_bins;
+
+  const uint32_t limits[nof_bins - 1] = {50, 100, 200, 400, 800, 1600, 3200};
+  for (uint32_t i = 0; i < nof_bins - 1; i++) {
+    TESTASSERT(limits[i] == (tm_t::bin0_limit_us << i));
+  }
+
+  // Every stage of a TTI takes the same time, so all stages fall in the same bin
+  const uint32_t durations[]        = {0, 49, 50, 99, 100, 799, 800, 3199, 3200, 100000};
+  const uint32_t bins[]             = {0, 0, 1, 1, 2, 4, 5, 6, 7, 7};
+  uint32_t       expected[nof_bins] = {};
+  for (uint32_t i = 0; i < sizeof(durations) / sizeof(durations[0]); i++) {
+    uint32_t stage_us[tm_t::nof_stages];
+    for (uint32_t s = 0; s < tm_t::nof_stages; s++) {
+      stage_us[s] = durations[i];
+    }
+    common.timing_report(make_timing(stage_us), &late_stage);
+    expected[bins[i]]++;
+  }
+
+  common.get_timing_metrics(&m);
+  for (uint32_t s = 0; s < tm_t::nof_stages; s++) {
+    for (uint32_t b = 0; b < nof_bins; b++) {
+      TESTASSERT(m.hist[s][b] == expected[b]);
+    }
+  }
+
+  // The metrics are reset once read
+  common.get_timing_metrics(&m);
+  TESTASSERT(m.n_samples == 0);
+  for (uint32_t b = 0; b < nof_bins; b++) {
+    TESTASSERT(m.hist[0][b] == 0);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Mean, maximum, slack and attribution of the late subframes to their longest stage
+ */
+int test_late_attribution()
+{
+  phy_common common;
+  tm_t       m          = {};
+  uint32_t   late_stage = tm_t::nof_stages;
+
+  // On time
+  const uint32_t tti0[tm_t::nof_stages] = {10, 100, 50, 900, 40};
+  float          slack0                 = common.timing_report(make_timing(tti0), &late_stage);
+  TESTASSERT(slack0 == (float)phy_common::tx_deadline_us - total_us(tti0));
+  TESTASSERT(late_stage == tm_t::nof_stages);
+
+  // Late because of the encoding
+  const uint32_t tti1[tm_t::nof_stages] = {20, 300, 60, 3000, 20};
+  float          slack1                 = common.timing_report(make_timing(tti1), &late_stage);
+  TESTASSERT(slack1 == (float)phy_common::tx_deadline_us - total_us(tti1));
+  TESTASSERT(slack1 < 0);
+  TESTASSERT(late_stage == tm_t::encode);
+
+  common.get_timing_metrics(&m);
+  TESTASSERT(m.n_samples == 2);
+  TESTASSERT(m.n_late == 1);
+  for (uint32_t s = 0; s < tm_t::nof_stages; s++) {
+    TESTASSERT(m.n_late_stage[s] == (s == tm_t::encode ? 1 : 0));
+    TESTASSERT(std::abs(m.mean_us[s] - (tti0[s] + tti1[s]) / 2.0f) < 1e-3);
+    TESTASSERT(m.max_us[s] == std::max(tti0[s], tti1[s]));
+  }
+  TESTASSERT(m.slack_min_us == slack1);
+  TESTASSERT(std::abs(m.slack_mean_us - (slack0 + slack1) / 2) < 1e-3);
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Hand-over of the UL-RX stage of a TTI to its DL-TX stage: what is reported before the UL deadline, what is dropped
+ * after it and the TTIs without UL-RX worker
+ */
+int test_ul_rx_deadline()
+{
+  phy_common                            common;
+  std::vector<uint64_t>                 reported;
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point far = now + std::chrono::seconds(10);
+
+  // The eNb may have more cells than a UE has carriers
+  const uint32_t      nof_cells = SRSLTE_MAX_CARRIERS + 1;
+  phy_cell_cfg_list_t cell_list(nof_cells);
+  TESTASSERT(common.init(cell_list, nullptr, nullptr));
+
+  // The UL-RX stage finishes in time, the PUSCH of both carriers and the UCI were reported
+  common.ul_rx_start(10);
+  TESTASSERT(common.ul_rx_is_open(10));
+  TESTASSERT(common.ul_rx_report_begin(10));
+  common.ul_rx_report_end(10, 0, 0);
+  TESTASSERT(common.ul_rx_report_begin(10));
+  common.ul_rx_report_end(10, 0, 1ULL << 1);
+  TESTASSERT(common.ul_rx_report_begin(10));
+  common.ul_rx_report_end(10, 1, 1ULL << 0);
+  common.ul_rx_end(10);
+  TESTASSERT(common.ul_rx_wait(10, now, reported));
+  TESTASSERT(reported.size() == nof_cells);
+  TESTASSERT(reported[0] == (1ULL << 1) and reported[1] == (1ULL << 0));
+
+  // A PUSCH of the last cell does not overwrite the state of the next TTI
+  common.ul_rx_start(10 + TTIMOD_SZ);
+  common.ul_rx_start(11 + TTIMOD_SZ);
+  TESTASSERT(common.ul_rx_report_begin(10 + TTIMOD_SZ));
+  common.ul_rx_report_end(10 + TTIMOD_SZ, nof_cells - 1, UINT64_MAX);
+  common.ul_rx_end(10 + TTIMOD_SZ);
+  TESTASSERT(common.ul_rx_wait(10 + TTIMOD_SZ, now, reported));
+  TESTASSERT(reported[nof_cells - 1] == UINT64_MAX);
+  TESTASSERT(not common.ul_rx_wait(11 + TTIMOD_SZ, now, reported));
+  for (uint64_t mask : reported) {
+    TESTASSERT(mask == 0);
+  }
+
+  // The deadline expires with one PUSCH reported, the other one is dropped once the TTI is closed
+  common.ul_rx_start(11);
+  TESTASSERT(common.ul_rx_report_begin(11));
+  common.ul_rx_report_end(11, 0, 1ULL << 0);
+  TESTASSERT(not common.ul_rx_wait(11, now, reported));
+  TESTASSERT(reported[0] == (1ULL << 0));
+  TESTASSERT(not common.ul_rx_is_open(11));
+  TESTASSERT(not common.ul_rx_report_begin(11));
+  common.ul_rx_end(11);
+
+  // The DL-TX stage is woken up by the end of the UL-RX stage, well before the deadline
+  common.ul_rx_start(12);
+  std::thread ul_rx([&common]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    TESTASSERT(common.ul_rx_report_begin(12));
+    common.ul_rx_report_end(12, 0, 1ULL << 2);
+    common.ul_rx_end(12);
+    return SRSLTE_SUCCESS;
+  });
+  TESTASSERT(common.ul_rx_wait(12, far, reported));
+  TESTASSERT(std::chrono::steady_clock::now() < far);
+  TESTASSERT(reported[0] == (1ULL << 2));
+  ul_rx.join();
+
+  // Without UL-RX worker the TTI is never open, all the PUSCH are late without waiting for the deadline
+  common.ul_rx_skip(13);
+  TESTASSERT(not common.ul_rx_is_open(13));
+  TESTASSERT(not common.ul_rx_report_begin(13));
+  TESTASSERT(not common.ul_rx_wait(13, far, reported));
+  TESTASSERT(std::chrono::steady_clock::now() < far);
+  TESTASSERT(reported[0] == 0 and reported[1] == 0);
+
+  // The end of the TTI that used the same state before does not finish the current one
+  common.ul_rx_start(14 + TTIMOD_SZ);
+  common.ul_rx_end(14);
+  TESTASSERT(not common.ul_rx_wait(14 + TTIMOD_SZ, std::chrono::steady_clock::now(), reported));
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_histogram_bins() == SRSLTE_SUCCESS);
+  TESTASSERT(test_late_attribution() == SRSLTE_SUCCESS);
+  TESTASSERT(test_ul_rx_deadline() == SRSLTE_SUCCESS);
+  printf("Ok\n");
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/phy_ue_db.h"
+#include "srslte/common/test_common.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// As many readers as PHY workers in a loaded eNb, each one processes every nof_workers-th TTI like the PHY pipeline
+static const uint32_t nof_workers = 4;
+static const uint32_t nof_ttis    = 20000;
+static const uint32_t nof_runs    = 5;
+static const uint32_t nof_cells   = 2;
+static const uint16_t rnti        = 0x46;
+static const uint16_t rnti_tmp    = 0x47;
+
+static srsenb::phy_cell_cfg_list_t make_cell_cfg_list()
+{
+  srsenb::phy_cell_cfg_list_t cell_cfg_list(nof_cells);
+  for (uint32_t i = 0; i < nof_cells; i++) {
+    cell_cfg_list[i]              = {};
+    cell_cfg_list[i].cell.nof_prb = 25;
+    cell_cfg_list[i].cell.id      = i;
+    cell_cfg_list[i].cell_id      = i;
+  }
+  return cell_cfg_list;
+}
+
+// The configuration version is carried in n_pucch_sr so the readers can tell which one they see
+static srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t make_ue_cfg(uint16_t ue_rnti, uint32_t version)
+{
+  srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t phy_cfg_list(nof_cells);
+  for (uint32_t i = 0; i < nof_cells; i++) {
+    phy_cfg_list[i].configured = true;
+    phy_cfg_list[i].enb_cc_idx = i;
+    phy_cfg_list[i].phy_cfg.set_defaults();
+    phy_cfg_list[i].phy_cfg.ul_cfg.pucch.rnti       = ue_rnti;
+    phy_cfg_list[i].phy_cfg.ul_cfg.pucch.n_pucch_sr = version;
+  }
+  return phy_cfg_list;
+}
+
+typedef srsenb::phy_ue_db::snapshot_t snapshot_t;
+
+/*
+ * Lookups of a worker through a snapshot taken at the start of each TTI, without locking
+ */
+class snapshot_access
+{
+public:
+  static const bool consistent_tti = true;
+
+  struct shared_t {
+    explicit shared_t(srsenb::phy_ue_db& ue_db_) : ue_db(ue_db_) {}
+    srsenb::phy_ue_db& ue_db;
+  };
+
+  explicit snapshot_access(shared_t& shared_) : shared(shared_) {}
+  void new_tti() { tti_ue_db = shared.ue_db.get_snapshot(); }
+  template <class F>
+  auto lookup(F f) -> decltype(f(std::declval<snapshot_t&>()))
+  {
+    return f(tti_ue_db);
+  }
+  template <class F>
+  static void modify(shared_t& shared, F f)
+  {
+    f(shared.ue_db);
+  }
+
+private:
+  shared_t&  shared;
+  snapshot_t tti_ue_db;
+};
+
+/*
+ * Baseline of the database before the snapshots: every lookup and every modification takes the same mutex, and a
+ * TTI may see several configurations
+ */
+class mutex_access
+{
+public:
+  static const bool consistent_tti = false;
+
+  struct shared_t {
+    explicit shared_t(srsenb::phy_ue_db& ue_db_) : ue_db(ue_db_), current(ue_db_.get_snapshot()) {}
+    srsenb::phy_ue_db& ue_db;
+    snapshot_t         current;
+    std::mutex         mutex;
+  };
+
+  explicit mutex_access(shared_t& shared_) : shared(shared_) {}
+  void new_tti() {}
+  template <class F>
+  auto lookup(F f) -> decltype(f(std::declval<snapshot_t&>()))
+  {
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    return f(shared.current);
+  }
+  template <class F>
+  static void modify(shared_t& shared, F f)
+  {
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    f(shared.ue_db);
+    shared.current = shared.ue_db.get_snapshot();
+  }
+
+private:
+  shared_t& shared;
+};
+
+/*
+ * Reads the database as a PHY worker does: the configuration lookups of a TTI and the UL grant, UL transport block and
+ * ACK bookkeeping of that TTI
+ */
+template <class access_t>
+static int worker_thread(typename access_t::shared_t& shared, uint32_t worker_idx, std::atomic<uint32_t>& nof_lookups)
+{
+  access_t access(shared);
+  uint32_t last_version = 0;
+
+  srsenb::stack_interface_phy_lte::ul_sched_list_t ul_sched_list(nof_cells);
+  for (srsenb::stack_interface_phy_lte::ul_sched_t& ul_sched : ul_sched_list) {
+    ul_sched            = {};
+    ul_sched.nof_grants = 0;
+  }
+  ul_sched_list[0].nof_grants        = 1;
+  ul_sched_list[0].pusch[0].dci.rnti = rnti;
+
+  for (uint32_t tti = worker_idx; tti < nof_ttis; tti += nof_workers) {
+    access.new_tti();
+
+    access.lookup([tti](snapshot_t& s) { s.clear_tti_pending_ack(tti); });
+    access.lookup([tti, &ul_sched_list](snapshot_t& s) { s.set_ul_grant_available(tti, ul_sched_list); });
+
+    // The configuration never goes back in time, with snapshots it does not change within a TTI either
+    TESTASSERT(access.lookup([](snapshot_t& s) { return s.is_pcell(rnti, 0); }));
+    uint32_t version = access.lookup([](snapshot_t& s) { return s.get_ul_config(rnti, 0).pucch.n_pucch_sr; });
+    TESTASSERT(version >= last_version);
+    uint32_t version2 = access.lookup([](snapshot_t& s) { return s.get_ul_config(rnti, 0).pucch.n_pucch_sr; });
+    TESTASSERT(version2 == version or (not access_t::consistent_tti and version2 > version));
+    last_version = version2;
+
+    // The SCell keeps the configuration it was added with
+    TESTASSERT(access.lookup([](snapshot_t& s) { return s.get_ul_config(rnti, 1).pucch.n_pucch_sr; }) == 1);
+
+    // The lookups of the PDCCH, PDSCH and PUSCH of the UE in each cell
+    for (uint32_t cc = 0; cc < nof_cells; cc++) {
+      TESTASSERT(access.lookup([cc](snapshot_t& s) { return s.is_pcell(rnti, cc); }) == (cc == 0));
+      access.lookup([cc](snapshot_t& s) { return s.get_dci_dl_config(rnti, cc); });
+      access.lookup([cc](snapshot_t& s) { return s.get_dci_ul_config(rnti, cc); });
+      access.lookup([cc](snapshot_t& s) { return s.get_dl_config(rnti, cc); });
+    }
+
+    // The per-TTI state is kept across snapshots, this worker wrote the previous TB of the HARQ process
+    uint32_t pid = tti % SRSLTE_FDD_NOF_HARQ;
+    if (tti >= SRSLTE_FDD_NOF_HARQ) {
+      TESTASSERT(access.lookup([pid](snapshot_t& s) { return s.get_last_ul_tb(rnti, 0, pid).tbs; }) ==
+                 (int)(tti - SRSLTE_FDD_NOF_HARQ));
+    }
+    srslte_ra_tb_t tb = {};
+    tb.tbs            = tti;
+    access.lookup([pid, &tb](snapshot_t& s) { s.set_last_ul_tb(rnti, 0, pid, tb); });
+
+    nof_lookups += 8 + 4 * nof_cells;
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Runs the workers against a writer reconfiguring the UEs, returns the lookup rate in lookups/s or 0 on failure
+ */
+template <class access_t>
+static double run_concurrent_readers(const char* name)
+{
+  srsenb::phy_args_t                phy_args      = {};
+  const srsenb::phy_cell_cfg_list_t cell_cfg_list = make_cell_cfg_list();
+  srsenb::phy_ue_db                 ue_db;
+  ue_db.init(nullptr, phy_args, cell_cfg_list);
+  ue_db.addmod_rnti(rnti, make_ue_cfg(rnti, 1));
+  ue_db.complete_config(rnti);
+  ue_db.activate_deactivate_scell(rnti, 1, true);
+
+  typename access_t::shared_t shared(ue_db);
+  std::atomic<bool>           running(true);
+  std::atomic<uint32_t>       nof_lookups(0);
+  std::atomic<uint32_t>       nof_errors(0);
+
+  // The stack keeps reconfiguring the UE and adding and removing another one while the workers run
+  uint32_t    nof_versions = 1;
+  std::thread writer([&]() {
+    while (running) {
+      nof_versions++;
+      access_t::modify(shared, [nof_versions](srsenb::phy_ue_db& db) {
+        db.addmod_rnti(rnti, make_ue_cfg(rnti, nof_versions));
+        db.complete_config(rnti);
+        if (nof_versions % 2 == 0) {
+          db.addmod_rnti(rnti_tmp, make_ue_cfg(rnti_tmp, nof_versions));
+        } else {
+          db.rem_rnti(rnti_tmp);
+        }
+      });
+      std::this_thread::yield();
+    }
+  });
+
+  auto                     t_start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    workers.emplace_back([&shared, i, &nof_lookups, &nof_errors]() {
+      if (worker_thread<access_t>(shared, i, nof_lookups) != SRSLTE_SUCCESS) {
+        nof_errors++;
+      }
+    });
+  }
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  auto t_end = std::chrono::steady_clock::now();
+
+  running = false;
+  writer.join();
+
+  if (nof_errors != 0 or ue_db.get_snapshot().get_ul_config(rnti, 0).pucch.n_pucch_sr != nof_versions) {
+    return 0;
+  }
+
+  double elapsed_s = std::chrono::duration_cast<std::chrono::duration<double> >(t_end - t_start).count();
+  double rate      = nof_lookups / elapsed_s;
+  printf("%-8s %d workers: %d TTIs, %d configuration versions, %.2f M lookups/s\n",
+         name,
+         nof_workers,
+         nof_ttis,
+         nof_versions,
+         rate / 1e6);
+
+  return rate;
+}
+
+int test_concurrent_readers()
+{
+  // The rates are informative only, the comparison depends on the scheduling of the host
+  double mutex_rate    = 0;
+  double snapshot_rate = 0;
+  for (uint32_t i = 0; i < nof_runs; i++) {
+    double rate = run_concurrent_readers<mutex_access>("mutex");
+    TESTASSERT(rate > 0);
+    mutex_rate = std::max(mutex_rate, rate);
+
+    rate = run_concurrent_readers<snapshot_access>("snapshot");
+    TESTASSERT(rate > 0);
+    snapshot_rate = std::max(snapshot_rate, rate);
+  }
+  printf("snapshot/mutex lookup rate: %.2f\n", snapshot_rate / mutex_rate);
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * A snapshot keeps the version it was taken from, while the per-TTI state is shared by all the versions of a UE
+ */
+int test_snapshot_isolation()
+{
+  srsenb::phy_args_t                phy_args      = {};
+  const srsenb::phy_cell_cfg_list_t cell_cfg_list = make_cell_cfg_list();
+  srsenb::phy_ue_db                 ue_db;
+  ue_db.init(nullptr, phy_args, cell_cfg_list);
+  ue_db.addmod_rnti(rnti, make_ue_cfg(rnti, 1));
+  ue_db.complete_config(rnti);
+  snapshot_t snapshot1 = ue_db.get_snapshot();
+
+  ue_db.addmod_rnti(rnti, make_ue_cfg(rnti, 2));
+  ue_db.complete_config(rnti);
+  ue_db.addmod_rnti(rnti_tmp, make_ue_cfg(rnti_tmp, 2));
+  snapshot_t snapshot2 = ue_db.get_snapshot();
+
+  ue_db.rem_rnti(rnti);
+  snapshot_t snapshot3 = ue_db.get_snapshot();
+
+  // The older snapshots are not affected by the later modifications, not even by the removal of the UE
+  TESTASSERT(snapshot1.get_ul_config(rnti, 0).pucch.n_pucch_sr == 1);
+  TESTASSERT(not snapshot1.is_pcell(rnti_tmp, 0));
+  TESTASSERT(snapshot2.get_ul_config(rnti, 0).pucch.n_pucch_sr == 2);
+  TESTASSERT(snapshot2.is_pcell(rnti_tmp, 0));
+  TESTASSERT(not snapshot3.is_pcell(rnti, 0));
+  TESTASSERT(snapshot3.is_pcell(rnti_tmp, 0));
+
+  // The UL transport blocks written through a version are seen through the others
+  srslte_ra_tb_t tb = {};
+  tb.tbs            = 1234;
+  snapshot1.set_last_ul_tb(rnti, 0, 3, tb);
+  TESTASSERT(snapshot2.get_last_ul_tb(rnti, 0, 3).tbs == 1234);
+
+  // A UE added again starts from a clean state
+  ue_db.addmod_rnti(rnti, make_ue_cfg(rnti, 3));
+  snapshot_t snapshot4 = ue_db.get_snapshot();
+  TESTASSERT(snapshot4.get_ul_config(rnti, 0).pucch.n_pucch_sr == 3);
+  TESTASSERT(snapshot4.get_last_ul_tb(rnti, 0, 3).tbs == 0);
+  TESTASSERT(snapshot1.get_last_ul_tb(rnti, 0, 3).tbs == 1234);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_snapshot_isolation() == SRSLTE_SUCCESS);
+  TESTASSERT(test_concurrent_readers() == SRSLTE_SUCCESS);
+
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -28,13 +28,21 @@
 #ifndef SRSEPC_HSS_H
 #define SRSEPC_HSS_H
 
+#include "srsepc/hdr/hss/hss_db.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/log.h"
 #include "srslte/common/log_filter.h"
+#include "srslte/common/security.h"
+#include "srslte/common/thread_pool.h"
 #include "srslte/interfaces/epc_interfaces.h"
+#include <array>
 #include <cstddef>
+#include <deque>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <random>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -47,9 +55,17 @@ typedef struct {
   std::string db_file;
   uint16_t    mcc;
   uint16_t    mnc;
+  uint32_t    av_cache_size;  // Milenage authentication vectors precomputed per UE, 0 disables the cache
+  uint32_t    av_nof_workers; // Threads refilling the caches
 } hss_args_t;
 
-enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
+typedef struct {
+  uint8_t sqn[6];
+  uint8_t rand[16];
+  uint8_t xres[8];
+  uint8_t autn[16];
+  uint8_t k_asme[32];
+} hss_auth_vector_t;
 
 typedef struct {
   // Members
@@ -66,6 +82,14 @@ typedef struct {
   uint8_t            last_rand[16];
   std::string        static_ip_addr;
 
+  // Precomputed authentication vectors (Milenage only), for consecutive SQNs starting at sqn. Protected by the HSS
+  // av_mutex, as they are refilled by the HSS workers
+  srslte::aes_128_key           k_aes; // Key schedule of key, expanded once
+  std::deque<hss_auth_vector_t> av_cache;
+  bool                          av_refill_pending = false;
+
+  hss_db_record_t* db_record = nullptr; // Record in the binary database, where the SQN is kept up to date
+
   // Helper getters/setters
   void set_sqn(const uint8_t* sqn_);
   void set_last_rand(const uint8_t* rand_);
@@ -100,24 +124,27 @@ private:
        gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
   void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
 
+  void gen_auth_vector_milenage(hss_ue_ctx_t* ue_ctx, const uint8_t* sqn, hss_auth_vector_t* av);
+  bool pop_cached_auth_vector(hss_ue_ctx_t* ue_ctx, hss_auth_vector_t* av);
+  void refill_auth_vectors(hss_ue_ctx_t* ue_ctx);
+
   void resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
   void resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
 
-  std::vector<std::string> split_string(const std::string& str, char delimiter);
-  void                     get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len);
-
   void increment_ue_sqn(hss_ue_ctx_t* ue_ctx);
+  void store_ue_sqn(hss_ue_ctx_t* ue_ctx);
   void increment_seq_after_resync(hss_ue_ctx_t* ue_ctx);
-  void increment_sqn(uint8_t* sqn, uint8_t* next_sqn);
+  void increment_sqn(const uint8_t* sqn, uint8_t* next_sqn);
 
   bool          set_auth_algo(std::string auth_algo);
   bool          read_db_file(std::string db_file);
   bool          write_db_file(std::string db_file);
   hss_ue_ctx_t* get_ue_ctx(uint64_t imsi);
-
-  std::string hex_string(uint8_t* hex, int size);
+  hss_ue_ctx_t* add_ue_ctx(const hss_db_record_t& rec);
+  bool          add_static_ip_addr(const hss_db_record_t& rec);
 
   std::string db_file;
+  hss_db      m_db;
 
   /*Logs*/
   srslte::log_filter* m_hss_log;
@@ -126,6 +153,15 @@ private:
   uint16_t mnc;
 
   std::map<std::string, uint64_t> m_ip_to_imsi;
+
+  // Source of the RAND of the authentication vectors, non-deterministic (e.g. /dev/urandom)
+  std::random_device rand_dev;
+  std::mutex         rand_mutex;
+
+  // Authentication vector precomputation. The vectors are popped by the MME thread and refilled by the workers
+  uint32_t                                  av_cache_size = 0;
+  std::mutex                                av_mutex;
+  std::unique_ptr<srslte::task_thread_pool> av_workers;
 };
 
 inline void hss_ue_ctx_t::set_sqn(const uint8_t* sqn_)
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_db.h
+ * Description: HSS subscriber database. Reads and writes the CSV user
+ *              database and implements a binary, memory-mapped store
+ *              indexed by IMSI, with in-place SQN updates.
+ *****************************************************************************/
+
+#ifndef SRSEPC_HSS_DB_H
+#define SRSEPC_HSS_DB_H
+
+#include "srslte/common/log.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace srsepc {
+
+enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
+
+/// One subscriber, as stored in the binary database. Plain data with a fixed layout
+struct hss_db_record_t {
+  uint64_t imsi;
+  char     name[64]; // Null terminated, longer names are truncated
+  uint8_t  key[16];
+  uint8_t  op[16];
+  uint8_t  opc[16];
+  uint8_t  sqn[6];
+  uint8_t  amf[2];
+  uint8_t  algo; // hss_auth_algo
+  uint8_t  op_configured;
+  uint16_t qci;
+  uint32_t static_ip_addr; // IPv4 address in network byte order, 0 for dynamic allocation
+};
+
+/// Parse a CSV user database ("Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc" per line)
+bool hss_db_read_csv(const std::string& filename, std::vector<hss_db_record_t>* records, srslte::log* log);
+bool hss_db_write_csv(const std::string& filename, const std::vector<hss_db_record_t>& records, srslte::log* log);
+
+/**
+ * Memory-mapped subscriber database.
+ *
+ * The file holds a header, the records and an open addressing hash table on the IMSI, so opening it only maps the
+ * file and a lookup touches one or two pages. SQN updates are written in place in the mapping and flushed to disk by
+ * the kernel, instead of rewriting the whole database. The file is created from the records of a CSV database with
+ * create(), e.g. by the srsepc_hss_db tool.
+ */
+class hss_db
+{
+public:
+  hss_db() = default;
+  ~hss_db();
+  hss_db(const hss_db&) = delete;
+  hss_db& operator=(const hss_db&) = delete;
+
+  static bool create(const std::string& filename, const std::vector<hss_db_record_t>& records, srslte::log* log);
+
+  /// Whether the file is a binary database, as opposed to a CSV one
+  static bool is_db_file(const std::string& filename);
+
+  bool open(const std::string& filename, srslte::log* log);
+  void close();
+  bool is_open() const { return base != nullptr; }
+
+  /// Flush the SQN updates to disk
+  void sync();
+
+  hss_db_record_t* find(uint64_t imsi);
+
+  uint64_t         nof_records() const;
+  hss_db_record_t* get_record(uint64_t idx);
+
+  /// Records of the UEs with a static IP address, without going through the whole database
+  std::vector<hss_db_record_t*> get_static_ip_records();
+
+private:
+  struct header_t;
+
+  header_t*        hdr       = nullptr;
+  hss_db_record_t* records   = nullptr;
+  uint32_t*        index     = nullptr;
+  uint32_t*        static_ip = nullptr;
+  uint8_t*         base      = nullptr;
+  size_t           size      = 0;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_HSS_DB_H
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSEPC_CTX_TABLE_H
+#define SRSEPC_CTX_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace srsepc {
+
+/**
+ * Open addressing hash table for the MME context lookups (IMSI, MME UE S1AP Id, M-TMSI, eNB association).
+ *
+ * Linear probing on a power-of-two table kept at most half full, with backward shift deletion so that no tombstones
+ * accumulate as UEs attach and detach. Lookups hash the integer key once and usually hit the first slot, instead of
+ * walking a tree of heap nodes. The tables store the context pointers, which are the stable handles to the contexts:
+ * the value slots themselves move when the table grows or an entry is erased.
+ */
+template <typename Key, typename T>
+class ctx_table
+{
+public:
+  explicit ctx_table(uint32_t initial_capacity = 64) { rehash(initial_capacity); }
+
+  /// Returns nullptr if the key is not present. The pointer is invalidated by the next insert or erase
+  T* find(Key key)
+  {
+    uint32_t i = slot_of(key);
+    for (; slots[i].used; i = (i + 1) & mask) {
+      if (slots[i].key == key) {
+        return &slots[i].value;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Returns false, without modifying the table, if the key is already present
+  bool insert(Key key, T value)
+  {
+    if (find(key) != nullptr) {
+      return false;
+    }
+    if (2 * (count + 1) > slots.size()) {
+      rehash(2 * slots.size());
+    }
+    uint32_t i = slot_of(key);
+    while (slots[i].used) {
+      i = (i + 1) & mask;
+    }
+    slots[i].key   = key;
+    slots[i].value = std::move(value);
+    slots[i].used  = true;
+    count++;
+    return true;
+  }
+
+  bool erase(Key key)
+  {
+    uint32_t i = slot_of(key);
+    while (slots[i].used and slots[i].key != key) {
+      i = (i + 1) & mask;
+    }
+    if (not slots[i].used) {
+      return false;
+    }
+    // Move back the following entries of the probe sequence that would no longer be reachable
+    for (uint32_t j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+      uint32_t home = slot_of(slots[j].key);
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        slots[i] = std::move(slots[j]);
+        i        = j;
+      }
+    }
+    slots[i].used  = false;
+    slots[i].value = T();
+    count--;
+    return true;
+  }
+
+  /// Calls f(key, value) for every entry. The table must not be modified by f
+  template <typename F>
+  void for_each(F&& f)
+  {
+    for (slot_t& s : slots) {
+      if (s.used) {
+        f(s.key, s.value);
+      }
+    }
+  }
+
+  void clear()
+  {
+    for (slot_t& s : slots) {
+      s = slot_t();
+    }
+    count = 0;
+  }
+
+  size_t size() const { return count; }
+  bool   empty() const { return count == 0; }
+
+private:
+  struct slot_t {
+    Key  key   = Key();
+    T    value = T();
+    bool used  = false;
+  };
+
+  uint32_t slot_of(Key key) const
+  {
+    return (uint32_t)(((uint64_t)key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+  }
+
+  void rehash(size_t capacity)
+  {
+    size_t new_size = 16;
+    while (new_size < capacity) {
+      new_size *= 2;
+    }
+    std::vector<slot_t> old_slots(new_size);
+    std::swap(old_slots, slots);
+    mask  = new_size - 1;
+    count = 0;
+    for (slot_t& s : old_slots) {
+      if (s.used) {
+        insert(s.key, std::move(s.value));
+      }
+    }
+  }
+
+  std::vector<slot_t> slots;
+  uint32_t            mask  = 0;
+  size_t              count = 0;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_CTX_TABLE_H
@@ -28,6 +28,7 @@
 #ifndef SRSEPC_MME_H
 #define SRSEPC_MME_H
 
+#include "mme_timer_wheel.h"
 #include "s1ap.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/log.h"
@@ -43,12 +44,6 @@ typedef struct {
   // gtpc_args_t gtpc_args;
 } mme_args_t;
 
-typedef struct {
-  int                 fd;
-  uint64_t            imsi;
-  enum nas_timer_type type;
-} mme_timer_t;
-
 class mme : public srslte::thread, public mme_interface_nas
 {
 public:
@@ -64,7 +59,7 @@ public:
   void run_thread();
 
   // Timer Methods
-  virtual bool add_nas_timer(int timer_fd, enum nas_timer_type type, uint64_t imsi);
+  virtual bool add_nas_timer(uint32_t timeout_ms, enum nas_timer_type type, uint64_t imsi);
   virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi);
   virtual bool remove_nas_timer(enum nas_timer_type type, uint64_t imsi);
 
@@ -77,13 +72,16 @@ private:
 
   bool                      m_running;
   srslte::byte_buffer_pool* m_pool;
-  fd_set                    m_set;
+  int                       m_epoll_fd = -1;
 
-  // Timer map
-  std::vector<mme_timer_t> timers;
+  // NAS timers
+  mme_timer_wheel          m_timers;
+  std::vector<mme_timer_t> m_expired_timers;
 
-  // Timer Methods
-  void handle_timer_expire(int timer_fd);
+  // Event loop
+  bool add_epoll_fd(int fd);
+  void handle_s1_mme(int s1mme, srslte::byte_buffer_t* pdu);
+  void handle_timers();
 
   // Logs
   srslte::log_filter* m_nas_log;
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#ifndef SRSEPC_MME_TIMER_WHEEL_H
+#define SRSEPC_MME_TIMER_WHEEL_H
+
+#include "ctx_table.h"
+#include "srslte/interfaces/epc_interfaces.h"
+#include <vector>
+
+namespace srsepc {
+
+typedef struct {
+  uint64_t            imsi;
+  enum nas_timer_type type;
+} mme_timer_t;
+
+/**
+ * Hashed timer wheel for the NAS timers of the MME.
+ *
+ * All the timers share one timerfd, which ticks every tick_ms while any timer is running, instead of one timerfd per
+ * timer that has to be polled. A timer is put in the slot of its expiry tick, timers more than one turn of the wheel
+ * away stay in their slot until their turn comes. Removed timers are only dropped from the lookup table, their slot
+ * entries are discarded when the slot is visited.
+ */
+class mme_timer_wheel
+{
+public:
+  explicit mme_timer_wheel(uint32_t tick_ms_ = 10, uint32_t nof_slots_ = 512);
+  ~mme_timer_wheel();
+
+  int  init();
+  void stop();
+  int  get_fd() const { return m_fd; }
+
+  /// Returns false if a timer of this type is already running for the IMSI
+  bool   add(uint32_t timeout_ms, enum nas_timer_type type, uint64_t imsi);
+  bool   is_running(enum nas_timer_type type, uint64_t imsi);
+  bool   remove(enum nas_timer_type type, uint64_t imsi);
+  size_t size() const { return m_running.size(); }
+
+  /// Reads the timerfd and advances the wheel by the elapsed ticks, appending the expired timers
+  void handle_tick(std::vector<mme_timer_t>* expired);
+
+  /// Advances the wheel by nof_ticks, appending the expired timers
+  void advance(uint64_t nof_ticks, std::vector<mme_timer_t>* expired);
+
+private:
+  struct entry_t {
+    uint64_t    id;
+    uint64_t    expiry_tick;
+    mme_timer_t timer;
+  };
+
+  static uint64_t timer_key(enum nas_timer_type type, uint64_t imsi) { return (imsi << 8u) | (uint64_t)type; }
+  void            arm(bool enable);
+
+  uint32_t                           m_tick_ms;
+  uint32_t                           m_mask;
+  int                                m_fd       = -1;
+  uint64_t                           m_cur_tick = 0;
+  uint64_t                           m_next_id  = 0;
+  std::vector<std::vector<entry_t> > m_slots;
+  ctx_table<uint64_t, uint64_t>      m_running; // timer key -> id of its entry
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_MME_TIMER_WHEEL_H
@@ -21,6 +21,7 @@
 #ifndef SRSEPC_S1AP_H
 #define SRSEPC_S1AP_H
 
+#include "ctx_table.h"
 #include "mme_gtpc.h"
 #include "nas.h"
 #include "s1ap_ctx_mngmt_proc.h"
@@ -34,9 +35,13 @@
 #include "srslte/common/common.h"
 #include "srslte/common/log.h"
 #include "srslte/common/s1ap_pcap.h"
+#include "srslte/common/thread_pool.h"
 #include "srslte/interfaces/epc_interfaces.h"
 #include <arpa/inet.h>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <netinet/sctp.h>
 #include <set>
 #include <strings.h>
@@ -66,6 +71,12 @@ public:
 
   bool s1ap_tx_pdu(const s1ap_pdu_t& pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri);
+  void handle_s1ap_pdu(const s1ap_pdu_t& rx_pdu, struct sctp_sndrcvinfo* enb_sri);
+  void handle_sctp_shutdown(int32_t assoc_id);
+
+  // PDUs decoded by the S1AP workers. The notification fd is readable while there are PDUs to handle
+  int  get_rx_notify_fd() const { return m_rx_notify_fd; }
+  void handle_decoded_pdus();
   void handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri);
   void handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg);
 
@@ -103,7 +114,7 @@ public:
   s1ap_ctx_mngmt_proc* m_s1ap_ctx_mngmt_proc;
   s1ap_paging*         m_s1ap_paging;
 
-  std::map<uint32_t, uint64_t>   m_tmsi_to_imsi;
+  ctx_table<uint32_t, uint64_t>  m_tmsi_to_imsi;
   std::map<uint16_t, enb_ctx_t*> m_active_enbs;
 
   // Interfaces
@@ -128,11 +139,11 @@ private:
 
   hss_interface_nas*                     m_hss;
   int                                    m_s1mme;
-  std::map<int32_t, uint16_t>            m_sctp_to_enb_id;
-  std::map<int32_t, std::set<uint32_t> > m_enb_assoc_to_ue_ids;
+  std::map<int32_t, uint16_t>             m_sctp_to_enb_id;
+  ctx_table<int32_t, std::set<uint32_t> > m_enb_assoc_to_ue_ids;
 
-  std::map<uint64_t, nas*> m_imsi_to_nas_ctx;
-  std::map<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
+  ctx_table<uint64_t, nas*> m_imsi_to_nas_ctx;
+  ctx_table<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
 
   uint32_t m_next_mme_ue_s1ap_id;
   uint32_t m_next_m_tmsi;
@@ -143,6 +154,22 @@ private:
   // PCAP
   bool              m_pcap_enable;
   srslte::s1ap_pcap m_pcap;
+
+  // S1AP workers. The PDUs of an eNB association are always decoded by the same worker, and handed back to the MME
+  // thread in the order they were received. A PDU without buffer stands for the shutdown of the association
+  struct rx_pdu_t {
+    srslte::unique_byte_buffer_t buf;
+    s1ap_pdu_t                   pdu;
+    bool                         decoded = false;
+    struct sctp_sndrcvinfo       sri     = {};
+  };
+  void push_rx_pdu(std::shared_ptr<rx_pdu_t> rx_pdu);
+  void handle_rx_pdu(rx_pdu_t& rx_pdu);
+
+  std::vector<std::unique_ptr<srslte::task_thread_pool> > m_workers;
+  std::mutex                                              m_rx_mutex;
+  std::deque<std::shared_ptr<rx_pdu_t> >                  m_rx_pdus;
+  int                                                     m_rx_notify_fd = -1;
 };
 
 inline uint32_t s1ap::get_plmn()
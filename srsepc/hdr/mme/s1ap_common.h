@@ -49,6 +49,7 @@ typedef struct {
   std::string                         pcap_filename;
   srslte::CIPHERING_ALGORITHM_ID_ENUM encryption_algo;
   srslte::INTEGRITY_ALGORITHM_ID_ENUM integrity_algo;
+  uint32_t                            nof_workers; // S1AP decoding threads, 0 decodes in the MME thread
 } s1ap_args_t;
 
 typedef struct {
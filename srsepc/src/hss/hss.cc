@@ -20,12 +20,10 @@
  */
 #include "srsepc/hdr/hss/hss.h"
 #include "srslte/common/security.h"
+#include <algorithm>
+#include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
-#include <iomanip>
-#include <sstream>
-#include <stdlib.h> /* srand, rand */
 #include <string>
-#include <time.h>
 
 namespace srsepc {
 
@@ -64,7 +62,6 @@ void hss::cleanup()
 
 int hss::init(hss_args_t* hss_args, srslte::log_filter* hss_log)
 {
-  srand(time(NULL));
   /*Init loggers*/
   m_hss_log = hss_log;
 
@@ -79,6 +76,19 @@ int hss::init(hss_args_t* hss_args, srslte::log_filter* hss_log)
 
   db_file = hss_args->db_file;
 
+  // Precompute the first authentication vectors of every Milenage UE in the background
+  av_cache_size = hss_args->av_cache_size;
+  if (av_cache_size > 0) {
+    av_workers.reset(new srslte::task_thread_pool(std::max(hss_args->av_nof_workers, 1u)));
+    av_workers->start();
+    for (auto& ue_ctx_it : m_imsi_to_ue_ctx) {
+      refill_auth_vectors(ue_ctx_it.second.get());
+    }
+    m_hss_log->info("Caching %d authentication vectors per UE, refilled by %zu workers\n",
+                    av_cache_size,
+                    av_workers->nof_workers());
+  }
+
   m_hss_log->info("HSS Initialized. DB file %s, MCC: %d, MNC: %d\n", hss_args->db_file.c_str(), mcc, mnc);
   srslte::console("HSS Initialized.\n");
   return 0;
@@ -86,171 +96,120 @@ int hss::init(hss_args_t* hss_args, srslte::log_filter* hss_log)
 
 void hss::stop()
 {
-  write_db_file(db_file);
+  if (av_workers != nullptr) {
+    av_workers->stop();
+  }
+  // The SQNs of a binary database are updated in place
+  if (m_db.is_open()) {
+    m_db.close();
+  } else {
+    write_db_file(db_file);
+  }
   return;
 }
 
 bool hss::read_db_file(std::string db_filename)
 {
-  std::ifstream m_db_file;
-
-  m_db_file.open(db_filename.c_str(), std::ifstream::in);
-  if (!m_db_file.is_open()) {
-    return false;
-  }
-  m_hss_log->info("Opened DB file: %s\n", db_filename.c_str());
-
-  std::string line;
-  while (std::getline(m_db_file, line)) {
-    if (line[0] != '#' && line.length() > 0) {
-      uint                     column_size = 10;
-      std::vector<std::string> split       = split_string(line, ',');
-      if (split.size() != column_size) {
-        m_hss_log->error("Error parsing UE database. Wrong number of columns in .csv\n");
-        m_hss_log->error("Columns: %zd, Expected %d.\n", split.size(), column_size);
-
-        srslte::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
-        srslte::console("Perhaps you are using an old user_db.csv?\n");
-        srslte::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
-        return false;
-      }
-      std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
-      ue_ctx->name                         = split[0];
-      if (split[1] == std::string("xor")) {
-        ue_ctx->algo = HSS_ALGO_XOR;
-      } else if (split[1] == std::string("mil")) {
-        ue_ctx->algo = HSS_ALGO_MILENAGE;
-      } else {
-        m_hss_log->error("Neither XOR nor MILENAGE configured.\n");
-        return false;
-      }
-      ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
-      get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
-      if (split[4] == std::string("op")) {
-        ue_ctx->op_configured = true;
-        get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
-        srslte::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
-      } else if (split[4] == std::string("opc")) {
-        ue_ctx->op_configured = false;
-        get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
-      } else {
-        m_hss_log->error("Neither OP nor OPc configured.\n");
+  // A binary database is only mapped, the UE contexts are created when the UEs are first accessed
+  if (hss_db::is_db_file(db_filename)) {
+    if (not m_db.open(db_filename, m_hss_log)) {
+      return false;
+    }
+    for (hss_db_record_t* rec : m_db.get_static_ip_records()) {
+      if (not add_static_ip_addr(*rec)) {
         return false;
       }
-      get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
-      get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
-
-      m_hss_log->debug("Added user from DB, IMSI: %015" PRIu64 "\n", ue_ctx->imsi);
-      m_hss_log->debug_hex(ue_ctx->key, 16, "User Key : ");
-      if (ue_ctx->op_configured) {
-        m_hss_log->debug_hex(ue_ctx->op, 16, "User OP : ");
-      }
-      m_hss_log->debug_hex(ue_ctx->opc, 16, "User OPc : ");
-      m_hss_log->debug_hex(ue_ctx->amf, 2, "AMF : ");
-      m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN : ");
-      ue_ctx->qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
-      m_hss_log->debug("Default Bearer QCI: %d\n", ue_ctx->qci);
-
-      if (split[9] == std::string("dynamic")) {
-        ue_ctx->static_ip_addr = "0.0.0.0";
-      } else {
-        char buf[128] = {0};
-        if (inet_pton(AF_INET, split[9].c_str(), buf)) {
-          if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
-            ue_ctx->static_ip_addr = split[9];
-            m_hss_log->info("static ip addr %s\n", ue_ctx->static_ip_addr.c_str());
-          } else {
-            m_hss_log->info("duplicate static ip addr %s\n", split[9].c_str());
-            return false;
-          }
-        } else {
-          m_hss_log->info("invalid static ip addr %s, %s\n", split[9].c_str(), strerror(errno));
-          return false;
-        }
-      }
-      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
     }
+    return true;
   }
 
-  if (m_db_file.is_open()) {
-    m_db_file.close();
+  std::vector<hss_db_record_t> records;
+  if (not hss_db_read_csv(db_filename, &records, m_hss_log)) {
+    return false;
+  }
+  for (const hss_db_record_t& rec : records) {
+    if (rec.static_ip_addr != 0 and not add_static_ip_addr(rec)) {
+      return false;
+    }
+    add_ue_ctx(rec);
   }
-
   return true;
 }
 
 bool hss::write_db_file(std::string db_filename)
 {
-  std::string line;
-  uint8_t     k[16];
-  uint8_t     amf[2];
-  uint8_t     op[16];
-  uint8_t     sqn[6];
-
-  std::ofstream m_db_file;
-
-  m_db_file.open(db_filename.c_str(), std::ofstream::out);
-  if (!m_db_file.is_open()) {
-    return false;
-  }
-  m_hss_log->info("Opened DB file: %s\n", db_filename.c_str());
-
-  // Write comment info
-  m_db_file << "#                                                                                           \n"
-            << "# .csv to store UE's information in HSS                                                     \n"
-            << "# Kept in the following format: \"Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc\"  \n"
-            << "#                                                                                           \n"
-            << "# Name:     Human readable name to help distinguish UE's. Ignored by the HSS                \n"
-            << "# Auth:     Authentication algorithm used by the UE. Valid algorithms are XOR               \n"
-            << "#           (xor) and MILENAGE (mil)                                                        \n"
-            << "# IMSI:     UE's IMSI value                                                                 \n"
-            << "# Key:      UE's key, where other keys are derived from. Stored in hexadecimal              \n"
-            << "# OP_Type:  Operator's code type, either OP or OPc                                          \n"
-            << "# OP/OPc:   Operator Code/Cyphered Operator Code, stored in hexadecimal                     \n"
-            << "# AMF:      Authentication management field, stored in hexadecimal                          \n"
-            << "# SQN:      UE's Sequence number for freshness of the authentication                        \n"
-            << "# QCI:      QoS Class Identifier for the UE's default bearer.                               \n"
-            << "# IP_alloc: IP allocation stratagy for the SPGW.                                            \n"
-            << "#           With 'dynamic' the SPGW will automatically allocate IPs                         \n"
-            << "#           With a valid IPv4 (e.g. '172.16.0.2') the UE will have a statically assigned IP.\n"
-            << "#                                                                                           \n"
-            << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
+  std::vector<hss_db_record_t> records;
+  records.reserve(m_imsi_to_ue_ctx.size());
 
   std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
   while (it != m_imsi_to_ue_ctx.end()) {
-    m_db_file << it->second->name;
-    m_db_file << ",";
-    m_db_file << (it->second->algo == HSS_ALGO_XOR ? "xor" : "mil");
-    m_db_file << ",";
-    m_db_file << std::setfill('0') << std::setw(15) << it->second->imsi;
-    m_db_file << ",";
-    m_db_file << hex_string(it->second->key, 16);
-    m_db_file << ",";
-    if (it->second->op_configured) {
-      m_db_file << "op,";
-      m_db_file << hex_string(it->second->op, 16);
-    } else {
-      m_db_file << "opc,";
-      m_db_file << hex_string(it->second->opc, 16);
-    }
-    m_db_file << ",";
-    m_db_file << hex_string(it->second->amf, 2);
-    m_db_file << ",";
-    m_db_file << hex_string(it->second->sqn, 6);
-    m_db_file << ",";
-    m_db_file << it->second->qci;
-    if (it->second->static_ip_addr != "0.0.0.0") {
-      m_db_file << ",";
-      m_db_file << it->second->static_ip_addr;
-    } else {
-      m_db_file << ",dynamic";
-    }
-    m_db_file << std::endl;
+    hss_db_record_t rec = {};
+    strncpy(rec.name, it->second->name.c_str(), sizeof(rec.name) - 1);
+    rec.imsi          = it->second->imsi;
+    rec.algo          = it->second->algo;
+    rec.op_configured = it->second->op_configured;
+    memcpy(rec.key, it->second->key, 16);
+    memcpy(rec.op, it->second->op, 16);
+    memcpy(rec.opc, it->second->opc, 16);
+    memcpy(rec.amf, it->second->amf, 2);
+    memcpy(rec.sqn, it->second->sqn, 6);
+    rec.qci = it->second->qci;
+    inet_pton(AF_INET, it->second->static_ip_addr.c_str(), &rec.static_ip_addr);
+    records.push_back(rec);
     it++;
   }
-  if (m_db_file.is_open()) {
-    m_db_file.close();
+  return hss_db_write_csv(db_filename, records, m_hss_log);
+}
+
+hss_ue_ctx_t* hss::add_ue_ctx(const hss_db_record_t& rec)
+{
+  std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
+  ue_ctx->name                         = std::string(rec.name, strnlen(rec.name, sizeof(rec.name)));
+  ue_ctx->algo                         = (hss_auth_algo)rec.algo;
+  ue_ctx->imsi                         = rec.imsi;
+  memcpy(ue_ctx->key, rec.key, 16);
+  ue_ctx->k_aes.set_key(ue_ctx->key);
+  ue_ctx->op_configured = rec.op_configured;
+  if (ue_ctx->op_configured) {
+    memcpy(ue_ctx->op, rec.op, 16);
+    srslte::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
+  } else {
+    memcpy(ue_ctx->opc, rec.opc, 16);
+  }
+  memcpy(ue_ctx->amf, rec.amf, 2);
+  memcpy(ue_ctx->sqn, rec.sqn, 6);
+
+  m_hss_log->debug("Added user from DB, IMSI: %015" PRIu64 "\n", ue_ctx->imsi);
+  m_hss_log->debug_hex(ue_ctx->key, 16, "User Key : ");
+  if (ue_ctx->op_configured) {
+    m_hss_log->debug_hex(ue_ctx->op, 16, "User OP : ");
+  }
+  m_hss_log->debug_hex(ue_ctx->opc, 16, "User OPc : ");
+  m_hss_log->debug_hex(ue_ctx->amf, 2, "AMF : ");
+  m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN : ");
+  ue_ctx->qci = rec.qci;
+  m_hss_log->debug("Default Bearer QCI: %d\n", ue_ctx->qci);
+
+  char ip_str[INET_ADDRSTRLEN] = "0.0.0.0";
+  if (rec.static_ip_addr != 0) {
+    inet_ntop(AF_INET, &rec.static_ip_addr, ip_str, sizeof(ip_str));
+  }
+  ue_ctx->static_ip_addr = ip_str;
+
+  hss_ue_ctx_t* ue_ctx_ptr = ue_ctx.get();
+  m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
+  return ue_ctx_ptr;
+}
+
+bool hss::add_static_ip_addr(const hss_db_record_t& rec)
+{
+  char ip_str[INET_ADDRSTRLEN];
+  inet_ntop(AF_INET, &rec.static_ip_addr, ip_str, sizeof(ip_str));
+  if (not m_ip_to_imsi.insert(std::make_pair(std::string(ip_str), rec.imsi)).second) {
+    m_hss_log->info("duplicate static ip addr %s\n", ip_str);
+    return false;
   }
+  m_hss_log->info("static ip addr %s\n", ip_str);
   return true;
 }
 
@@ -274,6 +233,7 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
       break;
   }
   increment_ue_sqn(ue_ctx);
+  refill_auth_vectors(ue_ctx);
   return true;
 }
 
@@ -283,56 +243,121 @@ void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
                                         uint8_t*      rand,
                                         uint8_t*      xres)
 {
-  // Get K, AMF, OPC and SQN
-  uint8_t* k   = ue_ctx->key;
-  uint8_t* amf = ue_ctx->amf;
-  uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
+  hss_auth_vector_t av;
+  if (pop_cached_auth_vector(ue_ctx, &av)) {
+    m_hss_log->debug("Using cached authentication vector -- IMSI: %015" PRIu64 "\n", ue_ctx->imsi);
+  } else {
+    gen_auth_vector_milenage(ue_ctx, ue_ctx->sqn, &av);
+  }
+
+  memcpy(k_asme, av.k_asme, 32);
+  memcpy(autn, av.autn, 16);
+  memcpy(rand, av.rand, 16);
+  memcpy(xres, av.xres, 8);
+
+  m_hss_log->debug_hex(ue_ctx->key, 16, "User Key : ");
+  m_hss_log->debug_hex(ue_ctx->opc, 16, "User OPc : ");
+  m_hss_log->debug_hex(rand, 16, "User Rand : ");
+  m_hss_log->debug_hex(xres, 8, "User XRES: ");
+  m_hss_log->debug_hex(av.sqn, 6, "User SQN : ");
+  m_hss_log->debug("User MCC : %x  MNC : %x \n", mcc, mnc);
+  m_hss_log->debug_hex(k_asme, 32, "User k_asme : ");
+  m_hss_log->debug_hex(autn, 16, "User AUTN: ");
 
+  // Set last RAND
+  ue_ctx->set_last_rand(rand);
+  return;
+}
+
+// Computes the vector of a given SQN. Only reads the static subscriber data, so it can run in the HSS workers
+void hss::gen_auth_vector_milenage(hss_ue_ctx_t* ue_ctx, const uint8_t* sqn, hss_auth_vector_t* av)
+{
   // Temp variables
   uint8_t ck[16];
   uint8_t ik[16];
   uint8_t ak[6];
   uint8_t mac[8];
 
-  gen_rand(rand);
-
-  srslte::security_milenage_f2345(k, opc, rand, xres, ck, ik, ak);
-
-  m_hss_log->debug_hex(k, 16, "User Key : ");
-  m_hss_log->debug_hex(opc, 16, "User OPc : ");
-  m_hss_log->debug_hex(rand, 16, "User Rand : ");
-  m_hss_log->debug_hex(xres, 8, "User XRES: ");
-  m_hss_log->debug_hex(ck, 16, "User CK: ");
-  m_hss_log->debug_hex(ik, 16, "User IK: ");
-  m_hss_log->debug_hex(ak, 6, "User AK: ");
+  memcpy(av->sqn, sqn, 6);
+  gen_rand(av->rand);
 
-  srslte::security_milenage_f1(k, opc, rand, sqn, amf, mac);
-
-  m_hss_log->debug_hex(sqn, 6, "User SQN : ");
-  m_hss_log->debug_hex(mac, 8, "User MAC : ");
+  srslte::security_milenage_f12345(
+      ue_ctx->k_aes, ue_ctx->opc, av->rand, av->sqn, ue_ctx->amf, mac, av->xres, ck, ik, ak);
 
   // Generate K_asme
-  srslte::security_generate_k_asme(ck, ik, ak, sqn, mcc, mnc, k_asme);
-
-  m_hss_log->debug("User MCC : %x  MNC : %x \n", mcc, mnc);
-  m_hss_log->debug_hex(k_asme, 32, "User k_asme : ");
+  srslte::security_generate_k_asme(ck, ik, ak, av->sqn, mcc, mnc, av->k_asme);
 
   // Generate AUTN (autn = sqn ^ ak |+| amf |+| mac)
   for (int i = 0; i < 6; i++) {
-    autn[i] = sqn[i] ^ ak[i];
+    av->autn[i] = av->sqn[i] ^ ak[i];
   }
   for (int i = 0; i < 2; i++) {
-    autn[6 + i] = amf[i];
+    av->autn[6 + i] = ue_ctx->amf[i];
   }
   for (int i = 0; i < 8; i++) {
-    autn[8 + i] = mac[i];
+    av->autn[8 + i] = mac[i];
   }
-  m_hss_log->debug_hex(autn, 16, "User AUTN: ");
+}
 
-  // Set last RAND
-  ue_ctx->set_last_rand(rand);
-  return;
+bool hss::pop_cached_auth_vector(hss_ue_ctx_t* ue_ctx, hss_auth_vector_t* av)
+{
+  std::lock_guard<std::mutex> lock(av_mutex);
+  if (ue_ctx->av_cache.empty()) {
+    return false;
+  }
+  // The cached vectors were generated before a SQN resynchronization
+  if (memcmp(ue_ctx->av_cache.front().sqn, ue_ctx->sqn, 6) != 0) {
+    ue_ctx->av_cache.clear();
+    return false;
+  }
+  *av = ue_ctx->av_cache.front();
+  ue_ctx->av_cache.pop_front();
+  return true;
+}
+
+void hss::refill_auth_vectors(hss_ue_ctx_t* ue_ctx)
+{
+  if (av_workers == nullptr or ue_ctx->algo != HSS_ALGO_MILENAGE) {
+    return;
+  }
+
+  std::array<uint8_t, 6> next_sqn;
+  uint32_t               nof_avs;
+  {
+    std::lock_guard<std::mutex> lock(av_mutex);
+    if (ue_ctx->av_refill_pending or ue_ctx->av_cache.size() > av_cache_size / 2) {
+      return;
+    }
+    if (ue_ctx->av_cache.empty()) {
+      memcpy(next_sqn.data(), ue_ctx->sqn, 6);
+    } else {
+      increment_sqn(ue_ctx->av_cache.back().sqn, next_sqn.data());
+    }
+    nof_avs                   = av_cache_size - ue_ctx->av_cache.size();
+    ue_ctx->av_refill_pending = true;
+  }
+
+  av_workers->push_task([this, ue_ctx, next_sqn, nof_avs](uint32_t worker_id) {
+    std::vector<hss_auth_vector_t> avs(nof_avs);
+    std::array<uint8_t, 6>         sqn = next_sqn;
+    for (hss_auth_vector_t& av : avs) {
+      gen_auth_vector_milenage(ue_ctx, sqn.data(), &av);
+      increment_sqn(sqn.data(), sqn.data());
+    }
+
+    std::lock_guard<std::mutex> lock(av_mutex);
+    ue_ctx->av_refill_pending = false;
+    // Drop the vectors if the cache was flushed by a resynchronization in the meantime and they no longer follow
+    // the cached ones. If the cache is empty they are checked against the UE SQN when popped
+    if (not ue_ctx->av_cache.empty()) {
+      uint8_t expected_sqn[6];
+      increment_sqn(ue_ctx->av_cache.back().sqn, expected_sqn);
+      if (memcmp(expected_sqn, next_sqn.data(), 6) != 0) {
+        return;
+      }
+    }
+    ue_ctx->av_cache.insert(ue_ctx->av_cache.end(), avs.begin(), avs.end());
+  });
 }
 
 void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
@@ -432,13 +457,11 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
 
 bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
-    m_hss_log->info("User not found. IMSI: %015" PRIu64 "\n", imsi);
+  hss_ue_ctx_t* ue_ctx = get_ue_ctx(imsi);
+  if (ue_ctx == nullptr) {
     srslte::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
     return false;
   }
-  const std::unique_ptr<hss_ue_ctx_t>& ue_ctx = ue_ctx_it->second;
   m_hss_log->info("Found User %015" PRIu64 "\n", imsi);
   *qci = ue_ctx->qci;
   return true;
@@ -464,6 +487,14 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   }
 
   increment_seq_after_resync(ue_ctx);
+  store_ue_sqn(ue_ctx);
+
+  // The cached vectors were generated for the old SQN
+  {
+    std::lock_guard<std::mutex> lock(av_mutex);
+    ue_ctx->av_cache.clear();
+  }
+  refill_auth_vectors(ue_ctx);
   return true;
 }
 
@@ -532,9 +563,17 @@ void hss::increment_ue_sqn(hss_ue_ctx_t* ue_ctx)
   increment_sqn(ue_ctx->sqn, ue_ctx->sqn);
   m_hss_log->debug("Incremented SQN  -- IMSI: %015" PRIu64 "\n", ue_ctx->imsi);
   m_hss_log->debug_hex(ue_ctx->sqn, 6, "SQN: ");
+  store_ue_sqn(ue_ctx);
 }
 
-void hss::increment_sqn(uint8_t* sqn, uint8_t* next_sqn)
+void hss::store_ue_sqn(hss_ue_ctx_t* ue_ctx)
+{
+  if (ue_ctx->db_record != nullptr) {
+    memcpy(ue_ctx->db_record->sqn, ue_ctx->sqn, 6);
+  }
+}
+
+void hss::increment_sqn(const uint8_t* sqn, uint8_t* next_sqn)
 {
   // The following SQN incrementation function is implemented according to 3GPP TS 33.102 version 11.5.1 Annex C
   uint64_t seq;
@@ -596,56 +635,29 @@ void hss::increment_seq_after_resync(hss_ue_ctx_t* ue_ctx)
 
 void hss::gen_rand(uint8_t rand_[16])
 {
-  for (int i = 0; i < 16; i++) {
-    rand_[i] = rand() % 256; // Pulls on byte at a time. It's slow, but does not depend on RAND_MAX.
+  // Called from the auth vector workers, the random device is not thread-safe
+  std::lock_guard<std::mutex> lock(rand_mutex);
+  for (int i = 0; i < 16; i += 4) {
+    uint32_t r = rand_dev();
+    memcpy(&rand_[i], &r, 4);
   }
-  return;
 }
 
 hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 {
   std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
-    m_hss_log->info("User not found. IMSI: %015" PRIu64 "\n", imsi);
-    return nullptr;
-  }
-
-  return ue_ctx_it->second.get();
-}
-
-/* Helper functions*/
-std::vector<std::string> hss::split_string(const std::string& str, char delimiter)
-{
-  std::vector<std::string> tokens;
-  std::string              token;
-  std::istringstream       tokenStream(str);
-
-  while (std::getline(tokenStream, token, delimiter)) {
-    tokens.push_back(token);
-  }
-  return tokens;
-}
-
-void hss::get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len)
-{
-  const char* pos = key_str.c_str();
-
-  for (uint count = 0; count < len; count++) {
-    sscanf(pos, "%2hhx", &key[count]);
-    pos += 2;
+  if (ue_ctx_it != m_imsi_to_ue_ctx.end()) {
+    return ue_ctx_it->second.get();
   }
-  return;
-}
 
-std::string hss::hex_string(uint8_t* hex, int size)
-{
-  std::stringstream ss;
-
-  ss << std::hex << std::setfill('0');
-  for (int i = 0; i < size; i++) {
-    ss << std::setw(2) << static_cast<unsigned>(hex[i]);
+  hss_db_record_t* rec = m_db.find(imsi);
+  if (rec == nullptr) {
+    m_hss_log->info("User not found. IMSI: %015" PRIu64 "\n", imsi);
+    return nullptr;
   }
-  return ss.str();
+  hss_ue_ctx_t* ue_ctx = add_ue_ctx(*rec);
+  ue_ctx->db_record    = rec;
+  return ue_ctx;
 }
 
 std::map<std::string, uint64_t> hss::get_ip_to_imsi(void) const
@@ -0,0 +1,436 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srslte/common/standard_streams.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fstream>
+#include <inttypes.h> // for printing uint64_t
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace srsepc {
+
+static_assert(std::is_pod<hss_db_record_t>::value, "HSS DB records are copied as raw memory");
+static_assert(sizeof(hss_db_record_t) == 136, "Changing the HSS DB record layout requires a new DB version");
+
+/******************************************************************************
+ * CSV database
+ *****************************************************************************/
+namespace {
+
+std::vector<std::string> split_string(const std::string& str, char delimiter)
+{
+  std::vector<std::string> tokens;
+  std::string              token;
+  std::istringstream       tokenStream(str);
+
+  while (std::getline(tokenStream, token, delimiter)) {
+    tokens.push_back(token);
+  }
+  return tokens;
+}
+
+void get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len)
+{
+  const char* pos = key_str.c_str();
+
+  for (uint count = 0; count < len; count++) {
+    sscanf(pos, "%2hhx", &key[count]);
+    pos += 2;
+  }
+  return;
+}
+
+std::string hex_string(const uint8_t* hex, int size)
+{
+  std::stringstream ss;
+
+  ss << std::hex << std::setfill('0');
+  for (int i = 0; i < size; i++) {
+    ss << std::setw(2) << static_cast<unsigned>(hex[i]);
+  }
+  return ss.str();
+}
+
+} // namespace
+
+bool hss_db_read_csv(const std::string& filename, std::vector<hss_db_record_t>* records, srslte::log* log)
+{
+  std::ifstream m_db_file;
+
+  m_db_file.open(filename.c_str(), std::ifstream::in);
+  if (!m_db_file.is_open()) {
+    return false;
+  }
+  log->info("Opened DB file: %s\n", filename.c_str());
+
+  std::string line;
+  while (std::getline(m_db_file, line)) {
+    if (line[0] != '#' && line.length() > 0) {
+      uint                     column_size = 10;
+      std::vector<std::string> split       = split_string(line, ',');
+      if (split.size() != column_size) {
+        log->error("Error parsing UE database. Wrong number of columns in .csv\n");
+        log->error("Columns: %zu, Expected %d.\n", split.size(), column_size);
+
+        srslte::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
+        srslte::console("Perhaps you are using an old user_db.csv?\n");
+        srslte::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
+        return false;
+      }
+      hss_db_record_t rec = {};
+      strncpy(rec.name, split[0].c_str(), sizeof(rec.name) - 1);
+      if (split[1] == std::string("xor")) {
+        rec.algo = HSS_ALGO_XOR;
+      } else if (split[1] == std::string("mil")) {
+        rec.algo = HSS_ALGO_MILENAGE;
+      } else {
+        log->error("Neither XOR nor MILENAGE configured.\n");
+        return false;
+      }
+      rec.imsi = strtoull(split[2].c_str(), nullptr, 10);
+      get_uint_vec_from_hex_str(split[3], rec.key, 16);
+      if (split[4] == std::string("op")) {
+        rec.op_configured = true;
+        get_uint_vec_from_hex_str(split[5], rec.op, 16);
+      } else if (split[4] == std::string("opc")) {
+        rec.op_configured = false;
+        get_uint_vec_from_hex_str(split[5], rec.opc, 16);
+      } else {
+        log->error("Neither OP nor OPc configured.\n");
+        return false;
+      }
+      get_uint_vec_from_hex_str(split[6], rec.amf, 2);
+      get_uint_vec_from_hex_str(split[7], rec.sqn, 6);
+      rec.qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
+
+      if (split[9] != std::string("dynamic")) {
+        if (inet_pton(AF_INET, split[9].c_str(), &rec.static_ip_addr) != 1 || rec.static_ip_addr == 0) {
+          log->info("invalid static ip addr %s, %s\n", split[9].c_str(), strerror(errno));
+          return false;
+        }
+      }
+      records->push_back(rec);
+    }
+  }
+
+  if (m_db_file.is_open()) {
+    m_db_file.close();
+  }
+
+  return true;
+}
+
+bool hss_db_write_csv(const std::string& filename, const std::vector<hss_db_record_t>& records, srslte::log* log)
+{
+  std::ofstream m_db_file;
+
+  m_db_file.open(filename.c_str(), std::ofstream::out);
+  if (!m_db_file.is_open()) {
+    return false;
+  }
+  log->info("Opened DB file: %s\n", filename.c_str());
+
+  // Write comment info
+  m_db_file << "#                                                                                           \n"
+            << "# .csv to store UE's information in HSS                                                     \n"
+            << "# Kept in the following format: \"Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc\"  \n"
+            << "#                                                                                           \n"
+            << "# Name:     Human readable name to help distinguish UE's. Ignored by the HSS                \n"
+            << "# Auth:     Authentication algorithm used by the UE. Valid algorithms are XOR               \n"
+            << "#           (xor) and MILENAGE (mil)                                                        \n"
+            << "# IMSI:     UE's IMSI value                                                                 \n"
+            << "# Key:      UE's key, where other keys are derived from. Stored in hexadecimal              \n"
+            << "# OP_Type:  Operator's code type, either OP or OPc                                          \n"
+            << "# OP/OPc:   Operator Code/Cyphered Operator Code, stored in hexadecimal                     \n"
+            << "# AMF:      Authentication management field, stored in hexadecimal                          \n"
+            << "# SQN:      UE's Sequence number for freshness of the authentication                        \n"
+            << "# QCI:      QoS Class Identifier for the UE's default bearer.                               \n"
+            << "# IP_alloc: IP allocation stratagy for the SPGW.                                            \n"
+            << "#           With 'dynamic' the SPGW will automatically allocate IPs                         \n"
+            << "#           With a valid IPv4 (e.g. '172.16.0.2') the UE will have a statically assigned IP.\n"
+            << "#                                                                                           \n"
+            << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
+
+  for (const hss_db_record_t& rec : records) {
+    m_db_file << std::string(rec.name, strnlen(rec.name, sizeof(rec.name)));
+    m_db_file << ",";
+    m_db_file << (rec.algo == HSS_ALGO_XOR ? "xor" : "mil");
+    m_db_file << ",";
+    m_db_file << std::setfill('0') << std::setw(15) << rec.imsi;
+    m_db_file << ",";
+    m_db_file << hex_string(rec.key, 16);
+    m_db_file << ",";
+    if (rec.op_configured) {
+      m_db_file << "op,";
+      m_db_file << hex_string(rec.op, 16);
+    } else {
+      m_db_file << "opc,";
+      m_db_file << hex_string(rec.opc, 16);
+    }
+    m_db_file << ",";
+    m_db_file << hex_string(rec.amf, 2);
+    m_db_file << ",";
+    m_db_file << hex_string(rec.sqn, 6);
+    m_db_file << ",";
+    m_db_file << rec.qci;
+    if (rec.static_ip_addr != 0) {
+      char ip_str[INET_ADDRSTRLEN];
+      inet_ntop(AF_INET, &rec.static_ip_addr, ip_str, sizeof(ip_str));
+      m_db_file << ",";
+      m_db_file << ip_str;
+    } else {
+      m_db_file << ",dynamic";
+    }
+    m_db_file << std::endl;
+  }
+  if (m_db_file.is_open()) {
+    m_db_file.close();
+  }
+  return true;
+}
+
+/******************************************************************************
+ * Memory-mapped database
+ *****************************************************************************/
+static const char     hss_db_magic[8] = {'S', 'R', 'S', 'H', 'S', 'S', 'D', 'B'};
+static const uint32_t hss_db_version  = 1;
+
+// All offsets are in bytes from the start of the file
+struct hss_db::header_t {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t nof_records;
+  uint32_t index_bits; // The index has 2^index_bits slots, each the record number + 1, or 0 if empty
+  uint32_t nof_static_ip;
+  uint64_t records_offset;
+  uint64_t index_offset;
+  uint64_t static_ip_offset; // Record numbers of the UEs with a static IP
+  uint64_t file_size;
+};
+
+static uint32_t hash_imsi(uint64_t imsi, uint32_t index_bits)
+{
+  return (uint32_t)((imsi * 0x9e3779b97f4a7c15ULL) >> (64 - index_bits));
+}
+
+hss_db::~hss_db()
+{
+  close();
+}
+
+bool hss_db::create(const std::string& filename, const std::vector<hss_db_record_t>& recs, srslte::log* log)
+{
+  if (recs.size() >= UINT32_MAX / 2) {
+    log->error("Too many subscribers for the HSS DB: %zu\n", recs.size());
+    return false;
+  }
+
+  // Keep the index at most half full, so that lookups rarely probe more than one slot
+  uint32_t index_bits = 4;
+  while ((1ULL << index_bits) < 2 * recs.size()) {
+    index_bits++;
+  }
+  std::vector<uint32_t> idx(1u << index_bits, 0);
+  uint32_t              mask = (1u << index_bits) - 1;
+
+  std::vector<uint32_t>        static_ips;
+  std::map<uint32_t, uint64_t> ip_to_imsi;
+  for (uint32_t n = 0; n < recs.size(); n++) {
+    uint32_t i = hash_imsi(recs[n].imsi, index_bits);
+    while (idx[i] != 0) {
+      if (recs[idx[i] - 1].imsi == recs[n].imsi) {
+        log->error("Duplicate IMSI %015" PRIu64 " in HSS DB\n", recs[n].imsi);
+        return false;
+      }
+      i = (i + 1) & mask;
+    }
+    idx[i] = n + 1;
+
+    if (recs[n].static_ip_addr != 0) {
+      if (not ip_to_imsi.insert(std::make_pair(recs[n].static_ip_addr, recs[n].imsi)).second) {
+        log->error("Duplicate static IP address of IMSI %015" PRIu64 " in HSS DB\n", recs[n].imsi);
+        return false;
+      }
+      static_ips.push_back(n);
+    }
+  }
+
+  header_t h = {};
+  memcpy(h.magic, hss_db_magic, sizeof(h.magic));
+  h.version          = hss_db_version;
+  h.record_size      = sizeof(hss_db_record_t);
+  h.nof_records      = recs.size();
+  h.index_bits       = index_bits;
+  h.nof_static_ip    = static_ips.size();
+  h.records_offset   = sizeof(header_t);
+  h.index_offset     = h.records_offset + recs.size() * sizeof(hss_db_record_t);
+  h.static_ip_offset = h.index_offset + idx.size() * sizeof(uint32_t);
+  h.file_size        = h.static_ip_offset + static_ips.size() * sizeof(uint32_t);
+
+  // Write to a temporary file first, so that an existing database is only replaced by a complete one
+  std::string tmp_filename = filename + ".tmp";
+  FILE*       f            = fopen(tmp_filename.c_str(), "wb");
+  if (f == nullptr) {
+    log->error("Can't create HSS DB file %s: %s\n", tmp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  auto write = [f](const void* data, size_t elem_size, size_t nof_elems) {
+    return nof_elems == 0 || fwrite(data, elem_size, nof_elems, f) == nof_elems;
+  };
+  bool ok = write(&h, sizeof(h), 1) && write(recs.data(), sizeof(hss_db_record_t), recs.size()) &&
+            write(idx.data(), sizeof(uint32_t), idx.size()) &&
+            write(static_ips.data(), sizeof(uint32_t), static_ips.size());
+  ok      = (fclose(f) == 0) && ok;
+  if (not ok || rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    log->error("Error writing HSS DB file %s: %s\n", filename.c_str(), strerror(errno));
+    remove(tmp_filename.c_str());
+    return false;
+  }
+
+  log->info("Created HSS DB %s with %zu subscribers\n", filename.c_str(), recs.size());
+  return true;
+}
+
+bool hss_db::is_db_file(const std::string& filename)
+{
+  char  magic[sizeof(hss_db_magic)] = {};
+  FILE* f                           = fopen(filename.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  size_t n = fread(magic, 1, sizeof(magic), f);
+  fclose(f);
+  return n == sizeof(magic) and memcmp(magic, hss_db_magic, sizeof(magic)) == 0;
+}
+
+bool hss_db::open(const std::string& filename, srslte::log* log)
+{
+  close();
+
+  int fd = ::open(filename.c_str(), O_RDWR);
+  if (fd < 0) {
+    log->error("Can't open HSS DB file %s: %s\n", filename.c_str(), strerror(errno));
+    return false;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(header_t)) {
+    log->error("Invalid HSS DB file %s\n", filename.c_str());
+    ::close(fd);
+    return false;
+  }
+  void* ptr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    log->error("Can't map HSS DB file %s: %s\n", filename.c_str(), strerror(errno));
+    return false;
+  }
+  base = (uint8_t*)ptr;
+  size = st.st_size;
+  hdr  = (header_t*)base;
+
+  bool valid = memcmp(hdr->magic, hss_db_magic, sizeof(hss_db_magic)) == 0 && hdr->version == hss_db_version &&
+               hdr->record_size == sizeof(hss_db_record_t) && hdr->file_size == size && hdr->index_bits >= 4 &&
+               hdr->index_bits < 32 && hdr->records_offset == sizeof(header_t) &&
+               hdr->index_offset == hdr->records_offset + hdr->nof_records * sizeof(hss_db_record_t) &&
+               hdr->static_ip_offset == hdr->index_offset + (1ULL << hdr->index_bits) * sizeof(uint32_t) &&
+               hdr->file_size == hdr->static_ip_offset + hdr->nof_static_ip * sizeof(uint32_t);
+  if (not valid) {
+    log->error("Invalid or incompatible HSS DB file %s\n", filename.c_str());
+    close();
+    return false;
+  }
+  records   = (hss_db_record_t*)(base + hdr->records_offset);
+  index     = (uint32_t*)(base + hdr->index_offset);
+  static_ip = (uint32_t*)(base + hdr->static_ip_offset);
+
+  log->info("Opened HSS DB %s with %" PRIu64 " subscribers\n", filename.c_str(), hdr->nof_records);
+  return true;
+}
+
+void hss_db::close()
+{
+  if (base != nullptr) {
+    sync();
+    munmap(base, size);
+  }
+  hdr       = nullptr;
+  records   = nullptr;
+  index     = nullptr;
+  static_ip = nullptr;
+  base      = nullptr;
+  size      = 0;
+}
+
+void hss_db::sync()
+{
+  if (base != nullptr) {
+    msync(base, size, MS_SYNC);
+  }
+}
+
+hss_db_record_t* hss_db::find(uint64_t imsi)
+{
+  if (base == nullptr) {
+    return nullptr;
+  }
+  uint32_t mask = (1u << hdr->index_bits) - 1;
+  uint32_t i    = hash_imsi(imsi, hdr->index_bits);
+  for (uint32_t n = 0; n <= mask && index[i] != 0; n++, i = (i + 1) & mask) {
+    if (index[i] <= hdr->nof_records && records[index[i] - 1].imsi == imsi) {
+      return &records[index[i] - 1];
+    }
+  }
+  return nullptr;
+}
+
+uint64_t hss_db::nof_records() const
+{
+  return base != nullptr ? hdr->nof_records : 0;
+}
+
+hss_db_record_t* hss_db::get_record(uint64_t idx)
+{
+  return idx < nof_records() ? &records[idx] : nullptr;
+}
+
+std::vector<hss_db_record_t*> hss_db::get_static_ip_records()
+{
+  std::vector<hss_db_record_t*> recs;
+  for (uint32_t i = 0; base != nullptr && i < hdr->nof_static_ip; i++) {
+    hss_db_record_t* rec = get_record(static_ip[i]);
+    if (rec != nullptr) {
+      recs.push_back(rec);
+    }
+  }
+  return recs;
+}
+
+} // namespace srsepc
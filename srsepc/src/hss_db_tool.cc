@@ -0,0 +1,88 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        hss_db_tool.cc
+ * Description: Converts the HSS user database between the CSV format and
+ *              the binary, memory-mapped format.
+ *****************************************************************************/
+
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srslte/common/log_filter.h"
+#include <iostream>
+#include <string.h>
+
+using namespace srsepc;
+
+void usage(const char* prog)
+{
+  std::cout << "Usage: " << prog << " import <user_db.csv> <user_db.bin>" << std::endl
+            << "       " << prog << " export <user_db.bin> <user_db.csv>" << std::endl
+            << std::endl
+            << "import creates a binary HSS database from a CSV one, export converts it back." << std::endl
+            << "srsepc uses the binary format when hss.db_file points to a binary database." << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4) {
+    usage(argv[0]);
+    return SRSLTE_ERROR;
+  }
+  std::string cmd = argv[1];
+  std::string in  = argv[2];
+  std::string out = argv[3];
+
+  srslte::log_filter log("HSS ");
+  log.set_level(srslte::LOG_LEVEL_WARNING);
+
+  if (cmd == "import") {
+    std::vector<hss_db_record_t> records;
+    if (not hss_db_read_csv(in, &records, &log)) {
+      std::cout << "Error reading CSV user database " << in << std::endl;
+      return SRSLTE_ERROR;
+    }
+    if (not hss_db::create(out, records, &log)) {
+      std::cout << "Error creating HSS database " << out << std::endl;
+      return SRSLTE_ERROR;
+    }
+    std::cout << "Imported " << records.size() << " subscribers into " << out << std::endl;
+  } else if (cmd == "export") {
+    hss_db db;
+    if (not db.open(in, &log)) {
+      std::cout << "Error opening HSS database " << in << std::endl;
+      return SRSLTE_ERROR;
+    }
+    std::vector<hss_db_record_t> records(db.nof_records());
+    for (uint64_t i = 0; i < db.nof_records(); i++) {
+      records[i] = *db.get_record(i);
+    }
+    if (not hss_db_write_csv(out, records, &log)) {
+      std::cout << "Error writing CSV user database " << out << std::endl;
+      return SRSLTE_ERROR;
+    }
+    std::cout << "Exported " << records.size() << " subscribers into " << out << std::endl;
+  } else {
+    usage(argv[0]);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
@@ -115,7 +115,10 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("mme.encryption_algo", bpo::value<string>(&encryption_algo)->default_value("EEA0"),     "Set preferred encryption algorithm for NAS layer ")
     ("mme.integrity_algo",  bpo::value<string>(&integrity_algo)->default_value("EIA1"),      "Set preferred integrity protection algorithm for NAS")
     ("mme.paging_timer",    bpo::value<uint16_t>(&paging_timer)->default_value(2),           "Set paging timer value in seconds (T3413)")
+    ("mme.s1ap_workers",    bpo::value<uint32_t>(&args->mme_args.s1ap_args.nof_workers)->default_value(0), "Number of threads decoding S1AP messages, sharded by eNB (0 to decode in the MME thread)")
     ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
+    ("hss.av_cache_size",   bpo::value<uint32_t>(&args->hss_args.av_cache_size)->default_value(0), "Milenage authentication vectors precomputed per UE (0 to disable)")
+    ("hss.av_workers",      bpo::value<uint32_t>(&args->hss_args.av_nof_workers)->default_value(1), "Number of threads precomputing authentication vectors")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
     ("spgw.sgi_if_name",    bpo::value<string>(&sgi_if_name)->default_value("srs_spgw_sgi"), "Name of TUN interface for the SGi connection")
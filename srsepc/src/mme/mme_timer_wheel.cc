@@ -0,0 +1,153 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srsepc/hdr/mme/mme_timer_wheel.h"
+#include "srslte/common/common.h"
+#include <errno.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace srsepc {
+
+mme_timer_wheel::mme_timer_wheel(uint32_t tick_ms_, uint32_t nof_slots_) : m_tick_ms(std::max(tick_ms_, 1u))
+{
+  uint32_t nof_slots = 1;
+  while (nof_slots < nof_slots_) {
+    nof_slots *= 2;
+  }
+  m_slots.resize(nof_slots);
+  m_mask = nof_slots - 1;
+}
+
+mme_timer_wheel::~mme_timer_wheel()
+{
+  stop();
+}
+
+int mme_timer_wheel::init()
+{
+  m_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+  if (m_fd < 0) {
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+void mme_timer_wheel::stop()
+{
+  if (m_fd != -1) {
+    close(m_fd);
+    m_fd = -1;
+  }
+  for (std::vector<entry_t>& slot : m_slots) {
+    slot.clear();
+  }
+  m_running.clear();
+}
+
+bool mme_timer_wheel::add(uint32_t timeout_ms, enum nas_timer_type type, uint64_t imsi)
+{
+  uint64_t key = timer_key(type, imsi);
+  if (m_running.find(key) != nullptr) {
+    return false;
+  }
+  uint64_t nof_ticks = std::max((timeout_ms + m_tick_ms - 1) / m_tick_ms, 1u);
+
+  entry_t entry;
+  entry.id          = m_next_id++;
+  entry.expiry_tick = m_cur_tick + nof_ticks;
+  entry.timer.imsi  = imsi;
+  entry.timer.type  = type;
+  m_slots[entry.expiry_tick & m_mask].push_back(entry);
+  m_running.insert(key, entry.id);
+  if (m_running.size() == 1) {
+    arm(true);
+  }
+  return true;
+}
+
+bool mme_timer_wheel::is_running(enum nas_timer_type type, uint64_t imsi)
+{
+  return m_running.find(timer_key(type, imsi)) != nullptr;
+}
+
+bool mme_timer_wheel::remove(enum nas_timer_type type, uint64_t imsi)
+{
+  if (not m_running.erase(timer_key(type, imsi))) {
+    return false;
+  }
+  if (m_running.empty()) {
+    arm(false);
+  }
+  return true;
+}
+
+void mme_timer_wheel::handle_tick(std::vector<mme_timer_t>* expired)
+{
+  uint64_t nof_ticks = 0;
+  if (read(m_fd, &nof_ticks, sizeof(nof_ticks)) != sizeof(nof_ticks)) {
+    return;
+  }
+  advance(nof_ticks, expired);
+}
+
+void mme_timer_wheel::advance(uint64_t nof_ticks, std::vector<mme_timer_t>* expired)
+{
+  for (uint64_t n = 0; n < nof_ticks and not m_running.empty(); n++) {
+    m_cur_tick++;
+    std::vector<entry_t>& slot = m_slots[m_cur_tick & m_mask];
+    for (size_t i = 0; i < slot.size();) {
+      if (slot[i].expiry_tick > m_cur_tick) {
+        // Expires in a later turn of the wheel
+        i++;
+        continue;
+      }
+      uint64_t  key = timer_key(slot[i].timer.type, slot[i].timer.imsi);
+      uint64_t* id  = m_running.find(key);
+      if (id != nullptr and *id == slot[i].id) {
+        expired->push_back(slot[i].timer);
+        m_running.erase(key);
+      }
+      slot[i] = slot.back();
+      slot.pop_back();
+    }
+  }
+  if (m_running.empty()) {
+    arm(false);
+  }
+}
+
+void mme_timer_wheel::arm(bool enable)
+{
+  if (m_fd < 0) {
+    return;
+  }
+  struct itimerspec t_value = {};
+  if (enable) {
+    t_value.it_value.tv_sec  = m_tick_ms / 1000;
+    t_value.it_value.tv_nsec = (m_tick_ms % 1000) * 1000000;
+    t_value.it_interval      = t_value.it_value;
+  }
+  timerfd_settime(m_fd, 0, &t_value, NULL);
+}
+
+} // namespace srsepc
@@ -25,6 +25,7 @@
 #include "srslte/common/liblte_security.h"
 #include <cmath>
 #include <inttypes.h> // for printing uint64_t
+#include <sys/eventfd.h>
 
 namespace srsepc {
 
@@ -96,6 +97,20 @@ int s1ap::init(s1ap_args_t s1ap_args, srslte::log_filter* nas_log, srslte::log_f
   if (m_pcap_enable) {
     m_pcap.open(s1ap_args.pcap_filename.c_str());
   }
+
+  // Init S1AP workers
+  if (s1ap_args.nof_workers > 0) {
+    m_rx_notify_fd = eventfd(0, EFD_NONBLOCK);
+    if (m_rx_notify_fd < 0) {
+      m_s1ap_log->error("Error creating S1AP workers notification fd: %s\n", strerror(errno));
+      return -1;
+    }
+    for (uint32_t i = 0; i < s1ap_args.nof_workers; i++) {
+      m_workers.emplace_back(new srslte::task_thread_pool(1));
+      m_workers.back()->start();
+    }
+    m_s1ap_log->info("Decoding S1AP PDUs in %d workers\n", s1ap_args.nof_workers);
+  }
   m_s1ap_log->info("S1AP Initialized\n");
   return 0;
 }
@@ -105,6 +120,15 @@ void s1ap::stop()
   if (m_s1mme != -1) {
     close(m_s1mme);
   }
+  for (std::unique_ptr<srslte::task_thread_pool>& worker : m_workers) {
+    worker->stop();
+  }
+  m_workers.clear();
+  m_rx_pdus.clear();
+  if (m_rx_notify_fd != -1) {
+    close(m_rx_notify_fd);
+    m_rx_notify_fd = -1;
+  }
   std::map<uint16_t, enb_ctx_t*>::iterator enb_it = m_active_enbs.begin();
   while (enb_it != m_active_enbs.end()) {
     m_s1ap_log->info("Deleting eNB context. eNB Id: 0x%x\n", enb_it->second->enb_id);
@@ -113,13 +137,13 @@ void s1ap::stop()
     m_active_enbs.erase(enb_it++);
   }
 
-  std::map<uint64_t, nas*>::iterator ue_it = m_imsi_to_nas_ctx.begin();
-  while (ue_it != m_imsi_to_nas_ctx.end()) {
-    m_s1ap_log->info("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", ue_it->first);
-    srslte::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", ue_it->first);
-    delete ue_it->second;
-    m_imsi_to_nas_ctx.erase(ue_it++);
-  }
+  m_imsi_to_nas_ctx.for_each([this](uint64_t imsi, nas* nas_ctx) {
+    m_s1ap_log->info("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", imsi);
+    srslte::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", imsi);
+    delete nas_ctx;
+  });
+  m_imsi_to_nas_ctx.clear();
+  m_mme_ue_s1ap_id_to_nas_ctx.clear();
 
   // Cleanup message handlers
   s1ap_mngmt_proc::cleanup();
@@ -225,6 +249,21 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
 
 void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri)
 {
+  // Hand the PDU to the worker of its eNB association
+  if (not m_workers.empty()) {
+    std::shared_ptr<rx_pdu_t> rx_pdu = std::make_shared<rx_pdu_t>();
+    rx_pdu->buf                      = srslte::allocate_unique_buffer(*m_pool);
+    if (rx_pdu->buf == nullptr) {
+      m_s1ap_log->error("Fatal Error: Couldn't allocate buffer for S1AP PDU.\n");
+      return;
+    }
+    memcpy(rx_pdu->buf->msg, pdu->msg, pdu->N_bytes);
+    rx_pdu->buf->N_bytes = pdu->N_bytes;
+    rx_pdu->sri          = *enb_sri;
+    push_rx_pdu(std::move(rx_pdu));
+    return;
+  }
+
   // Save PCAP
   if (m_pcap_enable) {
     m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
@@ -237,7 +276,11 @@ void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo
     m_s1ap_log->error("Failed to unpack received PDU\n");
     return;
   }
+  handle_s1ap_pdu(rx_pdu, enb_sri);
+}
 
+void s1ap::handle_s1ap_pdu(const s1ap_pdu_t& rx_pdu, struct sctp_sndrcvinfo* enb_sri)
+{
   switch (rx_pdu.type().value) {
     case s1ap_pdu_t::types_opts::init_msg:
       m_s1ap_log->info("Received Initiating PDU\n");
@@ -256,6 +299,73 @@ void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo
   }
 }
 
+void s1ap::handle_sctp_shutdown(int32_t assoc_id)
+{
+  // The eNB context is deleted after its pending PDUs were handled
+  if (not m_workers.empty()) {
+    std::shared_ptr<rx_pdu_t> rx_pdu = std::make_shared<rx_pdu_t>();
+    rx_pdu->sri.sinfo_assoc_id       = assoc_id;
+    push_rx_pdu(std::move(rx_pdu));
+    return;
+  }
+  delete_enb_ctx(assoc_id);
+}
+
+void s1ap::push_rx_pdu(std::shared_ptr<rx_pdu_t> rx_pdu)
+{
+  uint32_t worker_idx = (uint32_t)rx_pdu->sri.sinfo_assoc_id % m_workers.size();
+  m_workers[worker_idx]->push_task([this, rx_pdu](uint32_t worker_id) {
+    if (rx_pdu->buf != nullptr) {
+      asn1::cbit_ref bref(rx_pdu->buf->msg, rx_pdu->buf->N_bytes);
+      rx_pdu->decoded = rx_pdu->pdu.unpack(bref) == asn1::SRSASN_SUCCESS;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_rx_mutex);
+      m_rx_pdus.push_back(rx_pdu);
+    }
+    uint64_t one = 1;
+    if (write(m_rx_notify_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+      m_s1ap_log->error("Error notifying decoded S1AP PDU: %s\n", strerror(errno));
+    }
+  });
+}
+
+void s1ap::handle_decoded_pdus()
+{
+  uint64_t counter = 0;
+  if (read(m_rx_notify_fd, &counter, sizeof(counter)) < 0 && errno != EAGAIN) {
+    m_s1ap_log->error("Error reading S1AP workers notification: %s\n", strerror(errno));
+  }
+
+  std::deque<std::shared_ptr<rx_pdu_t> > rx_pdus;
+  {
+    std::lock_guard<std::mutex> lock(m_rx_mutex);
+    rx_pdus.swap(m_rx_pdus);
+  }
+  for (std::shared_ptr<rx_pdu_t>& rx_pdu : rx_pdus) {
+    handle_rx_pdu(*rx_pdu);
+  }
+}
+
+void s1ap::handle_rx_pdu(rx_pdu_t& rx_pdu)
+{
+  if (rx_pdu.buf == nullptr) {
+    delete_enb_ctx(rx_pdu.sri.sinfo_assoc_id);
+    return;
+  }
+
+  // Save PCAP
+  if (m_pcap_enable) {
+    m_pcap.write_s1ap(rx_pdu.buf->msg, rx_pdu.buf->N_bytes);
+  }
+
+  if (not rx_pdu.decoded) {
+    m_s1ap_log->error("Failed to unpack received PDU\n");
+    return;
+  }
+  handle_s1ap_pdu(rx_pdu.pdu, &rx_pdu.sri);
+}
+
 void s1ap::handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri)
 {
   using init_msg_type_opts_t = asn1::s1ap::s1ap_elem_procs_o::init_msg_c::types_opts;
@@ -305,12 +415,11 @@ void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg
 void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri)
 {
   m_s1ap_log->info("Adding new eNB context. eNB ID %d\n", enb_ctx.enb_id);
-  std::set<uint32_t> ue_set;
-  enb_ctx_t*         enb_ptr = new enb_ctx_t;
-  *enb_ptr                   = enb_ctx;
+  enb_ctx_t* enb_ptr = new enb_ctx_t;
+  *enb_ptr           = enb_ctx;
   m_active_enbs.insert(std::pair<uint16_t, enb_ctx_t*>(enb_ptr->enb_id, enb_ptr));
   m_sctp_to_enb_id.insert(std::pair<int32_t, uint16_t>(enb_sri->sinfo_assoc_id, enb_ptr->enb_id));
-  m_enb_assoc_to_ue_ids.insert(std::pair<int32_t, std::set<uint32_t> >(enb_sri->sinfo_assoc_id, ue_set));
+  m_enb_assoc_to_ue_ids.insert(enb_sri->sinfo_assoc_id, std::set<uint32_t>());
 }
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
@@ -350,19 +459,18 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
 // UE Context Management
 bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 {
-  std::map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
-  if (ctx_it != m_imsi_to_nas_ctx.end()) {
+  if (m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi) != nullptr) {
     m_s1ap_log->error("UE Context already exists. IMSI %015" PRIu64 "\n", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-    if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
+    nas** ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    if (ctx_it2 != nullptr && *ctx_it2 != nas_ctx) {
       m_s1ap_log->error("Context identified with IMSI does not match context identified by MME UE S1AP Id.\n");
       return false;
     }
   }
-  m_imsi_to_nas_ctx.insert(std::pair<uint64_t, nas*>(nas_ctx->m_emm_ctx.imsi, nas_ctx));
+  m_imsi_to_nas_ctx.insert(nas_ctx->m_emm_ctx.imsi, nas_ctx);
   m_s1ap_log->debug("Saved UE context corresponding to IMSI %015" PRIu64 "\n", nas_ctx->m_emm_ctx.imsi);
   return true;
 }
@@ -373,72 +481,66 @@ bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
     m_s1ap_log->error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.\n");
     return false;
   }
-  std::map<uint32_t, nas*>::iterator ctx_it = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-  if (ctx_it != m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  if (m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id) != nullptr) {
     m_s1ap_log->error("UE Context already exists. MME UE S1AP Id %015" PRIu64 "\n", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
   if (nas_ctx->m_emm_ctx.imsi != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-    if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
+    nas** ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    if (ctx_it2 != nullptr && *ctx_it2 != nas_ctx) {
       m_s1ap_log->error("Context identified with MME UE S1AP Id does not match context identified by IMSI.\n");
       return false;
     }
   }
-  m_mme_ue_s1ap_id_to_nas_ctx.insert(std::pair<uint32_t, nas*>(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_ctx));
+  m_mme_ue_s1ap_id_to_nas_ctx.insert(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_ctx);
   m_s1ap_log->debug("Saved UE context corresponding to MME UE S1AP Id %d\n", nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
   return true;
 }
 
 bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
+  std::set<uint32_t>* ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
+  if (ues_in_enb == nullptr) {
     m_s1ap_log->error("Could not find eNB from eNB SCTP association %d\n", enb_assoc);
     return false;
   }
-  std::set<uint32_t>::iterator ue_id = ues_in_enb->second.find(mme_ue_s1ap_id);
-  if (ue_id != ues_in_enb->second.end()) {
+  if (ues_in_enb->count(mme_ue_s1ap_id) > 0) {
     m_s1ap_log->error("UE with MME UE S1AP Id already exists %d\n", mme_ue_s1ap_id);
     return false;
   }
-  ues_in_enb->second.insert(mme_ue_s1ap_id);
+  ues_in_enb->insert(mme_ue_s1ap_id);
   m_s1ap_log->debug("Added UE with MME-UE S1AP Id %d to eNB with association %d\n", mme_ue_s1ap_id, enb_assoc);
   return true;
 }
 
 nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
-  std::map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
-    return NULL;
-  } else {
-    return it->second;
-  }
+  nas** it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
+  return it != nullptr ? *it : nullptr;
 }
 
 nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 {
-  std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
-  if (it == m_imsi_to_nas_ctx.end()) {
-    return NULL;
-  } else {
-    return it->second;
-  }
+  nas** it = m_imsi_to_nas_ctx.find(imsi);
+  return it != nullptr ? *it : nullptr;
 }
 
 void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
   srslte::console("Releasing UEs context\n");
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  std::set<uint32_t>::iterator                     ue_id      = ues_in_enb->second.begin();
-  if (ue_id == ues_in_enb->second.end()) {
+  std::set<uint32_t>* ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
+  if (ues_in_enb == nullptr) {
+    m_s1ap_log->error("Could not find eNB from eNB SCTP association %d\n", enb_assoc);
+    return;
+  }
+  std::set<uint32_t>::iterator ue_id = ues_in_enb->begin();
+  if (ue_id == ues_in_enb->end()) {
     srslte::console("No UEs to be released\n");
   } else {
-    while (ue_id != ues_in_enb->second.end()) {
-      std::map<uint32_t, nas*>::iterator nas_ctx = m_mme_ue_s1ap_id_to_nas_ctx.find(*ue_id);
-      emm_ctx_t*                         emm_ctx = &nas_ctx->second->m_emm_ctx;
-      ecm_ctx_t*                         ecm_ctx = &nas_ctx->second->m_ecm_ctx;
+    while (ue_id != ues_in_enb->end()) {
+      nas*       nas_ctx = find_nas_ctx_from_mme_ue_s1ap_id(*ue_id);
+      emm_ctx_t* emm_ctx = &nas_ctx->m_emm_ctx;
+      ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
 
       m_s1ap_log->info(
           "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d\n", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
@@ -450,7 +552,7 @@ void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
       ecm_ctx->state          = ECM_STATE_IDLE;
       ecm_ctx->mme_ue_s1ap_id = 0;
       ecm_ctx->enb_ue_s1ap_id = 0;
-      ues_in_enb->second.erase(ue_id++);
+      ues_in_enb->erase(ue_id++);
     }
   }
 }
@@ -471,12 +573,12 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
     return false;
   }
   uint16_t                                         enb_id = it->second;
-  std::map<int32_t, std::set<uint32_t> >::iterator ue_set = m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (ue_set == m_enb_assoc_to_ue_ids.end()) {
+  std::set<uint32_t>* ue_set = m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
+  if (ue_set == nullptr) {
     m_s1ap_log->error("Could not find the eNB's UEs.\n");
     return false;
   }
-  ue_set->second.erase(mme_ue_s1ap_id);
+  ue_set->erase(mme_ue_s1ap_id);
 
   // Release UE ECM context
   m_mme_ue_s1ap_id_to_nas_ctx.erase(mme_ue_s1ap_id);
@@ -511,21 +613,20 @@ bool s1ap::delete_ue_ctx(uint64_t imsi)
 // UE Bearer Managment
 void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
-  std::map<uint64_t, nas*>::iterator ue_ctx_it = m_imsi_to_nas_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_nas_ctx.end()) {
+  nas* nas_ctx = find_nas_ctx_from_imsi(imsi);
+  if (nas_ctx == nullptr) {
     m_s1ap_log->error("Could not activate EPS bearer: Could not find UE context\n");
     return;
   }
   // Make sure NAS is active
-  uint32_t                           mme_ue_s1ap_id = ue_ctx_it->second->m_ecm_ctx.mme_ue_s1ap_id;
-  std::map<uint32_t, nas*>::iterator it             = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  uint32_t mme_ue_s1ap_id = nas_ctx->m_ecm_ctx.mme_ue_s1ap_id;
+  if (find_nas_ctx_from_mme_ue_s1ap_id(mme_ue_s1ap_id) == nullptr) {
     m_s1ap_log->error("Could not activate EPS bearer: ECM context seems to be missing\n");
     return;
   }
 
-  ecm_ctx_t* ecm_ctx = &ue_ctx_it->second->m_ecm_ctx;
-  esm_ctx_t* esm_ctx = &ue_ctx_it->second->m_esm_ctx[ebi];
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+  esm_ctx_t* esm_ctx = &nas_ctx->m_esm_ctx[ebi];
   if (esm_ctx->state != ERAB_CTX_SETUP) {
     m_s1ap_log->error(
         "Could not be activate EPS Bearer, bearer in wrong state: MME S1AP Id %d, EPS Bearer id %d, state %d\n",
@@ -551,17 +652,17 @@ uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
   uint32_t m_tmsi = m_next_m_tmsi;
   m_next_m_tmsi   = (m_next_m_tmsi + 1) % UINT32_MAX;
 
-  m_tmsi_to_imsi.insert(std::pair<uint32_t, uint64_t>(m_tmsi, imsi));
+  m_tmsi_to_imsi.insert(m_tmsi, imsi);
   m_s1ap_log->debug("Allocated M-TMSI 0x%x to IMSI %015" PRIu64 ",\n", m_tmsi, imsi);
   return m_tmsi;
 }
 
 uint64_t s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi)
 {
-  std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
-  if (it != m_tmsi_to_imsi.end()) {
-    m_s1ap_log->debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x\n", it->second, m_tmsi);
-    return it->second;
+  uint64_t* imsi = m_tmsi_to_imsi.find(m_tmsi);
+  if (imsi != nullptr) {
+    m_s1ap_log->debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x\n", *imsi, m_tmsi);
+    return *imsi;
   } else {
     m_s1ap_log->debug("Could not find IMSI from M-TMSI 0x%x\n", m_tmsi);
     return 0;
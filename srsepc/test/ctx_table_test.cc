@@ -0,0 +1,124 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/ctx_table.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <map>
+#include <random>
+
+/*
+ * Random inserts and erases checked against std::map, with keys that share the low bits to produce long probe
+ * sequences and exercise the backward shift deletion
+ */
+int test_against_map()
+{
+  srsepc::ctx_table<uint64_t, uint32_t> table(16);
+  std::map<uint64_t, uint32_t>          ref;
+  std::mt19937                          rng(1234);
+
+  for (uint32_t n = 0; n < 200000; n++) {
+    uint64_t key = 1010000000000ULL + (rng() % 512) * 4096;
+    if (rng() % 3 == 0) {
+      TESTASSERT(table.erase(key) == (ref.erase(key) > 0));
+    } else {
+      TESTASSERT(table.insert(key, n) == ref.insert(std::make_pair(key, n)).second);
+    }
+    TESTASSERT(table.size() == ref.size());
+
+    if (n % 1000 == 0) {
+      for (const std::pair<const uint64_t, uint32_t>& e : ref) {
+        uint32_t* value = table.find(e.first);
+        TESTASSERT(value != nullptr && *value == e.second);
+      }
+      std::map<uint64_t, uint32_t> entries;
+      table.for_each([&entries](uint64_t key, uint32_t value) { entries[key] = value; });
+      TESTASSERT(entries == ref);
+    }
+  }
+
+  table.clear();
+  TESTASSERT(table.empty());
+  TESTASSERT(table.find(ref.begin()->first) == nullptr);
+
+  return SRSLTE_SUCCESS;
+}
+
+// Negative keys, as used by the SCTP association ids
+int test_signed_keys()
+{
+  srsepc::ctx_table<int32_t, int32_t> table;
+  for (int32_t i = -100; i < 100; i++) {
+    TESTASSERT(table.insert(i, -i));
+  }
+  for (int32_t i = -100; i < 100; i++) {
+    TESTASSERT(table.find(i) != nullptr && *table.find(i) == -i);
+  }
+  TESTASSERT(table.find(100) == nullptr);
+  TESTASSERT(table.size() == 200);
+
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Lookup time of the MME UE contexts with many attached UEs
+ */
+int test_lookup_time()
+{
+  const uint32_t nof_ues     = 100000;
+  const uint32_t nof_lookups = 1000000;
+
+  srsepc::ctx_table<uint64_t, void*> table;
+  std::map<uint64_t, void*>          ref;
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    table.insert(1010000000000ULL + i * 7, &table);
+    ref.insert(std::make_pair(1010000000000ULL + i * 7, &table));
+  }
+
+  std::mt19937 rng(4321);
+  uint32_t     found = 0;
+  auto         t0    = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_lookups; i++) {
+    found += table.find(1010000000000ULL + (rng() % nof_ues) * 7) != nullptr;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_lookups; i++) {
+    found += ref.find(1010000000000ULL + (rng() % nof_ues) * 7) != ref.end();
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  TESTASSERT(found == 2 * nof_lookups);
+
+  printf("IMSI lookup with %d UEs: std::map %.1f ns, ctx_table %.1f ns\n",
+         nof_ues,
+         std::chrono::duration<double, std::nano>(t2 - t1).count() / nof_lookups,
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / nof_lookups);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_against_map() == SRSLTE_SUCCESS);
+  TESTASSERT(test_signed_keys() == SRSLTE_SUCCESS);
+  TESTASSERT(test_lookup_time() == SRSLTE_SUCCESS);
+
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/aes_128.h"
+
+#include "srsepc/hdr/hss/hss.h"
+#include "srslte/common/liblte_security.h"
+#include "srslte/common/security.h"
+#include "srslte/common/test_common.h"
+#include <chrono>
+#include <inttypes.h>
+#include <thread>
+#include <vector>
+
+static const char*    db_file = "hss_auth_test_db.csv";
+static const uint16_t mcc     = 0xf001;
+static const uint16_t mnc     = 0xff01;
+
+struct test_ue_t {
+  uint64_t imsi;
+  uint8_t  k[16];
+  uint8_t  opc[16];
+  uint8_t  last_rand[16];
+  uint64_t last_sqn;
+};
+
+uint64_t sqn_to_uint64(const uint8_t* sqn)
+{
+  uint64_t sqn64 = 0;
+  for (int i = 0; i < 6; i++) {
+    sqn64 = (sqn64 << 8) | sqn[i];
+  }
+  return sqn64;
+}
+
+std::vector<test_ue_t> make_ues(uint32_t nof_ues)
+{
+  std::vector<test_ue_t> ues(nof_ues);
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    ues[i].imsi = 1010000000000 + i;
+    for (uint32_t j = 0; j < 16; j++) {
+      ues[i].k[j]   = (uint8_t)(i * 31 + j * 7);
+      ues[i].opc[j] = (uint8_t)(i * 11 + j * 13 + 1);
+    }
+    ues[i].last_sqn = 0;
+  }
+  return ues;
+}
+
+void write_db(const std::vector<test_ue_t>& ues)
+{
+  FILE* f = fopen(db_file, "w");
+  for (const test_ue_t& ue : ues) {
+    fprintf(f, "ue%" PRIu64 ",mil,%015" PRIu64 ",", ue.imsi, ue.imsi);
+    for (uint32_t j = 0; j < 16; j++) {
+      fprintf(f, "%02x", ue.k[j]);
+    }
+    fprintf(f, ",opc,");
+    for (uint32_t j = 0; j < 16; j++) {
+      fprintf(f, "%02x", ue.opc[j]);
+    }
+    fprintf(f, ",8000,000000001234,7,dynamic\n");
+  }
+  fclose(f);
+}
+
+srsepc::hss* start_hss(const std::vector<test_ue_t>& ues, uint32_t av_cache_size, srslte::log_filter* log)
+{
+  write_db(ues);
+
+  srsepc::hss_args_t args = {};
+  args.db_file            = db_file;
+  args.mcc                = mcc;
+  args.mnc                = mnc;
+  args.av_cache_size      = av_cache_size;
+  args.av_nof_workers     = 1;
+
+  srsepc::hss* hss = srsepc::hss::get_instance();
+  if (hss->init(&args, log) != 0) {
+    return nullptr;
+  }
+  return hss;
+}
+
+void stop_hss(srsepc::hss* hss)
+{
+  hss->stop();
+  srsepc::hss::cleanup();
+  remove(db_file);
+}
+
+/*
+ * Stand-in for the S1AP/NAS side of an attach. Requests the authentication vector of the UE from the HSS, as the MME
+ * does when it receives the Attach Request, and checks the challenge like the USIM of the UE would
+ */
+class s1ap_client_stub
+{
+public:
+  explicit s1ap_client_stub(srsepc::hss_interface_nas* hss_) : hss(hss_) {}
+
+  struct auth_request_t {
+    uint8_t k_asme[32];
+    uint8_t autn[16];
+    uint8_t rand[16];
+    uint8_t xres[8];
+  };
+
+  int request_auth(const test_ue_t& ue, auth_request_t* req)
+  {
+    TESTASSERT(hss->gen_auth_info_answer(ue.imsi, req->k_asme, req->autn, req->rand, req->xres));
+    return SRSLTE_SUCCESS;
+  }
+
+  int check_auth(test_ue_t& ue, auth_request_t& req)
+  {
+    uint8_t res[8];
+    uint8_t ck[16];
+    uint8_t ik[16];
+    uint8_t ak[6];
+    uint8_t sqn[6];
+    uint8_t mac[8];
+    uint8_t k_asme[32];
+
+    liblte_security_milenage_f2345(ue.k, ue.opc, req.rand, res, ck, ik, ak);
+    for (uint32_t i = 0; i < 6; i++) {
+      sqn[i] = req.autn[i] ^ ak[i];
+    }
+    liblte_security_milenage_f1(ue.k, ue.opc, req.rand, sqn, &req.autn[6], mac);
+    TESTASSERT(memcmp(mac, &req.autn[8], 8) == 0);
+    TESTASSERT(memcmp(res, req.xres, 8) == 0);
+    srslte::security_generate_k_asme(ck, ik, ak, sqn, mcc, mnc, k_asme);
+    TESTASSERT(memcmp(k_asme, req.k_asme, 32) == 0);
+
+    // The SQN and the RAND must be fresh
+    TESTASSERT(sqn_to_uint64(sqn) > ue.last_sqn);
+    TESTASSERT(memcmp(req.rand, ue.last_rand, 16) != 0);
+    ue.last_sqn = sqn_to_uint64(sqn);
+    memcpy(ue.last_rand, req.rand, 16);
+    return SRSLTE_SUCCESS;
+  }
+
+  int attach(test_ue_t& ue)
+  {
+    auth_request_t req;
+    TESTASSERT(request_auth(ue, &req) == SRSLTE_SUCCESS);
+    TESTASSERT(check_auth(ue, req) == SRSLTE_SUCCESS);
+    return SRSLTE_SUCCESS;
+  }
+
+  // The UE answers the last challenge with a synchronization failure, reporting its own SQN
+  int sync_failure(test_ue_t& ue, uint64_t sqn_ms64)
+  {
+    uint8_t sqn_ms[6];
+    uint8_t ak_star[6];
+    uint8_t mac_s[8];
+    uint8_t amf[2]   = {};
+    uint8_t auts[16] = {};
+
+    for (int i = 0; i < 6; i++) {
+      sqn_ms[i] = (sqn_ms64 >> (5 - i) * 8) & 0xff;
+    }
+    liblte_security_milenage_f5_star(ue.k, ue.opc, ue.last_rand, ak_star);
+    liblte_security_milenage_f1_star(ue.k, ue.opc, ue.last_rand, sqn_ms, amf, mac_s);
+    for (uint32_t i = 0; i < 6; i++) {
+      auts[i] = sqn_ms[i] ^ ak_star[i];
+    }
+    memcpy(&auts[6], mac_s, 8);
+
+    TESTASSERT(hss->resync_sqn(ue.imsi, auts));
+    ue.last_sqn = sqn_ms64;
+    return SRSLTE_SUCCESS;
+  }
+
+private:
+  srsepc::hss_interface_nas* hss;
+};
+
+/*
+ * Repeated attaches of several UEs, with more attaches per UE than cached vectors
+ */
+int test_auth_vectors(uint32_t av_cache_size, srslte::log_filter* log)
+{
+  std::vector<test_ue_t> ues = make_ues(16);
+  srsepc::hss*           hss = start_hss(ues, av_cache_size, log);
+  TESTASSERT(hss != nullptr);
+  s1ap_client_stub s1ap(hss);
+
+  for (uint32_t n = 0; n < 10; n++) {
+    for (test_ue_t& ue : ues) {
+      TESTASSERT(s1ap.attach(ue) == SRSLTE_SUCCESS);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  stop_hss(hss);
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * After a resynchronization the cached vectors must not be used anymore
+ */
+int test_resync(uint32_t av_cache_size, srslte::log_filter* log)
+{
+  std::vector<test_ue_t> ues = make_ues(1);
+  srsepc::hss*           hss = start_hss(ues, av_cache_size, log);
+  TESTASSERT(hss != nullptr);
+  s1ap_client_stub s1ap(hss);
+  test_ue_t&       ue = ues[0];
+
+  TESTASSERT(s1ap.attach(ue) == SRSLTE_SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  TESTASSERT(s1ap.sync_failure(ue, ue.last_sqn + (1000 << LTE_FDD_ENB_IND_HE_N_BITS)) == SRSLTE_SUCCESS);
+  for (uint32_t n = 0; n < 10; n++) {
+    TESTASSERT(s1ap.attach(ue) == SRSLTE_SUCCESS);
+  }
+
+  stop_hss(hss);
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Attach storm: every UE attaches at once. Only the time spent in the HSS, i.e. in the MME thread, is measured
+ */
+int test_attach_storm(uint32_t av_cache_size, srslte::log_filter* log)
+{
+  const uint32_t         nof_ues = 2000;
+  std::vector<test_ue_t> ues     = make_ues(nof_ues);
+  srsepc::hss*           hss     = start_hss(ues, av_cache_size, log);
+  TESTASSERT(hss != nullptr);
+  s1ap_client_stub s1ap(hss);
+
+  // Give the workers time to fill the caches, as between two storms
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  std::vector<s1ap_client_stub::auth_request_t> reqs(nof_ues);
+  auto                                          t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    TESTASSERT(s1ap.request_auth(ues[i], &reqs[i]) == SRSLTE_SUCCESS);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    TESTASSERT(s1ap.check_auth(ues[i], reqs[i]) == SRSLTE_SUCCESS);
+  }
+
+  double us = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / 1000.0;
+  printf("Attach storm of %d UEs with %d cached vectors per UE: %.2f us per authentication vector (AES backend: %s)\n",
+         nof_ues,
+         av_cache_size,
+         us / nof_ues,
+         srslte::aes_128_key::backend());
+
+  stop_hss(hss);
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::log_filter log("HSS");
+  log.set_level(srslte::LOG_LEVEL_ERROR);
+
+  for (uint32_t av_cache_size : {0u, 1u, 4u}) {
+    TESTASSERT(test_auth_vectors(av_cache_size, &log) == SRSLTE_SUCCESS);
+    TESTASSERT(test_resync(av_cache_size, &log) == SRSLTE_SUCCESS);
+  }
+  for (uint32_t av_cache_size : {0u, 4u}) {
+    TESTASSERT(test_attach_storm(av_cache_size, &log) == SRSLTE_SUCCESS);
+  }
+
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss.h"
+#include "srslte/common/test_common.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <inttypes.h>
+#include <vector>
+
+static const char* csv_file    = "hss_db_test.csv";
+static const char* db_file     = "hss_db_test.bin";
+static const char* export_file = "hss_db_test_export.csv";
+
+std::vector<srsepc::hss_db_record_t> make_records(uint32_t nof_records)
+{
+  std::vector<srsepc::hss_db_record_t> records(nof_records);
+  for (uint32_t i = 0; i < nof_records; i++) {
+    srsepc::hss_db_record_t& rec = records[i];
+    rec                          = {};
+    snprintf(rec.name, sizeof(rec.name), "ue%d", i);
+    rec.imsi          = 1010000000000 + i * 7;
+    rec.algo          = i % 2 ? srsepc::HSS_ALGO_MILENAGE : srsepc::HSS_ALGO_XOR;
+    rec.op_configured = i % 3 == 0;
+    for (uint32_t j = 0; j < 16; j++) {
+      rec.key[j] = (uint8_t)(i * 31 + j);
+      if (rec.op_configured) {
+        rec.op[j] = (uint8_t)(i * 13 + j);
+      } else {
+        rec.opc[j] = (uint8_t)(i * 17 + j);
+      }
+    }
+    rec.amf[0] = 0x80;
+    rec.sqn[5] = (uint8_t)i;
+    rec.sqn[4] = 0x12;
+    rec.qci    = 7;
+    if (i % 100 == 1) {
+      rec.static_ip_addr = htonl(0xac100002 + i);
+    }
+  }
+  return records;
+}
+
+/*
+ * CSV import into the binary database and export back
+ */
+int test_import_export(srslte::log_filter* log)
+{
+  const uint32_t                       nof_records = 1000;
+  std::vector<srsepc::hss_db_record_t> records     = make_records(nof_records);
+
+  TESTASSERT(srsepc::hss_db_write_csv(csv_file, records, log));
+  std::vector<srsepc::hss_db_record_t> csv_records;
+  TESTASSERT(srsepc::hss_db_read_csv(csv_file, &csv_records, log));
+  TESTASSERT(csv_records.size() == nof_records);
+  TESTASSERT(memcmp(csv_records.data(), records.data(), nof_records * sizeof(srsepc::hss_db_record_t)) == 0);
+
+  TESTASSERT(not srsepc::hss_db::is_db_file(csv_file));
+  TESTASSERT(srsepc::hss_db::create(db_file, csv_records, log));
+  TESTASSERT(srsepc::hss_db::is_db_file(db_file));
+
+  srsepc::hss_db db;
+  TESTASSERT(db.open(db_file, log));
+  TESTASSERT(db.nof_records() == nof_records);
+  for (const srsepc::hss_db_record_t& rec : records) {
+    srsepc::hss_db_record_t* found = db.find(rec.imsi);
+    TESTASSERT(found != nullptr);
+    TESTASSERT(memcmp(found, &rec, sizeof(rec)) == 0);
+    TESTASSERT(db.find(rec.imsi + 1) == nullptr);
+  }
+  std::vector<srsepc::hss_db_record_t*> static_ip = db.get_static_ip_records();
+  TESTASSERT(static_ip.size() == nof_records / 100);
+  for (srsepc::hss_db_record_t* rec : static_ip) {
+    TESTASSERT(rec->static_ip_addr != 0);
+  }
+
+  // In-place update, visible after reopening the database
+  db.find(records[10].imsi)->sqn[0] = 0xaa;
+  db.close();
+  TESTASSERT(db.open(db_file, log));
+  TESTASSERT(db.find(records[10].imsi)->sqn[0] == 0xaa);
+  records[10].sqn[0] = 0xaa;
+
+  std::vector<srsepc::hss_db_record_t> exported(db.nof_records());
+  for (uint64_t i = 0; i < db.nof_records(); i++) {
+    exported[i] = *db.get_record(i);
+  }
+  db.close();
+  TESTASSERT(srsepc::hss_db_write_csv(export_file, exported, log));
+  csv_records.clear();
+  TESTASSERT(srsepc::hss_db_read_csv(export_file, &csv_records, log));
+  TESTASSERT(memcmp(csv_records.data(), records.data(), nof_records * sizeof(srsepc::hss_db_record_t)) == 0);
+
+  // Duplicated IMSIs are rejected
+  records[1].imsi = records[0].imsi;
+  TESTASSERT(not srsepc::hss_db::create(db_file, records, log));
+
+  remove(csv_file);
+  remove(db_file);
+  remove(export_file);
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * The HSS keeps the SQN of the binary database up to date, without rewriting it on stop
+ */
+int test_hss_sqn_update(srslte::log_filter* log)
+{
+  std::vector<srsepc::hss_db_record_t> records = make_records(10);
+  TESTASSERT(srsepc::hss_db::create(db_file, records, log));
+
+  srsepc::hss_args_t args = {};
+  args.db_file            = db_file;
+  args.mcc                = 0xf001;
+  args.mnc                = 0xff01;
+
+  uint8_t k_asme[32];
+  uint8_t autn[16];
+  uint8_t rand[16];
+  uint8_t xres[8];
+  uint8_t qci = 0;
+
+  srsepc::hss* hss = srsepc::hss::get_instance();
+  TESTASSERT(hss->init(&args, log) == 0);
+  TESTASSERT(hss->get_ip_to_imsi().size() == 1);
+  TESTASSERT(hss->gen_update_loc_answer(records[1].imsi, &qci));
+  TESTASSERT(qci == records[1].qci);
+  TESTASSERT(hss->gen_auth_info_answer(records[1].imsi, k_asme, autn, rand, xres));
+  TESTASSERT(not hss->gen_auth_info_answer(records[1].imsi + 1, k_asme, autn, rand, xres));
+  hss->stop();
+  srsepc::hss::cleanup();
+
+  // SEQ and IND are both incremented
+  srsepc::hss_db db;
+  TESTASSERT(db.open(db_file, log));
+  TESTASSERT(db.find(records[1].imsi)->sqn[5] == records[1].sqn[5] + 0x21);
+  TESTASSERT(memcmp(db.find(records[3].imsi)->sqn, records[3].sqn, 6) == 0);
+  db.close();
+
+  remove(db_file);
+  return SRSLTE_SUCCESS;
+}
+
+/*
+ * Start-up time of a large database, CSV parse against mapping the binary database
+ */
+int test_startup_time(srslte::log_filter* log)
+{
+  const uint32_t                       nof_records = 100000;
+  std::vector<srsepc::hss_db_record_t> records     = make_records(nof_records);
+  TESTASSERT(srsepc::hss_db_write_csv(csv_file, records, log));
+  TESTASSERT(srsepc::hss_db::create(db_file, records, log));
+
+  auto                                 t0 = std::chrono::steady_clock::now();
+  std::vector<srsepc::hss_db_record_t> csv_records;
+  TESTASSERT(srsepc::hss_db_read_csv(csv_file, &csv_records, log));
+  auto           t1 = std::chrono::steady_clock::now();
+  srsepc::hss_db db;
+  TESTASSERT(db.open(db_file, log));
+  auto t2 = std::chrono::steady_clock::now();
+  for (const srsepc::hss_db_record_t& rec : records) {
+    TESTASSERT(db.find(rec.imsi) != nullptr);
+  }
+  auto t3 = std::chrono::steady_clock::now();
+  db.close();
+
+  printf("%d subscribers: CSV parse %.1f ms, DB open %.3f ms, %.3f us per IMSI lookup\n",
+         nof_records,
+         std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / 1000.0,
+         std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() / 1000.0,
+         std::chrono::duration_cast<std::chrono::nanoseconds>(t3 - t2).count() / 1000.0 / nof_records);
+
+  remove(csv_file);
+  remove(db_file);
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::log_filter log("HSS");
+  log.set_level(srslte::LOG_LEVEL_ERROR);
+
+  TESTASSERT(test_import_export(&log) == SRSLTE_SUCCESS);
+  TESTASSERT(test_hss_sqn_update(&log) == SRSLTE_SUCCESS);
+  TESTASSERT(test_startup_time(&log) == SRSLTE_SUCCESS);
+
+  return SRSLTE_SUCCESS;
+}
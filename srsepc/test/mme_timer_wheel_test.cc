@@ -0,0 +1,117 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include "srsepc/hdr/mme/mme_timer_wheel.h"
+#include "srslte/common/test_common.h"
+#include <poll.h>
+
+using srsepc::mme_timer_t;
+
+// Timers expire at their tick, also when they are more than one turn of the wheel away
+int test_expiry()
+{
+  srsepc::mme_timer_wheel  wheel(10, 8);
+  std::vector<mme_timer_t> expired;
+
+  TESTASSERT(wheel.add(25, srsepc::T_3413, 1));  // tick 3
+  TESTASSERT(wheel.add(200, srsepc::T_3413, 2)); // tick 20, after 2 turns
+  TESTASSERT(wheel.add(0, srsepc::T_3413, 3));   // tick 1
+  TESTASSERT(not wheel.add(10, srsepc::T_3413, 1));
+  TESTASSERT(wheel.size() == 3);
+
+  wheel.advance(1, &expired);
+  TESTASSERT(expired.size() == 1 && expired[0].imsi == 3);
+  wheel.advance(1, &expired);
+  TESTASSERT(expired.size() == 1);
+  wheel.advance(1, &expired);
+  TESTASSERT(expired.size() == 2 && expired[1].imsi == 1 && expired[1].type == srsepc::T_3413);
+  TESTASSERT(wheel.is_running(srsepc::T_3413, 2));
+
+  wheel.advance(16, &expired);
+  TESTASSERT(expired.size() == 2);
+  wheel.advance(1, &expired);
+  TESTASSERT(expired.size() == 3 && expired[2].imsi == 2);
+  TESTASSERT(wheel.size() == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+// Removed timers don't expire, also when they are added again with another timeout
+int test_remove()
+{
+  srsepc::mme_timer_wheel  wheel(10, 8);
+  std::vector<mme_timer_t> expired;
+
+  TESTASSERT(not wheel.remove(srsepc::T_3413, 1));
+  for (uint64_t imsi = 0; imsi < 100; imsi++) {
+    TESTASSERT(wheel.add(50, srsepc::T_3413, imsi));
+  }
+  for (uint64_t imsi = 0; imsi < 100; imsi += 2) {
+    TESTASSERT(wheel.remove(srsepc::T_3413, imsi));
+    TESTASSERT(not wheel.is_running(srsepc::T_3413, imsi));
+  }
+  TESTASSERT(wheel.add(100, srsepc::T_3413, 0));
+
+  wheel.advance(5, &expired);
+  TESTASSERT(expired.size() == 50);
+  for (const mme_timer_t& t : expired) {
+    TESTASSERT(t.imsi % 2 == 1);
+  }
+  wheel.advance(5, &expired);
+  TESTASSERT(expired.size() == 51 && expired[50].imsi == 0);
+  TESTASSERT(wheel.size() == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+// The timerfd only ticks while there are timers running
+int test_timerfd()
+{
+  srsepc::mme_timer_wheel  wheel(10, 8);
+  std::vector<mme_timer_t> expired;
+  TESTASSERT(wheel.init() == SRSLTE_SUCCESS);
+
+  struct pollfd pfd = {};
+  pfd.fd            = wheel.get_fd();
+  pfd.events        = POLLIN;
+  TESTASSERT(poll(&pfd, 1, 30) == 0);
+
+  TESTASSERT(wheel.add(30, srsepc::T_3413, 1));
+  for (uint32_t i = 0; i < 100 && expired.empty(); i++) {
+    TESTASSERT(poll(&pfd, 1, 100) == 1);
+    wheel.handle_tick(&expired);
+  }
+  TESTASSERT(expired.size() == 1 && expired[0].imsi == 1);
+  TESTASSERT(poll(&pfd, 1, 30) == 0);
+
+  wheel.stop();
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_expiry() == SRSLTE_SUCCESS);
+  TESTASSERT(test_remove() == SRSLTE_SUCCESS);
+  TESTASSERT(test_timerfd() == SRSLTE_SUCCESS);
+
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,1155 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        s1ap_loadgen.cc
+ * Description: S1AP/NAS load generator for srsepc. Emulates many eNBs and
+ *              UEs over SCTP and drives the attach, service request, paging
+ *              and detach procedures against a running MME, reporting the
+ *              latency percentiles of each procedure.
+ *****************************************************************************/
+
+#include "srsepc/hdr/hss/hss_db.h"
+#include "srsepc/hdr/mme/ctx_table.h"
+#include "srslte/asn1/liblte_mme.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/bcd_helpers.h"
+#include "srslte/common/int_helpers.h"
+#include "srslte/common/log_filter.h"
+#include "srslte/common/network_utils.h"
+#include "srslte/common/security.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <getopt.h>
+#include <inttypes.h>
+#include <netinet/sctp.h>
+#include <queue>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace srslte;
+using namespace asn1::s1ap;
+
+#define S1AP_PORT 36412
+#define S1AP_PPID 18
+#define NONUE_STREAM_ID 0
+#define UE_STREAM_ID 1
+
+namespace {
+
+struct args_t {
+  std::string mme_addr     = "127.0.1.100";
+  std::string bind_addr    = "127.0.1.1";
+  uint32_t    nof_enbs     = 1;
+  uint32_t    nof_ues      = 100;
+  uint64_t    imsi_base    = 1010123456789ull;
+  std::string key          = "00112233445566778899aabbccddeeff";
+  std::string opc          = "63bfa50ee6523365ff14c1f45f88737d";
+  std::string mcc          = "001";
+  std::string mnc          = "01";
+  uint16_t    tac          = 7;
+  uint32_t    nof_cycles   = 1;
+  uint32_t    rate         = 0; // UEs started per second, 0 starts all of them at once
+  uint32_t    hold_ms      = 100;
+  uint32_t    timeout_ms   = 5000;
+  bool        paging       = false;
+  std::string user_db_file = "";
+};
+
+args_t        args;
+volatile bool running = true;
+
+void sig_int_handler(int signo)
+{
+  running = false;
+}
+
+uint64_t now_us()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool hex_to_bytes(const std::string& str, uint8_t* out, uint32_t len)
+{
+  if (str.size() != 2 * len) {
+    return false;
+  }
+  for (uint32_t i = 0; i < len; i++) {
+    char* end  = nullptr;
+    char  b[3] = {str[2 * i], str[2 * i + 1], 0};
+    out[i]     = (uint8_t)strtoul(b, &end, 16);
+    if (*end != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+ * Procedures and statistics
+ ******************************************************************************/
+
+enum proc_t { PROC_ATTACH, PROC_SERVICE_REQUEST, PROC_PAGING, PROC_RELEASE, PROC_DETACH, PROC_NOF };
+const char* proc_names[PROC_NOF] = {"Attach", "Service Request", "Paging", "Release", "Detach"};
+
+struct proc_stats_t {
+  std::vector<uint32_t> latency_us;
+  uint32_t              nof_failures = 0;
+};
+
+/// Steps of one cycle of a UE. Each step is one procedure, the paging step continues with a service request
+enum step_t { STEP_ATTACH, STEP_RELEASE, STEP_PAGING, STEP_SERVICE_REQUEST, STEP_DETACH };
+
+struct ue_t {
+  enum state_t { IDLE, ATTACHING, SERVICE_REQUESTING, PAGING, RELEASING, DETACHING, CONNECTED, DONE };
+
+  uint64_t imsi           = 0;
+  uint32_t enb_idx        = 0;
+  uint32_t enb_ue_s1ap_id = 0;
+  uint32_t mme_ue_s1ap_id = 0;
+  state_t  state          = IDLE;
+  proc_t   proc           = PROC_ATTACH;
+  uint32_t step           = 0;
+  uint32_t cycle          = 0;
+  uint32_t timer_seq      = 0; // Invalidates the timers armed before the last state change
+  uint64_t t_start        = 0;
+
+  // NAS security context
+  uint8_t                     k_asme[32]    = {};
+  uint8_t                     k_nas_enc[32] = {};
+  uint8_t                     k_nas_int[32] = {};
+  CIPHERING_ALGORITHM_ID_ENUM cipher_algo   = CIPHERING_ALGORITHM_ID_EEA0;
+  INTEGRITY_ALGORITHM_ID_ENUM integ_algo    = INTEGRITY_ALGORITHM_ID_EIA0;
+  uint8_t                     ksi           = 0;
+  uint32_t                    ul_count      = 0;
+
+  LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT guti      = {};
+  bool                                 have_guti = false;
+  uint32_t                             ip        = 0; // Network byte order
+};
+
+struct enb_t {
+  uint32_t         enb_id = 0;
+  socket_handler_t socket;
+  sockaddr_in      mme_addr = {};
+  bool             ready    = false;
+};
+
+struct ue_timer_t {
+  uint64_t when;
+  uint32_t ue_idx;
+  uint32_t seq;
+  bool     operator>(const ue_timer_t& other) const { return when > other.when; }
+};
+
+/*******************************************************************************
+ * Load generator
+ ******************************************************************************/
+
+class loadgen
+{
+public:
+  bool init();
+  void run();
+  void print_report();
+
+private:
+  // Procedures
+  void start_step(uint32_t ue_idx);
+  void complete_proc(uint32_t ue_idx);
+  void fail_proc(uint32_t ue_idx, const char* reason);
+  void arm_timer(uint32_t ue_idx, uint64_t when);
+  void run_timers();
+
+  // UE side NAS
+  void send_attach_request(ue_t& ue);
+  void send_service_request(ue_t& ue, rrc_establishment_cause_opts::options cause);
+  void send_detach_request(ue_t& ue);
+  void handle_dl_nas(uint32_t ue_idx, const uint8_t* pdu, uint32_t len);
+  void handle_auth_request(ue_t& ue);
+  void handle_security_mode_command(ue_t& ue);
+  bool handle_attach_accept(ue_t& ue);
+  void protect_nas(ue_t& ue, uint8_t sec_hdr_type);
+  void integrity_generate(ue_t& ue, uint32_t count, uint8_t direction, uint8_t* msg, uint32_t len, uint8_t* mac);
+  void cipher(ue_t& ue, uint32_t count, uint8_t direction, uint8_t* msg, uint32_t len);
+
+  // eNB side S1AP
+  bool send_s1_setup_request(enb_t& enb);
+  bool send_initial_ue_message(ue_t& ue, rrc_establishment_cause_opts::options cause, bool with_s_tmsi);
+  bool send_ul_nas_transport(ue_t& ue);
+  bool send_ue_context_release_request(ue_t& ue);
+  bool send_ue_context_release_complete(ue_t& ue);
+  bool send_initial_context_setup_response(ue_t& ue, const init_context_setup_request_s& req);
+  bool send_s1ap_pdu(enb_t& enb, const s1ap_pdu_c& pdu, uint16_t stream_id);
+  void read_enb_socket(enb_t& enb);
+  void handle_s1ap_pdu(enb_t& enb, const s1ap_pdu_c& pdu);
+  void handle_init_msg(enb_t& enb, const init_msg_s& msg);
+  ue_t* find_ue(enb_t& enb, uint32_t enb_ue_s1ap_id);
+
+  srslte::log_ref      log_h = srslte::log_ref("LDGEN");
+  std::vector<enb_t>   enbs;
+  std::vector<ue_t>    ues;
+  std::vector<step_t>  steps;
+  proc_stats_t         stats[PROC_NOF];
+  uint32_t             nof_done = 0;
+  uint64_t             t_begin  = 0;
+  uint64_t             t_end    = 0;
+  int                  epoll_fd = -1;
+  int                  udp_fd   = -1;
+  uint8_t              key[16]  = {};
+  uint8_t              opc[16]  = {};
+  uint16_t             mcc      = 0;
+  uint16_t             mnc      = 0;
+  uint32_t             plmn     = 0;
+  tai_s                tai;
+  eutran_cgi_s         eutran_cgi;
+
+  // M-TMSI to UE index, to find the UE of a paging message
+  srsepc::ctx_table<uint32_t, uint32_t> tmsi_to_ue;
+
+  std::priority_queue<ue_timer_t, std::vector<ue_timer_t>, std::greater<ue_timer_t> > timers;
+
+  // Scratch messages, the NAS structures are too large for the stack of every handler
+  LIBLTE_BYTE_MSG_STRUCT                                           nas_msg;
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT                             attach_req;
+  LIBLTE_MME_ATTACH_ACCEPT_MSG_STRUCT                              attach_accept;
+  LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_complete;
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_REQUEST_MSG_STRUCT act_def_bearer_req;
+  std::vector<uint8_t>                                             rx_buf = std::vector<uint8_t>(65536);
+};
+
+bool loadgen::init()
+{
+  if (not hex_to_bytes(args.key, key, 16) or not hex_to_bytes(args.opc, opc, 16)) {
+    printf("Invalid K or OPc, expected 32 hex digits\n");
+    return false;
+  }
+  if (not string_to_mcc(args.mcc, &mcc) or not string_to_mnc(args.mnc, &mnc)) {
+    printf("Invalid MCC or MNC\n");
+    return false;
+  }
+  s1ap_mccmnc_to_plmn(mcc, mnc, &plmn);
+  tai.plm_nid.from_number(plmn);
+  tai.tac.from_number(args.tac);
+  eutran_cgi.plm_nid.from_number(plmn);
+
+  steps = {STEP_ATTACH, STEP_RELEASE};
+  if (args.paging) {
+    steps.push_back(STEP_PAGING);
+    steps.push_back(STEP_RELEASE);
+  }
+  steps.push_back(STEP_SERVICE_REQUEST);
+  steps.push_back(STEP_DETACH);
+
+  epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0) {
+    perror("epoll_create1()");
+    return false;
+  }
+  udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+  enbs.resize(args.nof_enbs);
+  for (uint32_t i = 0; i < enbs.size(); i++) {
+    enb_t& enb = enbs[i];
+    enb.enb_id = 0x100 + i;
+    if (not net_utils::sctp_init_client(&enb.socket, net_utils::socket_type::seqpacket, args.bind_addr.c_str())) {
+      printf("Failed to create the SCTP socket of eNB %d\n", i);
+      return false;
+    }
+    if (not enb.socket.connect_to(args.mme_addr.c_str(), S1AP_PORT, &enb.mme_addr)) {
+      printf("Failed to connect eNB %d to the MME at %s\n", i, args.mme_addr.c_str());
+      return false;
+    }
+    epoll_event ev = {};
+    ev.events      = EPOLLIN;
+    ev.data.u32    = i;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, enb.socket.fd(), &ev) != 0) {
+      perror("epoll_ctl()");
+      return false;
+    }
+    send_s1_setup_request(enb);
+  }
+
+  ues.resize(args.nof_ues);
+  for (uint32_t i = 0; i < ues.size(); i++) {
+    ues[i].imsi           = args.imsi_base + i;
+    ues[i].enb_idx        = i % args.nof_enbs;
+    ues[i].enb_ue_s1ap_id = i + 1;
+  }
+  return true;
+}
+
+void loadgen::run()
+{
+  // S1 Setup of all the eNBs before the first UE starts
+  uint64_t    setup_deadline = now_us() + 5000000;
+  epoll_event events[64];
+  while (running and now_us() < setup_deadline and
+         std::any_of(enbs.begin(), enbs.end(), [](const enb_t& e) { return not e.ready; })) {
+    int n = epoll_wait(epoll_fd, events, 64, 100);
+    for (int i = 0; i < n; i++) {
+      read_enb_socket(enbs[events[i].data.u32]);
+    }
+  }
+  if (std::any_of(enbs.begin(), enbs.end(), [](const enb_t& e) { return not e.ready; })) {
+    printf("S1 Setup failed\n");
+    return;
+  }
+  printf("%zu eNBs connected, starting %zu UEs\n", enbs.size(), ues.size());
+
+  t_begin = now_us();
+  for (uint32_t i = 0; i < ues.size(); i++) {
+    arm_timer(i, t_begin + (args.rate > 0 ? (uint64_t)i * 1000000 / args.rate : 0));
+  }
+
+  uint64_t next_print = t_begin + 1000000;
+  while (running and nof_done < ues.size()) {
+    int timeout_ms = 100;
+    if (not timers.empty()) {
+      uint64_t now = now_us();
+      timeout_ms   = timers.top().when <= now ? 0 : std::min<uint64_t>(100, (timers.top().when - now + 999) / 1000);
+    }
+    int n = epoll_wait(epoll_fd, events, 64, timeout_ms);
+    for (int i = 0; i < n; i++) {
+      read_enb_socket(enbs[events[i].data.u32]);
+    }
+    run_timers();
+
+    if (now_us() >= next_print) {
+      next_print += 1000000;
+      printf("[%4" PRIu64 " s] done %d/%zu UEs, attach %zu, service request %zu, detach %zu, failures %d\n",
+             (now_us() - t_begin) / 1000000,
+             nof_done,
+             ues.size(),
+             stats[PROC_ATTACH].latency_us.size(),
+             stats[PROC_SERVICE_REQUEST].latency_us.size(),
+             stats[PROC_DETACH].latency_us.size(),
+             stats[PROC_ATTACH].nof_failures + stats[PROC_SERVICE_REQUEST].nof_failures +
+                 stats[PROC_PAGING].nof_failures + stats[PROC_RELEASE].nof_failures +
+                 stats[PROC_DETACH].nof_failures);
+    }
+  }
+  t_end = now_us();
+}
+
+void loadgen::print_report()
+{
+  double secs = (t_end - t_begin) / 1e6;
+  printf("\n%zu UEs on %zu eNBs, %d cycles in %.2f s\n", ues.size(), enbs.size(), args.nof_cycles, secs);
+  printf("%-16s %8s %8s %10s %10s %10s %10s %10s\n", "Procedure", "Count", "Fail", "Rate/s", "p50 ms", "p90 ms",
+         "p99 ms", "max ms");
+  for (uint32_t p = 0; p < PROC_NOF; p++) {
+    std::vector<uint32_t>& lat = stats[p].latency_us;
+    if (lat.empty() and stats[p].nof_failures == 0) {
+      continue;
+    }
+    std::sort(lat.begin(), lat.end());
+    auto pct = [&lat](double q) { return lat.empty() ? 0.0 : lat[(size_t)(q * (lat.size() - 1))] / 1000.0; };
+    printf("%-16s %8zd %8d %10.1f %10.2f %10.2f %10.2f %10.2f\n",
+           proc_names[p],
+           lat.size(),
+           stats[p].nof_failures,
+           secs > 0 ? lat.size() / secs : 0.0,
+           pct(0.5),
+           pct(0.9),
+           pct(0.99),
+           pct(1.0));
+  }
+}
+
+/*******************************************************************************
+ * Procedures
+ ******************************************************************************/
+
+void loadgen::arm_timer(uint32_t ue_idx, uint64_t when)
+{
+  timers.push({when, ue_idx, ++ues[ue_idx].timer_seq});
+}
+
+void loadgen::run_timers()
+{
+  uint64_t now = now_us();
+  while (not timers.empty() and timers.top().when <= now) {
+    ue_timer_t t = timers.top();
+    timers.pop();
+    ue_t& ue = ues[t.ue_idx];
+    if (t.seq != ue.timer_seq) {
+      continue;
+    }
+    if (ue.state == ue_t::IDLE or ue.state == ue_t::CONNECTED) {
+      start_step(t.ue_idx);
+    } else if (ue.state != ue_t::DONE) {
+      fail_proc(t.ue_idx, "timeout");
+    }
+  }
+}
+
+void loadgen::start_step(uint32_t ue_idx)
+{
+  ue_t& ue   = ues[ue_idx];
+  ue.t_start = now_us();
+  switch (steps[ue.step]) {
+    case STEP_ATTACH:
+      ue.proc  = PROC_ATTACH;
+      ue.state = ue_t::ATTACHING;
+      send_attach_request(ue);
+      break;
+    case STEP_RELEASE:
+      ue.proc  = PROC_RELEASE;
+      ue.state = ue_t::RELEASING;
+      send_ue_context_release_request(ue);
+      break;
+    case STEP_PAGING: {
+      // Downlink data to the UE IP makes the SPGW notify the MME, which pages the UE
+      ue.proc             = PROC_PAGING;
+      ue.state            = ue_t::PAGING;
+      sockaddr_in dst     = {};
+      dst.sin_family      = AF_INET;
+      dst.sin_port        = htons(9);
+      dst.sin_addr.s_addr = ue.ip;
+      const char data[]   = "paging";
+      if (sendto(udp_fd, data, sizeof(data), 0, (sockaddr*)&dst, sizeof(dst)) < 0) {
+        log_h->warning("Failed to send downlink data to IMSI %015" PRIu64 "\n", ue.imsi);
+      }
+      break;
+    }
+    case STEP_SERVICE_REQUEST:
+      ue.proc  = PROC_SERVICE_REQUEST;
+      ue.state = ue_t::SERVICE_REQUESTING;
+      send_service_request(ue, rrc_establishment_cause_opts::mo_data);
+      break;
+    case STEP_DETACH:
+      ue.proc  = PROC_DETACH;
+      ue.state = ue_t::DETACHING;
+      send_detach_request(ue);
+      break;
+  }
+  arm_timer(ue_idx, ue.t_start + args.timeout_ms * 1000);
+}
+
+void loadgen::complete_proc(uint32_t ue_idx)
+{
+  ue_t&    ue  = ues[ue_idx];
+  uint64_t now = now_us();
+  stats[ue.proc].latency_us.push_back(now - ue.t_start);
+
+  bool connected = ue.proc == PROC_ATTACH or ue.proc == PROC_SERVICE_REQUEST;
+  ue.state       = connected ? ue_t::CONNECTED : ue_t::IDLE;
+  if (++ue.step == steps.size()) {
+    ue.step = 0;
+    if (++ue.cycle == args.nof_cycles) {
+      ue.state = ue_t::DONE;
+      nof_done++;
+      return;
+    }
+  }
+  arm_timer(ue_idx, now + args.hold_ms * 1000);
+}
+
+// The cycle of a failed UE starts over with an IMSI attach, which replaces whatever context the MME still has
+void loadgen::fail_proc(uint32_t ue_idx, const char* reason)
+{
+  ue_t& ue = ues[ue_idx];
+  log_h->warning("%s failed for IMSI %015" PRIu64 ": %s\n", proc_names[ue.proc], ue.imsi, reason);
+  stats[ue.proc].nof_failures++;
+  ue.state = ue_t::IDLE;
+  ue.step  = 0;
+  if (++ue.cycle == args.nof_cycles) {
+    ue.state = ue_t::DONE;
+    nof_done++;
+    return;
+  }
+  arm_timer(ue_idx, now_us() + args.hold_ms * 1000);
+}
+
+/*******************************************************************************
+ * UE side NAS
+ ******************************************************************************/
+
+void loadgen::integrity_generate(ue_t&    ue,
+                                 uint32_t count,
+                                 uint8_t  direction,
+                                 uint8_t* msg,
+                                 uint32_t len,
+                                 uint8_t* mac)
+{
+  switch (ue.integ_algo) {
+    case INTEGRITY_ALGORITHM_ID_128_EIA1:
+      security_128_eia1(&ue.k_nas_int[16], count, 0, direction, msg, len, mac);
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2:
+      security_128_eia2(&ue.k_nas_int[16], count, 0, direction, msg, len, mac);
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA3:
+      security_128_eia3(&ue.k_nas_int[16], count, 0, direction, msg, len, mac);
+      break;
+    default:
+      memset(mac, 0, 4);
+      break;
+  }
+}
+
+void loadgen::cipher(ue_t& ue, uint32_t count, uint8_t direction, uint8_t* msg, uint32_t len)
+{
+  switch (ue.cipher_algo) {
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+      security_128_eea1(&ue.k_nas_enc[16], count, 0, direction, msg, len, msg);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2:
+      security_128_eea2(&ue.k_nas_enc[16], count, 0, direction, msg, len, msg);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+      security_128_eea3(&ue.k_nas_enc[16], count, 0, direction, msg, len, msg);
+      break;
+    default:
+      break;
+  }
+}
+
+// Ciphers and integrity protects the packed message in nas_msg, as the UE NAS does, and steps the uplink count
+void loadgen::protect_nas(ue_t& ue, uint8_t sec_hdr_type)
+{
+  if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED ||
+      sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT) {
+    cipher(ue, nas_msg.msg[5], SECURITY_DIRECTION_UPLINK, &nas_msg.msg[6], nas_msg.N_bytes - 6);
+  }
+  integrity_generate(ue, ue.ul_count, SECURITY_DIRECTION_UPLINK, &nas_msg.msg[5], nas_msg.N_bytes - 5, &nas_msg.msg[1]);
+  ue.ul_count++;
+}
+
+void loadgen::send_attach_request(ue_t& ue)
+{
+  attach_req                 = {};
+  attach_req.eps_attach_type = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+  for (uint32_t i = 0; i < 4; i++) {
+    attach_req.ue_network_cap.eea[i] = true;
+    attach_req.ue_network_cap.eia[i] = true;
+  }
+  attach_req.nas_ksi.tsc_flag         = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req.nas_ksi.nas_ksi          = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+  attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  uint64_t imsi                       = ue.imsi;
+  for (int i = 14; i >= 0; i--) {
+    attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+    imsi /= 10;
+  }
+
+  // PDN connectivity request for the default bearer
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+  pdn_con_req.eps_bearer_id                                  = 0;
+  pdn_con_req.proc_transaction_id                            = 1;
+  pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+
+  nas_msg = {};
+  liblte_mme_pack_attach_request_msg(&attach_req, &nas_msg);
+  send_initial_ue_message(ue, rrc_establishment_cause_opts::mo_sig, false);
+}
+
+void loadgen::send_service_request(ue_t& ue, rrc_establishment_cause_opts::options cause)
+{
+  // The service request is packed directly, with the short MAC of the first two octets
+  nas_msg.N_bytes = 4;
+  nas_msg.msg[0]  = (LIBLTE_MME_SECURITY_HDR_TYPE_SERVICE_REQUEST << 4u) | LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT;
+  nas_msg.msg[1]  = ((ue.ksi & 0x07u) << 5u) | (ue.ul_count & 0x1fu);
+  uint8_t mac[4];
+  integrity_generate(ue, ue.ul_count, SECURITY_DIRECTION_UPLINK, nas_msg.msg, 2, mac);
+  nas_msg.msg[2] = mac[2];
+  nas_msg.msg[3] = mac[3];
+  ue.ul_count++;
+  send_initial_ue_message(ue, cause, true);
+}
+
+// Switch-off detach from connected mode, the MME answers with a UE context release
+void loadgen::send_detach_request(ue_t& ue)
+{
+  LIBLTE_MME_DETACH_REQUEST_MSG_STRUCT detach_req = {};
+  detach_req.detach_type.switch_off               = 1;
+  detach_req.detach_type.type_of_detach           = LIBLTE_MME_TOD_UL_EPS_DETACH;
+  detach_req.nas_ksi.tsc_flag                     = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  detach_req.nas_ksi.nas_ksi                      = ue.ksi;
+  detach_req.eps_mobile_id.type_of_id             = LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI;
+  detach_req.eps_mobile_id.guti                   = ue.guti;
+
+  nas_msg = {};
+  liblte_mme_pack_detach_request_msg(&detach_req, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY, ue.ul_count, &nas_msg);
+  protect_nas(ue, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY);
+  send_ul_nas_transport(ue);
+}
+
+// The MAC of downlink messages is not checked, the MME is trusted and the work is spent on the uplink side
+void loadgen::handle_dl_nas(uint32_t ue_idx, const uint8_t* pdu, uint32_t len)
+{
+  ue_t& ue = ues[ue_idx];
+  if (len < 2 or len > sizeof(nas_msg.msg)) {
+    return;
+  }
+  memcpy(nas_msg.msg, pdu, len);
+  nas_msg.N_bytes = len;
+
+  uint8_t pd, sec_hdr_type, msg_type;
+  liblte_mme_parse_msg_sec_header(&nas_msg, &pd, &sec_hdr_type);
+  if ((sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED ||
+       sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT) &&
+      len > 6) {
+    cipher(ue, nas_msg.msg[5], SECURITY_DIRECTION_DOWNLINK, &nas_msg.msg[6], len - 6);
+  }
+  liblte_mme_parse_msg_header(&nas_msg, &pd, &msg_type);
+
+  switch (msg_type) {
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+      handle_auth_request(ue);
+      break;
+    case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+      handle_security_mode_command(ue);
+      break;
+    case LIBLTE_MME_MSG_TYPE_EMM_INFORMATION:
+      break;
+    case LIBLTE_MME_MSG_TYPE_ATTACH_REJECT:
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REJECT:
+    case LIBLTE_MME_MSG_TYPE_SERVICE_REJECT:
+      fail_proc(ue_idx, liblte_nas_msg_type_to_string(msg_type));
+      break;
+    default:
+      log_h->info("Ignoring NAS message %s\n", liblte_nas_msg_type_to_string(msg_type));
+      break;
+  }
+}
+
+void loadgen::handle_auth_request(ue_t& ue)
+{
+  LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+  liblte_mme_unpack_authentication_request_msg(&nas_msg, &auth_req);
+
+  // The SQN is not checked for freshness, the generator never runs out of sync with the HSS
+  uint8_t res[8], ck[16], ik[16], ak[6], sqn[6];
+  security_milenage_f2345(key, opc, auth_req.rand, res, ck, ik, ak);
+  for (uint32_t i = 0; i < 6; i++) {
+    sqn[i] = auth_req.autn[i] ^ ak[i];
+  }
+  security_generate_k_asme(ck, ik, ak, sqn, mcc, mnc, ue.k_asme);
+  ue.ksi = auth_req.nas_ksi.nas_ksi;
+
+  LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_resp = {};
+  memcpy(auth_resp.res, res, 8);
+  auth_resp.res_len = 8;
+  nas_msg           = {};
+  liblte_mme_pack_authentication_response_msg(&auth_resp, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, &nas_msg);
+  send_ul_nas_transport(ue);
+}
+
+void loadgen::handle_security_mode_command(ue_t& ue)
+{
+  LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT smc = {};
+  liblte_mme_unpack_security_mode_command_msg(&nas_msg, &smc);
+  ue.cipher_algo = (CIPHERING_ALGORITHM_ID_ENUM)smc.selected_nas_sec_algs.type_of_eea;
+  ue.integ_algo  = (INTEGRITY_ALGORITHM_ID_ENUM)smc.selected_nas_sec_algs.type_of_eia;
+  ue.ksi         = smc.nas_ksi.nas_ksi;
+  security_generate_k_nas(ue.k_asme, ue.cipher_algo, ue.integ_algo, ue.k_nas_enc, ue.k_nas_int);
+
+  // The new security context starts the counts from 0 (TS 24.301 5.4.3.2)
+  ue.ul_count                                           = 0;
+  LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT smc_comp = {};
+  nas_msg                                               = {};
+  liblte_mme_pack_security_mode_complete_msg(
+      &smc_comp, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT, 0, &nas_msg);
+  protect_nas(ue, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT);
+  send_ul_nas_transport(ue);
+}
+
+// Takes the GUTI and IP of the attach accept in nas_msg and packs the attach complete in its place
+bool loadgen::handle_attach_accept(ue_t& ue)
+{
+  uint8_t pd, msg_type;
+  liblte_mme_parse_msg_header(&nas_msg, &pd, &msg_type);
+  if (msg_type != LIBLTE_MME_MSG_TYPE_ATTACH_ACCEPT) {
+    return false;
+  }
+  attach_accept = {};
+  if (liblte_mme_unpack_attach_accept_msg(&nas_msg, &attach_accept) != LIBLTE_SUCCESS or
+      not attach_accept.guti_present) {
+    return false;
+  }
+  act_def_bearer_req = {};
+  liblte_mme_unpack_activate_default_eps_bearer_context_request_msg(&attach_accept.esm_msg, &act_def_bearer_req);
+
+  if (ue.have_guti) {
+    tmsi_to_ue.erase(ue.guti.m_tmsi);
+  }
+  ue.guti      = attach_accept.guti.guti;
+  ue.have_guti = true;
+  tmsi_to_ue.erase(ue.guti.m_tmsi);
+  tmsi_to_ue.insert(ue.guti.m_tmsi, ue.enb_ue_s1ap_id - 1);
+  memcpy(&ue.ip, act_def_bearer_req.pdn_addr.addr, 4);
+
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_def_bearer_acc = {};
+  act_def_bearer_acc.eps_bearer_id       = act_def_bearer_req.eps_bearer_id;
+  act_def_bearer_acc.proc_transaction_id = act_def_bearer_req.proc_transaction_id;
+  attach_complete                        = {};
+  liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_def_bearer_acc, &attach_complete.esm_msg);
+
+  nas_msg = {};
+  liblte_mme_pack_attach_complete_msg(
+      &attach_complete, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, ue.ul_count, &nas_msg);
+  protect_nas(ue, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED);
+  return true;
+}
+
+/*******************************************************************************
+ * eNB side S1AP
+ ******************************************************************************/
+
+bool loadgen::send_s1ap_pdu(enb_t& enb, const s1ap_pdu_c& pdu, uint16_t stream_id)
+{
+  uint8_t       buf[4096];
+  asn1::bit_ref bref(buf, sizeof(buf));
+  if (pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    log_h->error("Failed to pack S1AP PDU\n");
+    return false;
+  }
+  ssize_t n_sent = sctp_sendmsg(enb.socket.fd(),
+                                buf,
+                                bref.distance_bytes(),
+                                (struct sockaddr*)&enb.mme_addr,
+                                sizeof(struct sockaddr_in),
+                                htonl(S1AP_PPID),
+                                0,
+                                stream_id,
+                                0,
+                                0);
+  if (n_sent == -1) {
+    log_h->error("Failed to send S1AP PDU of eNB 0x%x\n", enb.enb_id);
+    return false;
+  }
+  return true;
+}
+
+bool loadgen::send_s1_setup_request(enb_t& enb)
+{
+  uint32_t plmn_be = htonl(plmn);
+  uint16_t tac_be  = htons(args.tac);
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+  s1_setup_request_ies_container& container = pdu.init_msg().value.s1_setup_request().protocol_ies;
+  container.global_enb_id.value.plm_nid[0]  = ((uint8_t*)&plmn_be)[1];
+  container.global_enb_id.value.plm_nid[1]  = ((uint8_t*)&plmn_be)[2];
+  container.global_enb_id.value.plm_nid[2]  = ((uint8_t*)&plmn_be)[3];
+  container.global_enb_id.value.enb_id.set_macro_enb_id().from_number(enb.enb_id);
+
+  container.enbname_present = true;
+  container.enbname.value.from_string("loadgen" + std::to_string(enb.enb_id));
+
+  container.supported_tas.value.resize(1);
+  memcpy(container.supported_tas.value[0].tac.data(), (uint8_t*)&tac_be, 2);
+  container.supported_tas.value[0].broadcast_plmns.resize(1);
+  container.supported_tas.value[0].broadcast_plmns[0][0] = ((uint8_t*)&plmn_be)[1];
+  container.supported_tas.value[0].broadcast_plmns[0][1] = ((uint8_t*)&plmn_be)[2];
+  container.supported_tas.value[0].broadcast_plmns[0][2] = ((uint8_t*)&plmn_be)[3];
+
+  container.default_paging_drx.value.value = asn1::s1ap::paging_drx_opts::v128;
+
+  return send_s1ap_pdu(enb, pdu, NONUE_STREAM_ID);
+}
+
+bool loadgen::send_initial_ue_message(ue_t& ue, rrc_establishment_cause_opts::options cause, bool with_s_tmsi)
+{
+  enb_t& enb = enbs[ue.enb_idx];
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+  init_ue_msg_ies_container& container = pdu.init_msg().value.init_ue_msg().protocol_ies;
+
+  if (with_s_tmsi) {
+    container.s_tmsi_present = true;
+    uint32_to_uint8(ue.guti.m_tmsi, container.s_tmsi.value.m_tmsi.data());
+    container.s_tmsi.value.mmec[0] = ue.guti.mme_code;
+  }
+  container.enb_ue_s1ap_id.value = ue.enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas_msg.N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas_msg.msg, nas_msg.N_bytes);
+  container.tai.value        = tai;
+  container.eutran_cgi.value = eutran_cgi;
+  container.eutran_cgi.value.cell_id.from_number(enb.enb_id << 8u);
+  container.rrc_establishment_cause.value = cause;
+
+  return send_s1ap_pdu(enb, pdu, UE_STREAM_ID);
+}
+
+bool loadgen::send_ul_nas_transport(ue_t& ue)
+{
+  enb_t& enb = enbs[ue.enb_idx];
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+  ul_nas_transport_ies_container& container = pdu.init_msg().value.ul_nas_transport().protocol_ies;
+  container.mme_ue_s1ap_id.value            = ue.mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value            = ue.enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas_msg.N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas_msg.msg, nas_msg.N_bytes);
+  container.eutran_cgi.value = eutran_cgi;
+  container.eutran_cgi.value.cell_id.from_number(enb.enb_id << 8u);
+  container.tai.value = tai;
+
+  return send_s1ap_pdu(enb, pdu, UE_STREAM_ID);
+}
+
+bool loadgen::send_ue_context_release_request(ue_t& ue)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE_REQUEST);
+  ue_context_release_request_ies_container& container =
+      pdu.init_msg().value.ue_context_release_request().protocol_ies;
+  container.mme_ue_s1ap_id.value = ue.mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value = ue.enb_ue_s1ap_id;
+  container.cause.value.set_radio_network().value = cause_radio_network_opts::user_inactivity;
+
+  return send_s1ap_pdu(enbs[ue.enb_idx], pdu, UE_STREAM_ID);
+}
+
+bool loadgen::send_ue_context_release_complete(ue_t& ue)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE);
+  auto& container                = pdu.successful_outcome().value.ue_context_release_complete().protocol_ies;
+  container.enb_ue_s1ap_id.value = ue.enb_ue_s1ap_id;
+  container.mme_ue_s1ap_id.value = ue.mme_ue_s1ap_id;
+
+  return send_s1ap_pdu(enbs[ue.enb_idx], pdu, UE_STREAM_ID);
+}
+
+bool loadgen::send_initial_context_setup_response(ue_t& ue, const init_context_setup_request_s& req)
+{
+  uint8_t addr[4];
+  inet_pton(AF_INET, args.bind_addr.c_str(), addr);
+
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+  auto& container = pdu.successful_outcome().value.init_context_setup_resp().protocol_ies;
+  container.mme_ue_s1ap_id.value = ue.mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value = ue.enb_ue_s1ap_id;
+
+  const erab_to_be_setup_list_ctxt_su_req_l& erabs = req.protocol_ies.erab_to_be_setup_list_ctxt_su_req.value;
+  container.erab_setup_list_ctxt_su_res.value.resize(erabs.size());
+  for (uint32_t i = 0; i < erabs.size(); i++) {
+    container.erab_setup_list_ctxt_su_res.value[i].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+    auto& item   = container.erab_setup_list_ctxt_su_res.value[i].value.erab_setup_item_ctxt_su_res();
+    item.erab_id = erabs[i].value.erab_to_be_setup_item_ctxt_su_req().erab_id;
+    item.transport_layer_address.resize(32);
+    for (uint32_t j = 0; j < 4; ++j) {
+      item.transport_layer_address.data()[j] = addr[3 - j];
+    }
+    uint32_to_uint8(ue.enb_ue_s1ap_id, item.gtp_teid.data());
+  }
+
+  return send_s1ap_pdu(enbs[ue.enb_idx], pdu, UE_STREAM_ID);
+}
+
+void loadgen::read_enb_socket(enb_t& enb)
+{
+  while (true) {
+    sockaddr_in     from    = {};
+    socklen_t       fromlen = sizeof(from);
+    sctp_sndrcvinfo sri     = {};
+    int             flags   = MSG_DONTWAIT;
+    int             n       = sctp_recvmsg(
+        enb.socket.fd(), rx_buf.data(), rx_buf.size(), (struct sockaddr*)&from, &fromlen, &sri, &flags);
+    if (n <= 0) {
+      if (n == 0 or (errno != EAGAIN and errno != EWOULDBLOCK)) {
+        printf("Lost the SCTP association of eNB 0x%x\n", enb.enb_id);
+        running = false;
+      }
+      return;
+    }
+    if (flags & MSG_NOTIFICATION) {
+      continue;
+    }
+
+    s1ap_pdu_c     pdu;
+    asn1::cbit_ref bref(rx_buf.data(), n);
+    if (pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+      log_h->error("Failed to unpack S1AP PDU\n");
+      continue;
+    }
+    handle_s1ap_pdu(enb, pdu);
+  }
+}
+
+ue_t* loadgen::find_ue(enb_t& enb, uint32_t enb_ue_s1ap_id)
+{
+  if (enb_ue_s1ap_id == 0 or enb_ue_s1ap_id > ues.size()) {
+    return nullptr;
+  }
+  ue_t* ue = &ues[enb_ue_s1ap_id - 1];
+  return &enbs[ue->enb_idx] == &enb ? ue : nullptr;
+}
+
+void loadgen::handle_s1ap_pdu(enb_t& enb, const s1ap_pdu_c& pdu)
+{
+  using successful_outcome_type_opts_t = s1ap_elem_procs_o::successful_outcome_c::types_opts;
+
+  switch (pdu.type().value) {
+    case s1ap_pdu_c::types_opts::init_msg:
+      handle_init_msg(enb, pdu.init_msg());
+      break;
+    case s1ap_pdu_c::types_opts::successful_outcome:
+      if (pdu.successful_outcome().value.type().value == successful_outcome_type_opts_t::s1_setup_resp) {
+        enb.ready = true;
+      }
+      break;
+    case s1ap_pdu_c::types_opts::unsuccessful_outcome:
+      printf("Unsuccessful outcome for eNB 0x%x: %s\n",
+             enb.enb_id,
+             pdu.unsuccessful_outcome().value.type().to_string().c_str());
+      break;
+    default:
+      break;
+  }
+}
+
+void loadgen::handle_init_msg(enb_t& enb, const init_msg_s& msg)
+{
+  using init_msg_type_opts_t = s1ap_elem_procs_o::init_msg_c::types_opts;
+
+  switch (msg.value.type().value) {
+    case init_msg_type_opts_t::dl_nas_transport: {
+      const dl_nas_transport_ies_container& ies = msg.value.dl_nas_transport().protocol_ies;
+      ue_t*                                 ue  = find_ue(enb, ies.enb_ue_s1ap_id.value.value);
+      if (ue == nullptr or ue->state == ue_t::DONE) {
+        break;
+      }
+      ue->mme_ue_s1ap_id = ies.mme_ue_s1ap_id.value.value;
+      handle_dl_nas(ue->enb_ue_s1ap_id - 1, ies.nas_pdu.value.data(), ies.nas_pdu.value.size());
+      break;
+    }
+    case init_msg_type_opts_t::init_context_setup_request: {
+      const init_context_setup_request_s& req = msg.value.init_context_setup_request();
+      ue_t* ue = find_ue(enb, req.protocol_ies.enb_ue_s1ap_id.value.value);
+      if (ue == nullptr or (ue->state != ue_t::ATTACHING and ue->state != ue_t::SERVICE_REQUESTING)) {
+        break;
+      }
+      ue->mme_ue_s1ap_id = req.protocol_ies.mme_ue_s1ap_id.value.value;
+      send_initial_context_setup_response(*ue, req);
+      if (ue->state == ue_t::ATTACHING) {
+        const erab_to_be_setup_item_ctxt_su_req_s& erab =
+            req.protocol_ies.erab_to_be_setup_list_ctxt_su_req.value[0].value.erab_to_be_setup_item_ctxt_su_req();
+        if (not erab.nas_pdu_present) {
+          fail_proc(ue->enb_ue_s1ap_id - 1, "no attach accept");
+          break;
+        }
+        handle_dl_nas(ue->enb_ue_s1ap_id - 1, erab.nas_pdu.data(), erab.nas_pdu.size());
+        if (not handle_attach_accept(*ue)) {
+          fail_proc(ue->enb_ue_s1ap_id - 1, "invalid attach accept");
+          break;
+        }
+        send_ul_nas_transport(*ue);
+      }
+      complete_proc(ue->enb_ue_s1ap_id - 1);
+      break;
+    }
+    case init_msg_type_opts_t::ue_context_release_cmd: {
+      const ue_context_release_cmd_ies_container& ies = msg.value.ue_context_release_cmd().protocol_ies;
+      if (ies.ue_s1ap_ids.value.type().value != ue_s1ap_ids_c::types_opts::ue_s1ap_id_pair) {
+        break;
+      }
+      ue_t* ue = find_ue(enb, ies.ue_s1ap_ids.value.ue_s1ap_id_pair().enb_ue_s1ap_id);
+      if (ue == nullptr) {
+        break;
+      }
+      send_ue_context_release_complete(*ue);
+      if (ue->state == ue_t::RELEASING or ue->state == ue_t::DETACHING) {
+        complete_proc(ue->enb_ue_s1ap_id - 1);
+      }
+      break;
+    }
+    case init_msg_type_opts_t::paging: {
+      // Paging is sent to all the eNBs of the TA, the first copy answers it
+      const paging_ies_container& ies = msg.value.paging().protocol_ies;
+      if (ies.ue_paging_id.value.type().value != ue_paging_id_c::types_opts::s_tmsi) {
+        break;
+      }
+      uint32_t  m_tmsi = ies.ue_paging_id.value.s_tmsi().m_tmsi.to_number();
+      uint32_t* ue_idx = tmsi_to_ue.find(m_tmsi);
+      if (ue_idx == nullptr or ues[*ue_idx].state != ue_t::PAGING) {
+        break;
+      }
+      // The paging step goes on with the service request, which completes it
+      ue_t&    ue  = ues[*ue_idx];
+      uint64_t now = now_us();
+      stats[PROC_PAGING].latency_us.push_back(now - ue.t_start);
+      ue.proc    = PROC_SERVICE_REQUEST;
+      ue.state   = ue_t::SERVICE_REQUESTING;
+      ue.t_start = now;
+      send_service_request(ue, rrc_establishment_cause_opts::mt_access);
+      arm_timer(*ue_idx, now + args.timeout_ms * 1000);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+/*******************************************************************************
+ * Arguments
+ ******************************************************************************/
+
+void usage(const char* prog)
+{
+  printf("Usage: %s [options]\n", prog);
+  printf("\t-a MME address [Default %s]\n", args.mme_addr.c_str());
+  printf("\t-b Local bind address of the eNBs [Default %s]\n", args.bind_addr.c_str());
+  printf("\t-e Number of eNBs [Default %d]\n", args.nof_enbs);
+  printf("\t-u Number of UEs [Default %d]\n", args.nof_ues);
+  printf("\t-i IMSI of the first UE, the others follow [Default %015" PRIu64 "]\n", args.imsi_base);
+  printf("\t-k K of all the UEs [Default %s]\n", args.key.c_str());
+  printf("\t-o OPc of all the UEs [Default %s]\n", args.opc.c_str());
+  printf("\t-c MCC [Default %s]\n", args.mcc.c_str());
+  printf("\t-n MNC [Default %s]\n", args.mnc.c_str());
+  printf("\t-t TAC [Default %d]\n", args.tac);
+  printf("\t-y Number of attach-detach cycles per UE [Default %d]\n", args.nof_cycles);
+  printf("\t-r UEs started per second, 0 starts them all at once [Default %d]\n", args.rate);
+  printf("\t-d Time between the procedures of a UE in ms [Default %d]\n", args.hold_ms);
+  printf("\t-T Procedure timeout in ms [Default %d]\n", args.timeout_ms);
+  printf("\t-p Page the UEs, by sending downlink data to their IP through the SPGW\n");
+  printf("\t-w Write the CSV user database of the UEs to a file and exit\n");
+  printf("\t-h Show this message\n");
+}
+
+bool parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "a:b:e:u:i:k:o:c:n:t:y:r:d:T:pw:h")) != -1) {
+    switch (opt) {
+      case 'a':
+        args.mme_addr = optarg;
+        break;
+      case 'b':
+        args.bind_addr = optarg;
+        break;
+      case 'e':
+        args.nof_enbs = std::max(1, atoi(optarg));
+        break;
+      case 'u':
+        args.nof_ues = std::max(1, atoi(optarg));
+        break;
+      case 'i':
+        args.imsi_base = strtoull(optarg, nullptr, 10);
+        break;
+      case 'k':
+        args.key = optarg;
+        break;
+      case 'o':
+        args.opc = optarg;
+        break;
+      case 'c':
+        args.mcc = optarg;
+        break;
+      case 'n':
+        args.mnc = optarg;
+        break;
+      case 't':
+        args.tac = (uint16_t)atoi(optarg);
+        break;
+      case 'y':
+        args.nof_cycles = std::max(1, atoi(optarg));
+        break;
+      case 'r':
+        args.rate = atoi(optarg);
+        break;
+      case 'd':
+        args.hold_ms = atoi(optarg);
+        break;
+      case 'T':
+        args.timeout_ms = atoi(optarg);
+        break;
+      case 'p':
+        args.paging = true;
+        break;
+      case 'w':
+        args.user_db_file = optarg;
+        break;
+      case 'h':
+      default:
+        usage(argv[0]);
+        return false;
+    }
+  }
+  return true;
+}
+
+int write_user_db()
+{
+  srsepc::hss_db_record_t rec = {};
+  if (not hex_to_bytes(args.key, rec.key, 16) or not hex_to_bytes(args.opc, rec.opc, 16)) {
+    printf("Invalid K or OPc, expected 32 hex digits\n");
+    return SRSLTE_ERROR;
+  }
+  rec.amf[0]        = 0x80;
+  rec.algo          = srsepc::HSS_ALGO_MILENAGE;
+  rec.op_configured = 0;
+  rec.qci           = 7;
+
+  std::vector<srsepc::hss_db_record_t> records(args.nof_ues, rec);
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    records[i].imsi = args.imsi_base + i;
+    snprintf(records[i].name, sizeof(records[i].name), "loadgen%d", i);
+  }
+
+  srslte::log_filter log("HSS ");
+  log.set_level(srslte::LOG_LEVEL_WARNING);
+  if (not srsepc::hss_db_write_csv(args.user_db_file, records, &log)) {
+    printf("Error writing the user database %s\n", args.user_db_file.c_str());
+    return SRSLTE_ERROR;
+  }
+  printf("Wrote %d subscribers to %s\n", args.nof_ues, args.user_db_file.c_str());
+  return SRSLTE_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  if (not parse_args(argc, argv)) {
+    return SRSLTE_ERROR;
+  }
+  if (not args.user_db_file.empty()) {
+    return write_user_db();
+  }
+
+  signal(SIGINT, sig_int_handler);
+  srslte::logmap::get("LDGEN")->set_level(srslte::LOG_LEVEL_WARNING);
+  srslte::logmap::get("COMMON")->set_level(srslte::LOG_LEVEL_WARNING);
+
+  std::unique_ptr<loadgen> gen(new loadgen);
+  if (not gen->init()) {
+    return SRSLTE_ERROR;
+  }
+  gen->run();
+  gen->print_report();
+  return SRSLTE_SUCCESS;
+}
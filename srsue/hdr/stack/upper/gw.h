@@ -31,7 +31,10 @@
 #include "srslte/common/threads.h"
 #include "srslte/interfaces/ue_interfaces.h"
 #include "tft_packet_filter.h"
+#include <atomic>
+#include <memory>
 #include <net/if.h>
+#include <vector>
 
 namespace srsue {
 
@@ -43,8 +46,23 @@ struct gw_args_t {
   std::string netns;
   std::string tun_dev_name;
   std::string tun_dev_netmask;
+  uint32_t    tun_nof_queues = 1; // Number of TUN queues (IFF_MULTI_QUEUE), each served by its own reader thread
+  uint32_t    tun_rx_batch   = 1; // Maximum number of packets drained from a TUN queue per wake-up
 };
 
+/**
+ * TUN queue helpers. A read() or write() on a TUN descriptor always transfers exactly one IP packet, there is no
+ * multi-packet syscall (writev() would concatenate the iovecs into a single packet).
+ */
+// Reads up to max_pkts packets from a TUN queue into batch, stops early when a non-blocking queue is drained
+int tun_read_batch(int32_t                                    fd,
+                   uint32_t                                   max_pkts,
+                   srslte::byte_buffer_pool*                  pool,
+                   srslte::log*                               log_h,
+                   std::vector<srslte::unique_byte_buffer_t>& batch);
+// Queue used to write the DL packets of a bearer, so each bearer keeps its packet order
+uint32_t tun_tx_queue_idx(uint32_t lcid, uint32_t nof_queues);
+
 class gw : public gw_interface_stack, public srslte::thread
 {
 public:
@@ -69,7 +87,21 @@ public:
   void add_mch_port(uint32_t lcid, uint32_t port);
 
 private:
-  static const int GW_THREAD_PRIO = -1;
+  static const int      GW_THREAD_PRIO     = -1;
+  static const uint32_t GW_MAX_TUN_QUEUES  = 16;
+  static const int      GW_POLL_TIMEOUT_MS = 100;
+
+  // Reader thread serving one of the additional queues of a multi-queue TUN device
+  class tun_queue_reader : public srslte::thread
+  {
+  public:
+    tun_queue_reader(gw* parent_, uint32_t queue_idx_);
+
+  private:
+    void     run_thread() final;
+    gw*      parent    = nullptr;
+    uint32_t queue_idx = 0;
+  };
 
   stack_interface_gw*       stack  = nullptr;
   srslte::byte_buffer_pool* pool   = nullptr;
@@ -77,25 +109,32 @@ private:
 
   gw_args_t args = {};
 
-  bool         running      = false;
-  bool         run_enable   = false;
-  int32_t      netns_fd     = 0;
-  int32_t      tun_fd       = 0;
-  struct ifreq ifr          = {};
-  int32_t      sock         = 0;
-  bool         if_up        = false;
-  uint32_t     default_lcid = 0;
+  std::atomic<uint32_t> nof_running  = {0};
+  std::atomic<bool>     run_enable   = {false};
+  int32_t               netns_fd     = 0;
+  std::vector<int32_t>  tun_fds; // One descriptor per TUN queue
+  struct ifreq          ifr          = {};
+  int32_t               sock         = 0;
+  bool                  if_up        = false;
+  uint32_t              default_lcid = 0;
 
   srslte::log_filter log;
 
   uint32_t current_ip_addr = 0;
   uint8_t  current_if_id[8];
 
-  long           ul_tput_bytes = 0;
-  long           dl_tput_bytes = 0;
-  struct timeval metrics_time[3];
+  std::atomic<long> ul_tput_bytes = {0};
+  long              dl_tput_bytes = 0;
+  struct timeval    metrics_time[3];
+
+  std::vector<std::unique_ptr<tun_queue_reader> > tun_readers;
 
   void run_thread();
+  void rx_loop(uint32_t queue_idx);
+  void write_tun(uint32_t lcid, srslte::unique_byte_buffer_t& pdu);
+  void handle_ul_packet(srslte::unique_byte_buffer_t pdu, uint32_t& attach_wait);
+  int  open_tun_queue(char* err_str);
+  void close_tun_fds();
   int  init_if(char* err_str);
   int  setup_if_addr4(uint32_t ip_addr, char* err_str);
   int  setup_if_addr6(uint8_t* ipv6_if_id, char* err_str);
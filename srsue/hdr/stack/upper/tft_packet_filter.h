@@ -27,6 +27,8 @@
 #include "srslte/common/log.h"
 #include "srslte/common/log_filter.h"
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace srsue {
 
@@ -109,6 +111,58 @@ public:
   bool match_port(const srslte::unique_byte_buffer_t& pdu);
 };
 
+/**
+ * Header fields of an outgoing IP packet that are relevant for TFT matching, parsed once per packet
+ */
+struct tft_packet_key_t {
+  uint8_t  version              = 0;
+  uint8_t  protocol             = 0;
+  uint8_t  type_of_service      = 0;
+  bool     has_ports            = false;
+  uint32_t ipv4_local_addr      = 0;
+  uint32_t ipv4_remote_addr     = 0;
+  uint8_t  ipv6_remote_addr[16] = {};
+  uint16_t local_port           = 0;
+  uint16_t remote_port          = 0;
+
+  bool parse(const srslte::unique_byte_buffer_t& pdu);
+};
+
+/**
+ * Tuple space classifier compiled from the installed TFT packet filters.
+ *
+ * Filters with the same set of exactly matched components and the same masks share a tuple, which is a hash table
+ * keyed on the masked header fields. A packet costs one hash probe per tuple, independently of the number of filters
+ * per tuple, and candidates found in a bucket are confirmed with tft_packet_filter_t::match(). Port ranges and other
+ * components that can't be hashed are only checked during that confirmation.
+ */
+class tft_classifier
+{
+public:
+  void                 compile(std::vector<tft_packet_filter_t*> filters);
+  tft_packet_filter_t* classify(const tft_packet_key_t& key, const srslte::unique_byte_buffer_t& pdu) const;
+  void                 clear() { tuples.clear(); }
+  uint32_t             nof_tuples() const { return tuples.size(); }
+
+private:
+  struct tuple_t {
+    uint16_t fields               = 0;
+    uint32_t ipv4_local_mask      = 0;
+    uint32_t ipv4_remote_mask     = 0;
+    uint8_t  ipv6_remote_mask[16] = {};
+    uint8_t  tos_mask             = 0;
+    uint8_t  min_precedence       = 0;
+    // Buckets sorted by evaluation precedence. Index 0 is used for IPv4 packets and index 1 for IPv6 packets.
+    std::unordered_map<uint64_t, std::vector<tft_packet_filter_t*> > table[2];
+  };
+
+  static tuple_t make_tuple(const tft_packet_filter_t& filter);
+  static bool    same_shape(const tuple_t& a, const tuple_t& b);
+  static bool    hash_key(const tuple_t& tuple, const tft_packet_key_t& key, uint64_t* hash);
+
+  std::vector<tuple_t> tuples;
+};
+
 /**
  * TFT PDU matcher class used by GW and TTCN3 DUT testloop handler
  */
@@ -125,11 +179,14 @@ public:
                                       const LIBLTE_MME_TRAFFIC_FLOW_TEMPLATE_STRUCT* tft);
 
 private:
+  void compile_classifier();
+
   srslte::log_filter*                             log          = nullptr;
   uint8_t                                         default_lcid = 0;
   std::mutex                                      tft_mutex;
   typedef std::map<uint16_t, tft_packet_filter_t> tft_filter_map_t;
   tft_filter_map_t                                tft_filter_map;
+  tft_classifier                                  classifier;
 };
 
 } // namespace srsue
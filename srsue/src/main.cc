@@ -186,6 +186,8 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("gw.netns", bpo::value<string>(&args->gw.netns)->default_value(""), "Network namespace to for TUN device (empty for default netns)")
     ("gw.ip_devname", bpo::value<string>(&args->gw.tun_dev_name)->default_value("tun_srsue"), "Name of the tun_srsue device")
     ("gw.ip_netmask", bpo::value<string>(&args->gw.tun_dev_netmask)->default_value("255.255.255.0"), "Netmask of the tun_srsue device")
+    ("gw.tun_nof_queues", bpo::value<uint32_t>(&args->gw.tun_nof_queues)->default_value(1), "Number of TUN queues (>1 enables a multi-queue TUN device with one reader thread per queue)")
+    ("gw.tun_rx_batch", bpo::value<uint32_t>(&args->gw.tun_rx_batch)->default_value(1), "Maximum number of IP packets read from a TUN queue per wake-up")
 
     /* Downlink Channel emulator section */
     ("channel.dl.enable",            bpo::value<bool>(&args->phy.dl_channel_args.enable)->default_value(false),                 "Enable/Disable internal Downlink channel emulator")
@@ -28,6 +28,7 @@
 #include <linux/ip.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -36,6 +37,17 @@ namespace srsue {
 
 gw::gw() : thread("GW"), pool(srslte::byte_buffer_pool::get_instance()), tft_matcher(&log) {}
 
+gw::tun_queue_reader::tun_queue_reader(gw* parent_, uint32_t queue_idx_) :
+  thread("GW_RX" + std::to_string(queue_idx_)),
+  parent(parent_),
+  queue_idx(queue_idx_)
+{}
+
+void gw::tun_queue_reader::run_thread()
+{
+  parent->rx_loop(queue_idx);
+}
+
 int gw::init(const gw_args_t& args_, srslte::logger* logger_, stack_interface_gw* stack_)
 {
   stack      = stack_;
@@ -47,6 +59,12 @@ int gw::init(const gw_args_t& args_, srslte::logger* logger_, stack_interface_gw
   log.set_level(args.log.gw_level);
   log.set_hex_limit(args.log.gw_hex_limit);
 
+  if (args.tun_nof_queues == 0 || args.tun_nof_queues > GW_MAX_TUN_QUEUES) {
+    log.error("Invalid number of TUN queues %d (must be between 1 and %d)\n", args.tun_nof_queues, GW_MAX_TUN_QUEUES);
+    return SRSLTE_ERROR;
+  }
+  args.tun_rx_batch = std::max(args.tun_rx_batch, 1u);
+
   gettimeofday(&metrics_time[1], NULL);
 
   // MBSFN
@@ -71,18 +89,26 @@ void gw::stop()
   if (run_enable) {
     run_enable = false;
     if (if_up) {
-      close(tun_fd);
-
-      // Wait thread to exit gracefully otherwise might leave a mutex locked
+      // Polling readers wake up at least every GW_POLL_TIMEOUT_MS, wait for them to exit gracefully otherwise might
+      // leave a mutex locked. Readers blocked in read() are cancelled
       int cnt = 0;
-      while (running && cnt < 100) {
+      while (nof_running > 0 && cnt < 100) {
         usleep(10000);
         cnt++;
       }
-      if (running) {
+      if (nof_running > 0) {
         thread_cancel();
+        for (auto& reader : tun_readers) {
+          reader->thread_cancel();
+        }
       }
       wait_thread_finish();
+      for (auto& reader : tun_readers) {
+        reader->wait_thread_finish();
+      }
+      tun_readers.clear();
+
+      close_tun_fds();
 
       current_ip_addr = 0;
     }
@@ -124,10 +150,7 @@ void gw::write_pdu(uint32_t lcid, srslte::unique_byte_buffer_t pdu)
     // Only handle IPv4 and IPv6 packets
     struct iphdr* ip_pkt = (struct iphdr*)pdu->msg;
     if (ip_pkt->version == 4 || ip_pkt->version == 6) {
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes);
-      if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
-        log.warning("DL TUN/TAP write failure. Wanted to write %d B but only wrote %d B.\n", pdu->N_bytes, n);
-      }
+      write_tun(lcid, pdu);
     } else {
       log.error("Unsupported IP version. Dropping packet with %d B\n", pdu->N_bytes);
     }
@@ -150,14 +173,23 @@ void gw::write_pdu_mch(uint32_t lcid, srslte::unique_byte_buffer_t pdu)
     if (!if_up) {
       log.warning("TUN/TAP not up - dropping gw RX message\n");
     } else {
-      int n = write(tun_fd, pdu->msg, pdu->N_bytes);
-      if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
-        log.warning("DL TUN/TAP write failure\n");
-      }
+      write_tun(lcid, pdu);
     }
   }
 }
 
+void gw::write_tun(uint32_t lcid, srslte::unique_byte_buffer_t& pdu)
+{
+  if (tun_fds.empty()) {
+    log.warning("TUN/TAP queues closed - dropping gw RX message\n");
+    return;
+  }
+  int n = write(tun_fds[tun_tx_queue_idx(lcid, tun_fds.size())], pdu->msg, pdu->N_bytes);
+  if (n > 0 && (pdu->N_bytes != (uint32_t)n)) {
+    log.warning("DL TUN/TAP write failure. Wanted to write %d B but only wrote %d B.\n", pdu->N_bytes, n);
+  }
+}
+
 /*******************************************************************************
   NAS interface
 *******************************************************************************/
@@ -180,8 +212,14 @@ int gw::setup_if_addr(uint32_t lcid, uint8_t pdn_type, uint32_t ip_addr, uint8_t
   default_lcid = lcid;
   tft_matcher.set_default_lcid(lcid);
 
-  // Setup a thread to receive packets from the TUN device
+  // Setup a thread to receive packets from the TUN device, plus one per additional queue
   start(GW_THREAD_PRIO);
+  if (tun_readers.empty()) {
+    for (uint32_t i = 1; i < tun_fds.size(); i++) {
+      tun_readers.emplace_back(new tun_queue_reader(this, i));
+      tun_readers.back()->start(GW_THREAD_PRIO);
+    }
+  }
   return SRSLTE_SUCCESS;
 }
 
@@ -212,98 +250,141 @@ void gw::add_mch_port(uint32_t lcid, uint32_t port)
 /********************/
 void gw::run_thread()
 {
-  uint32 idx     = 0;
-  int32  N_bytes = 0;
-
-  srslte::unique_byte_buffer_t pdu = srslte::allocate_unique_buffer(*pool, true);
-  if (!pdu) {
-    log.error("Fatal Error: Couldn't allocate PDU in run_thread().\n");
-    return;
-  }
+  rx_loop(0);
+}
 
-  const static uint32_t ATTACH_WAIT_TOUT = 40; // 4 sec
-  uint32_t              attach_wait      = 0;
+void gw::rx_loop(uint32_t queue_idx)
+{
+  int32_t                                   fd          = tun_fds[queue_idx];
+  uint32_t                                  attach_wait = 0;
+  std::vector<srslte::unique_byte_buffer_t> batch;
+  batch.reserve(args.tun_rx_batch);
 
-  log.info("GW IP packet receiver thread run_enable\n");
+  log.info("GW IP packet receiver thread for TUN queue %d running\n", queue_idx);
 
-  running = true;
+  nof_running++;
   while (run_enable) {
-    if (SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET > idx) {
-      N_bytes = read(tun_fd, &pdu->msg[idx], SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET - idx);
-    } else {
-      log.error("GW pdu buffer full - gw receive thread exiting.\n");
-      srslte::console("GW pdu buffer full - gw receive thread exiting.\n");
+    // Without batching the queue is blocking, so each packet costs a single read()
+    int ret = 1;
+    if (args.tun_rx_batch > 1) {
+      struct pollfd pfd = {};
+      pfd.fd            = fd;
+      pfd.events        = POLLIN;
+      ret               = poll(&pfd, 1, GW_POLL_TIMEOUT_MS);
+      if (ret == 0 || (ret < 0 && errno == EINTR)) {
+        continue;
+      }
+      if (ret > 0 && (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+        ret = SRSLTE_ERROR;
+      }
+    }
+    if (ret < 0 || tun_read_batch(fd, args.tun_rx_batch, pool, &log, batch) < 0) {
+      log.error("Failed to read from TUN interface - gw receive thread exiting.\n");
+      srslte::console("Failed to read from TUN interface - gw receive thread exiting.\n");
       break;
     }
-    log.debug("Read %d bytes from TUN fd=%d, idx=%d\n", N_bytes, tun_fd, idx);
-    if (N_bytes > 0) {
-      struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
-      struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
-      uint16_t        pkt_len = 0;
-      pdu->N_bytes            = idx + N_bytes;
-      if (ip_pkt->version == 4 || ip_pkt->version == 6) {
-        if (ip_pkt->version == 4) {
-          pkt_len = ntohs(ip_pkt->tot_len);
-        } else if (ip_pkt->version == 6) {
-          pkt_len = ntohs(ip6_pkt->payload_len) + 40;
-        } else {
-          log.error_hex(pdu->msg, pdu->N_bytes, "Unsupported IP version. Dropping packet.\n");
-          continue;
-        }
-        log.debug("IPv%d packet total length: %d Bytes\n", ip_pkt->version, pkt_len);
-        // Check if entire packet was received
-        if (pkt_len == pdu->N_bytes) {
-          log.info_hex(pdu->msg, pdu->N_bytes, "TX PDU");
-
-          while (run_enable && !stack->is_lcid_enabled(default_lcid) && attach_wait < ATTACH_WAIT_TOUT) {
-            if (!attach_wait) {
-              log.info(
-                  "LCID=%d not active, requesting NAS attach (%d/%d)\n", default_lcid, attach_wait, ATTACH_WAIT_TOUT);
-              if (not stack->switch_on()) {
-                log.warning("Could not re-establish the connection\n");
-              }
-            }
-            usleep(100000);
-            attach_wait++;
-          }
+    log.debug("Read %zu packets from TUN fd=%d\n", batch.size(), fd);
 
-          attach_wait = 0;
+    for (srslte::unique_byte_buffer_t& pdu : batch) {
+      if (!run_enable) {
+        break;
+      }
+      handle_ul_packet(std::move(pdu), attach_wait);
+    }
+    batch.clear();
+  }
+  nof_running--;
+  log.info("GW IP receiver thread for TUN queue %d exiting.\n", queue_idx);
+}
 
-          if (!run_enable) {
-            break;
-          }
+/**
+ * Reads up to max_pkts packets from a TUN queue. On a non-blocking queue the batch amortizes the poll() wake-up over
+ * all packets that are pending in the queue, a blocking queue should be read with max_pkts = 1.
+ *
+ * @return number of packets read, or SRSLTE_ERROR if the descriptor failed before any packet was read
+ */
+int tun_read_batch(int32_t                                    fd,
+                   uint32_t                                   max_pkts,
+                   srslte::byte_buffer_pool*                  pool,
+                   srslte::log*                               log_h,
+                   std::vector<srslte::unique_byte_buffer_t>& batch)
+{
+  const uint32_t max_len = SRSLTE_MAX_BUFFER_SIZE_BYTES - SRSLTE_BUFFER_HEADER_OFFSET;
+  while (batch.size() < max_pkts) {
+    srslte::unique_byte_buffer_t pdu = srslte::allocate_unique_buffer(*pool);
+    if (!pdu) {
+      log_h->error("Fatal Error: Couldn't allocate PDU in tun_read_batch().\n");
+      usleep(100000);
+      break;
+    }
+    int32_t N_bytes = read(fd, pdu->msg, max_len);
+    if (N_bytes <= 0) {
+      if (N_bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        break;
+      }
+      return batch.empty() ? SRSLTE_ERROR : batch.size();
+    }
+    pdu->N_bytes = N_bytes;
+    batch.push_back(std::move(pdu));
+  }
+  return batch.size();
+}
 
-          uint8_t lcid = tft_matcher.check_tft_filter_match(pdu);
-          // Send PDU directly to PDCP
-          if (stack->is_lcid_enabled(lcid)) {
-            pdu->set_timestamp();
-            ul_tput_bytes += pdu->N_bytes;
-            stack->write_sdu(lcid, std::move(pdu));
-            do {
-              pdu = srslte::allocate_unique_buffer(*pool);
-              if (!pdu) {
-                log.error("Fatal Error: Couldn't allocate PDU in run_thread().\n");
-                usleep(100000);
-              }
-            } while (!pdu);
-            idx = 0;
-          }
-        } else {
-          idx += N_bytes;
-          log.debug(
-              "Entire packet not read from socket. Total Length %d, N_Bytes %d.\n", ip_pkt->tot_len, pdu->N_bytes);
-        }
-      } else {
-        log.error("IP Version not handled. Version %d\n", ip_pkt->version);
+uint32_t tun_tx_queue_idx(uint32_t lcid, uint32_t nof_queues)
+{
+  return nof_queues > 0 ? lcid % nof_queues : 0;
+}
+
+void gw::handle_ul_packet(srslte::unique_byte_buffer_t pdu, uint32_t& attach_wait)
+{
+  const static uint32_t ATTACH_WAIT_TOUT = 40; // 4 sec
+
+  struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
+  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
+  uint16_t        pkt_len = 0;
+  if (ip_pkt->version == 4) {
+    pkt_len = ntohs(ip_pkt->tot_len);
+  } else if (ip_pkt->version == 6) {
+    pkt_len = ntohs(ip6_pkt->payload_len) + 40;
+  } else {
+    log.error("IP Version not handled. Version %d\n", ip_pkt->version);
+    return;
+  }
+  log.debug("IPv%d packet total length: %d Bytes\n", ip_pkt->version, pkt_len);
+
+  // TUN reads always return a whole packet, anything else was truncated by the kernel
+  if (pkt_len != pdu->N_bytes) {
+    log.warning("Entire packet not read from TUN. Total Length %d, N_Bytes %d. Dropping packet.\n",
+                pkt_len,
+                pdu->N_bytes);
+    return;
+  }
+  log.info_hex(pdu->msg, pdu->N_bytes, "TX PDU");
+
+  while (run_enable && !stack->is_lcid_enabled(default_lcid) && attach_wait < ATTACH_WAIT_TOUT) {
+    if (!attach_wait) {
+      log.info("LCID=%d not active, requesting NAS attach (%d/%d)\n", default_lcid, attach_wait, ATTACH_WAIT_TOUT);
+      if (not stack->switch_on()) {
+        log.warning("Could not re-establish the connection\n");
       }
-    } else {
-      log.error("Failed to read from TUN interface - gw receive thread exiting.\n");
-      srslte::console("Failed to read from TUN interface - gw receive thread exiting.\n");
-      break;
     }
+    usleep(100000);
+    attach_wait++;
+  }
+
+  attach_wait = 0;
+
+  if (!run_enable) {
+    return;
+  }
+
+  uint8_t lcid = tft_matcher.check_tft_filter_match(pdu);
+  // Send PDU directly to PDCP
+  if (stack->is_lcid_enabled(lcid)) {
+    pdu->set_timestamp();
+    ul_tput_bytes += pdu->N_bytes;
+    stack->write_sdu(lcid, std::move(pdu));
   }
-  running = false;
-  log.info("GW IP receiver thread exiting.\n");
 }
 
 /**************************/
@@ -332,25 +413,12 @@ int gw::init_if(char* err_str)
     }
   }
 
-  // Construct the TUN device
-  tun_fd = open("/dev/net/tun", O_RDWR);
-  log.info("TUN file descriptor = %d\n", tun_fd);
-  if (0 > tun_fd) {
-    err_str = strerror(errno);
-    log.error("Failed to open TUN device: %s\n", err_str);
-    return SRSLTE_ERROR_CANT_START;
-  }
-
-  memset(&ifr, 0, sizeof(ifr));
-  ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
-  strncpy(
-      ifr.ifr_ifrn.ifrn_name, args.tun_dev_name.c_str(), std::min(args.tun_dev_name.length(), (size_t)(IFNAMSIZ - 1)));
-  ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = 0;
-  if (0 > ioctl(tun_fd, TUNSETIFF, &ifr)) {
-    err_str = strerror(errno);
-    log.error("Failed to set TUN device name: %s\n", err_str);
-    close(tun_fd);
-    return SRSLTE_ERROR_CANT_START;
+  // Construct the TUN device, one descriptor per queue
+  for (uint32_t i = 0; i < args.tun_nof_queues; i++) {
+    if (open_tun_queue(err_str) != SRSLTE_SUCCESS) {
+      close_tun_fds();
+      return SRSLTE_ERROR_CANT_START;
+    }
   }
 
   // Bring up the interface
@@ -358,14 +426,14 @@ int gw::init_if(char* err_str)
   if (0 > ioctl(sock, SIOCGIFFLAGS, &ifr)) {
     err_str = strerror(errno);
     log.error("Failed to bring up socket: %s\n", err_str);
-    close(tun_fd);
+    close_tun_fds();
     return SRSLTE_ERROR_CANT_START;
   }
   ifr.ifr_flags |= IFF_UP | IFF_RUNNING;
   if (0 > ioctl(sock, SIOCSIFFLAGS, &ifr)) {
     err_str = strerror(errno);
     log.error("Failed to set socket flags: %s\n", err_str);
-    close(tun_fd);
+    close_tun_fds();
     return SRSLTE_ERROR_CANT_START;
   }
 
@@ -383,6 +451,51 @@ int gw::init_if(char* err_str)
   return SRSLTE_SUCCESS;
 }
 
+int gw::open_tun_queue(char* err_str)
+{
+  int32_t fd = open("/dev/net/tun", O_RDWR);
+  log.info("TUN file descriptor = %d (queue %zu)\n", fd, tun_fds.size());
+  if (0 > fd) {
+    err_str = strerror(errno);
+    log.error("Failed to open TUN device: %s\n", err_str);
+    return SRSLTE_ERROR_CANT_START;
+  }
+
+  memset(&ifr, 0, sizeof(ifr));
+  ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+  if (args.tun_nof_queues > 1) {
+    ifr.ifr_flags |= IFF_MULTI_QUEUE;
+  }
+  strncpy(
+      ifr.ifr_ifrn.ifrn_name, args.tun_dev_name.c_str(), std::min(args.tun_dev_name.length(), (size_t)(IFNAMSIZ - 1)));
+  ifr.ifr_ifrn.ifrn_name[IFNAMSIZ - 1] = 0;
+  if (0 > ioctl(fd, TUNSETIFF, &ifr)) {
+    err_str = strerror(errno);
+    log.error("Failed to set TUN device name: %s\n", err_str);
+    close(fd);
+    return SRSLTE_ERROR_CANT_START;
+  }
+
+  // Batching readers poll() the queue and drain it until EAGAIN
+  if (args.tun_rx_batch > 1 && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+    err_str = strerror(errno);
+    log.error("Failed to set non-blocking TUN queue: %s\n", err_str);
+    close(fd);
+    return SRSLTE_ERROR_CANT_START;
+  }
+
+  tun_fds.push_back(fd);
+  return SRSLTE_SUCCESS;
+}
+
+void gw::close_tun_fds()
+{
+  for (int32_t fd : tun_fds) {
+    close(fd);
+  }
+  tun_fds.clear();
+}
+
 int gw::setup_if_addr4(uint32_t ip_addr, char* err_str)
 {
   if (ip_addr != current_ip_addr) {
@@ -400,7 +513,7 @@ int gw::setup_if_addr4(uint32_t ip_addr, char* err_str)
     if (0 > ioctl(sock, SIOCSIFADDR, &ifr)) {
       err_str = strerror(errno);
       log.debug("Failed to set socket address: %s\n", err_str);
-      close(tun_fd);
+      close_tun_fds();
       return SRSLTE_ERROR_CANT_START;
     }
     ifr.ifr_netmask.sa_family                                = AF_INET;
@@ -408,7 +521,7 @@ int gw::setup_if_addr4(uint32_t ip_addr, char* err_str)
     if (0 > ioctl(sock, SIOCSIFNETMASK, &ifr)) {
       err_str = strerror(errno);
       log.debug("Failed to set socket netmask: %s\n", err_str);
-      close(tun_fd);
+      close_tun_fds();
       return SRSLTE_ERROR_CANT_START;
     }
     current_ip_addr = ip_addr;
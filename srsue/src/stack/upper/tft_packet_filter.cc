@@ -24,6 +24,7 @@
 #include <linux/ip.h>
 #include <linux/tcp.h>
 #include <linux/udp.h>
+#include <algorithm>
 
 namespace srsue {
 
@@ -384,10 +385,238 @@ bool tft_packet_filter_t::match_port(const srslte::unique_byte_buffer_t& pdu)
   return true;
 }
 
+/*
+ * Extracts the fields used by the classifier. Header offsets follow the ones used by tft_packet_filter_t::match().
+ * Returns false for packets that are not IPv4/IPv6 or too short, which are then matched linearly.
+ */
+bool tft_packet_key_t::parse(const srslte::unique_byte_buffer_t& pdu)
+{
+  struct iphdr*   ip_pkt  = (struct iphdr*)pdu->msg;
+  struct ipv6hdr* ip6_pkt = (struct ipv6hdr*)pdu->msg;
+  uint32_t        l4_offset;
+
+  if (pdu->N_bytes < sizeof(struct iphdr)) {
+    return false;
+  }
+  version = ip_pkt->version;
+  if (version == 4) {
+    protocol         = ip_pkt->protocol;
+    type_of_service  = ip_pkt->tos;
+    ipv4_local_addr  = ip_pkt->saddr;
+    ipv4_remote_addr = ip_pkt->daddr;
+    l4_offset        = ip_pkt->ihl * 4;
+  } else if (version == 6) {
+    if (pdu->N_bytes < sizeof(struct ipv6hdr)) {
+      return false;
+    }
+    protocol = ip6_pkt->nexthdr;
+    memcpy(ipv6_remote_addr, ip6_pkt->daddr.s6_addr, IPV6_ADDR_SIZE);
+    l4_offset = sizeof(struct ipv6hdr);
+  } else {
+    return false;
+  }
+
+  has_ports = (protocol == UDP_PROTOCOL || protocol == TCP_PROTOCOL);
+  if (has_ports) {
+    // Source and destination ports are at the same offset for UDP and TCP
+    if (pdu->N_bytes < l4_offset + sizeof(struct udphdr)) {
+      return false;
+    }
+    struct udphdr* udp_pkt = (struct udphdr*)&pdu->msg[l4_offset];
+    local_port             = udp_pkt->source;
+    remote_port            = udp_pkt->dest;
+  }
+  return true;
+}
+
+namespace {
+
+// Components that are hashed by the classifier. Port ranges, flow label and SPI are only checked by match().
+const uint16_t TFT_HASHED_FLAGS = IPV4_LOCAL_ADDR_FLAG | IPV4_REMOTE_ADDR_FLAG | IPV6_REMOTE_ADDR_FLAG |
+                                  IPV6_REMOTE_ADDR_LENGTH_FLAG | PROTOCOL_ID_FLAG | SINGLE_LOCAL_PORT_FLAG |
+                                  SINGLE_REMOTE_PORT_FLAG | TYPE_OF_SERVICE_FLAG;
+const uint16_t TFT_PORT_FLAGS =
+    SINGLE_LOCAL_PORT_FLAG | LOCAL_PORT_RANGE_FLAG | SINGLE_REMOTE_PORT_FLAG | REMOTE_PORT_RANGE_FLAG;
+// Set in a tuple whose filters have any port component, which requires a UDP/TCP packet
+const uint16_t TFT_PORTS_REQUIRED = 1 << 15;
+
+inline uint64_t tft_hash_mix(uint64_t h, uint64_t v)
+{
+  h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  return h;
+}
+
+} // namespace
+
+tft_classifier::tuple_t tft_classifier::make_tuple(const tft_packet_filter_t& filter)
+{
+  tuple_t tuple;
+  tuple.fields = filter.active_filters & TFT_HASHED_FLAGS;
+  if (filter.active_filters & TFT_PORT_FLAGS) {
+    tuple.fields |= TFT_PORTS_REQUIRED;
+  }
+  if (tuple.fields & IPV4_LOCAL_ADDR_FLAG) {
+    tuple.ipv4_local_mask = filter.ipv4_local_addr_mask;
+  }
+  if (tuple.fields & IPV4_REMOTE_ADDR_FLAG) {
+    tuple.ipv4_remote_mask = filter.ipv4_remote_addr_mask;
+  }
+  if (tuple.fields & (IPV6_REMOTE_ADDR_FLAG | IPV6_REMOTE_ADDR_LENGTH_FLAG)) {
+    // match_ip() only compares the first ipv6_remote_addr_length bytes
+    uint32_t len = std::min((uint32_t)filter.ipv6_remote_addr_length, (uint32_t)IPV6_ADDR_SIZE);
+    memcpy(tuple.ipv6_remote_mask, filter.ipv6_remote_addr_mask, len);
+  }
+  if (tuple.fields & TYPE_OF_SERVICE_FLAG) {
+    tuple.tos_mask = filter.type_of_service_mask;
+  }
+  tuple.min_precedence = filter.eval_precedence;
+  return tuple;
+}
+
+bool tft_classifier::same_shape(const tuple_t& a, const tuple_t& b)
+{
+  return a.fields == b.fields && a.ipv4_local_mask == b.ipv4_local_mask && a.ipv4_remote_mask == b.ipv4_remote_mask &&
+         memcmp(a.ipv6_remote_mask, b.ipv6_remote_mask, IPV6_ADDR_SIZE) == 0 && a.tos_mask == b.tos_mask;
+}
+
+/*
+ * Computes the hash of the masked header fields of a tuple. Returns false if no filter of the tuple can match a packet
+ * with this key, e.g. because it has port components but the packet is neither UDP nor TCP.
+ */
+bool tft_classifier::hash_key(const tuple_t& tuple, const tft_packet_key_t& key, uint64_t* hash)
+{
+  uint64_t h = tuple.fields;
+  if (tuple.fields & PROTOCOL_ID_FLAG) {
+    h = tft_hash_mix(h, key.protocol);
+  }
+  if (tuple.fields & TFT_PORTS_REQUIRED) {
+    if (not key.has_ports) {
+      return false;
+    }
+    if (tuple.fields & SINGLE_LOCAL_PORT_FLAG) {
+      h = tft_hash_mix(h, key.local_port);
+    }
+    if (tuple.fields & SINGLE_REMOTE_PORT_FLAG) {
+      h = tft_hash_mix(h, (uint64_t)key.remote_port << 16u);
+    }
+  }
+  if (key.version == 4) {
+    if (tuple.fields & IPV4_LOCAL_ADDR_FLAG) {
+      h = tft_hash_mix(h, key.ipv4_local_addr & tuple.ipv4_local_mask);
+    }
+    if (tuple.fields & IPV4_REMOTE_ADDR_FLAG) {
+      h = tft_hash_mix(h, (uint64_t)(key.ipv4_remote_addr & tuple.ipv4_remote_mask) << 32u);
+    }
+    if (tuple.fields & TYPE_OF_SERVICE_FLAG) {
+      h = tft_hash_mix(h, key.type_of_service & tuple.tos_mask);
+    }
+  } else {
+    if (tuple.fields & TYPE_OF_SERVICE_FLAG) {
+      // IPv6 traffic class not supported by match_type_of_service()
+      return false;
+    }
+    if (tuple.fields & (IPV6_REMOTE_ADDR_FLAG | IPV6_REMOTE_ADDR_LENGTH_FLAG)) {
+      for (uint32_t i = 0; i < IPV6_ADDR_SIZE; i += 8) {
+        uint64_t addr, mask;
+        memcpy(&addr, &key.ipv6_remote_addr[i], 8);
+        memcpy(&mask, &tuple.ipv6_remote_mask[i], 8);
+        h = tft_hash_mix(h, addr & mask);
+      }
+    }
+  }
+  *hash = h;
+  return true;
+}
+
+/*
+ * Rebuilds the tuple space. Filters are expected in ascending evaluation precedence order.
+ */
+void tft_classifier::compile(std::vector<tft_packet_filter_t*> filters)
+{
+  tuples.clear();
+  for (tft_packet_filter_t* filter : filters) {
+    if (filter->active_filters == 0) {
+      // Filters without components never match
+      continue;
+    }
+    tuple_t shape = make_tuple(*filter);
+    auto    it    = std::find_if(
+        tuples.begin(), tuples.end(), [&shape](const tuple_t& tuple) { return same_shape(tuple, shape); });
+    if (it == tuples.end()) {
+      tuples.push_back(shape);
+      it = tuples.end() - 1;
+    }
+
+    // A filter is placed in the IPv4 and the IPv6 table, with the key it would have for each IP version
+    tft_packet_key_t key;
+    key.protocol         = filter->protocol_id;
+    key.type_of_service  = filter->type_of_service;
+    key.has_ports        = true;
+    key.ipv4_local_addr  = filter->ipv4_local_addr;
+    key.ipv4_remote_addr = filter->ipv4_remote_addr;
+    memcpy(key.ipv6_remote_addr, filter->ipv6_remote_addr, IPV6_ADDR_SIZE);
+    key.local_port  = filter->single_local_port;
+    key.remote_port = filter->single_remote_port;
+    for (uint32_t i = 0; i < 2; i++) {
+      uint64_t hash;
+      key.version = (i == 0) ? 4 : 6;
+      if (hash_key(*it, key, &hash)) {
+        it->table[i][hash].push_back(filter);
+      }
+    }
+  }
+
+  // Visit tuples with the most prioritary filters first
+  std::sort(tuples.begin(), tuples.end(), [](const tuple_t& a, const tuple_t& b) {
+    return a.min_precedence < b.min_precedence;
+  });
+}
+
+tft_packet_filter_t* tft_classifier::classify(const tft_packet_key_t&            key,
+                                              const srslte::unique_byte_buffer_t& pdu) const
+{
+  tft_packet_filter_t* best = nullptr;
+  uint32_t             idx  = (key.version == 4) ? 0 : 1;
+  for (const tuple_t& tuple : tuples) {
+    if (best != nullptr && tuple.min_precedence >= best->eval_precedence) {
+      break;
+    }
+    uint64_t hash;
+    if (not hash_key(tuple, key, &hash)) {
+      continue;
+    }
+    auto bucket = tuple.table[idx].find(hash);
+    if (bucket == tuple.table[idx].end()) {
+      continue;
+    }
+    for (tft_packet_filter_t* filter : bucket->second) {
+      if (best != nullptr && filter->eval_precedence >= best->eval_precedence) {
+        break;
+      }
+      if (filter->match(pdu)) {
+        best = filter;
+        break;
+      }
+    }
+  }
+  return best;
+}
+
 uint8_t tft_pdu_matcher::check_tft_filter_match(const srslte::unique_byte_buffer_t& pdu)
 {
   std::lock_guard<std::mutex> lock(tft_mutex);
   uint8_t                     lcid = default_lcid;
+  tft_packet_key_t            key;
+  if (key.parse(pdu)) {
+    tft_packet_filter_t* filter = classifier.classify(key, pdu);
+    if (filter != nullptr) {
+      lcid = filter->lcid;
+      log->debug("Found filter match -- EPS bearer Id %d, LCID %d\n", filter->eps_bearer_id, lcid);
+    }
+    return lcid;
+  }
+
+  // Packets the classifier can't parse are checked against every filter
   for (std::pair<const uint16_t, tft_packet_filter_t>& filter_pair : tft_filter_map) {
     bool match = filter_pair.second.match(pdu);
     if (match) {
@@ -412,6 +641,7 @@ int tft_pdu_matcher::apply_traffic_flow_template(const uint8_t&
         auto                it = tft_filter_map.insert(std::make_pair(filter.eval_precedence, filter));
         if (it.second == false) {
           log->error("Error inserting TFT Packet Filter\n");
+          compile_classifier();
           return SRSLTE_ERROR_CANT_START;
         }
       }
@@ -420,9 +650,20 @@ int tft_pdu_matcher::apply_traffic_flow_template(const uint8_t&
       log->error("Unhandled TFT OP code\n");
       return SRSLTE_ERROR_CANT_START;
   }
+  compile_classifier();
   return SRSLTE_SUCCESS;
 }
 
+void tft_pdu_matcher::compile_classifier()
+{
+  std::vector<tft_packet_filter_t*> filters;
+  for (std::pair<const uint16_t, tft_packet_filter_t>& filter_pair : tft_filter_map) {
+    filters.push_back(&filter_pair.second);
+  }
+  classifier.compile(std::move(filters));
+  log->debug("Compiled %zu TFT packet filters into %d tuples\n", tft_filter_map.size(), classifier.nof_tuples());
+}
+
 void tft_pdu_matcher::set_default_lcid(const uint8_t lcid)
 {
   default_lcid = lcid;
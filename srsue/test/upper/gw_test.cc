@@ -0,0 +1,162 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/test_common.h"
+#include "srsue/hdr/stack/upper/gw.h"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace srsue;
+
+srslte::log_ref test_log{"TEST"};
+
+/*
+ * Creating a TUN device requires privileges, the queues are emulated with a SOCK_SEQPACKET socket pair, which like
+ * a TUN descriptor transfers one packet per read()/write()
+ */
+struct tun_queue_emulator {
+  int fds[2] = {-1, -1}; // fds[0] is the GW side, fds[1] the kernel side
+
+  int init(bool nonblocking)
+  {
+    TESTASSERT(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+    if (nonblocking) {
+      TESTASSERT(fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK) == 0);
+    }
+    return SRSLTE_SUCCESS;
+  }
+  ~tun_queue_emulator()
+  {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+  int send_pkt(uint32_t len, uint8_t seed)
+  {
+    std::vector<uint8_t> pkt(len);
+    for (uint32_t i = 0; i < len; i++) {
+      pkt[i] = seed + i;
+    }
+    TESTASSERT(write(fds[1], pkt.data(), len) == (ssize_t)len);
+    return SRSLTE_SUCCESS;
+  }
+};
+
+int check_pkt(const srslte::unique_byte_buffer_t& pdu, uint32_t len, uint8_t seed)
+{
+  TESTASSERT(pdu != nullptr);
+  TESTASSERT(pdu->N_bytes == len);
+  for (uint32_t i = 0; i < len; i++) {
+    TESTASSERT(pdu->msg[i] == (uint8_t)(seed + i));
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int test_read_batch()
+{
+  srslte::byte_buffer_pool*                 pool = srslte::byte_buffer_pool::get_instance();
+  std::vector<srslte::unique_byte_buffer_t> batch;
+  tun_queue_emulator                        queue;
+  TESTASSERT(queue.init(true) == SRSLTE_SUCCESS);
+
+  const uint32_t pkt_len[] = {20, 1500, 64, 9000, 40};
+  for (uint32_t i = 0; i < 5; i++) {
+    TESTASSERT(queue.send_pkt(pkt_len[i], i) == SRSLTE_SUCCESS);
+  }
+
+  // The first batch is full, the second one drains the queue, then the empty queue returns no packet
+  TESTASSERT(tun_read_batch(queue.fds[0], 3, pool, test_log.get(), batch) == 3);
+  for (uint32_t i = 0; i < 3; i++) {
+    TESTASSERT(check_pkt(batch[i], pkt_len[i], i) == SRSLTE_SUCCESS);
+  }
+  batch.clear();
+  TESTASSERT(tun_read_batch(queue.fds[0], 3, pool, test_log.get(), batch) == 2);
+  for (uint32_t i = 0; i < 2; i++) {
+    TESTASSERT(check_pkt(batch[i], pkt_len[3 + i], 3 + i) == SRSLTE_SUCCESS);
+  }
+  batch.clear();
+  TESTASSERT(tun_read_batch(queue.fds[0], 3, pool, test_log.get(), batch) == 0);
+
+  // A closed peer is reported as an error
+  close(queue.fds[1]);
+  queue.fds[1] = -1;
+  TESTASSERT(tun_read_batch(queue.fds[0], 3, pool, test_log.get(), batch) == SRSLTE_ERROR);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_read_single()
+{
+  srslte::byte_buffer_pool*                 pool = srslte::byte_buffer_pool::get_instance();
+  std::vector<srslte::unique_byte_buffer_t> batch;
+  tun_queue_emulator                        queue;
+  TESTASSERT(queue.init(false) == SRSLTE_SUCCESS);
+
+  // Without batching the queue is blocking and each call returns one packet
+  TESTASSERT(queue.send_pkt(100, 1) == SRSLTE_SUCCESS);
+  TESTASSERT(queue.send_pkt(200, 2) == SRSLTE_SUCCESS);
+  TESTASSERT(tun_read_batch(queue.fds[0], 1, pool, test_log.get(), batch) == 1);
+  TESTASSERT(check_pkt(batch[0], 100, 1) == SRSLTE_SUCCESS);
+  batch.clear();
+  TESTASSERT(tun_read_batch(queue.fds[0], 1, pool, test_log.get(), batch) == 1);
+  TESTASSERT(check_pkt(batch[0], 200, 2) == SRSLTE_SUCCESS);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_write_queue()
+{
+  // A single queue takes all bearers
+  for (uint32_t lcid = 0; lcid < 11; lcid++) {
+    TESTASSERT(tun_tx_queue_idx(lcid, 1) == 0);
+  }
+
+  // With several queues each bearer is mapped to a fixed queue and the bearers are spread over all queues
+  const uint32_t        nof_queues = 4;
+  std::vector<uint32_t> nof_lcids(nof_queues, 0);
+  for (uint32_t lcid = 3; lcid < 11; lcid++) {
+    uint32_t idx = tun_tx_queue_idx(lcid, nof_queues);
+    TESTASSERT(idx < nof_queues);
+    TESTASSERT(idx == tun_tx_queue_idx(lcid, nof_queues));
+    nof_lcids[idx]++;
+  }
+  for (uint32_t n : nof_lcids) {
+    TESTASSERT(n == 2);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_INFO);
+
+  TESTASSERT(test_read_batch() == SRSLTE_SUCCESS);
+  TESTASSERT(test_read_single() == SRSLTE_SUCCESS);
+  TESTASSERT(test_write_queue() == SRSLTE_SUCCESS);
+
+  srslte::byte_buffer_pool::cleanup();
+  test_log->info("Finished GW test successfully\n");
+  return SRSLTE_SUCCESS;
+}
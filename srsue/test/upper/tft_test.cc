@@ -22,7 +22,9 @@
 #include "srslte/asn1/liblte_mme.h"
 #include "srslte/common/log_filter.h"
 #include "srsue/hdr/stack/upper/tft_packet_filter.h"
+#include <chrono>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <srslte/common/buffer_pool.h>
 #include <srslte/common/int_helpers.h>
@@ -415,6 +417,109 @@ int tft_filter_test_ipv4_tos()
   return 0;
 }
 
+int tft_filter_test_classifier()
+{
+  srslte::log_filter log1("TFT");
+  log1.set_level(srslte::LOG_LEVEL_WARNING);
+  srslte::byte_buffer_pool* pool = srslte::byte_buffer_pool::get_instance();
+
+  const uint32_t nof_bearers    = 8;
+  const uint32_t nof_filters    = nof_bearers * LIBLTE_MME_PACKET_FILTER_LIST_MAX_SIZE;
+  const uint16_t base_port      = 2000;
+  const uint32_t nof_iterations = 20000;
+
+  // Every bearer gets 15 filters: UDP to 127.0.0.2 on a single remote port, every third one also on a local port
+  tft_pdu_matcher                         matcher(&log1);
+  std::map<uint16_t, tft_packet_filter_t> reference;
+  matcher.set_default_lcid(LCID);
+  for (uint32_t b = 0; b < nof_bearers; b++) {
+    LIBLTE_MME_TRAFFIC_FLOW_TEMPLATE_STRUCT tft = {};
+    tft.tft_op_code                             = LIBLTE_MME_TFT_OPERATION_CODE_CREATE_NEW_TFT;
+    tft.packet_filter_list_size                 = LIBLTE_MME_PACKET_FILTER_LIST_MAX_SIZE;
+    for (uint32_t i = 0; i < LIBLTE_MME_PACKET_FILTER_LIST_MAX_SIZE; i++) {
+      uint32_t                         n      = b * LIBLTE_MME_PACKET_FILTER_LIST_MAX_SIZE + i;
+      LIBLTE_MME_PACKET_FILTER_STRUCT& filter = tft.packet_filter_list[i];
+      filter.dir                              = LIBLTE_MME_TFT_PACKET_FILTER_DIRECTION_BIDIRECTIONAL;
+      filter.id                               = i;
+      filter.eval_precedence                  = n;
+      uint8_t* ptr                            = filter.filter;
+      *ptr++                                  = PROTOCOL_ID_TYPE;
+      *ptr++                                  = UDP_PROTOCOL;
+      *ptr++                                  = IPV4_REMOTE_ADDR_TYPE;
+      inet_pton(AF_INET, "127.0.0.2", ptr);
+      inet_pton(AF_INET, "255.255.255.255", ptr + 4);
+      ptr += 8;
+      *ptr++ = SINGLE_REMOTE_PORT_TYPE;
+      srslte::uint16_to_uint8(base_port + n, ptr);
+      ptr += 2;
+      if (n % 3 == 0) {
+        *ptr++ = SINGLE_LOCAL_PORT_TYPE;
+        srslte::uint16_to_uint8(2222, ptr);
+        ptr += 2;
+      }
+      filter.filter_size = ptr - filter.filter;
+      reference.insert(std::make_pair(n, tft_packet_filter_t(EPS_BEARER_ID + b, LCID + 1 + b, filter, &log1)));
+    }
+    TESTASSERT(matcher.apply_traffic_flow_template(EPS_BEARER_ID + b, LCID + 1 + b, &tft) == SRSLTE_SUCCESS);
+  }
+
+  // One packet per filter plus one that doesn't match any filter
+  std::vector<srslte::unique_byte_buffer_t> pdus;
+  for (uint32_t n = 0; n <= nof_filters; n++) {
+    srslte::unique_byte_buffer_t pdu = allocate_unique_buffer(*pool);
+    pdu->N_bytes                     = ip_message_len1;
+    memcpy(pdu->msg, ip_tst_message1, ip_message_len1);
+    srslte::uint16_to_uint8(base_port + n, &pdu->msg[22]);
+    pdus.push_back(std::move(pdu));
+  }
+
+  // The compiled classifier must agree with the linear evaluation
+  std::vector<uint8_t> expected(pdus.size(), LCID);
+  for (uint32_t n = 0; n < pdus.size(); n++) {
+    for (std::pair<const uint16_t, tft_packet_filter_t>& filter_pair : reference) {
+      if (filter_pair.second.match(pdus[n])) {
+        expected[n] = filter_pair.second.lcid;
+        break;
+      }
+    }
+    TESTASSERT(matcher.check_tft_filter_match(pdus[n]) == expected[n]);
+  }
+  TESTASSERT(expected[0] == LCID + 1);
+  TESTASSERT(expected[nof_filters] == LCID);
+
+  // Benchmark worst case (last filter and no match) of both
+  uint32_t                                       checksum = 0;
+  std::chrono::high_resolution_clock::time_point t0       = std::chrono::high_resolution_clock::now();
+  for (uint32_t k = 0; k < nof_iterations; k++) {
+    for (uint32_t n = nof_filters - 1; n <= nof_filters; n++) {
+      for (std::pair<const uint16_t, tft_packet_filter_t>& filter_pair : reference) {
+        if (filter_pair.second.match(pdus[n])) {
+          checksum += filter_pair.second.lcid;
+          break;
+        }
+      }
+    }
+  }
+  std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+  for (uint32_t k = 0; k < nof_iterations; k++) {
+    for (uint32_t n = nof_filters - 1; n <= nof_filters; n++) {
+      checksum += matcher.check_tft_filter_match(pdus[n]);
+    }
+  }
+  std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+  double linear_ns   = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (2.0 * nof_iterations);
+  double compiled_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / (2.0 * nof_iterations);
+  printf("TFT classifier with %d filters: linear %.1f ns/packet, compiled %.1f ns/packet (checksum %d)\n",
+         nof_filters,
+         linear_ns,
+         compiled_ns,
+         checksum);
+
+  printf("Test TFT classifier successfull\n");
+  return 0;
+}
+
 int main(int argc, char** argv)
 {
   srslte::byte_buffer_pool::get_instance();
@@ -436,5 +541,8 @@ int main(int argc, char** argv)
   if (tft_filter_test_ipv6_combined()) {
     return -1;
   }
+  if (tft_filter_test_classifier()) {
+    return -1;
+  }
   srslte::byte_buffer_pool::cleanup();
 }